@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/buffer_storage.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Array_AssignStruct(benchmark::State &state)
+{
+  // Converts every field, and reorders them
+  nd::array a = nd::empty(state.range_x(),
+                          ndt::type("{x: int32, y: float64, z: int16}"));
+  memset(a.get_readwrite_originptr(), 0, a.get_type().get_data_size());
+  nd::array b = nd::empty(state.range_x(),
+                          ndt::type("{z: int64, x: float64, y: float32}"));
+  while (state.KeepRunning()) {
+    b.val_assign(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Array_AssignStruct)->Range(1 << 4, 1 << 20);
+
+static nd::array make_strings(intptr_t size)
+{
+  stringstream ss;
+  ss << "[";
+  for (intptr_t i = 0; i < size; ++i) {
+    ss << (i == 0 ? "\"" : ", \"") << i * 7919 % 100003 << "\"";
+  }
+  ss << "]";
+  return parse_json(ndt::make_fixed_dim(size, ndt::make_string()), ss.str(),
+                    &eval::default_eval_context);
+}
+
+template <int DstKind>
+static void BM_Array_AssignString(benchmark::State &state)
+{
+  // From variable-sized strings to strings, fixed-size strings or ints
+  static const char *dst_tp[3] = {"string", "fixed_string[16]", "int32"};
+  nd::array a = make_strings(state.range_x());
+  nd::array b = nd::empty(state.range_x(), ndt::type(dst_tp[DstKind]));
+  while (state.KeepRunning()) {
+    // Strings which were assigned can't be assigned again until reset
+    reset_strided_buffer_array(b);
+    b.val_assign(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Array_AssignString, 0)->Range(1 << 4, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Array_AssignString, 1)->Range(1 << 4, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Array_AssignString, 2)->Range(1 << 4, 1 << 18);
+
+static void BM_Array_AssignVarDim(benchmark::State &state)
+{
+  // range_x ragged rows with up to range_y elements each
+  stringstream ss;
+  ss << "[";
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    ss << (i == 0 ? "[" : ", [");
+    for (intptr_t j = 0, j_end = i % state.range_y() + 1; j < j_end; ++j) {
+      ss << (j == 0 ? "" : ", ") << j;
+    }
+    ss << "]";
+  }
+  ss << "]";
+  nd::array a = parse_json(
+      ndt::make_fixed_dim(state.range_x(), ndt::type("var * int32")),
+      ss.str(), &eval::default_eval_context);
+  ndt::type dst_tp =
+      ndt::make_fixed_dim(state.range_x(), ndt::type("var * int64"));
+  while (state.KeepRunning()) {
+    // Each var dim is allocated by the assignment
+    nd::empty(dst_tp).val_assign(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Array_AssignVarDim)->RangePair(1 << 4, 1 << 16, 1, 64);
+
+static void BM_Array_AssignTransposed(benchmark::State &state)
+{
+  ndt::type tp = ndt::make_fixed_dim(
+      state.range_x(),
+      ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>()));
+  nd::array a = nd::random::uniform(kwds("dst_tp", tp)).transpose();
+  nd::array b = nd::empty(tp);
+  while (state.KeepRunning()) {
+    b.val_assign(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x() *
+                          state.range_x());
+}
+
+BENCHMARK(BM_Array_AssignTransposed)->Range(1 << 4, 1 << 12);
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const char *record_tp = "{id: int32, name: string, value: float64, "
+                               "tags: var * string, valid: bool}";
+
+static std::string make_records(intptr_t size)
+{
+  stringstream ss;
+  ss << "[";
+  for (intptr_t i = 0; i < size; ++i) {
+    ss << (i == 0 ? "" : ",\n") << "{\"id\": " << i << ", \"name\": \"name "
+       << i << "\", \"value\": " << i * 0.25 << ", \"tags\": [\"a\", \"b"
+       << i % 10 << "\"], \"valid\": " << (i % 2 ? "true" : "false") << "}";
+  }
+  ss << "]";
+  return ss.str();
+}
+
+static void BM_Array_ParseJSON_Records(benchmark::State &state)
+{
+  std::string json = make_records(state.range_x());
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::type(record_tp));
+  while (state.KeepRunning()) {
+    parse_json(tp, json, &eval::default_eval_context);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+BENCHMARK(BM_Array_ParseJSON_Records)->Range(1 << 4, 1 << 16);
+
+static void BM_Array_ParseJSON_Numbers(benchmark::State &state)
+{
+  stringstream ss;
+  ss << "[";
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    ss << (i == 0 ? "" : ", ") << i * 1.5;
+  }
+  ss << "]";
+  std::string json = ss.str();
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    parse_json(tp, json, &eval::default_eval_context);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+BENCHMARK(BM_Array_ParseJSON_Numbers)->Range(1 << 4, 1 << 20);
+
+static void BM_Array_FormatJSON_Records(benchmark::State &state)
+{
+  nd::array a =
+      parse_json(ndt::make_fixed_dim(state.range_x(), ndt::type(record_tp)),
+                 make_records(state.range_x()), &eval::default_eval_context);
+  while (state.KeepRunning()) {
+    format_json(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Array_FormatJSON_Records)->Range(1 << 4, 1 << 16);
@@ -4,14 +4,18 @@
 //
 
 #include <iostream>
+#include <fstream>
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include <dynd/config.hpp>
 
 #include <benchmark/benchmark.h>
 
+#include "json_reporter.hpp"
+
 using namespace std;
 using namespace dynd;
 
@@ -20,8 +24,34 @@ int main(int argc, const char *argv[])
   libdynd_init();
   atexit(&libdynd_cleanup);
 
+  // With --benchmark_json=<file>, the results are also written to <file>
+  // as JSON, for comparing runs with benchmarks/compare.py
+  const char *json_filename = NULL;
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--benchmark_json=", 17) == 0) {
+      json_filename = argv[i] + 17;
+      for (int j = i; j < argc; ++j) {
+        argv[j] = argv[j + 1];
+      }
+      --argc;
+      break;
+    }
+  }
+
   benchmark::Initialize(&argc, argv);
-  benchmark::RunSpecifiedBenchmarks();
+
+  if (json_filename != NULL) {
+    ofstream json(json_filename);
+    if (!json) {
+      cerr << "benchmark_libdynd: could not open " << json_filename << endl;
+      return 1;
+    }
+    json_reporter reporter(json);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    reporter.finish();
+  } else {
+    benchmark::RunSpecifiedBenchmarks();
+  }
 
   return 0;
 }
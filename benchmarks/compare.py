@@ -0,0 +1,77 @@
+#
+# Copyright (C) 2011-15 DyND Developers
+# BSD 2-Clause License, see LICENSE.txt
+#
+
+"""
+Compares two runs of benchmark_libdynd, and flags the benchmarks which got
+slower. Each run is the JSON written by
+
+    benchmark_libdynd --benchmark_repetitions=5 --benchmark_json=<file>
+
+and a benchmark's time is the minimum CPU time per iteration across its
+repetitions. Usage:
+
+    python compare.py [--threshold PERCENT] baseline.json contender.json
+
+The exit status is 1 if any benchmark in both runs is slower in the contender
+by more than the threshold (5% by default), so this can gate an upgrade.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        doc = json.load(f)
+    return dict((bm['name'], min(bm['cpu_time'])) for bm in doc['benchmarks'])
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('baseline')
+    parser.add_argument('contender')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='slowdown, in percent, which counts as a '
+                             'regression (default: 5)')
+    args = parser.parse_args(argv)
+
+    baseline = load(args.baseline)
+    contender = load(args.contender)
+    names = [name for name in baseline if name in contender]
+    if not names:
+        print('no benchmarks in common')
+        return 1
+    width = max(len(name) for name in names)
+
+    print('{:<{}}  {:>12}  {:>12}  {:>8}'.format('benchmark', width,
+                                                 'baseline ns', 'contender ns',
+                                                 'change'))
+    regressions = []
+    for name in sorted(names):
+        old, new = baseline[name], contender[name]
+        change = 100.0 * (new - old) / old if old > 0 else 0.0
+        flag = ''
+        if change > args.threshold:
+            flag = '  REGRESSION'
+            regressions.append(name)
+        print('{:<{}}  {:>12.1f}  {:>12.1f}  {:>+7.1f}%{}'.format(
+            name, width, old, new, change, flag))
+
+    for name in sorted(set(baseline) ^ set(contender)):
+        print('{} is only in {}'.format(
+            name, args.baseline if name in baseline else args.contender))
+
+    if regressions:
+        print('\n{} of {} benchmarks regressed by more than {}%'.format(
+            len(regressions), len(names), args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
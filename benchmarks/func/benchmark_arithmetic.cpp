@@ -10,6 +10,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include <dynd/array.hpp>
 #include <dynd/func/arithmetic.hpp>
 #include <dynd/func/random.hpp>
 
@@ -30,6 +31,120 @@ static void BM_Func_Arithmetic_Add(benchmark::State &state)
 
 BENCHMARK(BM_Func_Arithmetic_Add);
 
+// The remaining benchmarks take the number of elements as their argument,
+// so the per-call overhead and the throughput show up separately
+
+template <typename T>
+static nd::array uniform(intptr_t size)
+{
+  return nd::random::uniform(
+      kwds("dst_tp", ndt::make_fixed_dim(size, ndt::make_type<T>())));
+}
+
+template <typename T>
+static void BM_Func_Arithmetic_Add_Contiguous(benchmark::State &state)
+{
+  nd::array a = uniform<T>(state.range_x());
+  nd::array b = uniform<T>(state.range_x());
+  nd::array c = nd::empty(a.get_type());
+  while (state.KeepRunning()) {
+    nd::add(a, b, kwds("dst", c));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  state.SetBytesProcessed(state.iterations() * state.range_x() * 3 *
+                          sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_Add_Contiguous, float)
+    ->Range(1 << 4, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_Add_Contiguous, double)
+    ->Range(1 << 4, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_Add_Contiguous, int32_t)
+    ->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Arithmetic_Add_Allocating(benchmark::State &state)
+{
+  nd::array a = uniform<double>(state.range_x());
+  nd::array b = uniform<double>(state.range_x());
+  while (state.KeepRunning()) {
+    a + b;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Arithmetic_Add_Allocating)->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Arithmetic_Add_Strided(benchmark::State &state)
+{
+  // Every other element of arrays twice the size
+  nd::array a = uniform<double>(2 * state.range_x())(irange().by(2));
+  nd::array b = uniform<double>(2 * state.range_x())(irange().by(2));
+  nd::array c = nd::empty(state.range_x(), ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    nd::add(a, b, kwds("dst", c));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Arithmetic_Add_Strided)->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Arithmetic_Add_Broadcast(benchmark::State &state)
+{
+  // A matrix plus a row, with range_x rows of range_y elements
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(
+                    state.range_x(),
+                    ndt::make_fixed_dim(state.range_y(),
+                                        ndt::make_type<double>()))));
+  nd::array b = uniform<double>(state.range_y());
+  // A broadcast result doesn't match the return type of nd::add when it is
+  // passed as "dst", so this one includes allocating it
+  while (state.KeepRunning()) {
+    nd::add(a, b);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x() *
+                          state.range_y());
+}
+
+BENCHMARK(BM_Func_Arithmetic_Add_Broadcast)
+    ->RangePair(1 << 4, 1 << 12, 1 << 2, 1 << 10);
+
+static void BM_Func_Arithmetic_Add_Transposed(benchmark::State &state)
+{
+  // A C-order matrix plus a Fortran-order one
+  ndt::type tp = ndt::make_fixed_dim(
+      state.range_x(),
+      ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>()));
+  nd::array a = nd::random::uniform(kwds("dst_tp", tp));
+  nd::array b = nd::random::uniform(kwds("dst_tp", tp)).transpose();
+  nd::array c = nd::empty(tp);
+  while (state.KeepRunning()) {
+    nd::add(a, b, kwds("dst", c));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x() *
+                          state.range_x());
+}
+
+BENCHMARK(BM_Func_Arithmetic_Add_Transposed)->Range(1 << 4, 1 << 11);
+
+template <bool Deferred>
+static void BM_Func_Arithmetic_Fused(benchmark::State &state)
+{
+  // (a + b) * c - a, with or without deferred evaluation
+  nd::array a = uniform<double>(state.range_x());
+  nd::array b = uniform<double>(state.range_x());
+  nd::array c = uniform<double>(state.range_x());
+  eval::default_eval_context.deferred_elwise = Deferred;
+  while (state.KeepRunning()) {
+    ((a + b) * c - a).eval();
+  }
+  eval::default_eval_context.deferred_elwise = false;
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_Fused, false)->Range(1 << 4, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Func_Arithmetic_Fused, true)->Range(1 << 4, 1 << 22);
+
 /*
 
 #ifdef DYND_CUDA
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/arithmetic.hpp>
+#include <dynd/func/apply.hpp>
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/func/elwise.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// These measure the fixed cost of calling an arrfunc on small arrays, which
+// is mostly type resolution and ckernel instantiation
+
+static void BM_Func_ArrFunc_Call(benchmark::State &state)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<double>());
+  nd::array b = nd::empty(state.range_x(), ndt::make_type<double>());
+  a.val_assign(1.5);
+  b.val_assign(2.5);
+  while (state.KeepRunning()) {
+    nd::add(a, b);
+  }
+}
+
+BENCHMARK(BM_Func_ArrFunc_Call)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_Func_ArrFunc_Call_Uncached(benchmark::State &state)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<double>());
+  nd::array b = nd::empty(state.range_x(), ndt::make_type<double>());
+  a.val_assign(1.5);
+  b.val_assign(2.5);
+  intptr_t cache_size = eval::default_eval_context.kernel_cache_size;
+  eval::default_eval_context.kernel_cache_size = 0;
+  while (state.KeepRunning()) {
+    nd::add(a, b);
+  }
+  eval::default_eval_context.kernel_cache_size = cache_size;
+}
+
+BENCHMARK(BM_Func_ArrFunc_Call_Uncached)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_Func_ArrFunc_Call_Bound(benchmark::State &state)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<double>());
+  nd::array b = nd::empty(state.range_x(), ndt::make_type<double>());
+  a.val_assign(1.5);
+  b.val_assign(2.5);
+  // nd::add resolves a var dimension return type for its dispatch, and
+  // such types can't be bound, so this binds the equivalent elwise arrfunc
+  nd::arrfunc af = nd::functional::elwise(
+      nd::functional::apply([](double x, double y) { return x + y; }));
+  nd::bound_arrfunc bf = af.bind(a, b);
+  nd::array c = nd::empty(bf.get_dst_type());
+  char *const src[2] = {a.get_ndo()->m_data_pointer,
+                        b.get_ndo()->m_data_pointer};
+  while (state.KeepRunning()) {
+    bf.call(c.get_readwrite_originptr(), src);
+  }
+}
+
+// A dimension of size 1 broadcasts, which elwise resolves as a var dimension
+// that can't be bound, so this starts at 16
+BENCHMARK(BM_Func_ArrFunc_Call_Bound)->Arg(16)->Arg(256);
+
+static void BM_Func_ArrFunc_Instantiate(benchmark::State &state)
+{
+  // range_x is the number of dimensions
+  ndt::type tp = ndt::make_type<double>();
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    tp = ndt::make_fixed_dim(2, tp);
+  }
+  nd::array a = nd::empty(tp), b = nd::empty(tp), c = nd::empty(tp);
+  nd::arrfunc af = nd::functional::elwise(
+      nd::functional::apply([](double x, double y) { return x + y; }));
+  ndt::type src_tp[2] = {tp, tp};
+  const char *src_arrmeta[2] = {a.get_arrmeta(), b.get_arrmeta()};
+  std::map<nd::string, ndt::type> tp_vars;
+  while (state.KeepRunning()) {
+    ckernel_builder<kernel_request_host> ckb;
+    af.get()->instantiate(af.get(), af.get_type(), NULL, &ckb, 0, tp,
+                          c.get_arrmeta(), 2, src_tp, src_arrmeta,
+                          kernel_request_single, &eval::default_eval_context,
+                          nd::array(), tp_vars);
+  }
+}
+
+BENCHMARK(BM_Func_ArrFunc_Instantiate)->DenseRange(0, 4);
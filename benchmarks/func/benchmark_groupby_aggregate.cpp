@@ -0,0 +1,41 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/groupby_aggregate.hpp>
+#include <dynd/func/random.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_GroupbyAggregate_Mean(benchmark::State &state)
+{
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_y();
+  vector<nd::functional::groupby_aggregation> aggs(
+      1, nd::functional::groupby_aggregation{
+             "mean", nd::functional::groupby_mean, 0});
+  nd::arrfunc af = nd::functional::groupby_aggregate(1, 1, aggs);
+  nd::array keys = nd::empty(state.range_x(), ndt::make_type<int64_t>());
+  for (int i = 0; i < state.range_x(); ++i) {
+    keys(i).vals() = (i * 2654435761u) % 1000;
+  }
+  nd::array values = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    af(keys, values);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_GroupbyAggregate_Mean)->RangePair(1 << 12, 1 << 20, 1, 8);
@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/lift_reduction_arrfunc.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/kernels/describe_kernels.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static nd::arrfunc make_sum(intptr_t ndim, bool *reduction_dimflags)
+{
+  nd::arrfunc reduction_kernel =
+      kernels::make_builtin_sum_reduction_arrfunc(float64_type_id);
+  return lift_reduction_arrfunc(
+      reduction_kernel, ndt::make_fixed_dim_kind(ndt::make_type<double>(), ndim),
+      nd::array(), false, ndim, reduction_dimflags, true, true, false,
+      nd::array());
+}
+
+static void BM_Func_Reduction_Sum(benchmark::State &state)
+{
+  bool reduction_dimflags[1] = {true};
+  nd::arrfunc sum = make_sum(1, reduction_dimflags);
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  nd::array b = nd::empty(ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    sum(a, kwds("dst", b));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Reduction_Sum)->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Reduction_Sum_Kahan(benchmark::State &state)
+{
+  nd::arrfunc sum = kernels::make_builtin_sum1d_arrfunc(float64_type_id);
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  nd::array b = nd::empty(ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    sum(a, kwds("accuracy", nd::array("kahan"), "dst", b));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Reduction_Sum_Kahan)->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Reduction_Sum_Strided(benchmark::State &state)
+{
+  bool reduction_dimflags[1] = {true};
+  nd::arrfunc sum = make_sum(1, reduction_dimflags);
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp",
+      ndt::make_fixed_dim(2 * state.range_x(), ndt::make_type<double>())));
+  a = a(irange().by(2));
+  nd::array b = nd::empty(ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    sum(a, kwds("dst", b));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Reduction_Sum_Strided)->Range(1 << 4, 1 << 22);
+
+template <int Axis>
+static void BM_Func_Reduction_Sum_Axis(benchmark::State &state)
+{
+  // Reduces one axis of a range_x by range_y matrix
+  bool reduction_dimflags[2] = {Axis == 0, Axis == 1};
+  nd::arrfunc sum = make_sum(2, reduction_dimflags);
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(
+                    state.range_x(),
+                    ndt::make_fixed_dim(state.range_y(),
+                                        ndt::make_type<double>()))));
+  nd::array b = nd::empty(Axis == 0 ? state.range_y() : state.range_x(),
+                          ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    sum(a, kwds("dst", b));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x() *
+                          state.range_y());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Reduction_Sum_Axis, 0)
+    ->RangePair(1 << 4, 1 << 12, 1 << 2, 1 << 10);
+BENCHMARK_TEMPLATE(BM_Func_Reduction_Sum_Axis, 1)
+    ->RangePair(1 << 4, 1 << 12, 1 << 2, 1 << 10);
+
+static void BM_Func_Reduction_Describe(benchmark::State &state)
+{
+  nd::arrfunc describe = kernels::make_builtin_describe1d_arrfunc(
+      kernels::describe_all, ndt::make_type<double>());
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    describe(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Reduction_Describe)->Range(1 << 4, 1 << 22);
@@ -0,0 +1,82 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/func/rolling.hpp>
+#include <dynd/kernels/moments_kernels.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Rolling_Sum(benchmark::State &state)
+{
+  // range_x elements, with a window of range_y
+  nd::arrfunc rolling_sum = nd::functional::rolling(
+      kernels::make_builtin_sum1d_arrfunc(float64_type_id), state.range_y());
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    rolling_sum(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Rolling_Sum)->RangePair(1 << 10, 1 << 20, 4, 1 << 10);
+
+static void BM_Func_Rolling_Mean(benchmark::State &state)
+{
+  nd::arrfunc rolling_mean = nd::functional::rolling(
+      kernels::make_builtin_mean1d_arrfunc(float64_type_id, 0),
+      state.range_y());
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    rolling_mean(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Rolling_Mean)->RangePair(1 << 10, 1 << 20, 4, 1 << 10);
+
+static void BM_Func_Rolling_Std(benchmark::State &state)
+{
+  nd::arrfunc rolling_std = nd::functional::rolling(
+      kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_std,
+                                             float64_type_id, 1),
+      state.range_y());
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    rolling_std(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Rolling_Std)->RangePair(1 << 10, 1 << 20, 4, 1 << 10);
+
+static void BM_Func_Rolling_Max(benchmark::State &state)
+{
+  nd::arrfunc rolling_max = nd::functional::rolling(
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_max,
+                                                float64_type_id),
+      state.range_y());
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    rolling_max(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Rolling_Max)->RangePair(1 << 10, 1 << 20, 4, 1 << 10);
@@ -0,0 +1,45 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/func/scan.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Scan_Cumsum(benchmark::State &state)
+{
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    nd::cumsum(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Scan_Cumsum)->Range(1 << 10, 1 << 22);
+
+static void BM_Func_Scan_Cumsum_Parallel(benchmark::State &state)
+{
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_y();
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    nd::cumsum(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Scan_Cumsum_Parallel)->RangePair(1 << 16, 1 << 22, 1, 8);
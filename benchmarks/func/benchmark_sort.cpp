@@ -0,0 +1,59 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/func/sort.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Sort_Float64(benchmark::State &state)
+{
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    nd::sort(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Sort_Float64)->Range(1 << 10, 1 << 22);
+
+static void BM_Func_Argsort_Float64(benchmark::State &state)
+{
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    nd::argsort(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Argsort_Float64)->Range(1 << 10, 1 << 22);
+
+static void BM_Func_Sort_String_Parallel(benchmark::State &state)
+{
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_y();
+  nd::array a = nd::empty(state.range_x(), ndt::type("string"));
+  for (int i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = to_string((i * 2654435761u) % 1000003);
+  }
+  while (state.KeepRunning()) {
+    nd::sort(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Sort_String_Parallel)->RangePair(1 << 12, 1 << 18, 1, 8);
@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/func/take.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Take_Indexed(benchmark::State &state)
+{
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  // A scattered permutation of the indices
+  nd::array idx = nd::empty(state.range_x(), ndt::make_type<intptr_t>());
+  intptr_t *idx_data = reinterpret_cast<intptr_t *>(idx.get_readwrite_originptr());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    idx_data[i] = (i * 7919) % state.range_x();
+  }
+  while (state.KeepRunning()) {
+    nd::take(a, idx);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Take_Indexed)->Range(1 << 4, 1 << 22);
+
+static void BM_Func_Take_Masked(benchmark::State &state)
+{
+  nd::array a = nd::random::uniform(kwds(
+      "dst_tp", ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>())));
+  nd::array mask = nd::empty(state.range_x(), ndt::make_type<dynd_bool>());
+  dynd_bool *mask_data =
+      reinterpret_cast<dynd_bool *>(mask.get_readwrite_originptr());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    mask_data[i] = (i * 7919) % 3 != 0;
+  }
+  while (state.KeepRunning()) {
+    nd::take(a, mask);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Take_Masked)->Range(1 << 4, 1 << 22);
@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/unique.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Unique_Int64(benchmark::State &state)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<int64_t>());
+  for (int i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = (int64_t)((i * 2654435761u) % state.range_y());
+  }
+  while (state.KeepRunning()) {
+    nd::unique(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_Unique_Int64)->RangePair(1 << 12, 1 << 20, 16, 1 << 16);
+
+static void BM_Func_ValueCounts_String(benchmark::State &state)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::type("string"));
+  for (int i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = to_string((i * 2654435761u) % state.range_y());
+  }
+  while (state.KeepRunning()) {
+    nd::value_counts(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Func_ValueCounts_String)->RangePair(1 << 12, 1 << 18, 16, 1 << 16);
@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * A benchmark reporter which prints to the console as usual, and also
+ * writes every result to a stream as JSON, for benchmarks/compare.py. The
+ * output looks like
+ *
+ *   {
+ *     "context": {"num_cpus": 8, "mhz_per_cpu": 2600, ...},
+ *     "benchmarks": [
+ *       {"name": "BM_Func_Arithmetic_Add/1024", "iterations": 1000000,
+ *        "real_time": [512.3], "cpu_time": [510.9], "time_unit": "ns",
+ *        "bytes_per_second": 0, "items_per_second": 2.0e9, "label": ""},
+ *       ...
+ *     ]
+ *   }
+ *
+ * with one time per repetition, each the time of a single iteration.
+ */
+class json_reporter : public benchmark::internal::ConsoleReporter {
+  std::ostream &m_o;
+  mutable bool m_first;
+
+  static std::string quote(const std::string &s)
+  {
+    std::string res = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+        res += '\\';
+      }
+      res += c;
+    }
+    return res + "\"";
+  }
+
+  static std::string times(const std::vector<Run> &reports, bool real)
+  {
+    std::stringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < reports.size(); ++i) {
+      double seconds = real ? reports[i].real_accumulated_time
+                            : reports[i].cpu_accumulated_time;
+      ss << (i == 0 ? "" : ", ")
+         << seconds * 1e9 / std::max<int64_t>(reports[i].iterations, 1);
+    }
+    ss << "]";
+    return ss.str();
+  }
+
+public:
+  explicit json_reporter(std::ostream &o) : m_o(o), m_first(true) {}
+
+  virtual bool ReportContext(const Context &context) const
+  {
+    m_o << "{\n  \"context\": {\"num_cpus\": " << context.num_cpus
+        << ", \"mhz_per_cpu\": " << context.mhz_per_cpu
+        << ", \"cpu_scaling_enabled\": "
+        << (context.cpu_scaling_enabled ? "true" : "false")
+        << "},\n  \"benchmarks\": [";
+    return ConsoleReporter::ReportContext(context);
+  }
+
+  virtual void ReportRuns(const std::vector<Run> &reports) const
+  {
+    ConsoleReporter::ReportRuns(reports);
+    if (reports.empty()) {
+      return;
+    }
+
+    const Run &run = reports.front();
+    m_o << (m_first ? "\n" : ",\n") << "    {\"name\": "
+        << quote(run.benchmark_name) << ", \"iterations\": " << run.iterations
+        << ", \"real_time\": " << times(reports, true)
+        << ", \"cpu_time\": " << times(reports, false)
+        << ", \"time_unit\": \"ns\", \"bytes_per_second\": "
+        << run.bytes_per_second
+        << ", \"items_per_second\": " << run.items_per_second
+        << ", \"label\": " << quote(run.report_label) << "}";
+    m_first = false;
+  }
+
+  /** Closes the JSON document once all the benchmarks have run */
+  void finish() { m_o << "\n  ]\n}\n"; }
+};
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/buffer_storage.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/types/categorical_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+/**
+ * Makes range_x strings drawn from range_y distinct values.
+ */
+static nd::array make_values(intptr_t size, intptr_t ncategories)
+{
+  stringstream ss;
+  ss << "[";
+  for (intptr_t i = 0; i < size; ++i) {
+    ss << (i == 0 ? "\"" : ", \"") << "category "
+       << (i * 7919) % ncategories << "\"";
+  }
+  ss << "]";
+  return parse_json(ndt::make_fixed_dim(size, ndt::make_string()), ss.str(),
+                    &eval::default_eval_context);
+}
+
+static void BM_Types_FactorCategorical(benchmark::State &state)
+{
+  nd::array a = make_values(state.range_x(), state.range_y());
+  while (state.KeepRunning()) {
+    ndt::factor_categorical(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Types_FactorCategorical)
+    ->RangePair(1 << 10, 1 << 18, 1 << 2, 1 << 12);
+
+static void BM_Types_EncodeCategorical(benchmark::State &state)
+{
+  nd::array a = make_values(state.range_x(), state.range_y());
+  ndt::type cat_tp = ndt::factor_categorical(a);
+  nd::array b = nd::empty(state.range_x(), cat_tp);
+  while (state.KeepRunning()) {
+    b.val_assign(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Types_EncodeCategorical)
+    ->RangePair(1 << 10, 1 << 18, 1 << 2, 1 << 12);
+
+static void BM_Types_DecodeCategorical(benchmark::State &state)
+{
+  nd::array a = make_values(state.range_x(), state.range_y());
+  nd::array b = nd::empty(state.range_x(), ndt::factor_categorical(a));
+  b.val_assign(a);
+  nd::array c = nd::empty(state.range_x(), ndt::make_string());
+  while (state.KeepRunning()) {
+    // Strings which were assigned can't be assigned again until reset
+    reset_strided_buffer_array(c);
+    c.val_assign(b);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK(BM_Types_DecodeCategorical)
+    ->RangePair(1 << 10, 1 << 18, 1 << 2, 1 << 12);
@@ -0,0 +1,47 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/type.hpp>
+#include <dynd/types/datashape_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const char *datashapes[] = {
+    "int32", "10 * 20 * float64", "var * {x: int32, y: string, z: ?float64}",
+    "(Fixed * T, Fixed * T) -> Fixed * T",
+    "{id: int64, name: string, address: {street: string, city: string, "
+    "zip: fixed_string[5]}, visits: var * {when: datetime, duration: "
+    "int32}, tags: 3 * string}"};
+
+static void BM_Types_ParseDatashape(benchmark::State &state)
+{
+  const char *ds = datashapes[state.range_x()];
+  while (state.KeepRunning()) {
+    ndt::type tp(ds);
+  }
+  state.SetLabel(ds);
+}
+
+BENCHMARK(BM_Types_ParseDatashape)->DenseRange(0, 4);
+
+static void BM_Types_FormatDatashape(benchmark::State &state)
+{
+  ndt::type tp(datashapes[state.range_x()]);
+  while (state.KeepRunning()) {
+    stringstream ss;
+    ss << tp;
+  }
+}
+
+BENCHMARK(BM_Types_FormatDatashape)->DenseRange(0, 4);
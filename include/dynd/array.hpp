@@ -823,6 +823,12 @@ namespace nd {
     friend class array_vals_at;
   };
 
+  /**
+   * The arithmetic operators evaluate eagerly, unless deferred evaluation
+   * is enabled with eval_context::deferred_elwise or an operand is already
+   * deferred. Then they build a fused expression, which is evaluated in
+   * one pass on eval() or assignment (see eval/deferred_elwise_eval.hpp).
+   */
   array operator+(const array &a0);
   array operator-(const array &a0);
 
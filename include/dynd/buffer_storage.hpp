@@ -46,8 +46,13 @@ class buffer_storage {
   void internal_allocate()
   {
     if (m_type.get_type_id() != uninitialized_type_id) {
-      m_stride = m_type.get_data_size();
+      // Struct types have no fixed data size, so use the size their default
+      // arrmeta lays them out in
+      m_stride = m_type.get_default_data_size();
       m_storage = new char[DYND_BUFFER_CHUNK_SIZE * m_stride];
+      if (m_type.get_flags() & (type_flag_zeroinit | type_flag_destructor)) {
+        memset(m_storage, 0, DYND_BUFFER_CHUNK_SIZE * m_stride);
+      }
       m_arrmeta = NULL;
       size_t metasize =
           m_type.is_builtin() ? 0 : m_type.extended()->get_arrmeta_size();
@@ -116,6 +121,21 @@ public:
 
   inline const ndt::type &get_type() const { return m_type; }
 
+  /**
+   * The number of elements to pass through the buffer at a time. This is
+   * DYND_BUFFER_CHUNK_SIZE, or fewer for large elements so that a chunk
+   * stays within DYND_BUFFER_CHUNK_BYTES.
+   */
+  inline size_t get_chunk_size() const
+  {
+    if (m_stride * DYND_BUFFER_CHUNK_SIZE <= DYND_BUFFER_CHUNK_BYTES) {
+      return DYND_BUFFER_CHUNK_SIZE;
+    }
+    return m_stride < DYND_BUFFER_CHUNK_BYTES
+               ? DYND_BUFFER_CHUNK_BYTES / m_stride
+               : 1;
+  }
+
   inline char *const &get_storage() const { return m_storage; }
 
   inline const char *get_arrmeta() const { return m_arrmeta; }
@@ -7,10 +7,14 @@
 
 #include <map>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <dynd/type.hpp>
 #include <dynd/codegen/calling_conventions.hpp>
+#include <dynd/kernels/ckernel_prefix.hpp>
+#include <dynd/vm/elwise_program.hpp>
 
 namespace dynd {
 
@@ -25,6 +29,12 @@ class codegen_cache {
 //    std::map<uint64_t, unary_operation_pair_t> m_cached_unary_kernel_adapters;
     /** A mapping from binary kernel adapter unique id to the generated kernel adapter */
 //    std::map<uint64_t, binary_operation_pair_t> m_cached_binary_kernel_adapters;
+    /** A mapping from elwise VM program signature to the generated strided loop */
+    std::map<std::vector<int>, expr_strided_t> m_cached_elwise_programs;
+    std::mutex m_mutex;
+
+    codegen_cache(const codegen_cache&);
+    codegen_cache& operator=(const codegen_cache&);
 public:
     codegen_cache();
 
@@ -72,7 +82,18 @@ public:
 //                    memory_block_data *function_pointer_owner,
 //                    kernel_instance<unary_operation_pair_t>& out_kernel);
 
+    /**
+     * Returns a generated strided loop which evaluates the elementwise
+     * VM program, or NULL if the program can't be compiled on this
+     * platform. Programs with the same register types and instructions
+     * share one generated loop. This may be called from multiple threads.
+     */
+    expr_strided_t codegen_elwise_program(const vm::elwise_program& ep);
+
     void debug_print(std::ostream& o, const std::string& indent = "") const;
+
+    /** The process-wide codegen cache, whose code lives until exit */
+    static codegen_cache& get();
 };
 
 } // namespace dynd
@@ -0,0 +1,30 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/ckernel_prefix.hpp>
+#include <dynd/memblock/memory_block.hpp>
+#include <dynd/vm/elwise_program.hpp>
+
+namespace dynd {
+
+/**
+ * Generates machine code for a strided loop evaluating an elementwise VM
+ * program, placing it in the executable memory block. The loop has the
+ * expr_strided_t signature, with the program inputs as its sources, and
+ * ignores its ckernel argument. All the registers live in machine registers,
+ * so each element is computed without any calls or temporary memory.
+ *
+ * Returns NULL if the platform or the program isn't supported. Currently
+ * only x86-64 System V is supported, for programs whose registers are all
+ * float32 or all float64, with at most 7 inputs and 15 registers, using
+ * the copy, add, subtract, multiply, divide, minimum, maximum and sqrt
+ * opcodes.
+ */
+expr_strided_t codegen_elwise_program(memory_block_data *exec_memblock,
+                                      const vm::elwise_program &ep);
+
+} // namespace dynd
@@ -31,6 +31,12 @@
 /** The number of elements to process at once when doing chunking/buffering */
 #define DYND_BUFFER_CHUNK_SIZE 128
 
+/**
+ * The most bytes one chunk of buffers may take. This is half of a 32KB L1
+ * data cache, so the buffered values are still in cache when they are read.
+ */
+#define DYND_BUFFER_CHUNK_BYTES 0x4000
+
 #ifdef __clang__
 
 #if __has_feature(cxx_constexpr)
@@ -87,6 +93,10 @@
 // MSVC 2013 doesn't support nested initializer lists
 // https://stackoverflow.com/questions/23965565/how-to-do-nested-initializer-lists-in-visual-c-2013
 #define DYND_NESTED_INIT_LIST_BUG
+// MSVC 2013 doesn't support thread_local, and its __declspec(thread) only
+// holds values without constructors or destructors
+#define DYND_THREAD_LOCAL __declspec(thread)
+#define DYND_THREAD_LOCAL_POD_ONLY
 #endif
 
 // No DYND_CONSTEXPR yet, define it as nothing
@@ -119,6 +129,10 @@ public:
 
 #endif // end of compiler vendor checks
 
+#ifndef DYND_THREAD_LOCAL
+#define DYND_THREAD_LOCAL thread_local
+#endif
+
 #ifdef __CUDACC__
 #define DYND_CUDA_HOST_DEVICE __host__ __device__
 #else
@@ -0,0 +1,39 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/vm/elwise_program.hpp>
+
+namespace dynd { namespace eval {
+
+/**
+ * Returns true if the array is a deferred elementwise expression, as
+ * built by make_deferred_elwise.
+ */
+bool is_deferred_elwise(const nd::array &a);
+
+/**
+ * Builds a deferred elementwise expression applying one of the arithmetic
+ * opcodes (add, subtract, multiply, divide, negate) to the arguments. The
+ * result is an array of expr type whose operands are the leaf arrays of
+ * the whole expression, and whose kernel generator holds a single VM
+ * program for it. Arguments which are deferred expressions themselves
+ * have their programs fused into the new one, so ``(a + b) * c - d``
+ * allocates nothing until it is evaluated.
+ *
+ * Evaluation happens on eval() or on assignment to an array, as one pass
+ * of evaluate_elwise_vm over the broadcast leaves.
+ *
+ * The arguments must have strided dimensions and an int8, int16, int32,
+ * int64, float32 or float64 dtype, and the result type follows the C++
+ * arithmetic promotion rules. Returns a NULL array if the arguments can't
+ * be deferred, or if the expression would have fewer than two leaves.
+ */
+nd::array make_deferred_elwise(int opcode, intptr_t narg, const nd::array *args);
+
+}} // namespace dynd::eval
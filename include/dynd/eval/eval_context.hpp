@@ -37,6 +37,16 @@ struct eval_context {
     std::atomic<date_parse_order_t> date_parse_order;
     // Century selection for 2 digit years in date strings
     std::atomic<int> century_window;
+    // Maximum number of threads used to execute a kernel, 1 means serial
+    std::atomic<intptr_t> nthreads;
+    // Minimum number of outer dimension elements given to each thread
+    std::atomic<intptr_t> parallel_grain_size;
+    // Number of instantiated ckernels nd::arrfunc::call keeps for reuse
+    std::atomic<intptr_t> kernel_cache_size;
+    // Whether the nd::array arithmetic operators build deferred expressions
+    std::atomic<bool> deferred_elwise;
+    // Whether nd::arrfunc::call instruments its ckernels, see ckernel_profile
+    std::atomic<bool> profile_kernels;
 #else
     // Default error mode for computations
     assign_error_mode errmode;
@@ -46,12 +56,24 @@ struct eval_context {
     date_parse_order_t date_parse_order;
     // Century selection for 2 digit years in date strings
     int century_window;
+    // Maximum number of threads used to execute a kernel, 1 means serial
+    intptr_t nthreads;
+    // Minimum number of outer dimension elements given to each thread
+    intptr_t parallel_grain_size;
+    // Number of instantiated ckernels nd::arrfunc::call keeps for reuse
+    intptr_t kernel_cache_size;
+    // Whether the nd::array arithmetic operators build deferred expressions
+    bool deferred_elwise;
+    // Whether nd::arrfunc::call instruments its ckernels, see ckernel_profile
+    bool profile_kernels;
 #endif
 
     DYND_CONSTEXPR eval_context()
         : errmode(assign_error_fractional),
           cuda_device_errmode(assign_error_nocheck),
-          date_parse_order(date_parse_no_ambig), century_window(70)
+          date_parse_order(date_parse_no_ambig), century_window(70),
+          nthreads(1), parallel_grain_size(16384), kernel_cache_size(32),
+          deferred_elwise(false), profile_kernels(false)
     {
     }
 
@@ -61,7 +83,12 @@ struct eval_context {
         : errmode(rhs.errmode.load()),
           cuda_device_errmode(rhs.cuda_device_errmode.load()),
           date_parse_order(rhs.date_parse_order.load()),
-          century_window(rhs.century_window.load())
+          century_window(rhs.century_window.load()),
+          nthreads(rhs.nthreads.load()),
+          parallel_grain_size(rhs.parallel_grain_size.load()),
+          kernel_cache_size(rhs.kernel_cache_size.load()),
+          deferred_elwise(rhs.deferred_elwise.load()),
+          profile_kernels(rhs.profile_kernels.load())
     {
     }
 
@@ -70,6 +97,11 @@ struct eval_context {
         cuda_device_errmode.store(rhs.cuda_device_errmode.load());
         date_parse_order.store(rhs.date_parse_order.load());
         century_window.store(rhs.century_window.load());
+        nthreads.store(rhs.nthreads.load());
+        parallel_grain_size.store(rhs.parallel_grain_size.load());
+        kernel_cache_size.store(rhs.kernel_cache_size.load());
+        deferred_elwise.store(rhs.deferred_elwise.load());
+        profile_kernels.store(rhs.profile_kernels.load());
         return *this;
     }
 #endif
@@ -13,7 +13,31 @@
 
 namespace dynd { namespace eval {
 
+/**
+ * Evaluates an elementwise VM program, broadcasting the inputs together
+ * and returning a new C-order array with the type of the output register.
+ *
+ * The program runs over the broadcast inputs in chunks small enough for
+ * the registers to stay in the L1 cache, so the temporaries of an
+ * expression like ``a*b + c*d`` never exist at full size. Inputs whose
+ * type differs from their register are converted one chunk at a time.
+ *
+ * When every input is read in place and the platform supports it, the
+ * program is compiled to machine code through the process-wide
+ * codegen_cache instead, which keeps the registers in machine registers.
+ */
 nd::array evaluate_elwise_vm(const vm::elwise_program& ep, std::vector<nd::array> inputs,
                     const eval::eval_context *ectx = &eval::default_eval_context);
 
+/**
+ * Evaluates an elementwise VM program into existing memory. The output
+ * must have strided dimensions and the type of the output register, with
+ * any strides, and each input must broadcast to its shape.
+ */
+void evaluate_elwise_vm(const vm::elwise_program &ep, const ndt::type &dst_tp,
+                        const char *dst_arrmeta, char *dst_data,
+                        const ndt::type *src_tp, const char *const *src_arrmeta,
+                        char *const *src_data,
+                        const eval::eval_context *ectx = &eval::default_eval_context);
+
 }} // namespace dynd::eval
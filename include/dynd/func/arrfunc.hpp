@@ -771,6 +771,88 @@ namespace nd {
   template <typename T>
   struct declfunc;
 
+  namespace detail {
+
+    struct bound_kernel;
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * An arrfunc together with a ckernel instantiated for one fixed set of
+   * argument types and arrmeta, as returned by nd::arrfunc::bind. Calling
+   * it performs no type resolution or instantiation, only the ckernel
+   * call, so it is meant for running the same operation many times on
+   * arrays that share a layout.
+   *
+   * A bound_arrfunc is not reentrant, and must not be called from more
+   * than one thread at a time.
+   */
+  class bound_arrfunc {
+    std::shared_ptr<detail::bound_kernel> m_kernel;
+
+  public:
+    bound_arrfunc() {}
+
+    explicit bound_arrfunc(const std::shared_ptr<detail::bound_kernel> &kernel)
+        : m_kernel(kernel)
+    {
+    }
+
+    bool is_null() const { return !m_kernel; }
+
+    /** The type of the arrays this bound_arrfunc returns */
+    const ndt::type &get_dst_type() const;
+
+    intptr_t get_narg() const;
+
+    const ndt::type &get_arg_type(intptr_t i) const;
+
+    /**
+     * Returns true if ``a`` has exactly the type and arrmeta that
+     * argument ``i`` was bound to.
+     */
+    bool matches(intptr_t i, const array &a) const;
+
+    /**
+     * Calls the ckernel directly on raw data pointers. No checking is done,
+     * the data must be laid out as described by the bound types and arrmeta.
+     */
+    void call(char *dst, char *const *src) const;
+
+    /** Calls the ckernel on arrays, checking that they match the binding */
+    array call(intptr_t narg, const array *args) const;
+
+    /** Calls the ckernel into a provided destination array */
+    void call(const array &dst, intptr_t narg, const array *args) const;
+
+    array operator()() const
+    {
+      return call(0, static_cast<const array *>(NULL));
+    }
+
+    template <typename... A>
+    array operator()(const A &... a) const
+    {
+      array args[sizeof...(A)] = {array(a)...};
+      return call(sizeof...(A), args);
+    }
+  };
+
+  /**
+   * Discards all the ckernels cached by nd::arrfunc::call, and resets the
+   * hit count.
+   */
+  void clear_kernel_cache();
+
+  /** The number of ckernels currently cached by nd::arrfunc::call */
+  intptr_t get_kernel_cache_size();
+
+  /**
+   * The number of calls which reused a cached ckernel since the cache was
+   * last cleared.
+   */
+  intptr_t get_kernel_cache_hits();
+
   /**
    * Holds a single instance of an arrfunc in an nd::array,
    * providing some more direct convenient interface.
@@ -898,24 +980,29 @@ namespace nd {
           }
     */
 
-    /** Implements the general call operator which returns an array */
+  private:
+    /**
+     * Validates the arguments of a call, producing the argument types,
+     * arrmeta and data, the keyword arguments as a struct array, and the
+     * typevar assignments. ``dst`` is set if it was passed as a keyword.
+     */
     template <typename A, typename K>
-    array call(const A &args, const K &kwds) const
+    void validate_call(const A &args, const K &kwds, array &dst,
+                       std::vector<ndt::type> &arg_tp,
+                       std::vector<const char *> &arg_arrmeta,
+                       std::vector<char *> &arg_data, array &kwds_as_array,
+                       std::map<nd::string, ndt::type> &tp_vars) const
     {
-      const arrfunc_type_data *self = get();
       const ndt::arrfunc_type *self_tp = get_type();
 
-      array dst;
-
       // ...
       std::vector<ndt::type> kwd_tp(self_tp->get_nkwd());
       std::vector<intptr_t> available, missing;
       kwds.validate_names(self_tp, dst, kwd_tp, available, missing);
 
-      std::map<nd::string, ndt::type> tp_vars;
-      std::vector<ndt::type> arg_tp(self_tp->get_npos());
-      std::vector<const char *> arg_arrmeta(self_tp->get_npos());
-      std::vector<char *> arg_data(self_tp->get_npos());
+      arg_tp.resize(self_tp->get_npos());
+      arg_arrmeta.resize(self_tp->get_npos());
+      arg_data.resize(self_tp->get_npos());
       // Validate the array arguments
       args.validate_types(self_tp, arg_tp, arg_arrmeta, arg_data, tp_vars);
 
@@ -936,63 +1023,100 @@ namespace nd {
       detail::validate_kwd_types(self_tp, kwd_tp, available, missing, tp_vars);
 
       // ...
-      array kwds_as_array =
+      kwds_as_array =
           kwds.as_array(ndt::make_struct(self_tp->get_kwd_names(), kwd_tp),
                         available, missing);
+    }
 
-      // ...
-      std::unique_ptr<char[]> data(new char[get()->data_size]);
+    /**
+     * Resolves the destination type, instantiates the ckernel and runs it,
+     * reusing a cached ckernel when one matches the arguments.
+     */
+    array call_validated(array &dst, const std::vector<ndt::type> &arg_tp,
+                         const std::vector<const char *> &arg_arrmeta,
+                         const std::vector<char *> &arg_data,
+                         array &kwds_as_array,
+                         std::map<nd::string, ndt::type> &tp_vars) const;
+
+    /** Instantiates a ckernel owned by a new bound_arrfunc */
+    bound_arrfunc bind_validated(const std::vector<ndt::type> &arg_tp,
+                                 const std::vector<const char *> &arg_arrmeta,
+                                 array &kwds_as_array,
+                                 std::map<nd::string, ndt::type> &tp_vars) const;
 
-      // Resolve the optional keyword arguments
-      if (self->resolve_option_values != NULL) {
-        self->resolve_option_values(self, self_tp, data.get(), arg_tp.size(),
-                                    arg_tp.empty() ? NULL : arg_tp.data(),
-                                    kwds_as_array, tp_vars);
-      }
+  public:
+    /** Implements the general call operator which returns an array */
+    template <typename A, typename K>
+    array call(const A &args, const K &kwds) const
+    {
+      array dst;
+      std::vector<ndt::type> arg_tp;
+      std::vector<const char *> arg_arrmeta;
+      std::vector<char *> arg_data;
+      array kwds_as_array;
+      std::map<nd::string, ndt::type> tp_vars;
+      validate_call(args, kwds, dst, arg_tp, arg_arrmeta, arg_data,
+                    kwds_as_array, tp_vars);
 
-      // Construct the destination array, if it was not provided
-      ndt::type dst_tp;
-      if (dst.is_null()) {
-        // Resolve the destination type
-        if (self->resolve_dst_type != NULL) {
-          self->resolve_dst_type(
-              self, self_tp, data.get(), dst_tp, arg_tp.size(),
-              arg_tp.empty() ? NULL : arg_tp.data(), kwds_as_array, tp_vars);
-        } else {
-          dst_tp = ndt::substitute(self_tp->get_return_type(), tp_vars, true);
-        }
+      return call_validated(dst, arg_tp, arg_arrmeta, arg_data, kwds_as_array,
+                            tp_vars);
+    }
 
-        dst = empty(dst_tp);
-      } else if (self->resolve_dst_type != NULL) {
-        // In this case, with dst_tp already populated, resolve_dst_type
-        // must not overwrite it
-        dst_tp = dst.get_type();
-        self->resolve_dst_type(self, self_tp, data.get(), dst_tp, arg_tp.size(),
-                               arg_tp.empty() ? NULL : arg_tp.data(),
-                               kwds_as_array, tp_vars);
-        // Sanity error check against rogue resolve_test_type
-        if (dst_tp.extended() != dst.get_type().extended()) {
-          std::stringstream ss;
-          ss << "Arrfunc internal error: resolve_dst_type modified a dst_tp "
-                "provided for output, transforming " << dst.get_type()
-             << " into " << dst_tp;
-          throw std::runtime_error(ss.str());
-        }
+    /** Implements binding the arrfunc to the layout of a set of arguments */
+    template <typename A, typename K>
+    bound_arrfunc make_bound(const A &args, const K &kwds) const
+    {
+      array dst;
+      std::vector<ndt::type> arg_tp;
+      std::vector<const char *> arg_arrmeta;
+      std::vector<char *> arg_data;
+      array kwds_as_array;
+      std::map<nd::string, ndt::type> tp_vars;
+      validate_call(args, kwds, dst, arg_tp, arg_arrmeta, arg_data,
+                    kwds_as_array, tp_vars);
+      if (!dst.is_null()) {
+        throw std::invalid_argument(
+            "an arrfunc cannot be bound to a provided \"dst\"");
       }
 
-      // Generate and evaluate the ckernel
-      ckernel_builder<kernel_request_host> ckb;
-      self->instantiate(self, self_tp, data.get(), &ckb, 0, dst_tp,
-                        dst.get_arrmeta(), arg_tp.size(),
-                        arg_tp.empty() ? NULL : arg_tp.data(),
-                        arg_arrmeta.empty() ? NULL : arg_arrmeta.data(),
-                        kernel_request_single, &eval::default_eval_context,
-                        kwds_as_array, tp_vars);
-      expr_single_t fn = ckb.get()->get_function<expr_single_t>();
-      fn(dst.get_readwrite_originptr(),
-         arg_data.empty() ? NULL : arg_data.data(), ckb.get());
-
-      return dst;
+      return bind_validated(arg_tp, arg_arrmeta, kwds_as_array, tp_vars);
+    }
+
+    /**
+     * Instantiates the ckernel for arguments with the types and arrmeta
+     * of ``a...``, optionally followed by kwds(...). The returned
+     * bound_arrfunc can be called on any arrays with that same layout,
+     * skipping type resolution and instantiation.
+     */
+    bound_arrfunc bind() const
+    {
+      return make_bound(detail::args<>(), detail::kwds<>());
+    }
+
+    template <typename... T>
+    typename std::enable_if<
+        detail::is_kwds<typename back<type_sequence<T...>>::type>::value,
+        bound_arrfunc>::type
+    bind(T &&... a) const
+    {
+      typedef make_index_sequence<sizeof...(T)-1> I;
+      typedef typename instantiate<
+          detail::args,
+          typename to<type_sequence<typename as_array<T>::type...>,
+                      sizeof...(T)-1>::type>::type args_type;
+
+      args_type arr =
+          index_proxy<I>::template make<args_type>(std::forward<T>(a)...);
+      return make_bound(arr, dynd::get<sizeof...(T)-1>(std::forward<T>(a)...));
+    }
+
+    template <typename... A>
+    typename std::enable_if<
+        !detail::is_kwds<typename back<type_sequence<A...>>::type>::value,
+        bound_arrfunc>::type
+    bind(A &&... a) const
+    {
+      return bind(std::forward<A>(a)..., kwds());
     }
 
     /**
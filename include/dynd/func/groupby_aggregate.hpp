@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /** The aggregates groupby_aggregate computes for each group */
+    enum groupby_aggregate_t {
+      /** The number of values which aren't NaN, int64 */
+      groupby_count,
+      /**
+       * The sum of the values which aren't NaN, int64 for signed
+       * integers, uint64 for unsigned integers and bool, and float64 for
+       * reals
+       */
+      groupby_sum,
+      /** The mean of the values which aren't NaN, float64 */
+      groupby_mean,
+      /** The minimum of the values which aren't NaN, of the value type */
+      groupby_min,
+      /** The maximum of the values which aren't NaN, of the value type */
+      groupby_max
+    };
+
+    /** One field of the groupby_aggregate result */
+    struct groupby_aggregation {
+      /** The name of the field */
+      std::string name;
+      groupby_aggregate_t op;
+      /** The index of the value array among the value arguments */
+      intptr_t value;
+    };
+
+    /**
+     * Create an arrfunc which groups the rows of ``nkeys`` key arrays by
+     * their values, and reduces the rows of ``nvalues`` value arrays in
+     * each group with the ``aggregations``, in one pass over the data.
+     * ``(Fixed * K0, ..., Fixed * V0, ...) -> {key0: var * K0, ...,
+     * <aggregation name>: var * <aggregate type>, ...}``.
+     *
+     * The groups are listed in the order of their first row. The keys may
+     * be builtin numbers, dates, times, datetimes, strings, bytes, options
+     * of builtin types, and tuples or structs of these. The values must
+     * be builtin integers, reals or bools.
+     *
+     * The groups are found with an open addressing hash table. When the
+     * eval_context asks for more than one thread and the arrays are
+     * large enough, the rows are hashed in parallel, then each thread
+     * groups and reduces the rows of one partition of the hash values,
+     * which gives the same result as the serial pass.
+     */
+    arrfunc groupby_aggregate(intptr_t nkeys, intptr_t nvalues,
+                              const std::vector<groupby_aggregation> &aggs);
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -15,6 +15,12 @@ namespace dynd {
  * Lifts the provided arrfunc, broadcasting it as necessary to execute
  * across the additional dimensions in the ``lifted_types`` array.
  *
+ * When the eval_context asks for more than one thread, the outermost
+ * dimension is reduced, the operation is associative, and ``combine`` is
+ * provided, the outermost dimension is split into chunks reduced in
+ * parallel. The partial results are combined in order, so the operation
+ * doesn't need to be commutative.
+ *
  * \param elwise_reduction  The arrfunc to be lifted. This must
  *                          be a unary operation, which modifies the output
  *                          in place.
@@ -41,6 +47,9 @@ namespace dynd {
  *                           from right to left instead of left to right.
  * \param reduction_identity  If not a NULL nd::array, this is the identity
  *                            value for the accumulator.
+ * \param combine  If not NULL, a reduction arrfunc of the accumulator
+ *                 type, unary or binary like `elwise_reduction`, which
+ *                 merges one partial accumulator into another.
  */
 nd::arrfunc lift_reduction_arrfunc(const nd::arrfunc &elwise_reduction,
                                    const ndt::type &lifted_arr_type,
@@ -49,6 +58,15 @@ nd::arrfunc lift_reduction_arrfunc(const nd::arrfunc &elwise_reduction,
                                    const bool *reduction_dimflags,
                                    bool associative, bool commutative,
                                    bool right_associative,
-                                   const nd::array &reduction_identity);
+                                   const nd::array &reduction_identity,
+                                   const nd::arrfunc &combine = nd::arrfunc());
+
+/**
+ * If ``af`` was made by lift_reduction_arrfunc from one of the builtin
+ * reductions, reducing every dimension, returns the identity of that
+ * reduction. Reducing an extra value equal to it leaves the result
+ * unchanged. Otherwise returns a NULL nd::array.
+ */
+nd::array get_lifted_builtin_reduction_identity(const nd::arrfunc &af);
 
 } // namespace dynd
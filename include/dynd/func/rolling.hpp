@@ -17,12 +17,25 @@ namespace nd {
      * Create an arrfunc which applies a given window_op in a
      * rolling window fashion.
      *
+     * If the window op is a builtin sum, mean, var, std, min or max (see
+     * kernels::get_builtin1d_info), it is not called, and the aggregate
+     * is instead updated as values enter and leave the window, in time
+     * independent of the window size.
+     *
      * \param window_op  A arrfunc object which should be applied to each
      *                   window. The types of this ckernel must match
      *                   appropriately with `dst_tp` and `src_tp`.
      * \param window_size  The size of the rolling window.
+     * \param min_periods  The fewest values the windows at the start of the
+     *                    dimension, which are shorter than window_size,
+     *                    need to be computed instead of being NaN. The
+     *                    default of -1 means window_size. A smaller value
+     *                    requires a builtin aggregate, or a builtin
+     *                    reduction lifted by lift_reduction_arrfunc, whose
+     *                    identity pads those windows to window_size.
      */
-    arrfunc rolling(const arrfunc &window_op, intptr_t window_size);
+    arrfunc rolling(const arrfunc &window_op, intptr_t window_size,
+                    intptr_t min_periods = -1);
 
   } // namespace dynd::nd::functional
 } // namespace dynd::nd
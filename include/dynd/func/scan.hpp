@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Create an arrfunc which computes the inclusive scan of a binary
+     * operation along one dimension of its argument, the one selected by
+     * the ``axis`` keyword (0 by default, negative values count from the
+     * innermost dimension). Element ``i`` of the result is
+     * ``op(...op(op(a[0], a[1]), a[2])..., a[i])``, and the other
+     * dimensions are kept as they are, fixed or var.
+     *
+     * \param op  An arrfunc ``(T, T) -> T``. If ``T`` has fewer dimensions
+     *            than the elements along the scanned dimension, it is
+     *            applied elementwise to them.
+     * \param associative  If true, a large enough fixed dimension is
+     *                     scanned in parallel when the eval_context asks for
+     *                     more than one thread, reducing chunks of it, then
+     *                     scanning each chunk from the combined results of
+     *                     the chunks before it.
+     */
+    arrfunc scan(const arrfunc &op, bool associative = false);
+
+  } // namespace dynd::nd::functional
+
+  /**
+   * Cumulative sum along a dimension, ``(Dims... * T, axis: ?int32) ->
+   * Dims... * T`` for the builtin integer, real and complex types. The
+   * result has the type of the input.
+   */
+  extern struct cumsum : declfunc<cumsum> {
+    static arrfunc make();
+  } cumsum;
+
+  /** Cumulative product along a dimension, like cumsum */
+  extern struct cumprod : declfunc<cumprod> {
+    static arrfunc make();
+  } cumprod;
+
+  /**
+   * Cumulative minimum along a dimension, like cumsum but not for complex
+   * types. A NaN propagates to the rest of the scan.
+   */
+  extern struct cummin : declfunc<cummin> {
+    static arrfunc make();
+  } cummin;
+
+  /** Cumulative maximum along a dimension, like cummin */
+  extern struct cummax : declfunc<cummax> {
+    static arrfunc make();
+  } cummax;
+
+} // namespace dynd::nd
+} // namespace dynd
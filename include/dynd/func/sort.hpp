@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Sorts an array along one dimension, the one selected by the ``axis``
+   * keyword (-1, the innermost dimension, by default; negative values
+   * count from the innermost dimension). ``(Dims... * T, axis: ?int32,
+   * stable: ?bool) -> Dims... * T``. Every line along the sorted dimension
+   * is sorted independently, so the dimensions after it have to be fixed.
+   *
+   * The builtin integer, real, bool, date, time and datetime types are
+   * sorted with an LSD radix sort, which is stable, and places NaN and NA
+   * values last. Any other type is sorted with the
+   * ``comparison_type_sorting_less`` comparison kernel of its elements,
+   * as a merge sort spread over the threads of the eval_context. That sort
+   * is only stable if the ``stable`` keyword is true.
+   */
+  extern struct sort : declfunc<sort> {
+    static arrfunc make();
+  } sort;
+
+  /**
+   * The indices which sort an array along one dimension, like sort.
+   * ``(Dims... * T, axis: ?int32, stable: ?bool) -> Dims... * int64``
+   */
+  extern struct argsort : declfunc<argsort> {
+    static arrfunc make();
+  } argsort;
+
+} // namespace dynd::nd
+} // namespace dynd
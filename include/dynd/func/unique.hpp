@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * The distinct values of a one dimensional array, in the order they
+   * first appear, or sorted by the ``comparison_type_sorting_less``
+   * comparison kernel of the elements if the ``sorted`` keyword is true.
+   * ``(Fixed * T, sorted: ?bool) -> var * T``
+   *
+   * The values are found with a hash index of their encodings, so the
+   * element type can be any type a key_encoder supports, such as the
+   * builtin types, strings and fixed strings. All NaNs are one value, as
+   * are zero and negative zero.
+   */
+  extern struct unique : declfunc<unique> {
+    static arrfunc make();
+  } unique;
+
+  /**
+   * The distinct values of a one dimensional array, like unique, and the
+   * number of times each appears.
+   * ``(Fixed * T, sorted: ?bool) -> {values: var * T, counts: var * int64}``
+   */
+  extern struct value_counts : declfunc<value_counts> {
+    static arrfunc make();
+  } value_counts;
+
+  namespace functional {
+
+    /**
+     * Makes a unique arrfunc which also returns the inverse indices, the
+     * index in ``values`` of each element of the argument, and/or the
+     * counts of the values.
+     * ``(Fixed * T, sorted: ?bool) -> {values: var * T,
+     *                                  inverse: Fixed * int64,
+     *                                  counts: var * int64}``,
+     * with only the fields which were asked for.
+     */
+    arrfunc unique(bool return_inverse, bool return_counts);
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
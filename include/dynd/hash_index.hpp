@@ -0,0 +1,313 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <dynd/type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+namespace dynd {
+
+/** The finalizer of MurmurHash3, spreading every bit over the others */
+inline uint64_t hash_mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/** A 64-bit hash of a sequence of bytes */
+inline uint64_t hash_bytes(const char *data, size_t size)
+{
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t w;
+    memcpy(&w, data, 8);
+    h = (h ^ hash_mix(w)) * 0x9e3779b97f4a7c15ULL;
+  }
+  if (size > 0) {
+    uint64_t w = 0;
+    memcpy(&w, data, size);
+    h = (h ^ hash_mix(w)) * 0x9e3779b97f4a7c15ULL;
+  }
+  return hash_mix(h);
+}
+
+inline uint64_t hash_bytes(const std::vector<char> &key)
+{
+  return hash_bytes(key.empty() ? NULL : &key[0], key.size());
+}
+
+/**
+ * Encodes values of a type as bytes, so two values are equal if and only
+ * if their encodings are. Reals are normalized, so all NaNs are equal and
+ * negative zero is equal to zero, and strings are prefixed with their
+ * size. An option real is NA if it is any NaN, so all its NaNs are
+ * encoded as the NA bit pattern. Supports the builtin types, dates, times,
+ * datetimes, fixed and variable sized strings and bytes, options of
+ * builtin types, and tuples or structs of these.
+ */
+class key_encoder {
+  /** A scalar within a value */
+  struct leaf {
+    enum kind_t {
+      raw,
+      real32,
+      real64,
+      option_real32,
+      option_real64,
+      string
+    } kind;
+    intptr_t offset;
+    size_t size;
+  };
+
+  std::vector<leaf> m_leaves;
+
+  void add_leaves(const ndt::type &tp, const char *arrmeta, intptr_t offset);
+
+  template <class T>
+  static void append(std::vector<char> &buf, T value)
+  {
+    const char *p = reinterpret_cast<const char *>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+  }
+
+  template <class T>
+  static T normalize_real(T v)
+  {
+    if (v != v) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    return v == 0 ? 0 : v;
+  }
+
+  /**
+   * Appends an option real, whose NaNs are all NA (see is_avail), so they
+   * are encoded as the NA bit pattern
+   */
+  template <class T, class U>
+  static void append_option_real(std::vector<char> &buf, const char *p,
+                                 U na_bits)
+  {
+    T v = *reinterpret_cast<const T *>(p);
+    if (v != v) {
+      append(buf, na_bits);
+    } else {
+      append(buf, normalize_real(v));
+    }
+  }
+
+  template <class T>
+  static uint64_t to_word(T value)
+  {
+    uint64_t w = 0;
+    memcpy(&w, &value, sizeof(T));
+    return w;
+  }
+
+public:
+  key_encoder() {}
+
+  /**
+   * An encoder of values with the type and arrmeta, throwing a type_error
+   * if the type isn't supported
+   */
+  key_encoder(const ndt::type &tp, const char *arrmeta);
+
+  /** Whether values of the type can be encoded */
+  static bool is_supported(const ndt::type &tp);
+
+  /**
+   * Whether every value is encoded as one scalar of at most 8 bytes, as for
+   * the builtin types, so encode_word can be used instead of encode
+   */
+  bool is_word() const
+  {
+    return m_leaves.size() == 1 && m_leaves[0].kind != leaf::string &&
+           m_leaves[0].size <= 8;
+  }
+
+  /** The size of the encoding, when is_word is true */
+  size_t get_word_size() const { return m_leaves[0].size; }
+
+  /**
+   * The encoding of the value at ``data`` in the first get_word_size()
+   * bytes of a word, with the rest zero, when is_word is true
+   */
+  uint64_t encode_word(const char *data) const
+  {
+    const leaf &l = m_leaves[0];
+    const char *p = data + l.offset;
+    switch (l.kind) {
+    case leaf::real32:
+      return to_word(normalize_real(*reinterpret_cast<const float *>(p)));
+    case leaf::real64:
+      return to_word(normalize_real(*reinterpret_cast<const double *>(p)));
+    case leaf::option_real32: {
+      float v = *reinterpret_cast<const float *>(p);
+      return v != v ? to_word<uint32_t>(DYND_FLOAT32_NA_AS_UINT)
+                    : to_word(normalize_real(v));
+    }
+    case leaf::option_real64: {
+      double v = *reinterpret_cast<const double *>(p);
+      return v != v ? to_word<uint64_t>(DYND_FLOAT64_NA_AS_UINT)
+                    : to_word(normalize_real(v));
+    }
+    default: {
+      uint64_t w = 0;
+      memcpy(&w, p, l.size);
+      return w;
+    }
+    }
+  }
+
+  /** Appends the encoding of the value at ``data`` to ``buf`` */
+  void encode(const char *data, std::vector<char> &buf) const
+  {
+    for (size_t i = 0; i < m_leaves.size(); ++i) {
+      const leaf &l = m_leaves[i];
+      const char *p = data + l.offset;
+      switch (l.kind) {
+      case leaf::raw:
+        buf.insert(buf.end(), p, p + l.size);
+        break;
+      case leaf::real32:
+        append(buf, normalize_real(*reinterpret_cast<const float *>(p)));
+        break;
+      case leaf::real64:
+        append(buf, normalize_real(*reinterpret_cast<const double *>(p)));
+        break;
+      case leaf::option_real32:
+        append_option_real<float, uint32_t>(buf, p, DYND_FLOAT32_NA_AS_UINT);
+        break;
+      case leaf::option_real64:
+        append_option_real<double, uint64_t>(buf, p, DYND_FLOAT64_NA_AS_UINT);
+        break;
+      case leaf::string: {
+        const string_type_data *s =
+            reinterpret_cast<const string_type_data *>(p);
+        append(buf, static_cast<size_t>(s->end - s->begin));
+        buf.insert(buf.end(), s->begin, s->end);
+        break;
+      }
+      }
+    }
+  }
+};
+
+/**
+ * An open addressing hash table with linear probing, which gives the
+ * encoded keys inserted into it the consecutive ids 0, 1, 2, ..., and keeps
+ * a copy of them.
+ */
+class hash_index {
+  // The id of the key in each slot, or -1, the number of slots a power of
+  // two at least twice the number of keys
+  std::vector<intptr_t> m_slots;
+  std::vector<uint64_t> m_hashes;
+  // The key with id i is [m_key_offsets[i], m_key_offsets[i + 1])
+  std::vector<char> m_key_data;
+  std::vector<size_t> m_key_offsets;
+
+  void grow();
+
+  bool key_equal(intptr_t id, const char *key, size_t size,
+                 uint64_t hash) const
+  {
+    return m_hashes[id] == hash &&
+           m_key_offsets[id + 1] - m_key_offsets[id] == size &&
+           (size == 0 ||
+            memcmp(&m_key_data[m_key_offsets[id]], key, size) == 0);
+  }
+
+public:
+  hash_index() : m_slots(16, -1), m_key_offsets(1, 0) {}
+
+  /** The number of keys */
+  intptr_t size() const { return m_hashes.size(); }
+
+  /** The hash of the key with the id */
+  uint64_t get_hash(intptr_t id) const { return m_hashes[id]; }
+
+  /** The bytes of the key with the id */
+  const char *get_key(intptr_t id) const
+  {
+    return m_key_data.empty() ? NULL : &m_key_data[m_key_offsets[id]];
+  }
+
+  size_t get_key_size(intptr_t id) const
+  {
+    return m_key_offsets[id + 1] - m_key_offsets[id];
+  }
+
+  /** Makes room for ``n`` keys without growing the table */
+  void reserve(intptr_t n);
+
+  /** The id of the key with the hash, or -1 if it isn't in the index */
+  intptr_t find(const char *key, size_t size, uint64_t hash) const
+  {
+    size_t mask = m_slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      intptr_t id = m_slots[slot];
+      if (id < 0 || key_equal(id, key, size, hash)) {
+        return id;
+      }
+    }
+  }
+
+  intptr_t find(const std::vector<char> &key) const
+  {
+    return find(key.empty() ? NULL : &key[0], key.size(), hash_bytes(key));
+  }
+
+  /**
+   * The id of the key with the hash, which is added with the next id if it
+   * isn't in the index yet, setting ``inserted`` to whether it was added
+   */
+  intptr_t insert(const char *key, size_t size, uint64_t hash,
+                  bool &inserted)
+  {
+    size_t mask = m_slots.size() - 1;
+    size_t slot = hash & mask;
+    for (;; slot = (slot + 1) & mask) {
+      intptr_t id = m_slots[slot];
+      if (id < 0) {
+        break;
+      }
+      if (key_equal(id, key, size, hash)) {
+        inserted = false;
+        return id;
+      }
+    }
+
+    intptr_t id = m_hashes.size();
+    m_slots[slot] = id;
+    m_hashes.push_back(hash);
+    m_key_data.insert(m_key_data.end(), key, key + size);
+    m_key_offsets.push_back(m_key_data.size());
+    if (static_cast<size_t>(2 * (id + 1)) > m_slots.size()) {
+      grow();
+    }
+    inserted = true;
+    return id;
+  }
+
+  intptr_t insert(const std::vector<char> &key, bool &inserted)
+  {
+    return insert(key.empty() ? NULL : &key[0], key.size(), hash_bytes(key),
+                  inserted);
+  }
+};
+
+} // namespace dynd
@@ -2,6 +2,7 @@
 
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/multidispatch_by_type_id.hpp>
+#include <dynd/kernels/simd_arithmetic.hpp>
 
 namespace dynd {
 namespace nd {
@@ -84,6 +85,28 @@ namespace nd {
           *reinterpret_cast<A0 *>(src[0]) + *reinterpret_cast<A1 *>(src[1]);
     }
 
+    DYND_CUDA_HOST_DEVICE void strided(char *dst, intptr_t dst_stride,
+                                       char *const *src,
+                                       const intptr_t *src_stride,
+                                       size_t count)
+    {
+#ifndef __CUDA_ARCH__
+      if (kernels::simd_binary<kernels::arithmetic_op_add, R, A0, A1>::run(
+              dst, dst_stride, src, src_stride, count)) {
+        return;
+      }
+#endif
+      char *src0 = src[0], *src1 = src[1];
+      intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<R *>(dst) =
+            *reinterpret_cast<A0 *>(src0) + *reinterpret_cast<A1 *>(src1);
+        dst += dst_stride;
+        src0 += src0_stride;
+        src1 += src1_stride;
+      }
+    }
+
     static void resolve_dst_type(
         const arrfunc_type_data *DYND_UNUSED(self),
         const ndt::arrfunc_type *DYND_UNUSED(self_tp), char *DYND_UNUSED(data),
@@ -120,6 +143,28 @@ namespace nd {
           *reinterpret_cast<A0 *>(src[0]) - *reinterpret_cast<A1 *>(src[1]);
     }
 
+    DYND_CUDA_HOST_DEVICE void strided(char *dst, intptr_t dst_stride,
+                                       char *const *src,
+                                       const intptr_t *src_stride,
+                                       size_t count)
+    {
+#ifndef __CUDA_ARCH__
+      if (kernels::simd_binary<kernels::arithmetic_op_subtract, R, A0, A1>::run(
+              dst, dst_stride, src, src_stride, count)) {
+        return;
+      }
+#endif
+      char *src0 = src[0], *src1 = src[1];
+      intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<R *>(dst) =
+            *reinterpret_cast<A0 *>(src0) - *reinterpret_cast<A1 *>(src1);
+        dst += dst_stride;
+        src0 += src0_stride;
+        src1 += src1_stride;
+      }
+    }
+
     static ndt::type make_type()
     {
       std::map<string, ndt::type> tp_vars;
@@ -156,6 +201,28 @@ namespace nd {
           *reinterpret_cast<A0 *>(src[0]) * *reinterpret_cast<A1 *>(src[1]);
     }
 
+    DYND_CUDA_HOST_DEVICE void strided(char *dst, intptr_t dst_stride,
+                                       char *const *src,
+                                       const intptr_t *src_stride,
+                                       size_t count)
+    {
+#ifndef __CUDA_ARCH__
+      if (kernels::simd_binary<kernels::arithmetic_op_multiply, R, A0, A1>::run(
+              dst, dst_stride, src, src_stride, count)) {
+        return;
+      }
+#endif
+      char *src0 = src[0], *src1 = src[1];
+      intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<R *>(dst) =
+            *reinterpret_cast<A0 *>(src0) * *reinterpret_cast<A1 *>(src1);
+        dst += dst_stride;
+        src0 += src0_stride;
+        src1 += src1_stride;
+      }
+    }
+
     static ndt::type make_type()
     {
       std::map<string, ndt::type> tp_vars;
@@ -192,6 +259,28 @@ namespace nd {
           *reinterpret_cast<A0 *>(src[0]) / *reinterpret_cast<A1 *>(src[1]);
     }
 
+    DYND_CUDA_HOST_DEVICE void strided(char *dst, intptr_t dst_stride,
+                                       char *const *src,
+                                       const intptr_t *src_stride,
+                                       size_t count)
+    {
+#ifndef __CUDA_ARCH__
+      if (kernels::simd_binary<kernels::arithmetic_op_divide, R, A0, A1>::run(
+              dst, dst_stride, src, src_stride, count)) {
+        return;
+      }
+#endif
+      char *src0 = src[0], *src1 = src[1];
+      intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<R *>(dst) =
+            *reinterpret_cast<A0 *>(src0) / *reinterpret_cast<A1 *>(src1);
+        dst += dst_stride;
+        src0 += src0_stride;
+        src1 += src1_stride;
+      }
+    }
+
     static ndt::type make_type()
     {
       std::map<string, ndt::type> tp_vars;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <typeinfo>
+
 #include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/types/arrfunc_type.hpp>
 
@@ -90,8 +92,10 @@ namespace nd {
       ckb->reserve(inout_ckb_offset);                                          \
       ckernel_prefix *rawself =                                                \
           ckb->template get_at<ckernel_prefix>(ckb_offset);                    \
-      return ckb->template init<self_type>(rawself, kernreq,                   \
-                                           std::forward<A>(args)...);          \
+      self_type *self = ckb->template init<self_type>(                         \
+          rawself, kernreq, std::forward<A>(args)...);                         \
+      ckb->record_ckernel(ckb_offset, kernreq, typeid(self_type).name());      \
+      return self;                                                             \
     }                                                                          \
                                                                                \
     template <typename... A>                                                   \
@@ -5,7 +5,8 @@
 
 #pragma once
 
-#include <dynd/arrmeta_holder.hpp>
+#include <algorithm>
+
 #include <dynd/buffer_storage.hpp>
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/kernels/base_kernel.hpp>
@@ -15,8 +16,9 @@ namespace nd {
   namespace functional {
 
     /**
-     * A kernel for chaining two other kernels, using temporary buffers
-     * dynamically allocated on the heap.
+     * A kernel for chaining two other kernels, using a temporary buffer of
+     * DYND_BUFFER_CHUNK_SIZE elements allocated when the kernel is
+     * instantiated.
      */
     struct chain_kernel : base_kernel<chain_kernel, kernel_request_host, 1> {
       struct static_data {
@@ -32,22 +34,13 @@ namespace nd {
       };
 
       intptr_t second_offset; // The offset to the second child kernel
-      ndt::type buffer_tp;
-      arrmeta_holder buffer_arrmeta;
-      std::vector<intptr_t> buffer_shape;
+      buffer_storage buffer;
 
-      chain_kernel(const ndt::type &buffer_tp) : buffer_tp(buffer_tp)
-      {
-        arrmeta_holder(this->buffer_tp).swap(buffer_arrmeta);
-        buffer_arrmeta.arrmeta_default_construct(true);
-        buffer_shape.push_back(DYND_BUFFER_CHUNK_SIZE);
-      }
+      chain_kernel(const ndt::type &buffer_tp) : buffer(buffer_tp) {}
 
       void single(char *dst, char *const *src)
       {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_tp);
-        char *buffer_data = buffer.get_readwrite_originptr();
+        char *buffer_data = buffer.get_storage();
 
         ckernel_prefix *first = get_child_ckernel();
         expr_single_t first_func = first->get_function<expr_single_t>();
@@ -55,6 +48,7 @@ namespace nd {
         ckernel_prefix *second = get_child_ckernel(second_offset);
         expr_single_t second_func = second->get_function<expr_single_t>();
 
+        buffer.reset_arrmeta();
         first_func(buffer_data, src, first);
         second_func(dst, &buffer_data, second);
       }
@@ -62,12 +56,9 @@ namespace nd {
       void strided(char *dst, intptr_t dst_stride, char *const *src,
                    const intptr_t *src_stride, size_t count)
       {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_shape[0], buffer_tp);
-        char *buffer_data = buffer.get_readwrite_originptr();
-        intptr_t buffer_stride =
-            reinterpret_cast<const fixed_dim_type_arrmeta *>(
-                buffer.get_arrmeta())->stride;
+        char *buffer_data = buffer.get_storage();
+        intptr_t buffer_stride = buffer.get_stride();
+        size_t chunk_size = buffer.get_chunk_size();
 
         ckernel_prefix *first = get_child_ckernel();
         expr_strided_t first_func = first->get_function<expr_strided_t>();
@@ -78,24 +69,18 @@ namespace nd {
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
 
-        size_t chunk_size =
-            std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
-        first_func(buffer_data, buffer_stride, &src0, src_stride, chunk_size,
-                   first);
-        second_func(dst, dst_stride, &buffer_data, &buffer_stride, chunk_size,
-                    second);
-        count -= chunk_size;
-        while (count) {
-          src0 += chunk_size * src0_stride;
-          dst += chunk_size * dst_stride;
-          reset_strided_buffer_array(buffer);
-          chunk_size =
-              std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
-          first_func(buffer_data, buffer_stride, &src0, src_stride, chunk_size,
+        while (count > 0) {
+          size_t chunk = std::min(count, chunk_size);
+          // Releases the memory any blockref values of the previous chunk
+          // were using
+          buffer.reset_arrmeta();
+          first_func(buffer_data, buffer_stride, &src0, src_stride, chunk,
                      first);
-          second_func(dst, dst_stride, &buffer_data, &buffer_stride, chunk_size,
+          second_func(dst, dst_stride, &buffer_data, &buffer_stride, chunk,
                       second);
-          count -= chunk_size;
+          src0 += chunk * src0_stride;
+          dst += chunk * dst_stride;
+          count -= chunk;
         }
       }
 
@@ -92,6 +92,8 @@ public:
       if (requested_capacity < grown_capacity) {
         requested_capacity = grown_capacity;
       }
+      requested_capacity =
+          reinterpret_cast<CKBT *>(this)->round_capacity(requested_capacity);
       // Do a realloc
       char *new_data =
           reinterpret_cast<char *>(reinterpret_cast<CKBT *>(this)->realloc(
@@ -150,6 +152,47 @@ public:
   intptr_t get_capacity() const { return m_capacity; }
 };
 
+class ckernel_profile;
+
+namespace detail {
+
+/**
+ * Adds a ckernel which was just constructed at ``ckb_offset`` to the
+ * profile being recorded for its ckernel_builder. See ckernel_profile.hpp.
+ */
+void record_ckernel(ckernel_profile *profile, intptr_t ckb_offset,
+                    kernel_request_t kernreq, const char *name);
+
+/**
+ * Rounds a ckernel_builder capacity up to the size of the pooled buffer that
+ * will hold it. When ``first_spill`` is true, the builder is leaving its
+ * inline storage, and the capacity is also raised to what recent builders on
+ * this thread needed, so typical kernels only spill once.
+ */
+intptr_t ckernel_buffer_round_capacity(intptr_t capacity, bool first_spill);
+
+/**
+ * Allocates, reallocates and frees ckernel_builder buffers from a
+ * thread-local pool. The capacities must come from
+ * ckernel_buffer_round_capacity, and a buffer may be freed on a different
+ * thread than the one which allocated it. Compilers without thread_local
+ * objects (DYND_THREAD_LOCAL_POD_ONLY) have no pool, and use the heap.
+ */
+void *ckernel_buffer_alloc(intptr_t capacity);
+void *ckernel_buffer_realloc(void *ptr, intptr_t old_capacity,
+                             intptr_t new_capacity);
+void ckernel_buffer_free(void *ptr, intptr_t capacity);
+
+} // namespace detail
+
+/**
+ * Returns how many times ckernel_builder buffers have been allocated from the
+ * heap, across all threads, because the thread-local pool had no buffer
+ * of the needed size. Repeatedly instantiating the same ckernels should
+ * leave this unchanged once the pool is warm.
+ */
+intptr_t get_ckernel_builder_heap_allocation_count();
+
 template <kernel_request_t kernreq>
 class ckernel_builder;
 
@@ -159,6 +202,8 @@ class ckernel_builder<kernel_request_host>
   // When the amount of data is small, this static data is used,
   // otherwise dynamic memory is allocated when it gets too big
   char m_static_data[16 * 8];
+  // When non-NULL, the ckernels constructed are recorded for profiling
+  ckernel_profile *m_profile;
 
   bool using_static_data() const { return m_data == &m_static_data[0]; }
 
@@ -168,6 +213,19 @@ public:
     m_data = &m_static_data[0];
     m_capacity = sizeof(m_static_data);
     set(m_static_data, 0, sizeof(m_static_data));
+    m_profile = NULL;
+  }
+
+  ckernel_profile *get_profile() const { return m_profile; }
+
+  void set_profile(ckernel_profile *profile) { m_profile = profile; }
+
+  void record_ckernel(intptr_t ckb_offset, kernel_request_t kernreq,
+                      const char *name)
+  {
+    if (m_profile != NULL) {
+      detail::record_ckernel(m_profile, ckb_offset, kernreq, name);
+    }
   }
 
   template <typename self_type, typename... A>
@@ -184,12 +242,18 @@ public:
 
   void destroy(ckernel_prefix *self) { self->destroy(); }
 
-  void *alloc(size_t size) { return std::malloc(size); }
+  intptr_t round_capacity(intptr_t capacity) const
+  {
+    return detail::ckernel_buffer_round_capacity(capacity,
+                                                 using_static_data());
+  }
+
+  void *alloc(size_t size) { return detail::ckernel_buffer_alloc(size); }
 
   void *realloc(void *ptr, size_t old_size, size_t new_size)
   {
     if (using_static_data()) {
-      // If we were previously using the static data, do a malloc
+      // If we were previously using the static data, get a pooled buffer
       void *new_data = alloc(new_size);
       // If the allocation succeeded, copy the old data as the realloc would
       if (new_data != NULL) {
@@ -197,14 +261,15 @@ public:
       }
       return new_data;
     } else {
-      return std::realloc(ptr, new_size);
+      return detail::ckernel_buffer_realloc(ptr, old_size, new_size);
     }
   }
 
   void free(void *ptr)
   {
+    // The buffer is always m_data, whose size class follows from m_capacity
     if (!using_static_data()) {
-      std::free(ptr);
+      detail::ckernel_buffer_free(ptr, m_capacity);
     }
   }
 
@@ -220,6 +285,7 @@ public:
 
   void swap(ckernel_builder<kernel_request_host> &rhs)
   {
+    (std::swap)(m_profile, rhs.m_profile);
     if (using_static_data()) {
       if (rhs.using_static_data()) {
         char tmp_static_data[sizeof(m_static_data)];
@@ -325,6 +391,14 @@ public:
     m_capacity = 16 * 8;
   }
 
+  intptr_t round_capacity(intptr_t capacity) const { return capacity; }
+
+  void record_ckernel(intptr_t DYND_UNUSED(ckb_offset),
+                      kernel_request_t DYND_UNUSED(kernreq),
+                      const char *DYND_UNUSED(name))
+  {
+  }
+
   void *alloc(size_t size) { return allocator.allocate(size); }
 
   void *realloc(void *old_ptr, size_t old_size, size_t new_size)
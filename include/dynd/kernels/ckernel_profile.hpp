@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <dynd/kernels/ckernel_builder.hpp>
+
+namespace dynd {
+
+/**
+ * Instruments the ckernels instantiated into one ckernel_builder, so that
+ * every call to them is counted and timed. This is enabled for the ckernels
+ * nd::arrfunc::call instantiates by setting ``profile_kernels`` in the
+ * eval_context, or by setting the DYND_PROFILE_KERNELS environment variable
+ * to a value other than "0" before the process starts, in which case the
+ * profiles are also printed to stderr when the process exits.
+ *
+ * Only ckernels created with nd::base_kernel::make are instrumented. For each
+ * one, the number of calls, the number of elements processed (one per single
+ * call, ``count`` per strided call), and the wall clock time spent inside it,
+ * including its children, are recorded. A ckernel's parent in the report is
+ * the ckernel which was running on the same thread the first time it was
+ * called, so children executed on worker threads by a parallel elwise show
+ * up at the top level.
+ *
+ * Usage:
+ *
+ *     ckernel_builder<kernel_request_host> ckb;
+ *     ckernel_profile_scope profile(&ckb, true);
+ *     af.get()->instantiate(..., &ckb, 0, ...);
+ *     profile.instrument("my call");
+ *     // ... call the ckernel ...
+ *     print_ckernel_profiles(std::cout);
+ */
+class ckernel_profile_scope {
+  std::shared_ptr<ckernel_profile> m_profile;
+  ckernel_builder<kernel_request_host> *m_ckb;
+
+public:
+  /**
+   * Starts recording the ckernels constructed in ``ckb`` if ``enabled`` is
+   * true, otherwise does nothing. The scope must be destroyed before the
+   * ckernel_builder is.
+   */
+  ckernel_profile_scope(ckernel_builder<kernel_request_host> *ckb,
+                        bool enabled);
+
+  ckernel_profile_scope(const ckernel_profile_scope &) = delete;
+
+  ~ckernel_profile_scope();
+
+  ckernel_profile_scope &operator=(const ckernel_profile_scope &) = delete;
+
+  bool is_enabled() const { return m_profile.get() != NULL; }
+
+  /**
+   * Called once the ckernel has been instantiated, to stop recording and
+   * substitute the profiling wrappers for the recorded kernel functions.
+   * The profile is added to the ones print_ckernel_profiles reports, under
+   * the given label.
+   */
+  void instrument(const std::string &label);
+};
+
+/**
+ * Prints the kernel tree of every instrumented ckernel, with the calls,
+ * elements and time of each node, similar to a database's EXPLAIN ANALYZE.
+ * The self time of a node is its time minus the time of its children.
+ * Only the 1024 most recently instrumented profiles are kept, so a long
+ * running process profiling every call doesn't grow without bound.
+ */
+void print_ckernel_profiles(std::ostream &o);
+
+/**
+ * Discards the profiles collected so far.
+ */
+void clear_ckernel_profiles();
+
+namespace detail {
+  /**
+   * Whether the DYND_PROFILE_KERNELS environment variable turns profiling
+   * on. It does unless it is unset, empty or "0".
+   */
+  bool profile_kernels_from_env();
+} // namespace dynd::detail
+
+} // namespace dynd
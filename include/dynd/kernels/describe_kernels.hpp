@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd { namespace kernels {
+
+/**
+ * The accumulator of the describe reduction, from which all the describe
+ * statistics are computed, so they take one pass over the data. Two of
+ * them can be merged, like moments_state. Its dynd type is
+ * ``{count: int64, na_count: int64, sum: float64, min: float64,
+ * max: float64}``.
+ */
+struct describe_state {
+  int64_t count, na_count;
+  double sum, min, max;
+};
+
+/** Flags selecting the fields of the describe statistics struct */
+enum describe_statistic_t {
+  /** The number of values which aren't NA, int64 */
+  describe_count = 0x01,
+  /** The number of NA values, int64 */
+  describe_na_count = 0x02,
+  /** The sum of the values which aren't NA, float64 */
+  describe_sum = 0x04,
+  /** The mean of the values which aren't NA, float64 */
+  describe_mean = 0x08,
+  /** The minimum of the values which aren't NA, float64 */
+  describe_min = 0x10,
+  /** The maximum of the values which aren't NA, float64 */
+  describe_max = 0x20,
+  describe_all = 0x3f
+};
+
+/** The dynd type of describe_state */
+ndt::type make_describe_state_type();
+
+/**
+ * The struct type of the statistics selected by ``stats``, an or of
+ * describe_statistic_t flags, with the fields in the order of the flags.
+ */
+ndt::type make_describe_statistics_type(int stats);
+
+/**
+ * Makes a unary reduction arrfunc accumulating values into a
+ * describe_state, for lift_reduction_arrfunc. ``src_tp`` is a builtin real
+ * numeric type, or an option of a signed integer or real type. NaN counts
+ * as NA, for the option types as well as for the plain real types.
+ * (<src_tp>) -> <describe state type>
+ */
+nd::arrfunc make_builtin_describe_reduction_arrfunc(const ndt::type &src_tp);
+
+/**
+ * Makes a unary reduction arrfunc merging one describe_state into another,
+ * the ``combine`` of lift_reduction_arrfunc.
+ * (<describe state type>) -> <describe state type>
+ */
+nd::arrfunc make_describe_combine_arrfunc();
+
+/**
+ * Lifts the describe reduction like lift_reduction_arrfunc does, with the
+ * identity and combine arrfunc filled in, so it reduces any subset of the
+ * dimensions in one pass, in parallel if the eval_context asks for it.
+ */
+nd::arrfunc lift_builtin_describe_reduction_arrfunc(
+    const ndt::type &src_tp, const ndt::type &lifted_arr_type, bool keepdims,
+    intptr_t reduction_ndim, const bool *reduction_dimflags);
+
+/**
+ * Makes an arrfunc computing the statistics selected by ``stats`` from a
+ * describe_state. The mean, min and max of no values are NaN.
+ * (<describe state type>) -> <describe statistics type>
+ */
+nd::arrfunc make_describe_statistics_arrfunc(int stats);
+
+/**
+ * Makes an arrfunc computing the statistics selected by ``stats`` over the
+ * dimensions selected by ``reduction_dimflags``, in one pass over the
+ * data. The other dimensions are kept, and the reduced ones are dropped,
+ * or kept with size 1 if ``keepdims`` is true.
+ * (<lifted_arr_type>) -> <kept dims> * <describe statistics type>
+ */
+nd::arrfunc make_builtin_describe_arrfunc(int stats, const ndt::type &src_tp,
+                                          const ndt::type &lifted_arr_type,
+                                          bool keepdims,
+                                          intptr_t reduction_ndim,
+                                          const bool *reduction_dimflags);
+
+/**
+ * Makes a 1D describe arrfunc.
+ * (Fixed * <src_tp>) -> <describe statistics type>
+ */
+nd::arrfunc make_builtin_describe1d_arrfunc(int stats,
+                                            const ndt::type &src_tp);
+
+}} // namespace dynd::kernels
@@ -7,6 +7,7 @@
 
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/base_virtual_kernel.hpp>
+#include <dynd/thread_pool.hpp>
 #include <dynd/types/ellipsis_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/dim_fragment_type.hpp>
@@ -284,6 +285,205 @@ namespace nd {
       }
     };
 
+    /**
+     * Expr kernel for the outermost strided dimension of an elwise
+     * arrfunc which splits the dimension into contiguous chunks and
+     * executes them on the thread pool. Each chunk has its own copy
+     * of the child ckernel, so children with mutable state (buffers,
+     * etc) are never shared between threads.
+     *
+     * This is only used when the eval_context requests more than one
+     * thread, for a top-level (kernel_request_single) call.
+     */
+    template <int N>
+    struct parallel_elwise_ck
+        : base_kernel<parallel_elwise_ck<N>, kernel_request_host, N> {
+      typedef parallel_elwise_ck self_type;
+
+      intptr_t m_nthreads;
+      intptr_t m_dst_stride, m_src_stride[N];
+      std::vector<intptr_t> m_chunk_begin;
+      std::vector<intptr_t> m_child_offsets;
+
+      parallel_elwise_ck(intptr_t nthreads, intptr_t dst_stride,
+                         const intptr_t *src_stride)
+          : m_nthreads(nthreads), m_dst_stride(dst_stride)
+      {
+        memcpy(m_src_stride, src_stride, sizeof(m_src_stride));
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        thread_pool::get().run(
+            m_nthreads, m_child_offsets.size(), [&](intptr_t i) {
+              ckernel_prefix *child =
+                  this->get_child_ckernel(m_child_offsets[i]);
+              expr_strided_t opchild = child->get_function<expr_strided_t>();
+
+              intptr_t begin = m_chunk_begin[i];
+              char *src_chunk[N];
+              for (int j = 0; j != N; ++j) {
+                src_chunk[j] = src[j] + begin * m_src_stride[j];
+              }
+              opchild(dst + begin * m_dst_stride, m_dst_stride, src_chunk,
+                      m_src_stride, m_chunk_begin[i + 1] - begin, child);
+            });
+      }
+
+      void destruct_children()
+      {
+        for (size_t i = 0; i < m_child_offsets.size(); ++i) {
+          this->destroy_child_ckernel(m_child_offsets[i]);
+        }
+      }
+
+      /**
+       * Returns true if a kernel for the outermost dimension of the given
+       * size should be executed in parallel.
+       */
+      static bool use_parallel(kernel_request_t kernreq,
+                               const eval::eval_context *ectx, intptr_t size,
+                               const ndt::type &dst_tp)
+      {
+        // Only top-level host calls are split, and outputs which
+        // allocate into a shared memory block must stay serial
+        return kernreq == kernel_request_single && ectx != NULL &&
+               ectx->nthreads > 1 && size >= 2 * ectx->parallel_grain_size &&
+               !(dst_tp.get_flags() & type_flag_blockref);
+      }
+
+      /**
+       * Creates the parallel kernel, and instantiates one copy of the child
+       * kernel per chunk. If ``finished`` is false, the child is the next
+       * lifted elwise dimension, otherwise it is the elementwise arrfunc.
+       */
+      static intptr_t
+      instantiate(const arrfunc_type_data *self,
+                  const ndt::arrfunc_type *self_tp, char *data, void *ckb,
+                  intptr_t ckb_offset, intptr_t size, intptr_t dst_stride,
+                  const intptr_t *src_stride, const ndt::type &child_dst_tp,
+                  const char *child_dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *child_src_tp,
+                  const char *const *child_src_arrmeta, bool finished,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const nd::array &kwds,
+                  const std::map<dynd::nd::string, ndt::type> &tp_vars)
+      {
+        const arrfunc_type_data *child =
+            self->get_data_as<dynd::nd::arrfunc>()->get();
+        const ndt::arrfunc_type *child_tp =
+            self->get_data_as<dynd::nd::arrfunc>()->get_type();
+
+        intptr_t root_ckb_offset = ckb_offset;
+        self_type *self_ck = self_type::make(ckb, kernreq, ckb_offset,
+                                             ectx->nthreads, dst_stride,
+                                             src_stride);
+        intptr_t nchunks =
+            partition_range(ectx->nthreads, size, ectx->parallel_grain_size,
+                            self_ck->m_chunk_begin);
+        self_ck->m_child_offsets.resize(nchunks);
+
+        kernreq = (kernreq & kernel_request_memory) | kernel_request_strided;
+        for (intptr_t i = 0; i < nchunks; ++i) {
+          self_ck = self_type::get_self(
+              reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+              root_ckb_offset);
+          self_ck->m_child_offsets[i] = ckb_offset - root_ckb_offset;
+          if (!finished) {
+            ckb_offset = nd::functional::elwise_virtual_ck<N>::instantiate(
+                self, self_tp, data, ckb, ckb_offset, child_dst_tp,
+                child_dst_arrmeta, nsrc, child_src_tp, child_src_arrmeta,
+                kernreq, ectx, kwds, tp_vars);
+          } else {
+            ckb_offset = child->instantiate(
+                child, child_tp, NULL, ckb, ckb_offset, child_dst_tp,
+                child_dst_arrmeta, nsrc, child_src_tp, child_src_arrmeta,
+                kernreq, ectx, kwds, tp_vars);
+          }
+          reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+              ->reserve(ckb_offset + sizeof(ckernel_prefix));
+        }
+
+        return ckb_offset;
+      }
+    };
+
+    /**
+     * Merges the fixed dimensions following the one already extracted
+     * into it, for as long as every operand steps through the pair with
+     * a single stride, i.e. stride == inner_size * inner_stride (with
+     * broadcast operands having a zero stride in both). This turns a
+     * C-contiguous ``1000 * 1000 * 4 * T`` into one strided loop of
+     * 4000000 elements instead of three nested ckernels.
+     *
+     * On return, ``size``, the strides, the child types and arrmeta
+     * describe the merged dimension, and ``dst_ndim`` and ``finished``
+     * are updated to match.
+     */
+    template <int N>
+    void coalesce_strided_dims(const ndt::arrfunc_type *child_tp,
+                               intptr_t &dst_ndim, bool &finished,
+                               intptr_t &size, intptr_t &dst_stride,
+                               ndt::type &child_dst_tp,
+                               const char *&child_dst_arrmeta,
+                               intptr_t *src_stride, ndt::type *child_src_tp,
+                               const char **child_src_arrmeta)
+    {
+      while (!finished && child_dst_tp.get_type_id() == fixed_dim_type_id) {
+        intptr_t inner_size, inner_dst_stride, inner_src_stride[N + 1];
+        ndt::type inner_dst_tp, inner_src_tp[N + 1];
+        const char *inner_dst_arrmeta, *inner_src_arrmeta[N + 1];
+        if (!child_dst_tp.get_as_strided(child_dst_arrmeta, &inner_size,
+                                         &inner_dst_stride, &inner_dst_tp,
+                                         &inner_dst_arrmeta) ||
+            dst_stride != inner_size * inner_dst_stride) {
+          return;
+        }
+
+        bool inner_finished = dst_ndim == 2;
+        for (int i = 0; i < N; ++i) {
+          intptr_t src_ndim =
+              child_src_tp[i].get_ndim() - child_tp->get_pos_type(i).get_ndim();
+          intptr_t src_size;
+          if (src_ndim < dst_ndim - 1) {
+            // Broadcast through the inner dimension as well
+            inner_src_stride[i] = 0;
+            inner_src_tp[i] = child_src_tp[i];
+            inner_src_arrmeta[i] = child_src_arrmeta[i];
+            inner_finished &= src_ndim == 0;
+          } else if (child_src_tp[i].get_type_id() == fixed_dim_type_id &&
+                     child_src_tp[i].get_as_strided(
+                         child_src_arrmeta[i], &src_size, &inner_src_stride[i],
+                         &inner_src_tp[i], &inner_src_arrmeta[i])) {
+            if (src_size == 1 && inner_size != 1) {
+              inner_src_stride[i] = 0;
+            } else if (src_size != inner_size) {
+              // Leave the broadcast error to the nested ckernel
+              return;
+            }
+            inner_finished &= src_ndim == 1;
+          } else {
+            return;
+          }
+          if (src_stride[i] != inner_size * inner_src_stride[i]) {
+            return;
+          }
+        }
+
+        size *= inner_size;
+        dst_stride = inner_dst_stride;
+        child_dst_tp = inner_dst_tp;
+        child_dst_arrmeta = inner_dst_arrmeta;
+        for (int i = 0; i < N; ++i) {
+          src_stride[i] = inner_src_stride[i];
+          child_src_tp[i] = inner_src_tp[i];
+          child_src_arrmeta[i] = inner_src_arrmeta[i];
+        }
+        --dst_ndim;
+        finished = inner_finished;
+      }
+    }
+
     template <int N>
     struct elwise_ck<fixed_dim_type_id, fixed_dim_type_id, N>
         : base_kernel<elwise_ck<fixed_dim_type_id, fixed_dim_type_id, N>,
@@ -389,6 +589,10 @@ namespace nd {
               throw broadcast_error(dst_tp, dst_arrmeta, src_tp[i],
                                     src_arrmeta[i]);
             }
+            if (src_size == 1) {
+              // A size one dimension broadcasts, whatever its stride
+              src_stride[i] = 0;
+            }
             finished &= src_ndim == 1;
           } else {
             std::stringstream ss;
@@ -398,6 +602,18 @@ namespace nd {
           }
         }
 
+        coalesce_strided_dims<N>(child_tp, dst_ndim, finished, size,
+                                 dst_stride, child_dst_tp, child_dst_arrmeta,
+                                 src_stride, child_src_tp, child_src_arrmeta);
+
+        if (parallel_elwise_ck<N>::use_parallel(kernreq, ectx, size,
+                                                dst_tp)) {
+          return parallel_elwise_ck<N>::instantiate(
+              self, self_tp, data, ckb, ckb_offset, size, dst_stride,
+              src_stride, child_dst_tp, child_dst_arrmeta, nsrc, child_src_tp,
+              child_src_arrmeta, finished, kernreq, ectx, kwds, tp_vars);
+        }
+
         self_type::make(ckb, kernreq, ckb_offset, size, dst_stride,
                         dynd::detail::make_array_wrapper<N>(src_stride));
         kernreq = (kernreq & kernel_request_memory) | kernel_request_strided;
@@ -494,11 +710,14 @@ namespace nd {
           throw type_error(ss.str());
         }
 
+        bool finished = dst_ndim == 1;
+        coalesce_strided_dims<0>(child_tp, dst_ndim, finished, size,
+                                 dst_stride, child_dst_tp, child_dst_arrmeta,
+                                 NULL, NULL, NULL);
+
         self_type::make(ckb, kernreq, ckb_offset, size, dst_stride);
         kernreq = (kernreq & kernel_request_memory) | kernel_request_strided;
 
-        bool finished = dst_ndim == 1;
-
         // If there are still dimensions to broadcast, recursively lift more
         if (!finished) {
           return nd::functional::elwise_virtual_ck<0>::instantiate(
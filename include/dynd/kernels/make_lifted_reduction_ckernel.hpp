@@ -45,6 +45,11 @@ namespace dynd {
  *                 dynd::kernel_request_strided,
  *                 as required by the caller.
  * \param ectx  The evaluation context to use.
+ * \param combine  Either NULL, or a unary reduction arrfunc which merges
+ *                 one accumulator value into another. The reduction is
+ *                 only parallelized when it is given, by combining
+ *                 partial accumulators with it.
+ * \param combine_tp  The type of ``combine``.
  */
 size_t make_lifted_reduction_ckernel(
     const arrfunc_type_data *elwise_reduction,
@@ -56,6 +61,8 @@ size_t make_lifted_reduction_ckernel(
     const bool *reduction_dimflags, bool associative, bool commutative,
     bool right_associative, const nd::array &reduction_identity,
     dynd::kernel_request_t kernreq,
-    const eval::eval_context *ectx = &eval::default_eval_context);
+    const eval::eval_context *ectx = &eval::default_eval_context,
+    const arrfunc_type_data *combine = NULL,
+    const ndt::arrfunc_type *combine_tp = NULL);
 
 } // namespace dynd
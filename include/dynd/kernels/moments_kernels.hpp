@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd { namespace kernels {
+
+/**
+ * The accumulator of the moments reductions, the count, mean, and sums of
+ * the second, third and fourth powers of the deviations from the mean.
+ * It's updated one value at a time with Welford's method, and two of them
+ * can be merged, so partial results over pieces of the data combine into
+ * the result over all of it. Its dynd type is
+ * ``{count: int64, mean: float64, m2: float64, m3: float64, m4: float64}``.
+ */
+struct moments_state {
+  int64_t count;
+  double mean, m2, m3, m4;
+};
+
+/** The statistics computed from a moments_state */
+enum moment_statistic_t {
+  /** The variance, dividing by the count minus ddof */
+  moment_statistic_var,
+  /** The square root of the variance */
+  moment_statistic_std,
+  /** The skewness, m3 / m2^1.5 with the population moments */
+  moment_statistic_skew,
+  /** The excess kurtosis, m4 / m2^2 - 3 with the population moments */
+  moment_statistic_kurtosis
+};
+
+/** The dynd type of moments_state */
+ndt::type make_moments_type();
+
+/**
+ * Makes a unary reduction arrfunc accumulating values of a real numeric
+ * type id into a moments_state, for lift_reduction_arrfunc.
+ * (<tid>) -> <moments type>
+ */
+nd::arrfunc make_builtin_moments_reduction_arrfunc(type_id_t tid);
+
+/**
+ * Makes a unary reduction arrfunc merging one moments_state into another,
+ * the ``combine`` of lift_reduction_arrfunc.
+ * (<moments type>) -> <moments type>
+ */
+nd::arrfunc make_moments_combine_arrfunc();
+
+/**
+ * Lifts the moments reduction of the type id like lift_reduction_arrfunc
+ * does, with the identity and combine arrfunc filled in, so it reduces
+ * any subset of the dimensions in one pass, in parallel if the
+ * eval_context asks for it.
+ */
+nd::arrfunc lift_builtin_moments_reduction_arrfunc(
+    type_id_t tid, const ndt::type &lifted_arr_type, bool keepdims,
+    intptr_t reduction_ndim, const bool *reduction_dimflags);
+
+/**
+ * Makes an arrfunc computing a statistic from a moments_state. The result
+ * is NaN if the count is at most ``ddof``, or for skew and kurtosis, if
+ * the values are all equal.
+ * (<moments type>) -> float64
+ */
+nd::arrfunc make_moment_statistic_arrfunc(moment_statistic_t stat,
+                                          intptr_t ddof = 0);
+
+/**
+ * Makes a 1D arrfunc computing a statistic in one pass over the data.
+ * (Fixed * <tid>) -> float64
+ */
+nd::arrfunc make_builtin_moment1d_arrfunc(moment_statistic_t stat,
+                                          type_id_t tid, intptr_t ddof = 0);
+
+}} // namespace dynd::kernels
@@ -11,33 +11,165 @@
 
 namespace dynd { namespace kernels {
 
+/**
+ * How a sum of floating point values is accumulated. Pairwise summation
+ * has an error growing with the log of the count, and runs at the speed
+ * of the naive loop. Kahan (Neumaier) summation has an error independent
+ * of the count, but is several times slower. Integer sums are exact in
+ * either mode.
+ */
+enum sum_accuracy_t {
+  sum_accuracy_pairwise,
+  sum_accuracy_kahan
+};
+
 /**
  * Makes a unary reduction ckernel which adds values for the
  * given type id. This is not defined for all type_id values.
  */
-intptr_t make_builtin_sum_reduction_ckernel(void *ckb,
-                                            intptr_t ckb_offset,
-                                            type_id_t tid,
-                                            kernel_request_t kernreq);
+intptr_t make_builtin_sum_reduction_ckernel(
+    void *ckb, intptr_t ckb_offset, type_id_t tid, kernel_request_t kernreq,
+    sum_accuracy_t accuracy = sum_accuracy_pairwise);
 
 /**
  * Makes a unary reduction arrfunc for the requested
- * type id.
+ * type id. Its ``accuracy`` kwd, "pairwise" or "kahan", overrides
+ * the accuracy given here.
+ * (<tid>, accuracy: ?string) -> <tid>
  */
-nd::arrfunc make_builtin_sum_reduction_arrfunc(type_id_t tid);
+nd::arrfunc make_builtin_sum_reduction_arrfunc(
+    type_id_t tid, sum_accuracy_t accuracy = sum_accuracy_pairwise);
 
 /**
- * Makes a 1D sum arrfunc.
- * (Fixed * <tid>) -> <tid>
+ * Makes a 1D sum arrfunc, pairwise unless the ``accuracy`` kwd is "kahan".
+ * (Fixed * <tid>, accuracy: ?string) -> <tid>
  */
 nd::arrfunc make_builtin_sum1d_arrfunc(type_id_t tid);
 
+/**
+ * The builtin reductions besides sum. Min and max propagate NaN, and
+ * any, all and count_nonzero treat NaN as nonzero. Any, all and
+ * count_nonzero produce bool, bool and int64, the others produce the
+ * input type.
+ */
+enum builtin_reduction_t {
+  builtin_reduction_min,
+  builtin_reduction_max,
+  builtin_reduction_prod,
+  builtin_reduction_any,
+  builtin_reduction_all,
+  builtin_reduction_count_nonzero
+};
+
+/**
+ * Makes a unary reduction ckernel for the builtin reduction on the given
+ * numeric type id. Complex types support only prod, any, all and
+ * count_nonzero, and bool doesn't support prod.
+ */
+intptr_t make_builtin_reduction_ckernel(void *ckb, intptr_t ckb_offset,
+                                        builtin_reduction_t op, type_id_t tid,
+                                        kernel_request_t kernreq);
+
+/**
+ * Makes a unary reduction arrfunc for the builtin reduction on the given
+ * type id, to be lifted with lift_reduction_arrfunc.
+ * (<tid>) -> <dst type of op>
+ *
+ * Any, all and count_nonzero can't start from a copy of the first element,
+ * so when it is lifted with neither an identity nor a dst_initialization,
+ * lift_reduction_arrfunc uses the one from make_builtin_reduction_identity.
+ */
+nd::arrfunc make_builtin_reduction_arrfunc(builtin_reduction_t op,
+                                           type_id_t tid);
+
+/**
+ * The identity of the builtin reduction on the given type id, of its dst
+ * type. Min and max start from the first value, so they have none, and
+ * this returns a NULL nd::array for them.
+ */
+nd::array make_builtin_reduction_identity(builtin_reduction_t op,
+                                          type_id_t tid);
+
+/**
+ * If ``af`` was made by make_builtin_reduction_arrfunc, returns the
+ * identity of its reduction, otherwise a NULL nd::array.
+ */
+nd::array get_builtin_reduction_identity(const nd::arrfunc &af);
+
+/**
+ * Makes the arrfunc merging partial results of the builtin reduction on
+ * the given type id, to pass as the combine of lift_reduction_arrfunc.
+ * This is the same reduction on the dst type, apart from count_nonzero,
+ * whose partial counts are summed.
+ * (<dst type of op>) -> <dst type of op>
+ */
+nd::arrfunc make_builtin_reduction_combine_arrfunc(builtin_reduction_t op,
+                                                   type_id_t tid);
+
+/**
+ * Makes a 1D builtin reduction arrfunc. Min and max of an empty
+ * dimension are errors.
+ * (Fixed * <tid>) -> <dst type of op>
+ */
+nd::arrfunc make_builtin_reduction1d_arrfunc(builtin_reduction_t op,
+                                             type_id_t tid);
+
+/**
+ * Makes a 1D arrfunc finding the first minimum value and its index in one
+ * pass. If there is a NaN, the first NaN is the result.
+ * (Fixed * <tid>) -> {index: intptr, value: <tid>}
+ */
+nd::arrfunc make_builtin_argmin1d_arrfunc(type_id_t tid);
+
+/**
+ * Makes a 1D arrfunc finding the first maximum value and its index in one
+ * pass. If there is a NaN, the first NaN is the result.
+ * (Fixed * <tid>) -> {index: intptr, value: <tid>}
+ */
+nd::arrfunc make_builtin_argmax1d_arrfunc(type_id_t tid);
+
 /**
  * Makes a 1D mean arrfunc.
  * (Fixed * <tid>) -> <tid>
  */
 nd::arrfunc make_builtin_mean1d_arrfunc(type_id_t tid, intptr_t minp);
 
+/**
+ * The builtin 1D aggregates which other arrfuncs, like
+ * nd::functional::rolling, can recognize and compute in their own way.
+ */
+enum builtin1d_op_t {
+  builtin1d_sum,
+  builtin1d_mean,
+  builtin1d_min,
+  builtin1d_max,
+  builtin1d_var,
+  builtin1d_std
+};
+
+struct builtin1d_info {
+  builtin1d_op_t op;
+  // The element type id of the input dimension
+  type_id_t tid;
+  // The minp of a mean, or the ddof of a var or std
+  intptr_t param;
+};
+
+/**
+ * Makes an arrfunc which behaves like ``child``, and which
+ * get_builtin1d_info identifies with ``info``.
+ */
+nd::arrfunc make_builtin1d_tagged_arrfunc(const nd::arrfunc &child,
+                                          const builtin1d_info &info);
+
+/**
+ * If ``af`` was made by make_builtin_sum1d_arrfunc,
+ * make_builtin_mean1d_arrfunc, make_builtin_reduction1d_arrfunc with min
+ * or max, or make_builtin_moment1d_arrfunc with var or std, fills in
+ * ``out_info`` and returns true. Returns false otherwise.
+ */
+bool get_builtin1d_info(const nd::arrfunc &af, builtin1d_info &out_info);
+
 intptr_t make_strided_reduction_ckernel(void *ckb, intptr_t ckb_offset);
 
 nd::arrfunc make_strided_reduction_arrfunc();
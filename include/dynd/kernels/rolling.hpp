@@ -5,11 +5,14 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/arrmeta_holder.hpp>
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/base_virtual_kernel.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
 
 namespace dynd {
 namespace nd {
@@ -17,16 +20,32 @@ namespace nd {
 
     struct rolling_arrfunc_data {
       intptr_t window_size;
+      // The fewest values a window at the start needs to be computed
+      intptr_t min_periods;
       // The window op
       arrfunc window_op;
+      // Whether the window op is a builtin aggregate, rolled incrementally
+      bool is_builtin;
+      kernels::builtin1d_info builtin;
+      // If the window op is a lifted builtin reduction, its identity, which
+      // pads the windows at the start shorter than window_size
+      array head_identity;
     };
 
     struct strided_rolling_ck
         : base_kernel<strided_rolling_ck, kernel_request_host, 1> {
-      intptr_t m_window_size;
+      intptr_t m_window_size, m_min_periods;
       intptr_t m_dim_size, m_dst_stride, m_src_stride;
       size_t m_window_op_offset;
       arrmeta_holder m_src_winop_meta;
+      // The windows at the start shorter than m_window_size are computed in
+      // one strided call of a second window op, over m_head_buffer. It holds
+      // m_window_size - 1 copies of the reduction identity followed by the
+      // first m_window_size - 1 values, contiguously.
+      size_t m_head_op_offset;
+      arrmeta_holder m_head_winop_meta;
+      intptr_t m_head_el_size;
+      std::vector<char> m_head_buffer;
 
       void single(char *dst, char *const *src);
 
@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /** The scans with their own typed kernels */
+    enum builtin_scan_t {
+      builtin_scan_none,
+      builtin_scan_sum,
+      builtin_scan_prod,
+      builtin_scan_min,
+      builtin_scan_max
+    };
+
+    struct scan_arrfunc_data {
+      // The binary operation, null for a builtin scan
+      arrfunc op;
+      // The operation lifted to apply elementwise
+      arrfunc elwise_op;
+      builtin_scan_t builtin;
+      bool associative;
+    };
+
+    /**
+     * Makes an arrfunc ``(T, T) -> T`` doing one step of a builtin scan,
+     * used when the scanned elements have dimensions of their own.
+     */
+    arrfunc make_builtin_scan_op_arrfunc(builtin_scan_t op, type_id_t tid);
+
+    struct scan_ck : base_virtual_kernel<scan_ck> {
+      static intptr_t
+      instantiate(const arrfunc_type_data *self,
+                  const ndt::arrfunc_type *self_tp, char *data, void *ckb,
+                  intptr_t ckb_offset, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *src_tp, const char *const *src_arrmeta,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const nd::array &kwds,
+                  const std::map<nd::string, ndt::type> &tp_vars);
+
+      static void
+      resolve_dst_type(const arrfunc_type_data *self,
+                       const ndt::arrfunc_type *self_tp, char *data,
+                       ndt::type &dst_tp, intptr_t nsrc,
+                       const ndt::type *src_tp, const nd::array &kwds,
+                       const std::map<nd::string, ndt::type> &tp_vars);
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,125 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/types/type_id.hpp>
+
+namespace dynd {
+namespace kernels {
+
+  /**
+   * The instruction set levels the contiguous arithmetic loops are
+   * compiled for. The level in use is picked from the CPU features when
+   * the library is loaded.
+   */
+  enum simd_level_t {
+    simd_level_none,
+    simd_level_sse2,
+    simd_level_avx2,
+    simd_level_avx512,
+    simd_level_count
+  };
+
+  /** The highest level the running CPU and this build both support */
+  simd_level_t get_supported_simd_level();
+
+  /** The level currently used by the arithmetic kernels */
+  simd_level_t get_simd_level();
+
+  /**
+   * Changes the level used by the arithmetic kernels, clamped to the
+   * supported level, and returns the level now in use. This is meant for
+   * testing and benchmarking, and must not be called while kernels are
+   * running on other threads.
+   */
+  simd_level_t set_simd_level(simd_level_t level);
+
+  enum arithmetic_op_t {
+    arithmetic_op_add,
+    arithmetic_op_subtract,
+    arithmetic_op_multiply,
+    arithmetic_op_divide,
+    arithmetic_op_count
+  };
+
+  /**
+   * A loop writing ``count`` contiguous results to ``dst``. Each source
+   * is either contiguous, or a single value broadcast to every element,
+   * as selected when the loop was looked up.
+   */
+  typedef void (*simd_binary_loop_t)(char *dst, const char *src0,
+                                     const char *src1, size_t count);
+
+  /**
+   * Returns the vectorized loop at the current level for ``op`` on
+   * float32, float64, int32 or int64 values, or NULL if there is none.
+   */
+  simd_binary_loop_t get_simd_binary_loop(arithmetic_op_t op, type_id_t tid,
+                                          bool src0_contiguous,
+                                          bool src1_contiguous);
+
+  /**
+   * Runs a strided binary arithmetic kernel call through a vectorized
+   * loop if the types and strides allow it, returning false otherwise.
+   * The vectorized loops cover a contiguous destination, with sources
+   * that are contiguous or zero-strided, when the destination and both
+   * sources have the same type.
+   */
+  template <arithmetic_op_t Op, typename R, typename A0, typename A1>
+  struct simd_binary {
+    static bool run(char *DYND_UNUSED(dst), intptr_t DYND_UNUSED(dst_stride),
+                    char *const *DYND_UNUSED(src),
+                    const intptr_t *DYND_UNUSED(src_stride),
+                    size_t DYND_UNUSED(count))
+    {
+      return false;
+    }
+  };
+
+  template <arithmetic_op_t Op, typename T>
+  struct simd_binary_same_type {
+    static bool run(char *dst, intptr_t dst_stride, char *const *src,
+                    const intptr_t *src_stride, size_t count)
+    {
+      if (dst_stride != sizeof(T) ||
+          (src_stride[0] != sizeof(T) && src_stride[0] != 0) ||
+          (src_stride[1] != sizeof(T) && src_stride[1] != 0)) {
+        return false;
+      }
+      simd_binary_loop_t loop = get_simd_binary_loop(
+          Op, static_cast<type_id_t>(type_id_of<T>::value),
+          src_stride[0] != 0, src_stride[1] != 0);
+      if (loop == NULL) {
+        return false;
+      }
+      loop(dst, src[0], src[1], count);
+      return true;
+    }
+  };
+
+  template <arithmetic_op_t Op>
+  struct simd_binary<Op, float, float, float>
+      : simd_binary_same_type<Op, float> {
+  };
+
+  template <arithmetic_op_t Op>
+  struct simd_binary<Op, double, double, double>
+      : simd_binary_same_type<Op, double> {
+  };
+
+  template <arithmetic_op_t Op>
+  struct simd_binary<Op, int32_t, int32_t, int32_t>
+      : simd_binary_same_type<Op, int32_t> {
+  };
+
+  template <arithmetic_op_t Op>
+  struct simd_binary<Op, int64_t, int64_t, int64_t>
+      : simd_binary_same_type<Op, int64_t> {
+  };
+
+} // namespace dynd::kernels
+} // namespace dynd
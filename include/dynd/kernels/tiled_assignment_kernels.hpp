@@ -0,0 +1,34 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+
+namespace dynd {
+
+/**
+ * Makes a kernel which assigns between leading fixed dimensions whose
+ * memory orders differ, for example a transposed or Fortran-ordered array
+ * into a C-ordered one. The dimension with the smallest dst stride and the
+ * dimension with the smallest src stride are traversed in square tiles
+ * sized from the element size, so the cache lines of both sides stay in
+ * the L1 cache while a tile is copied. The other dimensions are traversed
+ * in order of decreasing dst stride.
+ *
+ * Returns -1 without making a kernel if fewer than two leading dimensions
+ * are fixed, if the innermost dimensions of the dst and the src are the
+ * same, or if the tiled dimensions are too small for tiling to help.
+ */
+intptr_t make_tiled_assignment_kernel(void *ckb, intptr_t ckb_offset,
+                                      const ndt::type &dst_tp,
+                                      const char *dst_arrmeta,
+                                      const ndt::type &src_tp,
+                                      const char *src_arrmeta,
+                                      kernel_request_t kernreq,
+                                      const eval::eval_context *ectx);
+
+} // namespace dynd
@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /** The outputs of a unique arrfunc, its static data */
+  struct unique_arrfunc_data {
+    // Whether the result is a struct of the outputs, or just the values
+    bool struct_output;
+    bool inverse;
+    bool counts;
+  };
+
+  /** The arrfunc of unique and value_counts */
+  struct unique_ck : base_virtual_kernel<unique_ck> {
+    static intptr_t
+    instantiate(const arrfunc_type_data *self,
+                const ndt::arrfunc_type *self_tp, char *data, void *ckb,
+                intptr_t ckb_offset, const ndt::type &dst_tp,
+                const char *dst_arrmeta, intptr_t nsrc,
+                const ndt::type *src_tp, const char *const *src_arrmeta,
+                kernel_request_t kernreq, const eval::eval_context *ectx,
+                const nd::array &kwds,
+                const std::map<nd::string, ndt::type> &tp_vars);
+
+    static void resolve_dst_type(const arrfunc_type_data *self,
+                                 const ndt::arrfunc_type *self_tp, char *data,
+                                 ndt::type &dst_tp, intptr_t nsrc,
+                                 const ndt::type *src_tp, const nd::array &kwds,
+                                 const std::map<nd::string, ndt::type> &tp_vars);
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * A persistent pool of worker threads used to execute ckernels
+ * in parallel. The workers are started lazily, the first time
+ * a parallel execution asks for them, and live until the process
+ * exits.
+ *
+ * Only one parallel execution runs on the pool at a time. If
+ * ``run`` is called while another execution is in progress, for
+ * example from inside a task or from a second user thread, the
+ * tasks are executed serially on the calling thread instead of
+ * blocking.
+ */
+class thread_pool {
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv, m_done_cv;
+
+  // State of the execution currently in progress
+  const std::function<void(intptr_t)> *m_task;
+  intptr_t m_ntasks, m_next_task, m_pending_tasks;
+  // Number of threads executing tasks, and the limit on it
+  intptr_t m_nactive, m_max_active;
+  std::exception_ptr m_exception;
+  bool m_running, m_stopping;
+
+  void worker_main();
+  void run_tasks(std::unique_lock<std::mutex> &lock);
+  void grow(intptr_t nworkers);
+
+  thread_pool(const thread_pool &);
+  thread_pool &operator=(const thread_pool &);
+
+public:
+  thread_pool();
+  ~thread_pool();
+
+  /** The number of worker threads that have been started */
+  intptr_t get_nworkers() const { return m_workers.size(); }
+
+  /**
+   * Runs ``task(i)`` for every ``i`` in [0, ntasks), using up to
+   * ``nthreads`` threads including the calling thread. Returns after all
+   * the tasks have completed. If any task throws, the first exception is
+   * rethrown on the calling thread once every task has finished.
+   */
+  void run(intptr_t nthreads, intptr_t ntasks,
+           const std::function<void(intptr_t)> &task);
+
+  /** The process-wide pool used by dynd */
+  static thread_pool &get();
+};
+
+/**
+ * Splits the range [0, size) into at most ``nthreads`` contiguous chunks of
+ * at least ``grain_size`` elements each, returning the number of chunks.
+ * ``chunk_begin`` receives ``nchunks + 1`` boundaries, chunk ``i`` being
+ * [chunk_begin[i], chunk_begin[i + 1]).
+ */
+intptr_t partition_range(intptr_t nthreads, intptr_t size,
+                         intptr_t grain_size,
+                         std::vector<intptr_t> &chunk_begin);
+
+/**
+ * Calls ``func(i, begin, end)`` for each chunk ``i`` produced by
+ * ``partition_range``, executing the chunks on the thread pool.
+ */
+void parallel_for(intptr_t nthreads, intptr_t size, intptr_t grain_size,
+                  const std::function<void(intptr_t, intptr_t, intptr_t)> &func);
+
+} // namespace dynd
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <dynd/type.hpp>
 #include <dynd/array.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -18,6 +20,9 @@ struct assign_to_same_category_type;
 } // anonymous namespace
 
 namespace dynd {
+
+class hash_index;
+
 namespace ndt {
 
   class categorical_type : public base_type {
@@ -31,11 +36,16 @@ namespace ndt {
     nd::array m_category_index_to_value;
     // mapping from values to category indices
     nd::array m_value_to_category_index;
+    // hash index of the encoded categories, the id of a category being its
+    // value, or NULL if the category type can't be encoded
+    std::unique_ptr<hash_index> m_category_index;
+
+    void make_category_index();
 
   public:
     categorical_type(const nd::array &categories, bool presorted = false);
 
-    virtual ~categorical_type() {}
+    virtual ~categorical_type();
 
     void print_data(std::ostream &o, const char *arrmeta,
                     const char *data) const;
@@ -62,6 +72,16 @@ namespace ndt {
      */
     const type &get_storage_type() const { return m_storage_type; }
 
+    /**
+     * Returns the hash index of the categories, in which the id of a
+     * category is its value, or NULL if the categories aren't indexed. The
+     * keys are the encodings of a key_encoder for the category type.
+     */
+    const hash_index *get_category_index() const
+    {
+      return m_category_index.get();
+    }
+
     uint32_t get_value_from_category(const char *category_arrmeta,
                                      const char *category_data) const;
     uint32_t get_value_from_category(const nd::array &category) const;
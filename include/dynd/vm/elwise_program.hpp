@@ -11,14 +11,45 @@
 
 namespace dynd { namespace vm {
 
+/**
+ * The VM opcodes. Unless noted otherwise, the output and the
+ * arguments of an instruction all have the same type.
+ *
+ * The comparisons write a bool output, ``select`` picks its
+ * second or third argument based on its first bool argument,
+ * and ``cast`` converts between any two builtin types.
+ */
 enum opcode_t {
     opcode_copy,
     opcode_add,
     opcode_subtract,
     opcode_multiply,
-    opcode_divide
+    opcode_divide,
+    opcode_negate,
+    opcode_minimum,
+    opcode_maximum,
+    opcode_less,
+    opcode_less_equal,
+    opcode_equal,
+    opcode_not_equal,
+    opcode_greater_equal,
+    opcode_greater,
+    opcode_select,
+    opcode_cast,
+    // Math functions. abs accepts any numeric type, the others
+    // float32 and float64
+    opcode_abs,
+    opcode_sqrt,
+    opcode_exp,
+    opcode_log,
+    opcode_sin,
+    opcode_cos,
+    opcode_tan,
+    opcode_floor,
+    opcode_ceil,
+    opcode_power
 };
-const int opcode_count = opcode_divide + 1;
+const int opcode_count = opcode_power + 1;
 
 struct opcode_info_t {
     const char *name;
@@ -11,10 +11,17 @@
 
 namespace dynd { namespace vm {
 
+/**
+ * Contiguous memory for the registers of an elementwise VM program,
+ * each register holding the same number of elements. The element
+ * count is chosen so all the registers together fit in
+ * ``max_byte_count`` bytes.
+ */
 class register_allocation {
     const std::vector<ndt::type>& m_regtypes;
     std::vector<char *> m_registers;
     std::vector<memory_block_ptr> m_blockrefs;
+    intptr_t m_element_count;
     char *m_allocated_memory;
 public:
     register_allocation(const std::vector<ndt::type>& regtypes, intptr_t max_element_count, intptr_t max_byte_count);
@@ -27,6 +34,11 @@ public:
     const std::vector<char *>& get_registers() const {
         return m_registers;
     }
+
+    /** The number of elements each register holds */
+    intptr_t get_element_count() const {
+        return m_element_count;
+    }
 };
 
 }} // namespace dynd::vm
@@ -2331,6 +2331,13 @@ void nd::forward_as_array(const ndt::type &tp, char *arrmeta, char *data,
 
   if (tp.is_builtin() || tp.get_type_id() == arrfunc_type_id) {
     memcpy(data, val.get_readonly_originptr(), tp.get_data_size());
+  } else if (tp.get_type_id() == string_type_id ||
+             tp.get_type_id() == bytes_type_id) {
+    // The data of a string refers to memory held by its arrmeta's blockref,
+    // so copying the arrmeta shares that memory with ``val``
+    tp.extended()->arrmeta_copy_construct(arrmeta, val.get_arrmeta(),
+                                          val.get_data_memblock().get());
+    memcpy(data, val.get_readonly_originptr(), tp.get_data_size());
   } else {
     pointer_type_arrmeta *am =
         reinterpret_cast<pointer_type_arrmeta *>(arrmeta);
@@ -3,25 +3,73 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
-#if 0 // Temporarily disabled
-
 #include <dynd/codegen/codegen_cache.hpp>
+#include <dynd/codegen/elwise_program_codegen.hpp>
 #include <dynd/memblock/executable_memory_block.hpp>
-#include <dynd/codegen/unary_kernel_adapter_codegen.hpp>
-#include <dynd/codegen/binary_kernel_adapter_codegen.hpp>
-#include <dynd/codegen/binary_reduce_kernel_adapter_codegen.hpp>
-#include <dynd/kernels/kernel_instance.hpp>
 
 using namespace std;
 using namespace dynd;
 
 dynd::codegen_cache::codegen_cache()
     : m_exec_memblock(make_executable_memory_block()),
-        m_cached_unary_kernel_adapters(),
-        m_cached_binary_kernel_adapters()
+        m_cached_elwise_programs()
+{
+}
+
+expr_strided_t dynd::codegen_cache::codegen_elwise_program(const vm::elwise_program& ep)
+{
+    // The generated code depends only on the register types and the instructions
+    const std::vector<ndt::type>& regtypes = ep.get_register_types();
+    const std::vector<int>& program = ep.get_program();
+    std::vector<int> signature;
+    signature.reserve(2 + regtypes.size() + program.size());
+    signature.push_back(ep.get_input_count());
+    signature.push_back((int)regtypes.size());
+    for (size_t i = 0; i < regtypes.size(); ++i) {
+        if (!regtypes[i].is_builtin()) {
+            return NULL;
+        }
+        signature.push_back(regtypes[i].get_type_id());
+    }
+    signature.insert(signature.end(), program.begin(), program.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    map<std::vector<int>, expr_strided_t>::iterator it = m_cached_elwise_programs.find(signature);
+    if (it == m_cached_elwise_programs.end()) {
+        // Programs which can't be compiled are cached as NULL
+        expr_strided_t fn = ::codegen_elwise_program(m_exec_memblock.get(), ep);
+        it = m_cached_elwise_programs.insert(std::make_pair(signature, fn)).first;
+    }
+    return it->second;
+}
+
+codegen_cache& dynd::codegen_cache::get()
+{
+    static codegen_cache cgcache;
+    return cgcache;
+}
+
+void dynd::codegen_cache::debug_print(std::ostream& o, const std::string& indent) const
 {
+    o << indent << "------ codegen_cache\n";
+    o << indent << " cached elwise programs:\n";
+    for (map<std::vector<int>, expr_strided_t>::const_iterator i = m_cached_elwise_programs.begin(),
+                i_end = m_cached_elwise_programs.end(); i != i_end; ++i) {
+        o << indent << "  strided function ptr: " << (void *)i->second << "\n";
+    }
+
+    o << indent << " executable memory block:\n";
+    memory_block_debug_print(m_exec_memblock.get(), o, indent + " ");
+    o << indent << "------" << endl;
 }
 
+#if 0 // Temporarily disabled
+
+#include <dynd/codegen/unary_kernel_adapter_codegen.hpp>
+#include <dynd/codegen/binary_kernel_adapter_codegen.hpp>
+#include <dynd/codegen/binary_reduce_kernel_adapter_codegen.hpp>
+#include <dynd/kernels/kernel_instance.hpp>
+
 void dynd::codegen_cache::codegen_unary_function_adapter(const ndt::type& restype,
                 const ndt::type& arg0type, calling_convention_t callconv,
                 void *function_pointer,
@@ -0,0 +1,21 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/platform_definitions.hpp>
+
+#if !defined(DYND_CALL_SYSV_X64)
+
+#include <dynd/codegen/elwise_program_codegen.hpp>
+
+using namespace dynd;
+
+expr_strided_t dynd::codegen_elwise_program(
+    memory_block_data *DYND_UNUSED(exec_memblock),
+    const vm::elwise_program &DYND_UNUSED(ep))
+{
+  return NULL;
+}
+
+#endif // !defined(DYND_CALL_SYSV_X64)
@@ -0,0 +1,323 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/platform_definitions.hpp>
+
+#if defined(DYND_CALL_SYSV_X64)
+
+#include <cstring>
+#include <vector>
+
+#include <dynd/codegen/elwise_program_codegen.hpp>
+#include <dynd/memblock/executable_memory_block.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// General purpose register numbers
+enum {
+  rax = 0,
+  rcx = 1,
+  rdx = 2,
+  rbx = 3,
+  rsi = 6,
+  rdi = 7,
+  r8 = 8,
+  r9 = 9,
+  r10 = 10,
+  r11 = 11,
+  r14 = 14,
+  r15 = 15
+};
+
+// The registers holding the input pointers. None of them need a SIB byte
+// or a displacement when used as a base address.
+const int input_ptr_regs[] = {rax, r9, r10, r11, rbx, r14, r15};
+const int max_input_count = sizeof(input_ptr_regs) / sizeof(input_ptr_regs[0]);
+
+// VM register i lives in xmm<i>, and xmm15 is scratch
+const int scratch_xmm = 15;
+const int max_register_count = 15;
+
+/**
+ * Appends x86-64 machine code to a buffer, with just the instructions
+ * the elwise program loops need.
+ */
+class x64_emitter {
+  std::vector<unsigned char> m_code;
+
+  void rex(bool w, int reg, int rm)
+  {
+    int r = 0x40 | (w ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+    if (r != 0x40) {
+      byte(r);
+    }
+  }
+
+  void modrm(int mod, int reg, int rm)
+  {
+    byte((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+  }
+
+public:
+  const std::vector<unsigned char> &code() const { return m_code; }
+
+  intptr_t pos() const { return m_code.size(); }
+
+  void byte(int b) { m_code.push_back(static_cast<unsigned char>(b)); }
+
+  void imm32(int32_t v)
+  {
+    for (int i = 0; i < 4; ++i) {
+      byte((v >> (8 * i)) & 0xff);
+    }
+  }
+
+  void patch_imm32(intptr_t at, int32_t v)
+  {
+    for (int i = 0; i < 4; ++i) {
+      m_code[at + i] = static_cast<unsigned char>((v >> (8 * i)) & 0xff);
+    }
+  }
+
+  void push(int r)
+  {
+    rex(false, 0, r);
+    byte(0x50 + (r & 7));
+  }
+
+  void pop(int r)
+  {
+    rex(false, 0, r);
+    byte(0x58 + (r & 7));
+  }
+
+  /** mov dst, [base + disp8] */
+  void mov_load(int dst, int base, int disp8)
+  {
+    rex(true, dst, base);
+    byte(0x8B);
+    modrm(1, dst, base);
+    byte(disp8);
+  }
+
+  /** add dst, [base + disp8] */
+  void add_load(int dst, int base, int disp8)
+  {
+    rex(true, dst, base);
+    byte(0x03);
+    modrm(1, dst, base);
+    byte(disp8);
+  }
+
+  /** add dst, src */
+  void add(int dst, int src)
+  {
+    rex(true, src, dst);
+    byte(0x01);
+    modrm(3, src, dst);
+  }
+
+  /** test r, r */
+  void test(int r)
+  {
+    rex(true, r, r);
+    byte(0x85);
+    modrm(3, r, r);
+  }
+
+  /** dec r */
+  void dec(int r)
+  {
+    rex(true, 0, r);
+    byte(0xFF);
+    modrm(3, 1, r);
+  }
+
+  /** jz/jnz with a 32-bit displacement, returning where it is */
+  intptr_t jcc(bool zero, intptr_t target = 0)
+  {
+    byte(0x0F);
+    byte(zero ? 0x84 : 0x85);
+    intptr_t at = pos();
+    imm32(static_cast<int32_t>(target - (at + 4)));
+    return at;
+  }
+
+  void ret() { byte(0xC3); }
+
+  /** A scalar SSE operation with the movss/movsd prefix on xmm registers */
+  void sse_op(bool is_double, int op, int dst, int src)
+  {
+    byte(is_double ? 0xF2 : 0xF3);
+    rex(false, dst, src);
+    byte(0x0F);
+    byte(op);
+    modrm(3, dst, src);
+  }
+
+  /** movss/movsd xmm, [base] */
+  void sse_load(bool is_double, int xmm, int base)
+  {
+    byte(is_double ? 0xF2 : 0xF3);
+    rex(false, xmm, base);
+    byte(0x0F);
+    byte(0x10);
+    modrm(0, xmm, base);
+  }
+
+  /** movss/movsd [base], xmm */
+  void sse_store(bool is_double, int base, int xmm)
+  {
+    byte(is_double ? 0xF2 : 0xF3);
+    rex(false, xmm, base);
+    byte(0x0F);
+    byte(0x11);
+    modrm(0, xmm, base);
+  }
+
+  /** movapd/movaps dst, src */
+  void sse_move(bool is_double, int dst, int src)
+  {
+    if (dst == src) {
+      return;
+    }
+    if (is_double) {
+      byte(0x66);
+    }
+    rex(false, dst, src);
+    byte(0x0F);
+    byte(0x28);
+    modrm(3, dst, src);
+  }
+};
+
+enum {
+  sse_sqrt = 0x51,
+  sse_add = 0x58,
+  sse_mul = 0x59,
+  sse_sub = 0x5C,
+  sse_min = 0x5D,
+  sse_div = 0x5E,
+  sse_max = 0x5F
+};
+
+int get_sse_opcode(int opcode)
+{
+  switch (opcode) {
+  case vm::opcode_add:
+    return sse_add;
+  case vm::opcode_subtract:
+    return sse_sub;
+  case vm::opcode_multiply:
+    return sse_mul;
+  case vm::opcode_divide:
+    return sse_div;
+  case vm::opcode_minimum:
+    return sse_min;
+  case vm::opcode_maximum:
+    return sse_max;
+  case vm::opcode_sqrt:
+    return sse_sqrt;
+  default:
+    return -1;
+  }
+}
+
+} // anonymous namespace
+
+expr_strided_t dynd::codegen_elwise_program(memory_block_data *exec_memblock,
+                                            const vm::elwise_program &ep)
+{
+  const std::vector<ndt::type> &regtypes = ep.get_register_types();
+  const std::vector<int> &program = ep.get_program();
+  int input_count = ep.get_input_count();
+  int reg_count = (int)regtypes.size();
+  if (input_count > max_input_count || reg_count > max_register_count) {
+    return NULL;
+  }
+  type_id_t tid = regtypes[0].get_type_id();
+  if (tid != float32_type_id && tid != float64_type_id) {
+    return NULL;
+  }
+  for (int i = 1; i < reg_count; ++i) {
+    if (regtypes[i].get_type_id() != tid) {
+      return NULL;
+    }
+  }
+  for (size_t ip = 0; ip < program.size();
+       ip += 2 + vm::opcode_info[program[ip]].arity) {
+    if (program[ip] != vm::opcode_copy && get_sse_opcode(program[ip]) < 0) {
+      return NULL;
+    }
+  }
+  bool is_double = (tid == float64_type_id);
+
+  // Arguments: rdi = dst, rsi = dst_stride, rdx = src, rcx = src_stride,
+  // r8 = count, r9 = self (unused)
+  x64_emitter e;
+  e.push(rbx);
+  e.push(r14);
+  e.push(r15);
+  for (int i = 0; i < input_count; ++i) {
+    e.mov_load(input_ptr_regs[i], rdx, 8 * i);
+  }
+  e.test(r8);
+  intptr_t skip_loop = e.jcc(true);
+
+  intptr_t loop_begin = e.pos();
+  for (int i = 0; i < input_count; ++i) {
+    e.sse_load(is_double, i + 1, input_ptr_regs[i]);
+  }
+  for (size_t ip = 0; ip < program.size();
+       ip += 2 + vm::opcode_info[program[ip]].arity) {
+    int opcode = program[ip], dst = program[ip + 1], a = program[ip + 2];
+    switch (opcode) {
+    case vm::opcode_copy:
+      e.sse_move(is_double, dst, a);
+      break;
+    case vm::opcode_sqrt:
+      e.sse_op(is_double, sse_sqrt, dst, a);
+      break;
+    case vm::opcode_minimum:
+    case vm::opcode_maximum:
+      // minsd/maxsd return their second operand when the comparison
+      // fails, so this matches the interpreter, including for NaN
+      e.sse_move(is_double, scratch_xmm, program[ip + 3]);
+      e.sse_op(is_double, get_sse_opcode(opcode), scratch_xmm, a);
+      e.sse_move(is_double, dst, scratch_xmm);
+      break;
+    default:
+      // Going through scratch handles dst aliasing the second argument
+      e.sse_move(is_double, scratch_xmm, a);
+      e.sse_op(is_double, get_sse_opcode(opcode), scratch_xmm,
+               program[ip + 3]);
+      e.sse_move(is_double, dst, scratch_xmm);
+      break;
+    }
+  }
+  e.sse_store(is_double, rdi, 0);
+  e.add(rdi, rsi);
+  for (int i = 0; i < input_count; ++i) {
+    e.add_load(input_ptr_regs[i], rcx, 8 * i);
+  }
+  e.dec(r8);
+  e.jcc(false, loop_begin);
+
+  e.patch_imm32(skip_loop, static_cast<int32_t>(e.pos() - (skip_loop + 4)));
+  e.pop(r15);
+  e.pop(r14);
+  e.pop(rbx);
+  e.ret();
+
+  char *begin, *end;
+  allocate_executable_memory(exec_memblock, e.code().size(), 16, &begin, &end);
+  memcpy(begin, &e.code()[0], e.code().size());
+  return reinterpret_cast<expr_strided_t>(begin);
+}
+
+#endif // defined(DYND_CALL_SYSV_X64)
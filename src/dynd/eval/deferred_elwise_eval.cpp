@@ -0,0 +1,348 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/eval/deferred_elwise_eval.hpp>
+#include <dynd/eval/eval_elwise_vm.hpp>
+#include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/types/expr_type.hpp>
+#include <dynd/types/pointer_type.hpp>
+#include <dynd/types/tuple_type.hpp>
+#include <dynd/shape_tools.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * The kernel generator of a deferred elementwise expression, holding the
+ * VM program which computes the value from the operands.
+ */
+class elwise_vm_kernel_generator : public expr_kernel_generator {
+  vm::elwise_program m_program;
+
+public:
+  elwise_vm_kernel_generator(const vm::elwise_program &program)
+      : expr_kernel_generator(true), m_program(program)
+  {
+  }
+
+  virtual ~elwise_vm_kernel_generator() {}
+
+  const vm::elwise_program &get_program() const { return m_program; }
+
+  size_t make_expr_kernel(void *ckb, intptr_t ckb_offset,
+                          const ndt::type &dst_tp, const char *dst_arrmeta,
+                          size_t src_count, const ndt::type *src_tp,
+                          const char *const *src_arrmeta,
+                          kernel_request_t kernreq,
+                          const eval::eval_context *ectx) const;
+
+  void print_type(std::ostream &o) const
+  {
+    const std::vector<int> &program = m_program.get_program();
+    o << "elwise_vm(";
+    for (size_t ip = 0; ip < program.size();
+         ip += 2 + vm::opcode_info[program[ip]].arity) {
+      if (ip != 0) {
+        o << ", ";
+      }
+      o << vm::opcode_info[program[ip]].name;
+    }
+    o << ")";
+  }
+};
+
+/**
+ * Evaluates the whole deferred expression into the destination each time
+ * it's called, so the destination and the operands are complete arrays.
+ */
+struct elwise_vm_expr_ck
+    : nd::base_kernel<elwise_vm_expr_ck, kernel_request_host, -1> {
+  const elwise_vm_kernel_generator *m_kgen;
+  ndt::type m_dst_tp;
+  const char *m_dst_arrmeta;
+  std::vector<ndt::type> m_src_tp;
+  std::vector<const char *> m_src_arrmeta;
+  eval::eval_context m_ectx;
+  // The source pointers of strided, sized here so it doesn't allocate
+  std::vector<char *> m_src_copy;
+
+  elwise_vm_expr_ck(const elwise_vm_kernel_generator *kgen,
+                    const ndt::type &dst_tp, const char *dst_arrmeta,
+                    size_t src_count, const ndt::type *src_tp,
+                    const char *const *src_arrmeta,
+                    const eval::eval_context *ectx)
+      : m_kgen(kgen), m_dst_tp(dst_tp), m_dst_arrmeta(dst_arrmeta),
+        m_src_tp(src_tp, src_tp + src_count),
+        m_src_arrmeta(src_arrmeta, src_arrmeta + src_count), m_ectx(*ectx),
+        m_src_copy(src_count)
+  {
+    expr_kernel_generator_incref(m_kgen);
+  }
+
+  ~elwise_vm_expr_ck() { expr_kernel_generator_decref(m_kgen); }
+
+  void single(char *dst, char *const *src)
+  {
+    eval::evaluate_elwise_vm(m_kgen->get_program(), m_dst_tp, m_dst_arrmeta,
+                             dst, &m_src_tp[0], &m_src_arrmeta[0], src,
+                             &m_ectx);
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    std::copy(src, src + m_src_copy.size(), m_src_copy.begin());
+    for (size_t i = 0; i != count; ++i) {
+      single(dst, &m_src_copy[0]);
+      dst += dst_stride;
+      for (size_t j = 0; j != m_src_copy.size(); ++j) {
+        m_src_copy[j] += src_stride[j];
+      }
+    }
+  }
+};
+
+size_t elwise_vm_kernel_generator::make_expr_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, size_t src_count, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx) const
+{
+  if ((int)src_count != m_program.get_input_count()) {
+    stringstream ss;
+    ss << "The deferred elwise kernel requires "
+       << m_program.get_input_count() << " src operands, received "
+       << src_count;
+    throw runtime_error(ss.str());
+  }
+  elwise_vm_expr_ck::make(ckb, kernreq, ckb_offset, this, dst_tp, dst_arrmeta,
+                          src_count, src_tp, src_arrmeta, ectx);
+  return ckb_offset;
+}
+
+const elwise_vm_kernel_generator *get_elwise_vm_kgen(const nd::array &a)
+{
+  if (a.is_null() || a.get_type().get_type_id() != expr_type_id) {
+    return NULL;
+  }
+  return dynamic_cast<const elwise_vm_kernel_generator *>(
+      &a.get_type().extended<ndt::expr_type>()->get_kgen());
+}
+
+/**
+ * Makes a view of operand ``i`` of a deferred expression, dereferencing
+ * the pointer the expression holds to it.
+ */
+nd::array get_deferred_operand(const nd::array &a, intptr_t i)
+{
+  const ndt::tuple_type *fsd = a.get_type()
+                                   .extended<ndt::expr_type>()
+                                   ->get_operand_type()
+                                   .extended<ndt::tuple_type>();
+  const pointer_type_arrmeta *pmeta =
+      reinterpret_cast<const pointer_type_arrmeta *>(
+          a.get_arrmeta() + fsd->get_arrmeta_offsets_raw()[i]);
+  const ndt::type &tp =
+      fsd->get_field_type(i).extended<ndt::pointer_type>()->get_target_type();
+  const char *ptr = a.get_readonly_originptr() +
+                    fsd->get_data_offsets(a.get_arrmeta())[i];
+
+  nd::array result(make_array_memory_block(tp.get_arrmeta_size()));
+  result.get_ndo()->m_type = ndt::type(tp).release();
+  result.get_ndo()->m_data_pointer =
+      *reinterpret_cast<char *const *>(ptr) + pmeta->offset;
+  result.get_ndo()->m_data_reference = pmeta->blockref;
+  memory_block_incref(pmeta->blockref);
+  result.get_ndo()->m_flags = a.get_flags();
+  if (tp.get_arrmeta_size() > 0) {
+    tp.extended()->arrmeta_copy_construct(
+        result.get_arrmeta(), reinterpret_cast<const char *>(pmeta + 1),
+        pmeta->blockref);
+  }
+  return result;
+}
+
+// The dtypes which can be deferred, in the order of the C++ promotion
+// rules after the small integers are promoted to int
+int get_promotion_rank(type_id_t tid)
+{
+  switch (tid) {
+  case int8_type_id:
+  case int16_type_id:
+  case int32_type_id:
+    return 0;
+  case int64_type_id:
+    return 1;
+  case float32_type_id:
+    return 2;
+  case float64_type_id:
+    return 3;
+  default:
+    return -1;
+  }
+}
+
+const type_id_t promoted_type_ids[4] = {int32_type_id, int64_type_id,
+                                        float32_type_id, float64_type_id};
+
+} // anonymous namespace
+
+bool dynd::eval::is_deferred_elwise(const nd::array &a)
+{
+  return get_elwise_vm_kgen(a) != NULL;
+}
+
+nd::array dynd::eval::make_deferred_elwise(int opcode, intptr_t narg,
+                                           const nd::array *args)
+{
+  switch (opcode) {
+  case vm::opcode_add:
+  case vm::opcode_subtract:
+  case vm::opcode_multiply:
+  case vm::opcode_divide:
+  case vm::opcode_negate:
+    break;
+  default: {
+    stringstream ss;
+    ss << "Cannot make a deferred elwise expression with opcode " << opcode;
+    throw runtime_error(ss.str());
+  }
+  }
+  if (narg != vm::opcode_info[opcode].arity) {
+    stringstream ss;
+    ss << "The " << vm::opcode_info[opcode].name << " opcode requires "
+       << vm::opcode_info[opcode].arity << " arguments, but " << narg
+       << " were provided";
+    throw runtime_error(ss.str());
+  }
+
+  // Get the program of each deferred argument, and the promoted type
+  std::vector<const elwise_vm_kernel_generator *> kgens(narg);
+  std::vector<ndt::type> arg_tp(narg);
+  intptr_t ndim = 0;
+  int rank = 0;
+  for (intptr_t i = 0; i < narg; ++i) {
+    kgens[i] = get_elwise_vm_kgen(args[i]);
+    if (kgens[i] != NULL) {
+      arg_tp[i] = kgens[i]->get_program().get_register_types()[0];
+    } else if (args[i].get_type().get_strided_ndim() == args[i].get_ndim()) {
+      arg_tp[i] = args[i].get_dtype();
+    } else {
+      return nd::array();
+    }
+    int arg_rank = get_promotion_rank(arg_tp[i].get_type_id());
+    if (arg_rank < 0) {
+      return nd::array();
+    }
+    rank = max(rank, arg_rank);
+    ndim = max(ndim, args[i].get_ndim());
+  }
+  ndt::type result_tp(promoted_type_ids[rank]);
+
+  // Broadcast the argument shapes together
+  dimvector shape(ndim), arg_shape(ndim);
+  for (intptr_t j = 0; j < ndim; ++j) {
+    shape[j] = 1;
+  }
+  for (intptr_t i = 0; i < narg; ++i) {
+    args[i].get_shape(arg_shape.get());
+    incremental_broadcast(ndim, shape.get(), args[i].get_ndim(),
+                          arg_shape.get());
+  }
+
+  // The leaves of the new expression are the operands of the deferred
+  // arguments followed by the other arguments, each in argument order.
+  // Scalars are converted to the result type right away, so they don't
+  // need a conversion for every chunk.
+  std::vector<nd::array> leaves;
+  std::vector<ndt::type> regtypes(1, result_tp);
+  std::vector<intptr_t> input_begin(narg);
+  for (intptr_t i = 0; i < narg; ++i) {
+    input_begin[i] = leaves.size() + 1;
+    if (kgens[i] != NULL) {
+      const vm::elwise_program &ep = kgens[i]->get_program();
+      for (int k = 0; k < ep.get_input_count(); ++k) {
+        leaves.push_back(get_deferred_operand(args[i], k));
+        regtypes.push_back(ep.get_register_types()[k + 1]);
+      }
+    } else {
+      if (args[i].get_ndim() == 0 && arg_tp[i] != result_tp) {
+        leaves.push_back(args[i].ucast(result_tp).eval());
+      } else {
+        leaves.push_back(args[i]);
+      }
+      regtypes.push_back(result_tp);
+    }
+  }
+  int input_count = (int)leaves.size();
+  if (input_count < 2) {
+    // An expr type always has two or more operands
+    return nd::array();
+  }
+
+  // The temporaries of each deferred argument follow the inputs, then its
+  // output register, then a cast of its output to the result type if needed
+  std::vector<int> program, arg_reg(narg);
+  for (intptr_t i = 0; i < narg; ++i) {
+    if (kgens[i] == NULL) {
+      arg_reg[i] = (int)input_begin[i];
+      continue;
+    }
+    const vm::elwise_program &ep = kgens[i]->get_program();
+    const std::vector<ndt::type> &ep_regtypes = ep.get_register_types();
+    int ep_input_count = ep.get_input_count();
+    int temp_begin = (int)regtypes.size();
+    regtypes.insert(regtypes.end(), ep_regtypes.begin() + 1 + ep_input_count,
+                    ep_regtypes.end());
+    int output_reg = (int)regtypes.size();
+    regtypes.push_back(ep_regtypes[0]);
+    const std::vector<int> &ep_program = ep.get_program();
+    for (size_t ip = 0; ip < ep_program.size();) {
+      int arity = vm::opcode_info[ep_program[ip]].arity;
+      program.push_back(ep_program[ip]);
+      for (int k = 0; k < arity + 1; ++k) {
+        int r = ep_program[ip + 1 + k];
+        if (r == 0) {
+          r = output_reg;
+        } else if (r <= ep_input_count) {
+          r = (int)input_begin[i] + r - 1;
+        } else {
+          r = temp_begin + r - 1 - ep_input_count;
+        }
+        program.push_back(r);
+      }
+      ip += 2 + arity;
+    }
+    arg_reg[i] = output_reg;
+    if (ep_regtypes[0] != result_tp) {
+      arg_reg[i] = (int)regtypes.size();
+      regtypes.push_back(result_tp);
+      program.push_back(vm::opcode_cast);
+      program.push_back(arg_reg[i]);
+      program.push_back(output_reg);
+    }
+  }
+  program.push_back(opcode);
+  program.push_back(0);
+  program.insert(program.end(), arg_reg.begin(), arg_reg.end());
+  vm::elwise_program ep(input_count, regtypes, program);
+
+  // Because the expr type's operand is the result's type, we can swap it in
+  // as the type
+  nd::array result = nd::combine_into_tuple(leaves.size(), &leaves[0]);
+  ndt::type edt =
+      ndt::make_expr(ndt::make_type(ndim, shape.get(), result_tp),
+                     result.get_type(), new elwise_vm_kernel_generator(ep));
+  edt.swap(result.get_ndo()->m_type);
+  return result;
+}
@@ -4,8 +4,25 @@
 //
 
 #include <dynd/eval/eval_context.hpp>
+#include <dynd/kernels/ckernel_profile.hpp>
 
 using namespace std;
 using namespace dynd;
 
 eval::eval_context dynd::eval::default_eval_context;
+
+namespace {
+
+// Applies the environment variables to the default evaluation context. This
+// is separate from the definition above so that the context itself stays
+// constant initialized, and valid during any other static initialization.
+struct init_default_eval_context {
+  init_default_eval_context()
+  {
+    if (detail::profile_kernels_from_env()) {
+      eval::default_eval_context.profile_kernels = true;
+    }
+  }
+} init_default_eval_context_instance;
+
+} // anonymous namespace
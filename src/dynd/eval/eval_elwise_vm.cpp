@@ -3,25 +3,660 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
 #include <dynd/eval/eval_elwise_vm.hpp>
+#include <dynd/codegen/codegen_cache.hpp>
 #include <dynd/vm/register_allocation.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/shape_tools.hpp>
 
 using namespace std;
 using namespace dynd;
 
-nd::array dynd::eval::evaluate_elwise_vm(const vm::elwise_program& ep, std::vector<nd::array> DYND_UNUSED(inputs),
-                    const eval::eval_context *DYND_UNUSED(ectx))
+namespace {
+
+// The program runs over chunks of this many bytes of registers at a time, so
+// the temporaries of a chunk stay in the L1 cache between instructions
+const intptr_t vm_chunk_max_byte_count = 0x4000;
+const intptr_t vm_chunk_max_element_count = 0x1000;
+
+/**
+ * Runs one instruction over ``count`` elements. The output is always
+ * contiguous, while the arguments may be strided or broadcast.
+ */
+typedef void (*vm_loop_t)(char *dst, char *const *src,
+                          const intptr_t *src_stride, size_t count);
+
+struct vm_identity {
+  template <typename T>
+  static inline T apply(T a)
+  {
+    return a;
+  }
+};
+
+struct vm_negate {
+  template <typename T>
+  static inline T apply(T a)
+  {
+    return -a;
+  }
+};
+
+struct vm_abs {
+  template <typename T>
+  static inline T apply(T a)
+  {
+    return a < 0 ? -a : a;
+  }
+};
+
+#define DYND_VM_MATH_FUNC(NAME)                                                \
+  struct vm_##NAME {                                                           \
+    template <typename T>                                                      \
+    static inline T apply(T a)                                                 \
+    {                                                                          \
+      return std::NAME(a);                                                     \
+    }                                                                          \
+  };
+
+DYND_VM_MATH_FUNC(sqrt)
+DYND_VM_MATH_FUNC(exp)
+DYND_VM_MATH_FUNC(log)
+DYND_VM_MATH_FUNC(sin)
+DYND_VM_MATH_FUNC(cos)
+DYND_VM_MATH_FUNC(tan)
+DYND_VM_MATH_FUNC(floor)
+DYND_VM_MATH_FUNC(ceil)
+
+#undef DYND_VM_MATH_FUNC
+
+#define DYND_VM_BINARY_OP(NAME, EXPR)                                          \
+  struct vm_##NAME {                                                           \
+    template <typename T>                                                      \
+    static inline T apply(T a, T b)                                            \
+    {                                                                          \
+      return EXPR;                                                             \
+    }                                                                          \
+  };
+
+DYND_VM_BINARY_OP(add, a + b)
+DYND_VM_BINARY_OP(subtract, a - b)
+DYND_VM_BINARY_OP(multiply, a * b)
+DYND_VM_BINARY_OP(divide, a / b)
+DYND_VM_BINARY_OP(minimum, b < a ? b : a)
+DYND_VM_BINARY_OP(maximum, a < b ? b : a)
+DYND_VM_BINARY_OP(power, std::pow(a, b))
+
+#undef DYND_VM_BINARY_OP
+
+#define DYND_VM_COMPARISON_OP(NAME, OP)                                        \
+  struct vm_##NAME {                                                           \
+    template <typename T>                                                      \
+    static inline bool apply(T a, T b)                                         \
+    {                                                                          \
+      return a OP b;                                                           \
+    }                                                                          \
+  };
+
+DYND_VM_COMPARISON_OP(less, <)
+DYND_VM_COMPARISON_OP(less_equal, <=)
+DYND_VM_COMPARISON_OP(equal, ==)
+DYND_VM_COMPARISON_OP(not_equal, !=)
+DYND_VM_COMPARISON_OP(greater_equal, >=)
+DYND_VM_COMPARISON_OP(greater, >)
+
+#undef DYND_VM_COMPARISON_OP
+
+template <class Op, typename R, typename T>
+void unary_loop(char *dst, char *const *src, const intptr_t *src_stride,
+                size_t count)
 {
-    // Allocate contiguous registers for the VM
-    vm::register_allocation reg(ep.get_register_types(), 0x8000, 0x8000*16);
+  R *d = reinterpret_cast<R *>(dst);
+  const char *s0 = src[0];
+  intptr_t s0_stride = src_stride[0];
+  if (s0_stride == sizeof(T)) {
+    const T *a = reinterpret_cast<const T *>(s0);
+    for (size_t i = 0; i < count; ++i) {
+      d[i] = Op::apply(a[i]);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i, s0 += s0_stride) {
+      d[i] = Op::apply(*reinterpret_cast<const T *>(s0));
+    }
+  }
+}
+
+template <class Op, typename R, typename T>
+void binary_loop(char *dst, char *const *src, const intptr_t *src_stride,
+                 size_t count)
+{
+  R *d = reinterpret_cast<R *>(dst);
+  const char *s0 = src[0], *s1 = src[1];
+  intptr_t s0_stride = src_stride[0], s1_stride = src_stride[1];
+  if (s0_stride == sizeof(T) && s1_stride == sizeof(T)) {
+    const T *a = reinterpret_cast<const T *>(s0);
+    const T *b = reinterpret_cast<const T *>(s1);
+    for (size_t i = 0; i < count; ++i) {
+      d[i] = Op::apply(a[i], b[i]);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i, s0 += s0_stride, s1 += s1_stride) {
+      d[i] = Op::apply(*reinterpret_cast<const T *>(s0),
+                       *reinterpret_cast<const T *>(s1));
+    }
+  }
+}
+
+template <typename T>
+void select_loop(char *dst, char *const *src, const intptr_t *src_stride,
+                 size_t count)
+{
+  T *d = reinterpret_cast<T *>(dst);
+  const char *cond = src[0], *s1 = src[1], *s2 = src[2];
+  for (size_t i = 0; i < count; ++i) {
+    d[i] = *reinterpret_cast<const dynd_bool *>(cond)
+               ? *reinterpret_cast<const T *>(s1)
+               : *reinterpret_cast<const T *>(s2);
+    cond += src_stride[0];
+    s1 += src_stride[1];
+    s2 += src_stride[2];
+  }
+}
+
+// Copy and select only move values around, so they work by size
+struct vm_bytes16 {
+  uint64_t v[2];
+};
+
+template <typename T>
+vm_loop_t get_sized_loop(int opcode)
+{
+  return opcode == vm::opcode_copy ? &unary_loop<vm_identity, T, T>
+                                   : &select_loop<T>;
+}
+
+vm_loop_t get_sized_loop(int opcode, size_t data_size)
+{
+  switch (data_size) {
+  case 1:
+    return get_sized_loop<uint8_t>(opcode);
+  case 2:
+    return get_sized_loop<uint16_t>(opcode);
+  case 4:
+    return get_sized_loop<uint32_t>(opcode);
+  case 8:
+    return get_sized_loop<uint64_t>(opcode);
+  case 16:
+    return get_sized_loop<vm_bytes16>(opcode);
+  default:
+    return NULL;
+  }
+}
+
+template <typename T>
+vm_loop_t get_arithmetic_loop(int opcode)
+{
+  switch (opcode) {
+  case vm::opcode_add:
+    return &binary_loop<vm_add, T, T>;
+  case vm::opcode_subtract:
+    return &binary_loop<vm_subtract, T, T>;
+  case vm::opcode_multiply:
+    return &binary_loop<vm_multiply, T, T>;
+  case vm::opcode_divide:
+    return &binary_loop<vm_divide, T, T>;
+  case vm::opcode_negate:
+    return &unary_loop<vm_negate, T, T>;
+  case vm::opcode_minimum:
+    return &binary_loop<vm_minimum, T, T>;
+  case vm::opcode_maximum:
+    return &binary_loop<vm_maximum, T, T>;
+  case vm::opcode_less:
+    return &binary_loop<vm_less, dynd_bool, T>;
+  case vm::opcode_less_equal:
+    return &binary_loop<vm_less_equal, dynd_bool, T>;
+  case vm::opcode_equal:
+    return &binary_loop<vm_equal, dynd_bool, T>;
+  case vm::opcode_not_equal:
+    return &binary_loop<vm_not_equal, dynd_bool, T>;
+  case vm::opcode_greater_equal:
+    return &binary_loop<vm_greater_equal, dynd_bool, T>;
+  case vm::opcode_greater:
+    return &binary_loop<vm_greater, dynd_bool, T>;
+  case vm::opcode_abs:
+    return &unary_loop<vm_abs, T, T>;
+  default:
+    return NULL;
+  }
+}
 
-    // Determine the result broadcast shape
-    //int ndim;
-    //dimvector shape;
-    //broadcast_input_shapes(inputs, &ndim, &shape);
+template <typename T>
+vm_loop_t get_math_loop(int opcode)
+{
+  switch (opcode) {
+  case vm::opcode_sqrt:
+    return &unary_loop<vm_sqrt, T, T>;
+  case vm::opcode_exp:
+    return &unary_loop<vm_exp, T, T>;
+  case vm::opcode_log:
+    return &unary_loop<vm_log, T, T>;
+  case vm::opcode_sin:
+    return &unary_loop<vm_sin, T, T>;
+  case vm::opcode_cos:
+    return &unary_loop<vm_cos, T, T>;
+  case vm::opcode_tan:
+    return &unary_loop<vm_tan, T, T>;
+  case vm::opcode_floor:
+    return &unary_loop<vm_floor, T, T>;
+  case vm::opcode_ceil:
+    return &unary_loop<vm_ceil, T, T>;
+  case vm::opcode_power:
+    return &binary_loop<vm_power, T, T>;
+  default:
+    return get_arithmetic_loop<T>(opcode);
+  }
+}
+
+/**
+ * Returns the loop for an opcode on arguments of type ``tid``,
+ * or NULL if the opcode doesn't support that type.
+ */
+vm_loop_t get_numeric_loop(int opcode, type_id_t tid)
+{
+  switch (tid) {
+  case int8_type_id:
+    return get_arithmetic_loop<int8_t>(opcode);
+  case int16_type_id:
+    return get_arithmetic_loop<int16_t>(opcode);
+  case int32_type_id:
+    return get_arithmetic_loop<int32_t>(opcode);
+  case int64_type_id:
+    return get_arithmetic_loop<int64_t>(opcode);
+  case uint8_type_id:
+    return get_arithmetic_loop<uint8_t>(opcode);
+  case uint16_type_id:
+    return get_arithmetic_loop<uint16_t>(opcode);
+  case uint32_type_id:
+    return get_arithmetic_loop<uint32_t>(opcode);
+  case uint64_type_id:
+    return get_arithmetic_loop<uint64_t>(opcode);
+  case float32_type_id:
+    return get_math_loop<float>(opcode);
+  case float64_type_id:
+    return get_math_loop<double>(opcode);
+  default:
+    return NULL;
+  }
+}
+
+typedef std::unique_ptr<ckernel_builder<kernel_request_host>> vm_ckb_ptr;
+
+/**
+ * Builds a strided assignment ckernel, used for casts and for converting
+ * inputs whose type differs from their register.
+ */
+vm_ckb_ptr make_vm_assignment(const ndt::type &dst_tp, const ndt::type &src_tp,
+                              const char *src_arrmeta,
+                              const eval::eval_context *ectx)
+{
+  vm_ckb_ptr ckb(new ckernel_builder<kernel_request_host>());
+  make_assignment_kernel(NULL, NULL, ckb.get(), 0, dst_tp, NULL, src_tp,
+                         src_arrmeta, kernel_request_strided, ectx,
+                         nd::array());
+  return ckb;
+}
+
+struct vm_instruction {
+  int opcode, arity;
+  int dst, src[3];
+  // Either a loop, or the ckernel of a cast
+  vm_loop_t loop;
+  vm_ckb_ptr ckb;
+};
+
+/**
+ * Checks the register types of every instruction, and picks the loop or
+ * the ckernel which executes it.
+ */
+void compile_elwise_program(const vm::elwise_program &ep,
+                            const eval::eval_context *ectx,
+                            std::vector<vm_instruction> &out_instructions)
+{
+  const std::vector<ndt::type> &regtypes = ep.get_register_types();
+  const std::vector<int> &program = ep.get_program();
+  out_instructions.resize(ep.get_instruction_count());
+  for (size_t ip = 0, j = 0; ip < program.size(); ++j) {
+    vm_instruction &instr = out_instructions[j];
+    instr.opcode = program[ip];
+    instr.arity = vm::opcode_info[instr.opcode].arity;
+    instr.dst = program[ip + 1];
+    for (int k = 0; k < instr.arity; ++k) {
+      instr.src[k] = program[ip + 2 + k];
+    }
+    instr.loop = NULL;
+
+    const ndt::type &dst_tp = regtypes[instr.dst];
+    const ndt::type &src0_tp = regtypes[instr.src[0]];
+    bool args_match = true;
+    for (int k = 1; k < instr.arity; ++k) {
+      args_match = args_match && regtypes[instr.src[k]] == src0_tp;
+    }
+    switch (instr.opcode) {
+    case vm::opcode_copy:
+      if (dst_tp == src0_tp) {
+        instr.loop = get_sized_loop(instr.opcode, dst_tp.get_data_size());
+      }
+      break;
+    case vm::opcode_select:
+      if (src0_tp.get_type_id() == bool_type_id &&
+          regtypes[instr.src[1]] == dst_tp &&
+          regtypes[instr.src[2]] == dst_tp) {
+        instr.loop = get_sized_loop(instr.opcode, dst_tp.get_data_size());
+      }
+      break;
+    case vm::opcode_cast:
+      instr.ckb = make_vm_assignment(dst_tp, src0_tp, NULL, ectx);
+      break;
+    case vm::opcode_less:
+    case vm::opcode_less_equal:
+    case vm::opcode_equal:
+    case vm::opcode_not_equal:
+    case vm::opcode_greater_equal:
+    case vm::opcode_greater:
+      if (args_match && dst_tp.get_type_id() == bool_type_id) {
+        instr.loop = get_numeric_loop(instr.opcode, src0_tp.get_type_id());
+      }
+      break;
+    default:
+      if (args_match && dst_tp == src0_tp) {
+        instr.loop = get_numeric_loop(instr.opcode, src0_tp.get_type_id());
+      }
+      break;
+    }
+
+    if (instr.loop == NULL && !instr.ckb) {
+      stringstream ss;
+      ss << "DyND VM program opcode " << vm::opcode_info[instr.opcode].name
+         << " at position " << ip << " does not support the register types ("
+         << dst_tp;
+      for (int k = 0; k < instr.arity; ++k) {
+        ss << ", " << regtypes[instr.src[k]];
+      }
+      ss << ")";
+      throw type_error(ss.str());
+    }
+
+    ip += 2 + instr.arity;
+  }
+}
+
+} // anonymous namespace
+
+void dynd::eval::evaluate_elwise_vm(const vm::elwise_program &ep,
+                                    const ndt::type &dst_tp,
+                                    const char *dst_arrmeta, char *dst_data,
+                                    const ndt::type *src_tp,
+                                    const char *const *src_arrmeta,
+                                    char *const *src_data,
+                                    const eval::eval_context *ectx)
+{
+  const std::vector<ndt::type> &regtypes = ep.get_register_types();
+  intptr_t nregs = regtypes.size();
+  intptr_t ninputs = ep.get_input_count();
+  for (intptr_t i = 0; i < nregs; ++i) {
+    if (!regtypes[i].is_builtin()) {
+      stringstream ss;
+      ss << "DyND VM register " << i << " has type " << regtypes[i]
+         << ", but registers must have builtin types";
+      throw type_error(ss.str());
+    }
+  }
+  std::vector<vm_instruction> instructions;
+  compile_elwise_program(ep, ectx, instructions);
+
+  intptr_t ndim = dst_tp.get_ndim();
+  if (dst_tp.get_strided_ndim() != ndim || dst_tp.get_dtype() != regtypes[0]) {
+    stringstream ss;
+    ss << "DyND VM output must have strided dimensions of " << regtypes[0]
+       << ", got " << dst_tp;
+    throw type_error(ss.str());
+  }
+  dimvector shape(ndim);
+  // The data and the strides of the operands, [<result>, <input1>, ...]
+  intptr_t nops = ninputs + 1;
+  std::vector<char *> data(nops);
+  std::vector<intptr_t> strides(nops * ndim);
+  data[0] = dst_data;
+  if (ndim > 0) {
+    dst_tp.extended()->get_shape(ndim, 0, shape.get(), dst_arrmeta, NULL);
+    dst_tp.extended()->get_strides(0, &strides[0], dst_arrmeta);
+  }
+  std::vector<const char *> input_arrmeta(ninputs);
+  for (intptr_t i = 0; i < ninputs; ++i) {
+    const ndt::type &tp = src_tp[i];
+    intptr_t input_ndim = tp.get_ndim();
+    if (tp.get_strided_ndim() != input_ndim) {
+      stringstream ss;
+      ss << "DyND VM inputs must have strided dimensions, got " << tp;
+      throw type_error(ss.str());
+    }
+    data[i + 1] = src_data[i];
+    if (input_ndim > 0) {
+      dimvector input_shape(input_ndim), input_strides(input_ndim);
+      tp.extended()->get_shape(input_ndim, 0, input_shape.get(),
+                               src_arrmeta[i], NULL);
+      tp.extended()->get_strides(0, input_strides.get(), src_arrmeta[i]);
+      broadcast_to_shape(ndim, shape.get(), input_ndim, input_shape.get(),
+                         input_strides.get(), &strides[(i + 1) * ndim]);
+    } else {
+      for (intptr_t j = 0; j < ndim; ++j) {
+        strides[(i + 1) * ndim + j] = 0;
+      }
+    }
+  }
+
+  // Drop size one dimensions and merge dimensions which are contiguous
+  // with the next one for every operand, so the inner loop is as long
+  // as possible
+  intptr_t cdim = 0;
+  for (intptr_t j = 0; j < ndim; ++j) {
+    if (shape[j] == 0) {
+      return;
+    } else if (shape[j] == 1) {
+      continue;
+    }
+    bool merge = cdim > 0;
+    for (intptr_t op = 0; op < nops && merge; ++op) {
+      merge = strides[op * ndim + cdim - 1] ==
+              strides[op * ndim + j] * shape[j];
+    }
+    if (merge) {
+      shape[cdim - 1] *= shape[j];
+    } else {
+      shape[cdim++] = shape[j];
+    }
+    for (intptr_t op = 0; op < nops; ++op) {
+      strides[op * ndim + cdim - 1] = strides[op * ndim + j];
+    }
+  }
+  intptr_t inner_size = cdim > 0 ? shape[cdim - 1] : 1;
+  intptr_t outer_count = 1;
+  for (intptr_t j = 0; j + 1 < cdim; ++j) {
+    outer_count *= shape[j];
+  }
+
+  // Allocate contiguous registers for the VM
+  vm::register_allocation reg(regtypes, vm_chunk_max_element_count,
+                              vm_chunk_max_byte_count);
+  intptr_t chunk_size = reg.get_element_count();
+
+  // Where each register is read from. Inputs which have the type of their
+  // register are read in place, the others are converted into the register
+  // one chunk at a time.
+  std::vector<char *> reg_data(reg.get_registers());
+  std::vector<intptr_t> reg_stride(nregs), inner_stride(nops, 0);
+  for (intptr_t i = 0; i < nregs; ++i) {
+    reg_stride[i] = regtypes[i].get_data_size();
+  }
+  for (intptr_t op = 0; op < nops && cdim > 0; ++op) {
+    inner_stride[op] = strides[op * ndim + cdim - 1];
+  }
+  std::vector<vm_ckb_ptr> input_ckb(ninputs);
+  bool inputs_in_place = true;
+  for (intptr_t i = 0; i < ninputs; ++i) {
+    char *arrmeta = const_cast<char *>(src_arrmeta[i]);
+    ndt::type dtp =
+        src_tp[i].get_type_at_dimension(&arrmeta, src_tp[i].get_ndim());
+    if (dtp == regtypes[i + 1]) {
+      reg_stride[i + 1] = inner_stride[i + 1];
+    } else {
+      input_ckb[i] = make_vm_assignment(regtypes[i + 1], dtp, arrmeta, ectx);
+      inputs_in_place = false;
+    }
+  }
+  // The instruction loops write the output contiguously, so an output
+  // with a different inner stride goes through its register
+  bool output_in_place = inner_stride[0] == reg_stride[0] || inner_size == 1;
+  size_t output_size = reg_stride[0];
+
+  // When every input is read in place, a generated loop can run the whole
+  // inner dimension with the registers kept in machine registers
+  expr_strided_t jit_loop = NULL;
+  if (inputs_in_place) {
+    jit_loop = codegen_cache::get().codegen_elwise_program(ep);
+  }
+
+  std::vector<char *> origin(nops);
+  dimvector index(cdim);
+  for (intptr_t j = 0; j < cdim; ++j) {
+    index[j] = 0;
+  }
+  for (intptr_t outer = 0; outer < outer_count; ++outer) {
+    for (intptr_t op = 0; op < nops; ++op) {
+      origin[op] = data[op];
+      for (intptr_t j = 0; j + 1 < cdim; ++j) {
+        origin[op] += index[j] * strides[op * ndim + j];
+      }
+    }
+
+    if (jit_loop != NULL) {
+      jit_loop(origin[0], inner_stride[0], ninputs > 0 ? &origin[1] : NULL,
+               ninputs > 0 ? &inner_stride[1] : NULL, inner_size, NULL);
+    } else {
+      for (intptr_t chunk_begin = 0; chunk_begin < inner_size;
+           chunk_begin += chunk_size) {
+        size_t count = min(chunk_size, inner_size - chunk_begin);
+        char *dst = origin[0] + chunk_begin * inner_stride[0];
+        if (output_in_place) {
+          reg_data[0] = dst;
+        }
+        for (intptr_t i = 0; i < ninputs; ++i) {
+          char *src = origin[i + 1] + chunk_begin * inner_stride[i + 1];
+          if (input_ckb[i]) {
+            ckernel_prefix *ck = input_ckb[i]->get();
+            ck->get_function<expr_strided_t>()(reg_data[i + 1],
+                                               reg_stride[i + 1], &src,
+                                               &inner_stride[i + 1], count, ck);
+          } else {
+            reg_data[i + 1] = src;
+          }
+        }
+
+        for (size_t ip = 0; ip < instructions.size(); ++ip) {
+          const vm_instruction &instr = instructions[ip];
+          char *src[3];
+          intptr_t src_stride[3];
+          for (int k = 0; k < instr.arity; ++k) {
+            src[k] = reg_data[instr.src[k]];
+            src_stride[k] = reg_stride[instr.src[k]];
+          }
+          if (instr.loop != NULL) {
+            instr.loop(reg_data[instr.dst], src, src_stride, count);
+          } else {
+            ckernel_prefix *ck = instr.ckb->get();
+            ck->get_function<expr_strided_t>()(reg_data[instr.dst],
+                                               reg_stride[instr.dst], src,
+                                               src_stride, count, ck);
+          }
+        }
+
+        if (!output_in_place) {
+          for (size_t i = 0; i < count; ++i) {
+            memcpy(dst + i * inner_stride[0], reg_data[0] + i * output_size,
+                   output_size);
+          }
+        }
+      }
+    }
+
+    // Advance to the next inner dimension
+    for (intptr_t j = cdim - 2; j >= 0; --j) {
+      if (++index[j] < shape[j]) {
+        break;
+      }
+      index[j] = 0;
+    }
+  }
+}
+
+nd::array dynd::eval::evaluate_elwise_vm(const vm::elwise_program &ep,
+                                         std::vector<nd::array> inputs,
+                                         const eval::eval_context *ectx)
+{
+  const std::vector<ndt::type> &regtypes = ep.get_register_types();
+  intptr_t ninputs = ep.get_input_count();
+  if ((intptr_t)inputs.size() != ninputs) {
+    stringstream ss;
+    ss << "DyND VM program requires " << ninputs << " inputs, but "
+       << inputs.size() << " were provided";
+    throw runtime_error(ss.str());
+  }
 
+  // Determine the result broadcast shape
+  intptr_t ndim = 0;
+  for (intptr_t i = 0; i < ninputs; ++i) {
+    const nd::array &a = inputs[i];
+    if (a.get_type().get_strided_ndim() != a.get_ndim()) {
+      stringstream ss;
+      ss << "DyND VM inputs must have strided dimensions, got " << a.get_type();
+      throw type_error(ss.str());
+    }
+    ndim = max(ndim, a.get_ndim());
+  }
+  dimvector shape(ndim), input_shape(ndim);
+  for (intptr_t j = 0; j < ndim; ++j) {
+    shape[j] = 1;
+  }
+  std::vector<ndt::type> src_tp(ninputs);
+  std::vector<const char *> src_arrmeta(ninputs);
+  std::vector<char *> src_data(ninputs);
+  for (intptr_t i = 0; i < ninputs; ++i) {
+    inputs[i].get_shape(input_shape.get());
+    incremental_broadcast(ndim, shape.get(), inputs[i].get_ndim(),
+                          input_shape.get());
+    src_tp[i] = inputs[i].get_type();
+    src_arrmeta[i] = inputs[i].get_arrmeta();
+    src_data[i] = const_cast<char *>(inputs[i].get_readonly_originptr());
+  }
+  if (!regtypes.empty() && !regtypes[0].is_builtin()) {
+    stringstream ss;
+    ss << "DyND VM register 0 has type " << regtypes[0]
+       << ", but registers must have builtin types";
+    throw type_error(ss.str());
+  }
 
-    
-    return nd::array();
+  nd::array result = nd::dtyped_empty(ndim, shape.get(), regtypes[0]);
+  evaluate_elwise_vm(ep, result.get_type(), result.get_arrmeta(),
+                     result.get_readwrite_originptr(),
+                     ninputs > 0 ? &src_tp[0] : NULL,
+                     ninputs > 0 ? &src_arrmeta[0] : NULL,
+                     ninputs > 0 ? &src_data[0] : NULL, ectx);
+  return result;
 }
@@ -8,10 +8,41 @@
 #include <dynd/func/elwise.hpp>
 #include <dynd/func/call.hpp>
 #include <dynd/kernels/arithmetic.hpp>
+#include <dynd/eval/deferred_elwise_eval.hpp>
 #include <array>
 
 using namespace dynd;
 
+namespace {
+
+/**
+ * Builds a deferred expression for one of the arithmetic operators if
+ * deferred evaluation is enabled or an argument is already deferred. When
+ * the arguments can't be deferred, any deferred ones are evaluated in place
+ * for the eager arrfunc, and a NULL array is returned.
+ */
+nd::array defer_elwise(int opcode, intptr_t narg, nd::array *args)
+{
+  bool defer = eval::default_eval_context.deferred_elwise;
+  for (intptr_t i = 0; i < narg && !defer; ++i) {
+    defer = eval::is_deferred_elwise(args[i]);
+  }
+  if (defer) {
+    nd::array result = eval::make_deferred_elwise(opcode, narg, args);
+    if (!result.is_null()) {
+      return result;
+    }
+    for (intptr_t i = 0; i < narg; ++i) {
+      if (eval::is_deferred_elwise(args[i])) {
+        args[i] = args[i].eval();
+      }
+    }
+  }
+  return nd::array();
+}
+
+} // anonymous namespace
+
 nd::arrfunc nd::plus::children[DYND_TYPE_ID_MAX + 1];
 nd::arrfunc nd::plus::default_child;
 
@@ -26,7 +57,14 @@ nd::arrfunc nd::plus::make()
 
 struct nd::plus nd::plus;
 
-nd::array nd::operator+(const nd::array &a0) { return nd::plus(a0); }
+nd::array nd::operator+(const nd::array &a0)
+{
+  // A deferred expression already has a promoted type
+  if (eval::is_deferred_elwise(a0)) {
+    return a0;
+  }
+  return nd::plus(a0);
+}
 
 nd::arrfunc nd::minus::children[DYND_TYPE_ID_MAX + 1];
 nd::arrfunc nd::minus::default_child;
@@ -54,7 +92,15 @@ nd::arrfunc nd::minus::make()
 
 struct nd::minus nd::minus;
 
-nd::array nd::operator-(const nd::array &a0) { return nd::minus(a0); }
+nd::array nd::operator-(const nd::array &a0)
+{
+  nd::array args[1] = {a0};
+  nd::array result = defer_elwise(vm::opcode_negate, 1, args);
+  if (!result.is_null()) {
+    return result;
+  }
+  return nd::minus(args[0]);
+}
 
 nd::arrfunc nd::add::children[DYND_TYPE_ID_MAX + 1][DYND_TYPE_ID_MAX + 1];
 nd::arrfunc nd::add::default_child;
@@ -70,7 +116,12 @@ struct nd::add nd::add;
 
 nd::array nd::operator+(const nd::array &a0, const nd::array &a1)
 {
-  return nd::add(a0, a1);
+  nd::array args[2] = {a0, a1};
+  nd::array result = defer_elwise(vm::opcode_add, 2, args);
+  if (!result.is_null()) {
+    return result;
+  }
+  return nd::add(args[0], args[1]);
 }
 
 nd::arrfunc nd::subtract::make()
@@ -86,7 +137,12 @@ struct nd::subtract nd::subtract;
 
 nd::array nd::operator-(const nd::array &a0, const nd::array &a1)
 {
-  return nd::subtract(a0, a1);
+  nd::array args[2] = {a0, a1};
+  nd::array result = defer_elwise(vm::opcode_subtract, 2, args);
+  if (!result.is_null()) {
+    return result;
+  }
+  return nd::subtract(args[0], args[1]);
 }
 
 nd::arrfunc nd::multiply::make()
@@ -102,7 +158,12 @@ struct nd::multiply nd::multiply;
 
 nd::array nd::operator*(const nd::array &a0, const nd::array &a1)
 {
-  return nd::multiply(a0, a1);
+  nd::array args[2] = {a0, a1};
+  nd::array result = defer_elwise(vm::opcode_multiply, 2, args);
+  if (!result.is_null()) {
+    return result;
+  }
+  return nd::multiply(args[0], args[1]);
 }
 
 nd::arrfunc nd::divide::make()
@@ -118,5 +179,10 @@ struct nd::divide nd::divide;
 
 nd::array nd::operator/(const nd::array &a0, const nd::array &a1)
 {
-  return nd::divide(a0, a1);
+  nd::array args[2] = {a0, a1};
+  nd::array result = defer_elwise(vm::opcode_divide, 2, args);
+  if (!result.is_null()) {
+    return result;
+  }
+  return nd::divide(args[0], args[1]);
 }
\ No newline at end of file
@@ -3,9 +3,14 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
+#include <list>
+#include <mutex>
+
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
+#include <dynd/kernels/ckernel_profile.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/base_virtual_kernel.hpp>
 #include <dynd/types/expr_type.hpp>
@@ -248,4 +253,524 @@ nd::arrfunc::arrfunc(const nd::array &rhs)
       throw type_error(ss.str());
     }
   }
-}
\ No newline at end of file
+}
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    /**
+     * A ckernel instantiated from an arrfunc, along with copies of
+     * everything it was instantiated against. Kernels may hold on to the
+     * arrmeta, keyword arguments and eval context they were given, so
+     * those all live here for as long as the ckernel does.
+     */
+    struct bound_kernel {
+      // Keeps the arrfunc alive, and identifies it in the cache
+      array af;
+      size_t hash;
+      ndt::type dst_tp;
+      std::vector<char> dst_arrmeta;
+      std::vector<ndt::type> src_tp;
+      std::vector<std::vector<char>> src_arrmeta;
+      std::vector<const char *> src_arrmeta_ptrs;
+      // The keyword arguments as passed, before option resolution
+      std::vector<char> kwds_key;
+      array kwds;
+      std::unique_ptr<char[]> data;
+      std::map<nd::string, ndt::type> tp_vars;
+      eval::eval_context ectx;
+      ckernel_builder<kernel_request_host> ckb;
+      // Set while the cache has handed this kernel out to a call
+      bool in_use;
+
+      bound_kernel() : hash(0), in_use(false) {}
+
+      void run(char *dst, char *const *src)
+      {
+        expr_single_t fn = ckb.get()->get_function<expr_single_t>();
+        fn(dst, src, ckb.get());
+      }
+    };
+
+  } // namespace dynd::nd::detail
+} // namespace dynd::nd
+} // namespace dynd
+
+namespace {
+
+// Types whose arrmeta or data refer to other memory can't be captured
+// as plain bytes, so calls involving them are never cached
+const uint32_t uncacheable_type_flags =
+    type_flag_blockref | type_flag_destructor | type_flag_not_host_readable |
+    type_flag_symbolic;
+
+bool is_cacheable_type(const ndt::type &tp)
+{
+  return tp.is_builtin() || (tp.get_flags() & uncacheable_type_flags) == 0;
+}
+
+size_t hash_bytes(size_t h, const char *data, size_t size)
+{
+  // FNV-1a
+  for (size_t i = 0; i < size; ++i) {
+    h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+  }
+  return h;
+}
+
+// The keyword arguments are always laid out with the default data offsets
+size_t hash_call(const arrfunc_type_data *self, intptr_t narg,
+                 const ndt::type *arg_tp, const char *const *arg_arrmeta,
+                 const nd::array &kwds)
+{
+  size_t h = static_cast<size_t>(14695981039346656037ULL);
+  h = hash_bytes(h, reinterpret_cast<const char *>(&self), sizeof(self));
+  for (intptr_t i = 0; i < narg; ++i) {
+    type_id_t tid = arg_tp[i].get_type_id();
+    h = hash_bytes(h, reinterpret_cast<const char *>(&tid), sizeof(tid));
+    h = hash_bytes(h, arg_arrmeta[i], arg_tp[i].get_arrmeta_size());
+  }
+  h = hash_bytes(h, kwds.get_readonly_originptr(),
+                 kwds.get_type().get_default_data_size());
+  return h;
+}
+
+bool same_settings(const eval::eval_context &lhs,
+                   const eval::eval_context &rhs)
+{
+  return assign_error_mode(lhs.errmode) == assign_error_mode(rhs.errmode) &&
+         assign_error_mode(lhs.cuda_device_errmode) ==
+             assign_error_mode(rhs.cuda_device_errmode) &&
+         date_parse_order_t(lhs.date_parse_order) ==
+             date_parse_order_t(rhs.date_parse_order) &&
+         int(lhs.century_window) == int(rhs.century_window) &&
+         intptr_t(lhs.nthreads) == intptr_t(rhs.nthreads) &&
+         intptr_t(lhs.parallel_grain_size) ==
+             intptr_t(rhs.parallel_grain_size);
+}
+
+bool matches_call(const nd::detail::bound_kernel &bk,
+                  const arrfunc_type_data *self, size_t hash, intptr_t narg,
+                  const ndt::type *arg_tp, const char *const *arg_arrmeta,
+                  const nd::array &kwds, const eval::eval_context *ectx)
+{
+  if (bk.hash != hash || bk.af.get_readonly_originptr() !=
+                             reinterpret_cast<const char *>(self) ||
+      intptr_t(bk.src_tp.size()) != narg) {
+    return false;
+  }
+  for (intptr_t i = 0; i < narg; ++i) {
+    if (bk.src_tp[i] != arg_tp[i] ||
+        (!bk.src_arrmeta[i].empty() &&
+         memcmp(bk.src_arrmeta[i].data(), arg_arrmeta[i],
+                bk.src_arrmeta[i].size()) != 0)) {
+      return false;
+    }
+  }
+  size_t kwds_size = kwds.get_type().get_default_data_size();
+  if (bk.kwds.get_type() != kwds.get_type() ||
+      bk.kwds_key.size() != kwds_size ||
+      (kwds_size != 0 && memcmp(bk.kwds_key.data(),
+                                kwds.get_readonly_originptr(), kwds_size) != 0)) {
+    return false;
+  }
+  return same_settings(bk.ectx, *ectx);
+}
+
+/**
+ * A small most-recently-used cache of instantiated ckernels. A kernel is
+ * handed out to one call at a time, since ckernels may keep state between
+ * calls and are not reentrant.
+ */
+class kernel_cache {
+  std::mutex m_mutex;
+  std::list<std::shared_ptr<nd::detail::bound_kernel>> m_entries;
+  intptr_t m_hits;
+
+public:
+  kernel_cache() : m_hits(0) {}
+
+  std::shared_ptr<nd::detail::bound_kernel>
+  checkout(const arrfunc_type_data *self, size_t hash, intptr_t narg,
+           const ndt::type *arg_tp, const char *const *arg_arrmeta,
+           const nd::array &kwds, const eval::eval_context *ectx)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+      nd::detail::bound_kernel &bk = **it;
+      if (!bk.in_use &&
+          matches_call(bk, self, hash, narg, arg_tp, arg_arrmeta, kwds, ectx)) {
+        bk.in_use = true;
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return m_entries.front();
+      }
+    }
+    return std::shared_ptr<nd::detail::bound_kernel>();
+  }
+
+  void checkin(const std::shared_ptr<nd::detail::bound_kernel> &bk)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    bk->in_use = false;
+  }
+
+  void insert(const std::shared_ptr<nd::detail::bound_kernel> &bk,
+              intptr_t capacity)
+  {
+    std::list<std::shared_ptr<nd::detail::bound_kernel>> evicted;
+    lock_guard<mutex> lock(m_mutex);
+    bk->in_use = true;
+    m_entries.push_front(bk);
+    while (intptr_t(m_entries.size()) > capacity) {
+      // Kernels still in use stay alive through the caller's reference
+      evicted.splice(evicted.begin(), m_entries, --m_entries.end());
+    }
+  }
+
+  void clear()
+  {
+    std::list<std::shared_ptr<nd::detail::bound_kernel>> evicted;
+    lock_guard<mutex> lock(m_mutex);
+    evicted.swap(m_entries);
+    m_hits = 0;
+  }
+
+  intptr_t size()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    return m_entries.size();
+  }
+
+  intptr_t hits()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    return m_hits;
+  }
+
+  static kernel_cache &get()
+  {
+    static kernel_cache cache;
+    return cache;
+  }
+};
+
+/** Returns a cached kernel to the cache when the call is done with it */
+struct kernel_cache_checkout {
+  std::shared_ptr<nd::detail::bound_kernel> bk;
+
+  ~kernel_cache_checkout()
+  {
+    if (bk) {
+      kernel_cache::get().checkin(bk);
+    }
+  }
+};
+
+/**
+ * Resolves the destination type of a call, creating the destination array
+ * if ``dst`` is NULL.
+ */
+ndt::type resolve_dst(const arrfunc_type_data *self,
+                      const ndt::arrfunc_type *self_tp, char *data,
+                      nd::array &dst, const std::vector<ndt::type> &arg_tp,
+                      const nd::array &kwds_as_array,
+                      const std::map<nd::string, ndt::type> &tp_vars)
+{
+  ndt::type dst_tp;
+  if (dst.is_null()) {
+    // Resolve the destination type
+    if (self->resolve_dst_type != NULL) {
+      self->resolve_dst_type(self, self_tp, data, dst_tp, arg_tp.size(),
+                             arg_tp.empty() ? NULL : arg_tp.data(),
+                             kwds_as_array, tp_vars);
+    } else {
+      dst_tp = ndt::substitute(self_tp->get_return_type(), tp_vars, true);
+    }
+
+    dst = nd::empty(dst_tp);
+  } else if (self->resolve_dst_type != NULL) {
+    // In this case, with dst_tp already populated, resolve_dst_type
+    // must not overwrite it
+    dst_tp = dst.get_type();
+    self->resolve_dst_type(self, self_tp, data, dst_tp, arg_tp.size(),
+                           arg_tp.empty() ? NULL : arg_tp.data(),
+                           kwds_as_array, tp_vars);
+    // Sanity error check against rogue resolve_test_type
+    if (dst_tp.extended() != dst.get_type().extended()) {
+      std::stringstream ss;
+      ss << "Arrfunc internal error: resolve_dst_type modified a dst_tp "
+            "provided for output, transforming " << dst.get_type()
+         << " into " << dst_tp;
+      throw std::runtime_error(ss.str());
+    }
+  } else {
+    dst_tp = dst.get_type();
+  }
+
+  return dst_tp;
+}
+
+/**
+ * Instantiates a ckernel into a new bound_kernel, which owns copies of the
+ * argument arrmeta and keyword arguments. The destination array is created
+ * into ``dst``.
+ */
+std::shared_ptr<nd::detail::bound_kernel>
+make_bound_kernel(const nd::arrfunc &af, size_t hash, nd::array &dst,
+                  const std::vector<ndt::type> &arg_tp,
+                  const std::vector<const char *> &arg_arrmeta,
+                  const nd::array &kwds_as_array,
+                  const std::map<nd::string, ndt::type> &tp_vars,
+                  const eval::eval_context *ectx)
+{
+  const arrfunc_type_data *self = af.get();
+  const ndt::arrfunc_type *self_tp = af.get_type();
+  intptr_t narg = arg_tp.size();
+
+  std::shared_ptr<nd::detail::bound_kernel> bk =
+      std::make_shared<nd::detail::bound_kernel>();
+  bk->af = af;
+  bk->hash = hash;
+  bk->src_tp = arg_tp;
+  bk->src_arrmeta.resize(narg);
+  bk->src_arrmeta_ptrs.resize(narg);
+  for (intptr_t i = 0; i < narg; ++i) {
+    bk->src_arrmeta[i].assign(arg_arrmeta[i],
+                              arg_arrmeta[i] + arg_tp[i].get_arrmeta_size());
+    bk->src_arrmeta_ptrs[i] = bk->src_arrmeta[i].data();
+  }
+  bk->kwds_key.assign(kwds_as_array.get_readonly_originptr(),
+                      kwds_as_array.get_readonly_originptr() +
+                          kwds_as_array.get_type().get_default_data_size());
+  bk->kwds = kwds_as_array;
+  bk->tp_vars = tp_vars;
+  bk->ectx = *ectx;
+  bk->data.reset(new char[self->data_size]);
+
+  // Resolve the optional keyword arguments
+  if (self->resolve_option_values != NULL) {
+    self->resolve_option_values(self, self_tp, bk->data.get(), narg,
+                                arg_tp.empty() ? NULL : arg_tp.data(),
+                                bk->kwds, bk->tp_vars);
+  }
+
+  bk->dst_tp = resolve_dst(self, self_tp, bk->data.get(), dst, arg_tp,
+                           bk->kwds, bk->tp_vars);
+  bk->dst_arrmeta.assign(dst.get_arrmeta(),
+                         dst.get_arrmeta() + bk->dst_tp.get_arrmeta_size());
+
+  self->instantiate(self, self_tp, bk->data.get(), &bk->ckb, 0, bk->dst_tp,
+                    bk->dst_arrmeta.data(), narg,
+                    arg_tp.empty() ? NULL : bk->src_tp.data(),
+                    arg_tp.empty() ? NULL : bk->src_arrmeta_ptrs.data(),
+                    kernel_request_single, &bk->ectx, bk->kwds, bk->tp_vars);
+
+  return bk;
+}
+
+bool same_arrmeta(const std::vector<char> &arrmeta, const char *other)
+{
+  return arrmeta.empty() ||
+         memcmp(arrmeta.data(), other, arrmeta.size()) == 0;
+}
+
+} // anonymous namespace
+
+nd::array nd::arrfunc::call_validated(
+    array &dst, const std::vector<ndt::type> &arg_tp,
+    const std::vector<const char *> &arg_arrmeta,
+    const std::vector<char *> &arg_data, array &kwds_as_array,
+    std::map<nd::string, ndt::type> &tp_vars) const
+{
+  const arrfunc_type_data *self = get();
+  const ndt::arrfunc_type *self_tp = get_type();
+  const eval::eval_context *ectx = &eval::default_eval_context;
+  intptr_t narg = arg_tp.size();
+
+  // Calls which only involve plain types, and which don't write into a
+  // provided destination, can reuse a previously instantiated ckernel.
+  // Profiled calls always instantiate a new one to instrument.
+  intptr_t cache_size = ectx->kernel_cache_size;
+  bool cacheable = cache_size > 0 && !ectx->profile_kernels && dst.is_null() &&
+                   is_cacheable_type(kwds_as_array.get_type());
+  for (intptr_t i = 0; cacheable && i < narg; ++i) {
+    cacheable = is_cacheable_type(arg_tp[i]);
+  }
+
+  if (cacheable) {
+    size_t hash = hash_call(self, narg, arg_tp.data(), arg_arrmeta.data(),
+                            kwds_as_array);
+    kernel_cache_checkout checkout;
+    checkout.bk = kernel_cache::get().checkout(
+        self, hash, narg, arg_tp.data(), arg_arrmeta.data(), kwds_as_array,
+        ectx);
+    if (checkout.bk) {
+      dst = empty(checkout.bk->dst_tp);
+      if (same_arrmeta(checkout.bk->dst_arrmeta, dst.get_arrmeta())) {
+        checkout.bk->run(dst.get_readwrite_originptr(),
+                         arg_data.empty() ? NULL : const_cast<char *const *>(
+                                                       arg_data.data()));
+        return dst;
+      }
+      dst = array();
+    } else {
+      std::shared_ptr<detail::bound_kernel> bk =
+          make_bound_kernel(*this, hash, dst, arg_tp, arg_arrmeta,
+                            kwds_as_array, tp_vars, ectx);
+      if (is_cacheable_type(bk->dst_tp)) {
+        kernel_cache::get().insert(bk, cache_size);
+        checkout.bk = bk;
+      }
+      bk->run(dst.get_readwrite_originptr(),
+              arg_data.empty() ? NULL
+                               : const_cast<char *const *>(arg_data.data()));
+      return dst;
+    }
+  }
+
+  // ...
+  std::unique_ptr<char[]> data(new char[self->data_size]);
+
+  // Resolve the optional keyword arguments
+  if (self->resolve_option_values != NULL) {
+    self->resolve_option_values(self, self_tp, data.get(), narg,
+                                arg_tp.empty() ? NULL : arg_tp.data(),
+                                kwds_as_array, tp_vars);
+  }
+
+  // Construct the destination array, if it was not provided
+  ndt::type dst_tp =
+      resolve_dst(self, self_tp, data.get(), dst, arg_tp, kwds_as_array,
+                  tp_vars);
+
+  // Generate and evaluate the ckernel
+  ckernel_builder<kernel_request_host> ckb;
+  ckernel_profile_scope profile(&ckb, ectx->profile_kernels);
+  self->instantiate(self, self_tp, data.get(), &ckb, 0, dst_tp,
+                    dst.get_arrmeta(), narg,
+                    arg_tp.empty() ? NULL : arg_tp.data(),
+                    arg_arrmeta.empty() ? NULL : arg_arrmeta.data(),
+                    kernel_request_single, ectx, kwds_as_array, tp_vars);
+  if (profile.is_enabled()) {
+    std::stringstream ss;
+    ss << "(";
+    for (intptr_t i = 0; i < narg; ++i) {
+      ss << (i == 0 ? "" : ", ") << arg_tp[i];
+    }
+    ss << ") -> " << dst_tp;
+    profile.instrument(ss.str());
+  }
+  expr_single_t fn = ckb.get()->get_function<expr_single_t>();
+  fn(dst.get_readwrite_originptr(),
+     arg_data.empty() ? NULL : const_cast<char *const *>(arg_data.data()),
+     ckb.get());
+
+  return dst;
+}
+
+nd::bound_arrfunc nd::arrfunc::bind_validated(
+    const std::vector<ndt::type> &arg_tp,
+    const std::vector<const char *> &arg_arrmeta, array &kwds_as_array,
+    std::map<nd::string, ndt::type> &tp_vars) const
+{
+  for (size_t i = 0; i < arg_tp.size(); ++i) {
+    if (!is_cacheable_type(arg_tp[i])) {
+      stringstream ss;
+      ss << "cannot bind arrfunc to argument " << i << " of type "
+         << arg_tp[i] << ", only types which do not reference other memory "
+                         "can be bound";
+      throw type_error(ss.str());
+    }
+  }
+  if (!is_cacheable_type(kwds_as_array.get_type())) {
+    stringstream ss;
+    ss << "cannot bind arrfunc to keyword arguments of type "
+       << kwds_as_array.get_type();
+    throw type_error(ss.str());
+  }
+
+  array dst;
+  std::shared_ptr<detail::bound_kernel> bk =
+      make_bound_kernel(*this, 0, dst, arg_tp, arg_arrmeta, kwds_as_array,
+                        tp_vars, &eval::default_eval_context);
+  if (!is_cacheable_type(bk->dst_tp)) {
+    stringstream ss;
+    ss << "cannot bind arrfunc with return type " << bk->dst_tp
+       << ", only types which do not reference other memory can be bound";
+    throw type_error(ss.str());
+  }
+
+  return bound_arrfunc(bk);
+}
+
+const ndt::type &nd::bound_arrfunc::get_dst_type() const
+{
+  return m_kernel->dst_tp;
+}
+
+intptr_t nd::bound_arrfunc::get_narg() const
+{
+  return m_kernel->src_tp.size();
+}
+
+const ndt::type &nd::bound_arrfunc::get_arg_type(intptr_t i) const
+{
+  return m_kernel->src_tp[i];
+}
+
+bool nd::bound_arrfunc::matches(intptr_t i, const array &a) const
+{
+  return i >= 0 && i < get_narg() && a.get_type() == m_kernel->src_tp[i] &&
+         same_arrmeta(m_kernel->src_arrmeta[i], a.get_arrmeta());
+}
+
+void nd::bound_arrfunc::call(char *dst, char *const *src) const
+{
+  m_kernel->run(dst, src);
+}
+
+nd::array nd::bound_arrfunc::call(intptr_t narg, const array *args) const
+{
+  array dst = empty(m_kernel->dst_tp);
+  call(dst, narg, args);
+  return dst;
+}
+
+void nd::bound_arrfunc::call(const array &dst, intptr_t narg,
+                             const array *args) const
+{
+  if (narg != get_narg()) {
+    stringstream ss;
+    ss << "bound arrfunc expected " << get_narg()
+       << " positional arguments, but received " << narg;
+    throw invalid_argument(ss.str());
+  }
+  std::vector<char *> src(narg);
+  for (intptr_t i = 0; i < narg; ++i) {
+    if (!matches(i, args[i])) {
+      stringstream ss;
+      ss << "positional argument " << i
+         << " does not match the layout the arrfunc was bound to, expected "
+         << m_kernel->src_tp[i] << ", received " << args[i].get_type();
+      throw invalid_argument(ss.str());
+    }
+    src[i] = const_cast<char *>(args[i].get_readonly_originptr());
+  }
+  if (dst.get_type() != m_kernel->dst_tp ||
+      !same_arrmeta(m_kernel->dst_arrmeta, dst.get_arrmeta())) {
+    stringstream ss;
+    ss << "provided \"dst\" does not match the layout the arrfunc was bound "
+          "to, expected " << m_kernel->dst_tp << ", received "
+       << dst.get_type();
+    throw invalid_argument(ss.str());
+  }
+
+  m_kernel->run(dst.get_readwrite_originptr(), src.empty() ? NULL : &src[0]);
+}
+
+void nd::clear_kernel_cache() { kernel_cache::get().clear(); }
+
+intptr_t nd::get_kernel_cache_size() { return kernel_cache::get().size(); }
+
+intptr_t nd::get_kernel_cache_hits() { return kernel_cache::get().hits(); }
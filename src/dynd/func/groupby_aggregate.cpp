@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/groupby_aggregate.hpp>
+#include <dynd/kernels/groupby_aggregate.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/typevar_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+nd::arrfunc nd::functional::groupby_aggregate(
+    intptr_t nkeys, intptr_t nvalues,
+    const std::vector<groupby_aggregation> &aggs)
+{
+  if (nkeys < 1) {
+    throw invalid_argument("dynd groupby_aggregate: at least one key array "
+                           "is required");
+  }
+  if (nvalues < 0) {
+    throw invalid_argument("dynd groupby_aggregate: 'nvalues' cannot be "
+                           "negative");
+  }
+  for (size_t i = 0; i < aggs.size(); ++i) {
+    if (aggs[i].value < 0 || aggs[i].value >= nvalues) {
+      stringstream ss;
+      ss << "dynd groupby_aggregate: aggregation \"" << aggs[i].name
+         << "\" refers to value array " << aggs[i].value << ", but there are "
+         << nvalues << " value arrays";
+      throw invalid_argument(ss.str());
+    }
+  }
+
+  // (Fixed * K0, ..., Fixed * V0, ...) -> {key0: var * K0, ...,
+  //                                        <name>: var * R0, ...}
+  vector<ndt::type> arg_tp, field_tp;
+  vector<std::string> field_names;
+  for (intptr_t i = 0; i < nkeys; ++i) {
+    stringstream ss;
+    ss << "K" << i;
+    arg_tp.push_back(ndt::make_fixed_dim_kind(ndt::make_typevar(ss.str())));
+    field_tp.push_back(ndt::make_var_dim(ndt::make_typevar(ss.str())));
+    stringstream name;
+    name << "key" << i;
+    field_names.push_back(name.str());
+  }
+  for (intptr_t i = 0; i < nvalues; ++i) {
+    stringstream ss;
+    ss << "V" << i;
+    arg_tp.push_back(ndt::make_fixed_dim_kind(ndt::make_typevar(ss.str())));
+  }
+  for (size_t i = 0; i < aggs.size(); ++i) {
+    stringstream ss;
+    ss << "R" << i;
+    field_tp.push_back(ndt::make_var_dim(ndt::make_typevar(ss.str())));
+    field_names.push_back(aggs[i].name);
+  }
+
+  std::shared_ptr<groupby_aggregate_arrfunc_data> data(
+      new groupby_aggregate_arrfunc_data);
+  data->nkeys = nkeys;
+  data->nvalues = nvalues;
+  data->aggs = aggs;
+
+  return arrfunc::make<groupby_aggregate_ck>(
+      ndt::make_arrfunc(arg_tp.size(), &arg_tp[0],
+                        ndt::make_struct(field_names, field_tp)),
+      data, 0);
+}
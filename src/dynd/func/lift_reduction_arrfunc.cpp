@@ -5,6 +5,7 @@
 
 #include <dynd/func/lift_reduction_arrfunc.hpp>
 #include <dynd/kernels/make_lifted_reduction_ckernel.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 
@@ -17,6 +18,7 @@ struct lifted_reduction_arrfunc_data {
   // Pointer to the child arrfunc
   nd::arrfunc child_elwise_reduction;
   nd::arrfunc child_dst_initialization;
+  nd::arrfunc child_combine;
   nd::array reduction_identity;
   // The types of the child ckernel and this one
   const ndt::type *child_data_types;
@@ -52,7 +54,8 @@ static intptr_t instantiate_lifted_reduction_arrfunc_data(
       dst_arrmeta, src_tp[0], src_arrmeta[0], data->reduction_ndim,
       data->reduction_dimflags.get(), data->associative, data->commutative,
       data->right_associative, data->reduction_identity,
-      static_cast<dynd::kernel_request_t>(kernreq), ectx);
+      static_cast<dynd::kernel_request_t>(kernreq), ectx,
+      data->child_combine.get(), data->child_combine.get_type());
 }
 
 } // anonymous namespace
@@ -62,7 +65,7 @@ nd::arrfunc dynd::lift_reduction_arrfunc(
     const nd::arrfunc &dst_initialization_arr, bool keepdims,
     intptr_t reduction_ndim, const bool *reduction_dimflags, bool associative,
     bool commutative, bool right_associative,
-    const nd::array &reduction_identity)
+    const nd::array &reduction_identity, const nd::arrfunc &combine)
 {
   // Validate the input elwise_reduction arrfunc
   if (elwise_reduction_arr.is_null()) {
@@ -83,6 +86,23 @@ nd::arrfunc dynd::lift_reduction_arrfunc(
     throw invalid_argument(ss.str());
   }
 
+  if (!combine.is_null()) {
+    // Like the elwise reduction, a unary operation or a binary expr
+    const ndt::arrfunc_type *combine_tp = combine.get_type();
+    const ndt::type &acc_tp = elwise_reduction_tp->get_return_type();
+    if ((combine_tp->get_npos() != 1 &&
+         !(combine_tp->get_npos() == 2 &&
+           combine_tp->get_pos_type(1) == acc_tp)) ||
+        combine_tp->get_pos_type(0) != acc_tp ||
+        combine_tp->get_return_type() != acc_tp) {
+      stringstream ss;
+      ss << "lift_reduction_arrfunc: 'combine' must be a reduction of the "
+            "accumulator type " << acc_tp << ", its prototype is "
+         << combine.get_array_type();
+      throw invalid_argument(ss.str());
+    }
+  }
+
   // Figure out the result type
   ndt::type lifted_dst_type = elwise_reduction_tp->get_return_type();
   for (intptr_t i = reduction_ndim - 1; i >= 0; --i) {
@@ -118,15 +138,21 @@ nd::arrfunc dynd::lift_reduction_arrfunc(
   lifted_reduction_arrfunc_data *self = new lifted_reduction_arrfunc_data;
   self->child_elwise_reduction = elwise_reduction_arr;
   self->child_dst_initialization = dst_initialization_arr;
-  if (!reduction_identity.is_null()) {
-    if (reduction_identity.is_immutable() &&
-        reduction_identity.get_type() ==
-            elwise_reduction_tp->get_return_type()) {
-      self->reduction_identity = reduction_identity;
+  self->child_combine = combine;
+  // Builtin reductions like count_nonzero can't start from a copy of the
+  // first value, so they get their own identity if none was given
+  nd::array identity = reduction_identity;
+  if (identity.is_null() && dst_initialization_arr.is_null()) {
+    identity = kernels::get_builtin_reduction_identity(elwise_reduction_arr);
+  }
+  if (!identity.is_null()) {
+    if (identity.is_immutable() &&
+        identity.get_type() == elwise_reduction_tp->get_return_type()) {
+      self->reduction_identity = identity;
     } else {
       self->reduction_identity =
           nd::empty(elwise_reduction_tp->get_return_type());
-      self->reduction_identity.vals() = reduction_identity;
+      self->reduction_identity.vals() = identity;
       self->reduction_identity.flag_as_immutable();
     }
   }
@@ -145,3 +171,22 @@ nd::arrfunc dynd::lift_reduction_arrfunc(
       self, 0, &instantiate_lifted_reduction_arrfunc_data, NULL, NULL,
       &delete_lifted_reduction_arrfunc_data);
 }
+
+nd::array dynd::get_lifted_builtin_reduction_identity(const nd::arrfunc &af)
+{
+  if (af.is_null() ||
+      af.get()->instantiate != &instantiate_lifted_reduction_arrfunc_data) {
+    return nd::array();
+  }
+  const lifted_reduction_arrfunc_data *data =
+      *af.get()->get_data_as<lifted_reduction_arrfunc_data *>();
+  if (!data->child_dst_initialization.is_null()) {
+    return nd::array();
+  }
+  for (intptr_t i = 0; i < data->reduction_ndim; ++i) {
+    if (!data->reduction_dimflags[i]) {
+      return nd::array();
+    }
+  }
+  return kernels::get_builtin_reduction_identity(data->child_elwise_reduction);
+}
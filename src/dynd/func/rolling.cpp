@@ -3,6 +3,7 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <dynd/func/lift_reduction_arrfunc.hpp>
 #include <dynd/func/rolling.hpp>
 #include <dynd/kernels/rolling.hpp>
 #include <dynd/types/typevar_dim_type.hpp>
@@ -11,7 +12,8 @@ using namespace std;
 using namespace dynd;
 
 nd::arrfunc nd::functional::rolling(const nd::arrfunc &window_op,
-                                    intptr_t window_size)
+                                    intptr_t window_size,
+                                    intptr_t min_periods)
 {
   // Validate the input arrfunc
   if (window_op.is_null()) {
@@ -32,6 +34,21 @@ nd::arrfunc nd::functional::rolling(const nd::arrfunc &window_op,
     throw invalid_argument(ss.str());
   }
 
+  if (window_size < 1) {
+    stringstream ss;
+    ss << "make_rolling_arrfunc() 'window_size' must be positive, got "
+       << window_size;
+    throw invalid_argument(ss.str());
+  }
+  if (min_periods == -1) {
+    min_periods = window_size;
+  } else if (min_periods < 1 || min_periods > window_size) {
+    stringstream ss;
+    ss << "make_rolling_arrfunc() 'min_periods' must be between 1 and the "
+          "window size " << window_size << ", got " << min_periods;
+    throw invalid_argument(ss.str());
+  }
+
   nd::string rolldimname("RollDim");
   ndt::type roll_src_tp = ndt::make_typevar_dim(
       rolldimname, window_src_tp.get_type_at_dimension(NULL, 1));
@@ -41,7 +58,18 @@ nd::arrfunc nd::functional::rolling(const nd::arrfunc &window_op,
   // Create the data for the arrfunc
   std::shared_ptr<rolling_arrfunc_data> data(new rolling_arrfunc_data);
   data->window_size = window_size;
+  data->min_periods = min_periods;
   data->window_op = window_op;
+  data->is_builtin = kernels::get_builtin1d_info(window_op, data->builtin);
+  data->head_identity = get_lifted_builtin_reduction_identity(window_op);
+  if (min_periods < window_size && !data->is_builtin &&
+      data->head_identity.is_null()) {
+    stringstream ss;
+    ss << "make_rolling_arrfunc() 'min_periods' less than the window size "
+          "requires a builtin aggregate or reduction as the window op, got "
+       << window_af_tp;
+    throw invalid_argument(ss.str());
+  }
 
   return arrfunc::make<rolling_ck>(
       ndt::make_arrfunc(ndt::make_tuple(roll_src_tp), roll_dst_tp), data, 0);
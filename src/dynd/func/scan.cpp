@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/scan.hpp>
+#include <dynd/kernels/scan.hpp>
+#include <dynd/types/ellipsis_dim_type.hpp>
+#include <dynd/types/typevar_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/** (Dims... * <el_tp>, axis: ?int32) -> Dims... * <el_tp> */
+ndt::type make_scan_type(const ndt::type &el_tp)
+{
+  ndt::type arr_tp = ndt::make_ellipsis_dim("Dims", el_tp);
+  return ndt::make_arrfunc(
+      ndt::make_tuple(arr_tp),
+      ndt::make_struct(ndt::make_option(ndt::make_type<int32_t>()), "axis"),
+      arr_tp);
+}
+
+nd::arrfunc make_builtin_scan(nd::functional::builtin_scan_t op)
+{
+  std::shared_ptr<nd::functional::scan_arrfunc_data> data(
+      new nd::functional::scan_arrfunc_data);
+  data->builtin = op;
+  data->associative = true;
+
+  return nd::arrfunc::make<nd::functional::scan_ck>(
+      make_scan_type(ndt::make_typevar("T")), data, 0);
+}
+
+} // anonymous namespace
+
+nd::arrfunc nd::functional::scan(const nd::arrfunc &op, bool associative)
+{
+  // Validate the input arrfunc
+  if (op.is_null()) {
+    throw invalid_argument("dynd scan: 'op' cannot be null");
+  }
+  const ndt::arrfunc_type *op_tp = op.get_type();
+  if (op_tp->get_npos() != 2 ||
+      op_tp->get_pos_type(0) != op_tp->get_return_type() ||
+      op_tp->get_pos_type(1) != op_tp->get_return_type()) {
+    stringstream ss;
+    ss << "To make a scan arrfunc, an operation of the form (T, T) -> T "
+          "is required, got " << op_tp;
+    throw invalid_argument(ss.str());
+  }
+
+  std::shared_ptr<scan_arrfunc_data> data(new scan_arrfunc_data);
+  data->op = op;
+  data->elwise_op = elwise(op);
+  data->builtin = builtin_scan_none;
+  data->associative = associative;
+
+  return arrfunc::make<scan_ck>(make_scan_type(op_tp->get_return_type()),
+                                data, 0);
+}
+
+nd::arrfunc nd::cumsum::make()
+{
+  return make_builtin_scan(functional::builtin_scan_sum);
+}
+
+struct nd::cumsum nd::cumsum;
+
+nd::arrfunc nd::cumprod::make()
+{
+  return make_builtin_scan(functional::builtin_scan_prod);
+}
+
+struct nd::cumprod nd::cumprod;
+
+nd::arrfunc nd::cummin::make()
+{
+  return make_builtin_scan(functional::builtin_scan_min);
+}
+
+struct nd::cummin nd::cummin;
+
+nd::arrfunc nd::cummax::make()
+{
+  return make_builtin_scan(functional::builtin_scan_max);
+}
+
+struct nd::cummax nd::cummax;
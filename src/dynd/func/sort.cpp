@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/sort.hpp>
+#include <dynd/kernels/sort.hpp>
+#include <dynd/types/ellipsis_dim_type.hpp>
+#include <dynd/types/typevar_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * (Dims... * T, axis: ?int32, stable: ?bool) -> Dims... * T, or
+ * Dims... * int64 for argsort
+ */
+nd::arrfunc make_sort_arrfunc(bool argsort)
+{
+  ndt::type ret_el_tp =
+      argsort ? ndt::make_type<int64_t>() : ndt::make_typevar("T");
+  return nd::arrfunc::make<nd::sort_ck>(
+      ndt::make_arrfunc(
+          ndt::make_tuple(ndt::make_ellipsis_dim("Dims",
+                                                 ndt::make_typevar("T"))),
+          ndt::make_struct(ndt::make_option(ndt::make_type<int32_t>()), "axis",
+                           ndt::make_option(ndt::make_type<dynd_bool>()),
+                           "stable"),
+          ndt::make_ellipsis_dim("Dims", ret_el_tp)),
+      argsort, 0);
+}
+
+} // anonymous namespace
+
+nd::arrfunc nd::sort::make() { return make_sort_arrfunc(false); }
+
+struct nd::sort nd::sort;
+
+nd::arrfunc nd::argsort::make() { return make_sort_arrfunc(true); }
+
+struct nd::argsort nd::argsort;
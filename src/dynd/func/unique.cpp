@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/unique.hpp>
+#include <dynd/kernels/unique.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/typevar_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/** (Fixed * T, sorted: ?bool) -> var * T, or a struct of the outputs */
+nd::arrfunc make_unique_arrfunc(bool struct_output, bool inverse, bool counts)
+{
+  ndt::type ret_tp = ndt::make_var_dim(ndt::make_typevar("T"));
+  if (struct_output) {
+    vector<std::string> field_names(1, "values");
+    vector<ndt::type> field_tps(1, ret_tp);
+    if (inverse) {
+      field_names.push_back("inverse");
+      field_tps.push_back(
+          ndt::make_fixed_dim_kind(ndt::make_type<int64_t>()));
+    }
+    if (counts) {
+      field_names.push_back("counts");
+      field_tps.push_back(ndt::make_var_dim(ndt::make_type<int64_t>()));
+    }
+    ret_tp = ndt::make_struct(field_names, field_tps);
+  }
+
+  nd::unique_arrfunc_data data = {struct_output, inverse, counts};
+  return nd::arrfunc::make<nd::unique_ck>(
+      ndt::make_arrfunc(
+          ndt::make_tuple(ndt::make_fixed_dim_kind(ndt::make_typevar("T"))),
+          ndt::make_struct(ndt::make_option(ndt::make_type<dynd_bool>()),
+                           "sorted"),
+          ret_tp),
+      data, 0);
+}
+
+} // anonymous namespace
+
+nd::arrfunc nd::functional::unique(bool return_inverse, bool return_counts)
+{
+  return make_unique_arrfunc(return_inverse || return_counts, return_inverse,
+                             return_counts);
+}
+
+nd::arrfunc nd::unique::make() { return make_unique_arrfunc(false, false, false); }
+
+struct nd::unique nd::unique;
+
+nd::arrfunc nd::value_counts::make()
+{
+  return make_unique_arrfunc(true, false, true);
+}
+
+struct nd::value_counts nd::value_counts;
@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/hash_index.hpp>
+#include <dynd/types/base_tuple_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+dynd::key_encoder::key_encoder(const ndt::type &tp, const char *arrmeta)
+{
+  if (!is_supported(tp)) {
+    stringstream ss;
+    ss << "dynd key_encoder: values of type " << tp
+       << " cannot be encoded as keys";
+    throw type_error(ss.str());
+  }
+  add_leaves(tp, arrmeta, 0);
+}
+
+bool dynd::key_encoder::is_supported(const ndt::type &tp)
+{
+  switch (tp.get_type_id()) {
+  case bool_type_id:
+  case int8_type_id:
+  case int16_type_id:
+  case int32_type_id:
+  case int64_type_id:
+  case int128_type_id:
+  case uint8_type_id:
+  case uint16_type_id:
+  case uint32_type_id:
+  case uint64_type_id:
+  case uint128_type_id:
+  case float32_type_id:
+  case float64_type_id:
+  case complex_float32_type_id:
+  case complex_float64_type_id:
+  case date_type_id:
+  case time_type_id:
+  case datetime_type_id:
+  case fixed_string_type_id:
+  case fixed_bytes_type_id:
+  case string_type_id:
+  case bytes_type_id:
+    return true;
+  case option_type_id:
+    // The NA of a builtin type is one of its values
+    return tp.extended<ndt::option_type>()->get_value_type().is_builtin();
+  case tuple_type_id:
+  case struct_type_id: {
+    const ndt::base_tuple_type *tup_tp = tp.extended<ndt::base_tuple_type>();
+    for (intptr_t i = 0; i < tup_tp->get_field_count(); ++i) {
+      if (!is_supported(tup_tp->get_field_type(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+void dynd::key_encoder::add_leaves(const ndt::type &tp, const char *arrmeta,
+                                   intptr_t offset)
+{
+  leaf l = {leaf::raw, offset, tp.get_data_size()};
+  // The reals of an option are normalized too, apart from its NA
+  bool option = tp.get_type_id() == option_type_id;
+  type_id_t tid =
+      option ? tp.extended<ndt::option_type>()->get_value_type().get_type_id()
+             : tp.get_type_id();
+  switch (tid) {
+  case float32_type_id:
+    l.kind = option ? leaf::option_real32 : leaf::real32;
+    break;
+  case float64_type_id:
+    l.kind = option ? leaf::option_real64 : leaf::real64;
+    break;
+  case complex_float32_type_id:
+  case complex_float64_type_id:
+    // The real and imaginary parts
+    if (tid == complex_float32_type_id) {
+      l.kind = option ? leaf::option_real32 : leaf::real32;
+    } else {
+      l.kind = option ? leaf::option_real64 : leaf::real64;
+    }
+    l.size /= 2;
+    m_leaves.push_back(l);
+    l.offset += l.size;
+    break;
+  case string_type_id:
+  case bytes_type_id:
+    l.kind = leaf::string;
+    break;
+  case tuple_type_id:
+  case struct_type_id: {
+    const ndt::base_tuple_type *tup_tp = tp.extended<ndt::base_tuple_type>();
+    const uintptr_t *data_offsets = tup_tp->get_data_offsets(arrmeta);
+    const uintptr_t *arrmeta_offsets = tup_tp->get_arrmeta_offsets_raw();
+    for (intptr_t i = 0; i < tup_tp->get_field_count(); ++i) {
+      add_leaves(tup_tp->get_field_type(i), arrmeta + arrmeta_offsets[i],
+                 offset + data_offsets[i]);
+    }
+    return;
+  }
+  default:
+    break;
+  }
+  m_leaves.push_back(l);
+}
+
+void dynd::hash_index::grow()
+{
+  m_slots.assign(2 * m_slots.size(), -1);
+  size_t mask = m_slots.size() - 1;
+  for (size_t id = 0; id < m_hashes.size(); ++id) {
+    size_t slot = m_hashes[id] & mask;
+    while (m_slots[slot] >= 0) {
+      slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = id;
+  }
+}
+
+void dynd::hash_index::reserve(intptr_t n)
+{
+  m_hashes.reserve(n);
+  m_key_offsets.reserve(n + 1);
+  while (m_slots.size() < static_cast<size_t>(2 * n)) {
+    grow();
+  }
+}
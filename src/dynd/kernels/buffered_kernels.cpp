@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+
 #include <dynd/type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/buffered_kernels.hpp>
@@ -17,28 +19,34 @@ struct buffered_ck
     : public nd::base_kernel<buffered_ck, kernel_request_host, -1> {
   typedef buffered_ck self_type;
   intptr_t m_nsrc;
+  // The number of elements converted and processed at a time
+  size_t m_chunk_size;
   vector<intptr_t> m_src_buf_ck_offsets;
   vector<buffer_storage> m_bufs;
+  // Scratch for the child's src pointers and strides, sized when the
+  // ckernel is instantiated so that calling it doesn't allocate. The entries
+  // for the buffered operands always point at the buffers.
+  vector<char *> m_buf_src;
+  vector<intptr_t> m_buf_stride;
 
   static void single(char *dst, char *const *src, ckernel_prefix *rawself)
   {
     self_type *self = get_self(rawself);
-    vector<char *> buf_src(self->m_nsrc);
+    char **buf_src = &self->m_buf_src[0];
     for (intptr_t i = 0; i < self->m_nsrc; ++i) {
       if (!self->m_bufs[i].is_null()) {
         self->m_bufs[i].reset_arrmeta();
         ckernel_prefix *ck =
             self->get_child_ckernel(self->m_src_buf_ck_offsets[i]);
         expr_single_t ck_fn = ck->get_function<expr_single_t>();
-        ck_fn(self->m_bufs[i].get_storage(), &src[i], ck);
-        buf_src[i] = self->m_bufs[i].get_storage();
+        ck_fn(buf_src[i], &src[i], ck);
       } else {
         buf_src[i] = src[i];
       }
     }
     ckernel_prefix *child = self->get_child_ckernel();
     expr_single_t child_fn = child->get_function<expr_single_t>();
-    child_fn(dst, &buf_src[0], child);
+    child_fn(dst, buf_src, child);
   }
 
   static void strided(char *dst, intptr_t dst_stride, char *const *src,
@@ -46,47 +54,40 @@ struct buffered_ck
                       ckernel_prefix *rawself)
   {
     self_type *self = get_self(rawself);
-    vector<char *> buf_src(self->m_nsrc);
-    vector<intptr_t> buf_stride(self->m_nsrc);
+    char **buf_src = &self->m_buf_src[0];
+    intptr_t *buf_stride = &self->m_buf_stride[0];
     ckernel_prefix *child = self->get_child_ckernel();
     expr_strided_t child_fn = child->get_function<expr_strided_t>();
 
     for (intptr_t i = 0; i < self->m_nsrc; ++i) {
-      if (!self->m_bufs[i].is_null()) {
-        buf_src[i] = self->m_bufs[i].get_storage();
-        buf_stride[i] = self->m_bufs[i].get_stride();
-      } else {
+      if (self->m_bufs[i].is_null()) {
         buf_src[i] = src[i];
         buf_stride[i] = src_stride[i];
       }
     }
 
-    while (count > 0) {
-      size_t chunk_size = std::min(count, (size_t)DYND_BUFFER_CHUNK_SIZE);
+    // Convert a chunk of each buffered operand, then process the chunk while
+    // the converted values are in cache
+    for (size_t offset = 0; offset < count; offset += self->m_chunk_size) {
+      size_t chunk_size = std::min(count - offset, self->m_chunk_size);
       for (intptr_t i = 0; i < self->m_nsrc; ++i) {
         if (!self->m_bufs[i].is_null()) {
           self->m_bufs[i].reset_arrmeta();
           ckernel_prefix *ck =
               self->get_child_ckernel(self->m_src_buf_ck_offsets[i]);
           expr_strided_t ck_fn = ck->get_function<expr_strided_t>();
-          ck_fn(self->m_bufs[i].get_storage(), self->m_bufs[i].get_stride(),
-                &src[i], &src_stride[i], chunk_size, ck);
+          char *chunk_src = src[i] + offset * src_stride[i];
+          ck_fn(buf_src[i], buf_stride[i], &chunk_src, &src_stride[i],
+                chunk_size, ck);
         }
       }
-      child_fn(dst, dst_stride, &buf_src[0], &buf_stride[0], chunk_size, child);
+      child_fn(dst, dst_stride, buf_src, buf_stride, chunk_size, child);
+      dst += chunk_size * dst_stride;
       for (intptr_t i = 0; i < self->m_nsrc; ++i) {
-        if (!self->m_bufs[i].is_null()) {
-          self->m_bufs[i].reset_arrmeta();
-          ckernel_prefix *ck =
-              self->get_child_ckernel(self->m_src_buf_ck_offsets[i]);
-          expr_strided_t ck_fn = ck->get_function<expr_strided_t>();
-          ck_fn(self->m_bufs[i].get_storage(), buf_stride[i], &src[i],
-                &src_stride[i], chunk_size, ck);
-        } else {
+        if (self->m_bufs[i].is_null()) {
           buf_src[i] += chunk_size * buf_stride[i];
         }
       }
-      count -= chunk_size;
     }
   }
 
@@ -115,15 +116,26 @@ size_t dynd::make_buffered_ckernel(
   self->m_nsrc = nsrc;
   self->m_bufs.resize(nsrc);
   self->m_src_buf_ck_offsets.resize(nsrc);
+  self->m_buf_src.resize(nsrc);
+  self->m_buf_stride.resize(nsrc);
   vector<const char *> buffered_arrmeta(nsrc);
+  intptr_t buffered_bytes = 0;
   for (intptr_t i = 0; i < nsrc; ++i) {
     if (src_tp[i] == src_tp_for_af[i]) {
       buffered_arrmeta[i] = src_arrmeta[i];
     } else {
       self->m_bufs[i].allocate(src_tp_for_af[i]);
       buffered_arrmeta[i] = self->m_bufs[i].get_arrmeta();
+      self->m_buf_src[i] = self->m_bufs[i].get_storage();
+      self->m_buf_stride[i] = self->m_bufs[i].get_stride();
+      buffered_bytes += self->m_bufs[i].get_stride();
     }
   }
+  self->m_chunk_size = DYND_BUFFER_CHUNK_SIZE;
+  if (buffered_bytes * DYND_BUFFER_CHUNK_SIZE > DYND_BUFFER_CHUNK_BYTES) {
+    self->m_chunk_size =
+        std::max<intptr_t>(1, DYND_BUFFER_CHUNK_BYTES / buffered_bytes);
+  }
   // Instantiate the arrfunc being buffered
   ckb_offset =
       af->instantiate(af, af_tp, NULL, ckb, ckb_offset, dst_tp, dst_arrmeta,
@@ -36,12 +36,12 @@ intptr_t nd::functional::chain_kernel::instantiate(
   chain_kernel *self = make(ckb, kernreq, ckb_offset, static_data->buffer_tp);
   ckb_offset =
       first->instantiate(first, first_tp, data, ckb, ckb_offset, buffer_tp,
-                         self->buffer_arrmeta.get(), 1, src_tp, src_arrmeta,
+                         self->buffer.get_arrmeta(), 1, src_tp, src_arrmeta,
                          kernreq, ectx, kwds, tp_vars);
   self = get_self(reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
                   root_ckb_offset);
   self->second_offset = ckb_offset - root_ckb_offset;
-  const char *buffer_arrmeta = self->buffer_arrmeta.get();
+  const char *buffer_arrmeta = self->buffer.get_arrmeta();
   return second->instantiate(second, second_tp, data + first->data_size, ckb,
                              ckb_offset, dst_tp, dst_arrmeta, 1, &buffer_tp,
                              &buffer_arrmeta, kernreq, ectx, kwds, tp_vars);
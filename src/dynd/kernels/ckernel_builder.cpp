@@ -3,11 +3,175 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
 #include <dynd/kernels/ckernel_builder.hpp>
 
 using namespace std;
 using namespace dynd;
 
+namespace {
+
+// Buffers are pooled in power of two size classes from 256 bytes to 64KB,
+// anything bigger goes straight to the heap
+const int min_class_shift = 8;
+const int class_count = 9;
+const intptr_t max_class_size = intptr_t(1) << (min_class_shift + class_count - 1);
+// How many free buffers each size class keeps
+const int max_free_count = 8;
+// How many frees make up the window for tracking recent usage
+const int usage_window = 64;
+
+std::atomic<intptr_t> heap_allocation_count(0);
+
+int get_size_class(intptr_t capacity)
+{
+  int cls = 0;
+  while ((intptr_t(1) << (min_class_shift + cls)) < capacity) {
+    ++cls;
+  }
+  return cls;
+}
+
+void *heap_alloc(intptr_t capacity)
+{
+  ++heap_allocation_count;
+  return malloc(capacity);
+}
+
+struct ckernel_buffer_pool;
+
+// Set once a thread's pool has been destroyed, so builders which outlive it
+// (e.g. in static objects) free their buffers directly. This is trivially
+// destructible, so it stays valid during thread exit.
+DYND_THREAD_LOCAL bool pool_destroyed = false;
+
+struct ckernel_buffer_pool {
+  void *free_buffers[class_count][max_free_count];
+  int free_count[class_count];
+  // The largest size class freed in the last and the current usage window
+  int recent_class, window_class;
+  int window_frees;
+
+  ckernel_buffer_pool() : recent_class(0), window_class(0), window_frees(0)
+  {
+    memset(free_count, 0, sizeof(free_count));
+  }
+
+  ~ckernel_buffer_pool()
+  {
+    for (int cls = 0; cls < class_count; ++cls) {
+      for (int i = 0; i < free_count[cls]; ++i) {
+        ::free(free_buffers[cls][i]);
+      }
+    }
+    pool_destroyed = true;
+  }
+
+  void *alloc(int cls)
+  {
+    if (free_count[cls] > 0) {
+      return free_buffers[cls][--free_count[cls]];
+    }
+    return heap_alloc(intptr_t(1) << (min_class_shift + cls));
+  }
+
+  void free(void *ptr, int cls)
+  {
+    if (cls > window_class) {
+      window_class = cls;
+    }
+    if (cls > recent_class) {
+      recent_class = cls;
+    }
+    if (++window_frees == usage_window) {
+      recent_class = window_class;
+      window_class = 0;
+      window_frees = 0;
+    }
+
+    if (free_count[cls] < max_free_count) {
+      free_buffers[cls][free_count[cls]++] = ptr;
+    } else {
+      ::free(ptr);
+    }
+  }
+};
+
+ckernel_buffer_pool *get_pool()
+{
+#ifdef DYND_THREAD_LOCAL_POD_ONLY
+  // The pool has to free its buffers when its thread exits, so without
+  // thread_local objects the buffers come straight from the heap
+  return NULL;
+#else
+  if (pool_destroyed) {
+    return NULL;
+  }
+  static DYND_THREAD_LOCAL ckernel_buffer_pool pool;
+  return &pool;
+#endif
+}
+
+} // anonymous namespace
+
+intptr_t dynd::detail::ckernel_buffer_round_capacity(intptr_t capacity,
+                                                     bool first_spill)
+{
+  if (capacity > max_class_size) {
+    return capacity;
+  }
+  int cls = get_size_class(capacity);
+  if (first_spill) {
+    ckernel_buffer_pool *pool = get_pool();
+    if (pool != NULL && pool->recent_class > cls) {
+      cls = pool->recent_class;
+    }
+  }
+  return intptr_t(1) << (min_class_shift + cls);
+}
+
+void *dynd::detail::ckernel_buffer_alloc(intptr_t capacity)
+{
+  ckernel_buffer_pool *pool = get_pool();
+  if (capacity > max_class_size || pool == NULL) {
+    return heap_alloc(capacity);
+  }
+  return pool->alloc(get_size_class(capacity));
+}
+
+void *dynd::detail::ckernel_buffer_realloc(void *ptr, intptr_t old_capacity,
+                                           intptr_t new_capacity)
+{
+  if (old_capacity > max_class_size) {
+    ++heap_allocation_count;
+    return realloc(ptr, new_capacity);
+  }
+  void *new_ptr = ckernel_buffer_alloc(new_capacity);
+  if (new_ptr != NULL) {
+    memcpy(new_ptr, ptr, old_capacity);
+    ckernel_buffer_free(ptr, old_capacity);
+  }
+  return new_ptr;
+}
+
+void dynd::detail::ckernel_buffer_free(void *ptr, intptr_t capacity)
+{
+  ckernel_buffer_pool *pool = get_pool();
+  if (capacity > max_class_size || pool == NULL) {
+    ::free(ptr);
+  } else {
+    pool->free(ptr, get_size_class(capacity));
+  }
+}
+
+intptr_t dynd::get_ckernel_builder_heap_allocation_count()
+{
+  return heap_allocation_count;
+}
+
 #ifdef __CUDACC__
 
 ckernel_builder<kernel_request_cuda_device>::pooled_allocator ckernel_builder<kernel_request_cuda_device>::allocator;
@@ -0,0 +1,372 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#include <dynd/kernels/ckernel_profile.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+struct profile_node {
+  intptr_t ckb_offset;
+  kernel_request_t kernreq;
+  std::string name;
+  // The kernel function the profiling wrapper forwards to
+  void *function;
+  std::atomic<intptr_t> calls, elements;
+  std::atomic<int64_t> nanoseconds;
+  std::atomic<profile_node *> parent;
+
+  profile_node(intptr_t ckb_offset, kernel_request_t kernreq,
+               const char *name)
+      : ckb_offset(ckb_offset), kernreq(kernreq), name(name), function(NULL),
+        calls(0), elements(0), nanoseconds(0), parent(NULL)
+  {
+  }
+};
+
+} // anonymous namespace
+
+class dynd::ckernel_profile {
+public:
+  std::string label;
+  // The ckernels in the order they were constructed, parents first
+  std::vector<std::unique_ptr<profile_node>> nodes;
+};
+
+namespace {
+
+// The number of profiles kept for print_ckernel_profiles, the oldest are
+// dropped beyond it
+const size_t max_ckernel_profiles = 1024;
+
+/**
+ * The global state of the profiler. The profiling wrappers find the node
+ * for a ckernel through ``ckernels``. Each thread caches the entries it has
+ * looked up, so the lookup usually doesn't need the mutex, and drops its
+ * cache when ``generation`` changes. That happens when ckernels are
+ * forgotten, since their addresses may then be reused by other ckernels.
+ */
+struct profile_registry {
+  std::mutex mutex;
+  std::unordered_map<const ckernel_prefix *, profile_node *> ckernels;
+  std::atomic<intptr_t> generation;
+  std::deque<std::shared_ptr<ckernel_profile>> profiles;
+
+  profile_registry() : generation(0) {}
+
+  ~profile_registry();
+};
+
+profile_registry &get_registry()
+{
+  static profile_registry registry;
+  return registry;
+}
+
+// The thread's cache of looked up nodes, indexed by a hash of the ckernel's
+// address. It is plain data, so it can be DYND_THREAD_LOCAL on every
+// compiler.
+const size_t node_cache_size = 64;
+
+struct node_cache_entry {
+  const ckernel_prefix *ckp;
+  profile_node *node;
+};
+
+DYND_THREAD_LOCAL intptr_t node_cache_generation = -1;
+DYND_THREAD_LOCAL node_cache_entry node_cache[node_cache_size];
+
+profile_node *find_node(const ckernel_prefix *self)
+{
+  profile_registry &registry = get_registry();
+  intptr_t current_generation = registry.generation.load();
+  if (node_cache_generation != current_generation) {
+    memset(node_cache, 0, sizeof(node_cache));
+    node_cache_generation = current_generation;
+  }
+  node_cache_entry &entry =
+      node_cache[(reinterpret_cast<uintptr_t>(self) / sizeof(void *)) %
+                 node_cache_size];
+  if (entry.ckp == self) {
+    return entry.node;
+  }
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.ckernels.find(self);
+  if (it == registry.ckernels.end()) {
+    throw std::runtime_error(
+        "dynd ckernel profile: called a profiled ckernel which is not "
+        "registered, its ckernel_profile_scope was destroyed");
+  }
+  entry.ckp = self;
+  entry.node = it->second;
+  return it->second;
+}
+
+// The innermost profiled ckernel executing on this thread. Each call keeps
+// the one it interrupted, so together they form the thread's call stack.
+DYND_THREAD_LOCAL profile_node *current_node = NULL;
+
+/**
+ * Times one call of a profiled ckernel, and adds it to the node's totals
+ * when it goes out of scope.
+ */
+class profiled_call {
+  profile_node *m_node, *m_outer;
+  std::chrono::steady_clock::time_point m_begin;
+
+public:
+  profiled_call(profile_node *node, size_t count)
+      : m_node(node), m_outer(current_node)
+  {
+    if (m_outer != NULL) {
+      profile_node *expected = NULL;
+      node->parent.compare_exchange_strong(expected, m_outer);
+    }
+    current_node = node;
+    ++node->calls;
+    node->elements += count;
+    m_begin = std::chrono::steady_clock::now();
+  }
+
+  ~profiled_call()
+  {
+    m_node->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - m_begin)
+                               .count();
+    current_node = m_outer;
+  }
+};
+
+void profiled_single(char *dst, char *const *src, ckernel_prefix *self)
+{
+  profile_node *node = find_node(self);
+  profiled_call call(node, 1);
+  reinterpret_cast<expr_single_t>(node->function)(dst, src, self);
+}
+
+void profiled_strided(char *dst, intptr_t dst_stride, char *const *src,
+                      const intptr_t *src_stride, size_t count,
+                      ckernel_prefix *self)
+{
+  profile_node *node = find_node(self);
+  profiled_call call(node, count);
+  reinterpret_cast<expr_strided_t>(node->function)(dst, dst_stride, src,
+                                                   src_stride, count, self);
+}
+
+/**
+ * Turns a mangled C++ type name into a readable one, without the namespace
+ * qualifiers.
+ */
+std::string get_kernel_name(const std::string &mangled)
+{
+  std::string name = mangled;
+#if defined(__GNUC__)
+  int status = 0;
+  char *demangled =
+      abi::__cxa_demangle(mangled.c_str(), NULL, NULL, &status);
+  if (status == 0 && demangled != NULL) {
+    name = demangled;
+  }
+  free(demangled);
+#endif
+  std::string result;
+  size_t word_begin = 0;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (name[i] == ':' && i + 1 < name.size() && name[i + 1] == ':') {
+      // Drop the qualifier which precedes the "::"
+      result.resize(word_begin);
+      ++i;
+    } else {
+      result += name[i];
+      if (!isalnum(name[i]) && name[i] != '_') {
+        word_begin = result.size();
+      }
+    }
+  }
+  return result;
+}
+
+void print_node(std::ostream &o, const std::vector<profile_node *> &nodes,
+                const std::vector<std::vector<size_t>> &children, size_t i,
+                int depth)
+{
+  const profile_node *node = nodes[i];
+  int64_t child_nanoseconds = 0;
+  for (size_t j : children[i]) {
+    child_nanoseconds += nodes[j]->nanoseconds;
+  }
+
+  o << std::string(2 * depth + 2, ' ') << "-> "
+    << get_kernel_name(node->name);
+  if (node->calls == 0) {
+    o << "  (never executed)\n";
+  } else {
+    char times[128];
+    snprintf(times, sizeof(times), "  (time total=%.3f ms self=%.3f ms)",
+             node->nanoseconds * 1e-6,
+             (node->nanoseconds - child_nanoseconds) * 1e-6);
+    o << "  (calls=" << node->calls << " elements=" << node->elements << ")"
+      << times << "\n";
+  }
+
+  for (size_t j : children[i]) {
+    print_node(o, nodes, children, j, depth + 1);
+  }
+}
+
+void print_profile(std::ostream &o, const ckernel_profile &profile)
+{
+  // Arrange the nodes into a tree, each level in construction order
+  std::vector<profile_node *> nodes;
+  std::unordered_map<const profile_node *, size_t> indices;
+  for (const std::unique_ptr<profile_node> &node : profile.nodes) {
+    indices[node.get()] = nodes.size();
+    nodes.push_back(node.get());
+  }
+  std::vector<std::vector<size_t>> children(nodes.size());
+  std::vector<size_t> roots;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    // A parent from another profile, e.g. when a ckernel calls an arrfunc,
+    // makes the node a root of this one
+    auto parent = indices.find(nodes[i]->parent.load());
+    if (parent == indices.end()) {
+      roots.push_back(i);
+    } else {
+      children[parent->second].push_back(i);
+    }
+  }
+
+  o << profile.label << "\n";
+  for (size_t i : roots) {
+    print_node(o, nodes, children, i, 0);
+  }
+}
+
+profile_registry::~profile_registry()
+{
+  if (detail::profile_kernels_from_env()) {
+    for (const std::shared_ptr<ckernel_profile> &profile : profiles) {
+      print_profile(cerr, *profile);
+    }
+  }
+}
+
+} // anonymous namespace
+
+void dynd::detail::record_ckernel(ckernel_profile *profile,
+                                  intptr_t ckb_offset,
+                                  kernel_request_t kernreq, const char *name)
+{
+  // A ckernel constructed over one which was discarded replaces it
+  for (size_t i = 0; i < profile->nodes.size(); ++i) {
+    if (profile->nodes[i]->ckb_offset == ckb_offset) {
+      profile->nodes.erase(profile->nodes.begin() + i);
+      break;
+    }
+  }
+  profile->nodes.emplace_back(new profile_node(ckb_offset, kernreq, name));
+}
+
+dynd::ckernel_profile_scope::ckernel_profile_scope(
+    ckernel_builder<kernel_request_host> *ckb, bool enabled)
+    : m_ckb(ckb)
+{
+  if (enabled) {
+    m_profile = std::make_shared<ckernel_profile>();
+    m_ckb->set_profile(m_profile.get());
+  }
+}
+
+dynd::ckernel_profile_scope::~ckernel_profile_scope()
+{
+  if (m_profile) {
+    if (m_ckb->get_profile() == m_profile.get()) {
+      m_ckb->set_profile(NULL);
+    }
+    // Forget the ckernels, their memory is about to be released
+    profile_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const std::unique_ptr<profile_node> &node : m_profile->nodes) {
+      registry.ckernels.erase(
+          m_ckb->get_at<ckernel_prefix>(node->ckb_offset));
+    }
+    ++registry.generation;
+  }
+}
+
+void dynd::ckernel_profile_scope::instrument(const std::string &label)
+{
+  if (!m_profile) {
+    return;
+  }
+  m_ckb->set_profile(NULL);
+  m_profile->label = label;
+
+  profile_registry &registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (const std::unique_ptr<profile_node> &node : m_profile->nodes) {
+    ckernel_prefix *ckp = m_ckb->get_at<ckernel_prefix>(node->ckb_offset);
+    node->function = ckp->function;
+    switch (node->kernreq & ~kernel_request_memory) {
+    case kernel_request_single:
+      ckp->set_function<expr_single_t>(&profiled_single);
+      break;
+    case kernel_request_strided:
+      ckp->set_function<expr_strided_t>(&profiled_strided);
+      break;
+    default:
+      // Other kinds of kernel functions are left as they are
+      continue;
+    }
+    registry.ckernels[ckp] = node.get();
+  }
+  registry.profiles.push_back(m_profile);
+  if (registry.profiles.size() > max_ckernel_profiles) {
+    registry.profiles.pop_front();
+  }
+}
+
+bool dynd::detail::profile_kernels_from_env()
+{
+  const char *value = getenv("DYND_PROFILE_KERNELS");
+  return value != NULL && *value != '\0' && strcmp(value, "0") != 0;
+}
+
+void dynd::print_ckernel_profiles(std::ostream &o)
+{
+  profile_registry &registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (const std::shared_ptr<ckernel_profile> &profile : registry.profiles) {
+    print_profile(o, *profile);
+  }
+}
+
+void dynd::clear_ckernel_profiles()
+{
+  profile_registry &registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.profiles.clear();
+}
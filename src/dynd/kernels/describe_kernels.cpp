@@ -0,0 +1,533 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <dynd/kernels/describe_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/lift_reduction_arrfunc.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "state_reduction.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+// The sum is accumulated in blocks of this many values, which keeps its
+// error lower than adding each value to the total
+const size_t describe_block_size = 128;
+
+/**
+ * Classifies values as NA. The signed integers have an NA value only in
+ * an option type, and NaN is NA for the real types.
+ */
+template <class T, bool Option>
+struct describe_na {
+  static bool is_na(T v)
+  {
+    return Option && v == numeric_limits<T>::min();
+  }
+};
+
+template <bool Option>
+struct describe_na<float, Option> {
+  static bool is_na(float v) { return v != v; }
+};
+
+template <bool Option>
+struct describe_na<double, Option> {
+  static bool is_na(double v) { return v != v; }
+};
+
+inline void describe_merge(kernels::describe_state &a,
+                           const kernels::describe_state &b)
+{
+  a.count += b.count;
+  a.na_count += b.na_count;
+  a.sum += b.sum;
+  a.min = std::min(a.min, b.min);
+  a.max = std::max(a.max, b.max);
+}
+
+const uintptr_t describe_offsets[5] = {
+    offsetof(kernels::describe_state, count),
+    offsetof(kernels::describe_state, na_count),
+    offsetof(kernels::describe_state, sum),
+    offsetof(kernels::describe_state, min),
+    offsetof(kernels::describe_state, max)};
+
+void check_describe_arrmeta(const char *name, const ndt::type &tp,
+                            const char *arrmeta)
+{
+  detail::check_state_arrmeta(name, kernels::make_describe_state_type(),
+                              describe_offsets, tp, arrmeta);
+}
+
+template <class T, bool Option>
+struct describe_reduction_kernel
+    : nd::base_kernel<describe_reduction_kernel<T, Option>,
+                      kernel_request_host, 1> {
+  static void add(kernels::describe_state &s, T v)
+  {
+    if (describe_na<T, Option>::is_na(v)) {
+      ++s.na_count;
+    } else {
+      double x = static_cast<double>(v);
+      ++s.count;
+      s.sum += x;
+      s.min = std::min(s.min, x);
+      s.max = std::max(s.max, x);
+    }
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    add(*reinterpret_cast<kernels::describe_state *>(dst),
+        **reinterpret_cast<T *const *>(src));
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    const char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    if (dst_stride == 0) {
+      kernels::describe_state s =
+          *reinterpret_cast<kernels::describe_state *>(dst);
+      while (count > 0) {
+        size_t block = std::min(count, describe_block_size);
+        double block_sum = 0;
+        for (size_t i = 0; i < block; ++i) {
+          T v = *reinterpret_cast<const T *>(src0);
+          if (describe_na<T, Option>::is_na(v)) {
+            ++s.na_count;
+          } else {
+            double x = static_cast<double>(v);
+            ++s.count;
+            block_sum += x;
+            s.min = x < s.min ? x : s.min;
+            s.max = x > s.max ? x : s.max;
+          }
+          src0 += src0_stride;
+        }
+        s.sum += block_sum;
+        count -= block;
+      }
+      *reinterpret_cast<kernels::describe_state *>(dst) = s;
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        add(*reinterpret_cast<kernels::describe_state *>(dst),
+            *reinterpret_cast<const T *>(src0));
+        dst += dst_stride;
+        src0 += src0_stride;
+      }
+    }
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *self,
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *DYND_UNUSED(src_arrmeta),
+              kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_describe_arrmeta("dynd describe reduction", dst_tp, dst_arrmeta);
+    const ndt::type &expected_tp = *self->get_data_as<ndt::type>();
+    if (src_tp[0] != expected_tp) {
+      stringstream ss;
+      ss << "dynd describe reduction: expected source type " << expected_tp
+         << ", got " << src_tp[0];
+      throw type_error(ss.str());
+    }
+    describe_reduction_kernel::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  }
+};
+
+struct describe_combine_kernel
+    : nd::base_kernel<describe_combine_kernel, kernel_request_host, 1> {
+  void single(char *dst, char *const *src)
+  {
+    describe_merge(*reinterpret_cast<kernels::describe_state *>(dst),
+                   **reinterpret_cast<kernels::describe_state *const *>(src));
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *DYND_UNUSED(self),
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_describe_arrmeta("dynd describe combine", dst_tp, dst_arrmeta);
+    check_describe_arrmeta("dynd describe combine", src_tp[0], src_arrmeta[0]);
+    describe_combine_kernel::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  }
+};
+
+const int describe_statistic_count = 6;
+
+struct describe_statistics_kernel
+    : nd::base_kernel<describe_statistics_kernel, kernel_request_host, 1> {
+  // The offset of each statistic in the destination struct, by the bit
+  // number of its flag, or -1 if it isn't selected
+  intptr_t m_offsets[describe_statistic_count];
+
+  void single(char *dst, char *const *src)
+  {
+    const kernels::describe_state &s =
+        **reinterpret_cast<kernels::describe_state *const *>(src);
+    double nan = numeric_limits<double>::quiet_NaN();
+    if (m_offsets[0] >= 0) {
+      *reinterpret_cast<int64_t *>(dst + m_offsets[0]) = s.count;
+    }
+    if (m_offsets[1] >= 0) {
+      *reinterpret_cast<int64_t *>(dst + m_offsets[1]) = s.na_count;
+    }
+    if (m_offsets[2] >= 0) {
+      *reinterpret_cast<double *>(dst + m_offsets[2]) = s.sum;
+    }
+    if (m_offsets[3] >= 0) {
+      *reinterpret_cast<double *>(dst + m_offsets[3]) =
+          s.count > 0 ? s.sum / static_cast<double>(s.count) : nan;
+    }
+    if (m_offsets[4] >= 0) {
+      *reinterpret_cast<double *>(dst + m_offsets[4]) =
+          s.count > 0 ? s.min : nan;
+    }
+    if (m_offsets[5] >= 0) {
+      *reinterpret_cast<double *>(dst + m_offsets[5]) =
+          s.count > 0 ? s.max : nan;
+    }
+  }
+};
+
+struct describe_statistics_virtual_kernel
+    : nd::base_virtual_kernel<describe_statistics_virtual_kernel> {
+  static intptr_t
+  instantiate(const arrfunc_type_data *self,
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_describe_arrmeta("dynd describe statistics", src_tp[0],
+                           src_arrmeta[0]);
+    int stats = *self->get_data_as<int>();
+    if (dst_tp != kernels::make_describe_statistics_type(stats)) {
+      stringstream ss;
+      ss << "dynd describe statistics: expected destination type "
+         << kernels::make_describe_statistics_type(stats) << ", got "
+         << dst_tp;
+      throw type_error(ss.str());
+    }
+    const uintptr_t *offsets =
+        dst_tp.extended<ndt::base_struct_type>()->get_data_offsets(
+            dst_arrmeta);
+    describe_statistics_kernel *self_ck =
+        describe_statistics_kernel::make(ckb, kernreq, ckb_offset);
+    for (int i = 0, field = 0; i < describe_statistic_count; ++i) {
+      self_ck->m_offsets[i] =
+          (stats & (1 << i)) ? static_cast<intptr_t>(offsets[field++]) : -1;
+    }
+    return ckb_offset;
+  }
+};
+
+template <bool Option>
+arrfunc_instantiate_t get_describe_reduction_instantiate(type_id_t tid)
+{
+  switch (tid) {
+  case int8_type_id:
+    return &describe_reduction_kernel<int8_t, Option>::instantiate;
+  case int16_type_id:
+    return &describe_reduction_kernel<int16_t, Option>::instantiate;
+  case int32_type_id:
+    return &describe_reduction_kernel<int32_t, Option>::instantiate;
+  case int64_type_id:
+    return &describe_reduction_kernel<int64_t, Option>::instantiate;
+  case uint8_type_id:
+    return Option ? NULL : &describe_reduction_kernel<uint8_t, false>::instantiate;
+  case uint16_type_id:
+    return Option ? NULL
+                  : &describe_reduction_kernel<uint16_t, false>::instantiate;
+  case uint32_type_id:
+    return Option ? NULL
+                  : &describe_reduction_kernel<uint32_t, false>::instantiate;
+  case uint64_type_id:
+    return Option ? NULL
+                  : &describe_reduction_kernel<uint64_t, false>::instantiate;
+  case float32_type_id:
+    return &describe_reduction_kernel<float, Option>::instantiate;
+  case float64_type_id:
+    return &describe_reduction_kernel<double, Option>::instantiate;
+  default:
+    return NULL;
+  }
+}
+
+/**
+ * The type of the result of reducing the dimensions of ``src_tp``
+ * selected by ``reduction_dimflags`` to ``el_tp``. Symbolic dimensions
+ * stay symbolic, so this makes both the arrfunc's return type and the
+ * concrete result type.
+ */
+ndt::type make_reduced_type(const ndt::type &src_tp, intptr_t reduction_ndim,
+                            const bool *reduction_dimflags, bool keepdims,
+                            const ndt::type &el_tp)
+{
+  if (reduction_ndim == 0) {
+    return el_tp;
+  }
+  ndt::type child_tp = make_reduced_type(
+      src_tp.get_type_at_dimension(NULL, 1), reduction_ndim - 1,
+      reduction_dimflags + 1, keepdims, el_tp);
+  if (reduction_dimflags[0]) {
+    return keepdims ? ndt::make_fixed_dim(1, child_tp) : child_tp;
+  } else if (src_tp.get_type_id() == var_dim_type_id) {
+    return ndt::make_var_dim(child_tp);
+  } else if (src_tp.get_kind() == kind_kind) {
+    return ndt::make_fixed_dim_kind(child_tp);
+  } else {
+    return ndt::make_fixed_dim(src_tp.get_dim_size(NULL, NULL), child_tp);
+  }
+}
+
+struct describe_arrfunc_data {
+  // The lifted describe reduction
+  nd::arrfunc reduction;
+  // The statistics arrfunc, lifted elementwise if dimensions are kept
+  nd::arrfunc statistics;
+  int stats;
+  bool keepdims;
+  intptr_t reduction_ndim;
+  std::unique_ptr<bool[]> reduction_dimflags;
+};
+
+/**
+ * Reduces to an array of describe states held by the ckernel, then
+ * computes the statistics from them.
+ */
+struct describe_kernel
+    : nd::base_kernel<describe_kernel, kernel_request_host, 1> {
+  nd::array m_states;
+  size_t m_statistics_offset;
+
+  void single(char *dst, char *const *src)
+  {
+    char *states = m_states.get_readwrite_originptr();
+    ckernel_prefix *reduction = get_child_ckernel();
+    reduction->get_function<expr_single_t>()(states, src, reduction);
+    ckernel_prefix *statistics = get_child_ckernel(m_statistics_offset);
+    statistics->get_function<expr_single_t>()(dst, &states, statistics);
+  }
+
+  void destruct_children()
+  {
+    get_child_ckernel()->destroy();
+    destroy_child_ckernel(m_statistics_offset);
+  }
+};
+
+struct describe_virtual_kernel
+    : nd::base_virtual_kernel<describe_virtual_kernel> {
+  static intptr_t
+  instantiate(const arrfunc_type_data *af_self,
+              const ndt::arrfunc_type *DYND_UNUSED(af_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx,
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &tp_vars)
+  {
+    const describe_arrfunc_data *data =
+        *af_self->get_data_as<describe_arrfunc_data *>();
+    intptr_t root_ckb_offset = ckb_offset;
+    describe_kernel *self = describe_kernel::make(ckb, kernreq, ckb_offset);
+    self->m_states = nd::empty(
+        dst_tp.with_replaced_dtype(kernels::make_describe_state_type()));
+    ndt::type states_tp = self->m_states.get_type();
+    const char *states_arrmeta = self->m_states.get_arrmeta();
+
+    ckb_offset = data->reduction.get()->instantiate(
+        data->reduction.get(), data->reduction.get_type(), NULL, ckb,
+        ckb_offset, states_tp, states_arrmeta, 1, src_tp, src_arrmeta,
+        kernel_request_single, ectx, nd::array(), tp_vars);
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+    self = describe_kernel::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_statistics_offset = ckb_offset - root_ckb_offset;
+    return data->statistics.get()->instantiate(
+        data->statistics.get(), data->statistics.get_type(), NULL, ckb,
+        ckb_offset, dst_tp, dst_arrmeta, 1, &states_tp, &states_arrmeta,
+        kernel_request_single, ectx, nd::array(),
+        std::map<nd::string, ndt::type>());
+  }
+
+  static void
+  resolve_dst_type(const arrfunc_type_data *af_self,
+                   const ndt::arrfunc_type *DYND_UNUSED(af_tp),
+                   char *DYND_UNUSED(data), ndt::type &dst_tp,
+                   intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                   const nd::array &DYND_UNUSED(kwds),
+                   const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    const describe_arrfunc_data *data =
+        *af_self->get_data_as<describe_arrfunc_data *>();
+    dst_tp = make_reduced_type(
+        src_tp[0], data->reduction_ndim, data->reduction_dimflags.get(),
+        data->keepdims, kernels::make_describe_statistics_type(data->stats));
+  }
+};
+} // anonymous namespace
+
+ndt::type kernels::make_describe_state_type()
+{
+  static ndt::type describe_tp = ndt::make_struct(
+      ndt::make_type<int64_t>(), "count", ndt::make_type<int64_t>(),
+      "na_count", ndt::make_type<double>(), "sum", ndt::make_type<double>(),
+      "min", ndt::make_type<double>(), "max");
+  return describe_tp;
+}
+
+ndt::type kernels::make_describe_statistics_type(int stats)
+{
+  const char *names[describe_statistic_count] = {"count", "na_count", "sum",
+                                                 "mean",  "min",      "max"};
+  if (stats <= 0 || (stats & ~describe_all) != 0) {
+    stringstream ss;
+    ss << "dynd describe: invalid statistics flags " << stats;
+    throw invalid_argument(ss.str());
+  }
+  vector<ndt::type> field_types;
+  vector<string> field_names;
+  for (int i = 0; i < describe_statistic_count; ++i) {
+    if (stats & (1 << i)) {
+      field_types.push_back(i < 2 ? ndt::make_type<int64_t>()
+                                  : ndt::make_type<double>());
+      field_names.push_back(names[i]);
+    }
+  }
+  return ndt::make_struct(field_names, field_types);
+}
+
+nd::arrfunc
+kernels::make_builtin_describe_reduction_arrfunc(const ndt::type &src_tp)
+{
+  arrfunc_instantiate_t instantiate;
+  if (src_tp.get_type_id() == option_type_id) {
+    instantiate = get_describe_reduction_instantiate<true>(
+        src_tp.extended<ndt::option_type>()->get_value_type().get_type_id());
+  } else {
+    instantiate = get_describe_reduction_instantiate<false>(
+        src_tp.get_type_id());
+  }
+  if (instantiate == NULL) {
+    stringstream ss;
+    ss << "make_builtin_describe_reduction_arrfunc: data type " << src_tp
+       << " is not supported";
+    throw type_error(ss.str());
+  }
+  nd::array af = nd::empty(ndt::make_arrfunc(ndt::make_tuple(src_tp),
+                                             make_describe_state_type()));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  new (out_af->get_data_as<ndt::type>()) ndt::type(src_tp);
+  out_af->instantiate = instantiate;
+  out_af->free = &destroy_wrapper<ndt::type>;
+  af.flag_as_immutable();
+  return af;
+}
+
+nd::arrfunc kernels::make_describe_combine_arrfunc()
+{
+  return detail::make_unary_arrfunc(make_describe_state_type(),
+                                    make_describe_state_type(),
+                                    &describe_combine_kernel::instantiate);
+}
+
+nd::arrfunc kernels::lift_builtin_describe_reduction_arrfunc(
+    const ndt::type &src_tp, const ndt::type &lifted_arr_type, bool keepdims,
+    intptr_t reduction_ndim, const bool *reduction_dimflags)
+{
+  nd::array identity = nd::empty(make_describe_state_type());
+  describe_state empty = {0, 0, 0, numeric_limits<double>::infinity(),
+                          -numeric_limits<double>::infinity()};
+  *reinterpret_cast<describe_state *>(identity.get_readwrite_originptr()) =
+      empty;
+  identity.flag_as_immutable();
+  return lift_reduction_arrfunc(
+      make_builtin_describe_reduction_arrfunc(src_tp), lifted_arr_type,
+      nd::array(), keepdims, reduction_ndim, reduction_dimflags, true, true,
+      false, identity, make_describe_combine_arrfunc());
+}
+
+nd::arrfunc kernels::make_describe_statistics_arrfunc(int stats)
+{
+  return nd::arrfunc::make<describe_statistics_virtual_kernel>(
+      ndt::make_arrfunc(ndt::make_tuple(make_describe_state_type()),
+                        make_describe_statistics_type(stats)),
+      stats, 0);
+}
+
+nd::arrfunc kernels::make_builtin_describe_arrfunc(
+    int stats, const ndt::type &src_tp, const ndt::type &lifted_arr_type,
+    bool keepdims, intptr_t reduction_ndim, const bool *reduction_dimflags)
+{
+  std::shared_ptr<describe_arrfunc_data> data(new describe_arrfunc_data);
+  data->reduction = lift_builtin_describe_reduction_arrfunc(
+      src_tp, lifted_arr_type, keepdims, reduction_ndim, reduction_dimflags);
+  data->statistics = make_describe_statistics_arrfunc(stats);
+  data->stats = stats;
+  data->keepdims = keepdims;
+  data->reduction_ndim = reduction_ndim;
+  data->reduction_dimflags.reset(new bool[reduction_ndim]);
+  std::copy(reduction_dimflags, reduction_dimflags + reduction_ndim,
+            data->reduction_dimflags.get());
+  ndt::type dst_tp =
+      make_reduced_type(lifted_arr_type, reduction_ndim, reduction_dimflags,
+                        keepdims, make_describe_statistics_type(stats));
+  if (dst_tp.get_ndim() > 0) {
+    data->statistics = nd::functional::elwise(data->statistics);
+  }
+  return nd::arrfunc::make<describe_virtual_kernel>(
+      ndt::make_arrfunc(ndt::make_tuple(lifted_arr_type), dst_tp), data, 0);
+}
+
+nd::arrfunc kernels::make_builtin_describe1d_arrfunc(int stats,
+                                                     const ndt::type &src_tp)
+{
+  bool reduction_dimflags[1] = {true};
+  return make_builtin_describe_arrfunc(stats, src_tp,
+                                       ndt::make_fixed_dim_kind(src_tp), false,
+                                       1, reduction_dimflags);
+}
@@ -0,0 +1,722 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <memory>
+
+#include <dynd/hash_index.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/groupby_aggregate.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "kernel_helpers.hpp"
+
+using namespace std;
+using namespace dynd;
+using nd::functional::groupby_aggregate_t;
+
+namespace {
+
+using detail::is_nan_value;
+
+// The rows are grouped, then reduced, this many at a time
+const intptr_t groupby_batch_size = 1024;
+
+/** A key array, and the encoder of its elements */
+struct groupby_key {
+  const char *data;
+  intptr_t stride;
+  key_encoder encoder;
+
+  void encode(intptr_t row, std::vector<char> &buf) const
+  {
+    encoder.encode(data + row * stride, buf);
+  }
+};
+
+/**
+ * The partition of a hash, which uses its high bits, as the table slots use
+ * the low ones
+ */
+inline intptr_t get_partition(uint64_t hash, intptr_t nparts)
+{
+  return static_cast<intptr_t>((hash >> 40) % nparts);
+}
+
+inline void encode_keys(const std::vector<groupby_key> &keys, intptr_t row,
+                        std::vector<char> &buf)
+{
+  buf.clear();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i].encode(row, buf);
+  }
+}
+
+/** The state of one aggregation, for every group */
+struct groupby_accumulator {
+  virtual ~groupby_accumulator() {}
+
+  /** Appends the state of a new group */
+  virtual void add_group() = 0;
+
+  /**
+   * Adds the values of ``count`` rows to the groups they are in, the
+   * value of row ``rows[i]`` being in group ``groups[i]``
+   */
+  virtual void update(const intptr_t *groups, const intptr_t *rows,
+                      intptr_t count, const char *data, intptr_t stride) = 0;
+
+  /** Writes the aggregate of a group */
+  virtual void get(intptr_t group, char *dst) const = 0;
+};
+
+template <class T>
+struct count_accumulator : groupby_accumulator {
+  std::vector<int64_t> m_counts;
+
+  void add_group() { m_counts.push_back(0); }
+
+  void update(const intptr_t *groups, const intptr_t *rows, intptr_t count,
+              const char *data, intptr_t stride)
+  {
+    for (intptr_t i = 0; i < count; ++i) {
+      T v = *reinterpret_cast<const T *>(data + rows[i] * stride);
+      if (!is_nan_value(v)) {
+        ++m_counts[groups[i]];
+      }
+    }
+  }
+
+  void get(intptr_t group, char *dst) const
+  {
+    *reinterpret_cast<int64_t *>(dst) = m_counts[group];
+  }
+};
+
+template <class T, class A>
+struct sum_accumulator : groupby_accumulator {
+  std::vector<A> m_sums;
+
+  void add_group() { m_sums.push_back(0); }
+
+  void update(const intptr_t *groups, const intptr_t *rows, intptr_t count,
+              const char *data, intptr_t stride)
+  {
+    for (intptr_t i = 0; i < count; ++i) {
+      T v = *reinterpret_cast<const T *>(data + rows[i] * stride);
+      if (!is_nan_value(v)) {
+        m_sums[groups[i]] += static_cast<A>(v);
+      }
+    }
+  }
+
+  void get(intptr_t group, char *dst) const
+  {
+    *reinterpret_cast<A *>(dst) = m_sums[group];
+  }
+};
+
+template <class T>
+struct mean_accumulator : groupby_accumulator {
+  std::vector<double> m_sums;
+  std::vector<int64_t> m_counts;
+
+  void add_group()
+  {
+    m_sums.push_back(0);
+    m_counts.push_back(0);
+  }
+
+  void update(const intptr_t *groups, const intptr_t *rows, intptr_t count,
+              const char *data, intptr_t stride)
+  {
+    for (intptr_t i = 0; i < count; ++i) {
+      T v = *reinterpret_cast<const T *>(data + rows[i] * stride);
+      if (!is_nan_value(v)) {
+        m_sums[groups[i]] += static_cast<double>(v);
+        ++m_counts[groups[i]];
+      }
+    }
+  }
+
+  void get(intptr_t group, char *dst) const
+  {
+    *reinterpret_cast<double *>(dst) =
+        m_counts[group] > 0 ? m_sums[group] / m_counts[group]
+                            : numeric_limits<double>::quiet_NaN();
+  }
+};
+
+template <class T, bool Max>
+struct minmax_accumulator : groupby_accumulator {
+  std::vector<T> m_values;
+
+  void add_group()
+  {
+    // A group of NaNs only gets a NaN
+    if (numeric_limits<T>::has_quiet_NaN) {
+      m_values.push_back(numeric_limits<T>::quiet_NaN());
+    } else {
+      m_values.push_back(Max ? numeric_limits<T>::min()
+                             : numeric_limits<T>::max());
+    }
+  }
+
+  void update(const intptr_t *groups, const intptr_t *rows, intptr_t count,
+              const char *data, intptr_t stride)
+  {
+    for (intptr_t i = 0; i < count; ++i) {
+      T v = *reinterpret_cast<const T *>(data + rows[i] * stride);
+      T &cur = m_values[groups[i]];
+      if (!is_nan_value(v) &&
+          (is_nan_value(cur) || (Max ? (v > cur) : (v < cur)))) {
+        cur = v;
+      }
+    }
+  }
+
+  void get(intptr_t group, char *dst) const
+  {
+    *reinterpret_cast<T *>(dst) = m_values[group];
+  }
+};
+
+template <class T>
+struct sum_type {
+  typedef int64_t type;
+};
+
+template <>
+struct sum_type<uint8_t> {
+  typedef uint64_t type;
+};
+
+template <>
+struct sum_type<uint16_t> {
+  typedef uint64_t type;
+};
+
+template <>
+struct sum_type<uint32_t> {
+  typedef uint64_t type;
+};
+
+template <>
+struct sum_type<uint64_t> {
+  typedef uint64_t type;
+};
+
+template <>
+struct sum_type<float> {
+  typedef double type;
+};
+
+template <>
+struct sum_type<double> {
+  typedef double type;
+};
+
+template <class T>
+groupby_accumulator *make_typed_accumulator(groupby_aggregate_t op)
+{
+  switch (op) {
+  case nd::functional::groupby_count:
+    return new count_accumulator<T>;
+  case nd::functional::groupby_sum:
+    return new sum_accumulator<T, typename sum_type<T>::type>;
+  case nd::functional::groupby_mean:
+    return new mean_accumulator<T>;
+  case nd::functional::groupby_min:
+    return new minmax_accumulator<T, false>;
+  case nd::functional::groupby_max:
+    return new minmax_accumulator<T, true>;
+  default:
+    throw invalid_argument("dynd groupby_aggregate: unknown aggregation");
+  }
+}
+
+groupby_accumulator *make_accumulator(groupby_aggregate_t op, type_id_t tid)
+{
+  switch (tid) {
+  case bool_type_id:
+  case uint8_type_id:
+    return make_typed_accumulator<uint8_t>(op);
+  case uint16_type_id:
+    return make_typed_accumulator<uint16_t>(op);
+  case uint32_type_id:
+    return make_typed_accumulator<uint32_t>(op);
+  case uint64_type_id:
+    return make_typed_accumulator<uint64_t>(op);
+  case int8_type_id:
+    return make_typed_accumulator<int8_t>(op);
+  case int16_type_id:
+    return make_typed_accumulator<int16_t>(op);
+  case int32_type_id:
+    return make_typed_accumulator<int32_t>(op);
+  case int64_type_id:
+    return make_typed_accumulator<int64_t>(op);
+  case float32_type_id:
+    return make_typed_accumulator<float>(op);
+  case float64_type_id:
+    return make_typed_accumulator<double>(op);
+  default: {
+    stringstream ss;
+    ss << "dynd groupby_aggregate: value type " << ndt::type(tid)
+       << " is not supported";
+    throw type_error(ss.str());
+  }
+  }
+}
+
+/** The type of an aggregate of values of type ``value_tp`` */
+ndt::type get_aggregate_type(groupby_aggregate_t op,
+                             const ndt::type &value_tp)
+{
+  // Validates the value type
+  delete make_accumulator(op, value_tp.get_type_id());
+  switch (op) {
+  case nd::functional::groupby_count:
+    return ndt::make_type<int64_t>();
+  case nd::functional::groupby_mean:
+    return ndt::make_type<double>();
+  case nd::functional::groupby_sum:
+    switch (value_tp.get_type_id()) {
+    case float32_type_id:
+    case float64_type_id:
+      return ndt::make_type<double>();
+    case bool_type_id:
+    case uint8_type_id:
+    case uint16_type_id:
+    case uint32_type_id:
+    case uint64_type_id:
+      return ndt::make_type<uint64_t>();
+    default:
+      return ndt::make_type<int64_t>();
+    }
+  default:
+    return value_tp;
+  }
+}
+
+/**
+ * The groups of the rows of one partition, found with an open addressing
+ * hash table with linear probing, and their aggregates.
+ */
+struct groupby_table {
+  // The encoded keys of the groups, a group's id being its index
+  hash_index m_index;
+  std::vector<intptr_t> m_first_rows;
+  std::vector<std::unique_ptr<groupby_accumulator>> m_accumulators;
+
+  intptr_t get_group_count() const { return m_first_rows.size(); }
+
+  /** The group of the key, which is added if it's new */
+  intptr_t find_or_insert(const std::vector<char> &key, uint64_t hash,
+                          intptr_t row)
+  {
+    bool inserted;
+    intptr_t g = m_index.insert(key.empty() ? NULL : &key[0], key.size(),
+                                hash, inserted);
+    if (inserted) {
+      m_first_rows.push_back(row);
+      for (size_t i = 0; i < m_accumulators.size(); ++i) {
+        m_accumulators[i]->add_group();
+      }
+    }
+    return g;
+  }
+};
+
+struct groupby_value {
+  const char *data;
+  intptr_t stride;
+  type_id_t tid;
+};
+
+/** The groupby aggregation ckernel, which runs over the whole arrays */
+struct groupby_aggregate_kernel
+    : nd::base_kernel<groupby_aggregate_kernel, kernel_request_host, -1> {
+  intptr_t m_size;
+  std::vector<groupby_key> m_keys;
+  std::vector<groupby_value> m_values;
+  std::vector<nd::functional::groupby_aggregation> m_aggs;
+  intptr_t m_nthreads, m_grain_size;
+  // The fields of the destination struct
+  std::vector<ndt::type> m_field_tps;
+  std::vector<const char *> m_field_arrmeta;
+  std::vector<uintptr_t> m_field_offsets;
+  // The ckernels copying the elements of each key into the destination
+  std::vector<intptr_t> m_copy_offsets;
+  // The source pointers of strided, sized at instantiation
+  std::vector<char *> m_src_copy;
+
+  void init_table(groupby_table &table) const
+  {
+    for (size_t i = 0; i < m_aggs.size(); ++i) {
+      table.m_accumulators.push_back(std::unique_ptr<groupby_accumulator>(
+          make_accumulator(m_aggs[i].op, m_values[m_aggs[i].value].tid)));
+    }
+  }
+
+  /**
+   * Groups the rows with the given hashes, or hashes them if ``hashes``
+   * is NULL, and adds their values to the aggregates
+   */
+  void process_rows(groupby_table &table, const intptr_t *rows,
+                    const uint64_t *hashes, intptr_t count,
+                    std::vector<char> &buf, intptr_t *groups) const
+  {
+    for (intptr_t i = 0; i < count; ++i) {
+      encode_keys(m_keys, rows[i], buf);
+      uint64_t hash = hashes != NULL ? hashes[i] : hash_bytes(buf);
+      groups[i] = table.find_or_insert(buf, hash, rows[i]);
+    }
+    for (size_t i = 0; i < m_aggs.size(); ++i) {
+      const groupby_value &value = m_values[m_aggs[i].value];
+      table.m_accumulators[i]->update(groups, rows, count, value.data,
+                                      value.stride);
+    }
+  }
+
+  void group_serial(groupby_table &table) const
+  {
+    std::vector<char> buf;
+    intptr_t rows[groupby_batch_size], groups[groupby_batch_size];
+    for (intptr_t begin = 0; begin < m_size; begin += groupby_batch_size) {
+      intptr_t count = std::min(groupby_batch_size, m_size - begin);
+      for (intptr_t i = 0; i < count; ++i) {
+        rows[i] = begin + i;
+      }
+      process_rows(table, rows, NULL, count, buf, groups);
+    }
+  }
+
+  /**
+   * Groups the rows of one partition, which are in order so the
+   * aggregates match the serial ones
+   */
+  void group_partition(groupby_table &table, const intptr_t *rows,
+                       const uint64_t *hashes, intptr_t size) const
+  {
+    std::vector<char> buf;
+    intptr_t groups[groupby_batch_size];
+    for (intptr_t begin = 0; begin < size; begin += groupby_batch_size) {
+      process_rows(table, rows + begin, hashes + begin,
+                   std::min(groupby_batch_size, size - begin), buf, groups);
+    }
+  }
+
+  /**
+   * Hashes the rows, and scatters them into the partitions of their hashes
+   * with a counting sort, so each thread only reads the rows of its own
+   * partition. ``part_begin`` receives the ``nparts + 1`` boundaries of the
+   * partitions in ``part_rows`` and ``part_hashes``.
+   */
+  void partition_rows(intptr_t nparts, std::vector<intptr_t> &part_begin,
+                      std::vector<intptr_t> &part_rows,
+                      std::vector<uint64_t> &part_hashes) const
+  {
+    std::vector<intptr_t> chunk_begin;
+    intptr_t nchunks =
+        partition_range(m_nthreads, m_size, m_grain_size, chunk_begin);
+    std::vector<uint64_t> hashes(m_size);
+    // The number of rows of each chunk in each partition, then the
+    // position of its next row in the partition
+    std::vector<intptr_t> offsets(nchunks * nparts, 0);
+    thread_pool::get().run(m_nthreads, nchunks, [&](intptr_t c) {
+      std::vector<char> buf;
+      intptr_t *counts = &offsets[c * nparts];
+      for (intptr_t row = chunk_begin[c]; row < chunk_begin[c + 1]; ++row) {
+        encode_keys(m_keys, row, buf);
+        hashes[row] = hash_bytes(buf);
+        ++counts[get_partition(hashes[row], nparts)];
+      }
+    });
+
+    // The rows of a partition follow each other chunk by chunk, so they
+    // stay in order
+    part_begin.resize(nparts + 1);
+    intptr_t total = 0;
+    for (intptr_t p = 0; p < nparts; ++p) {
+      part_begin[p] = total;
+      for (intptr_t c = 0; c < nchunks; ++c) {
+        intptr_t count = offsets[c * nparts + p];
+        offsets[c * nparts + p] = total;
+        total += count;
+      }
+    }
+    part_begin[nparts] = total;
+
+    part_rows.resize(m_size);
+    part_hashes.resize(m_size);
+    thread_pool::get().run(m_nthreads, nchunks, [&](intptr_t c) {
+      intptr_t *next = &offsets[c * nparts];
+      for (intptr_t row = chunk_begin[c]; row < chunk_begin[c + 1]; ++row) {
+        intptr_t i = next[get_partition(hashes[row], nparts)]++;
+        part_rows[i] = row;
+        part_hashes[i] = hashes[row];
+      }
+    });
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+      m_keys[i].data = src[i];
+    }
+    for (size_t i = 0; i < m_values.size(); ++i) {
+      m_values[i].data = src[m_keys.size() + i];
+    }
+
+    intptr_t nparts = 1;
+    if (m_nthreads > 1 && m_size >= 2 * m_grain_size) {
+      nparts = m_nthreads;
+    }
+    std::vector<groupby_table> tables(nparts);
+    for (intptr_t p = 0; p < nparts; ++p) {
+      init_table(tables[p]);
+    }
+    if (nparts == 1) {
+      group_serial(tables[0]);
+    } else {
+      std::vector<intptr_t> part_begin, part_rows;
+      std::vector<uint64_t> part_hashes;
+      partition_rows(nparts, part_begin, part_rows, part_hashes);
+      thread_pool::get().run(m_nthreads, nparts, [&](intptr_t p) {
+        group_partition(tables[p], &part_rows[part_begin[p]],
+                        &part_hashes[part_begin[p]],
+                        part_begin[p + 1] - part_begin[p]);
+      });
+    }
+
+    // The groups of all the partitions, ordered by their first row
+    std::vector<std::pair<intptr_t, std::pair<intptr_t, intptr_t>>> order;
+    for (intptr_t p = 0; p < nparts; ++p) {
+      for (intptr_t g = 0; g < tables[p].get_group_count(); ++g) {
+        order.push_back(std::make_pair(tables[p].m_first_rows[g],
+                                       std::make_pair(p, g)));
+      }
+    }
+    if (nparts > 1) {
+      std::sort(order.begin(), order.end());
+    }
+    intptr_t ngroups = order.size();
+
+    for (size_t f = 0; f < m_field_tps.size(); ++f) {
+      char *field_data = dst + m_field_offsets[f];
+      ndt::var_dim_element_initialize(m_field_tps[f], m_field_arrmeta[f],
+                                      field_data, ngroups);
+      const var_dim_type_arrmeta *md =
+          reinterpret_cast<const var_dim_type_arrmeta *>(m_field_arrmeta[f]);
+      char *el = reinterpret_cast<var_dim_type_data *>(field_data)->begin +
+                 md->offset;
+      if (f < m_keys.size()) {
+        ckernel_prefix *copy = get_child_ckernel(m_copy_offsets[f]);
+        expr_single_t copy_fn = copy->get_function<expr_single_t>();
+        for (intptr_t i = 0; i < ngroups; ++i, el += md->stride) {
+          char *child_src =
+              const_cast<char *>(m_keys[f].data) +
+              order[i].first * m_keys[f].stride;
+          copy_fn(el, &child_src, copy);
+        }
+      } else {
+        size_t a = f - m_keys.size();
+        for (intptr_t i = 0; i < ngroups; ++i, el += md->stride) {
+          tables[order[i].second.first].m_accumulators[a]->get(
+              order[i].second.second, el);
+        }
+      }
+    }
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    std::copy(src, src + m_src_copy.size(), m_src_copy.begin());
+    for (size_t i = 0; i != count; ++i) {
+      single(dst, &m_src_copy[0]);
+      dst += dst_stride;
+      for (size_t j = 0; j != m_src_copy.size(); ++j) {
+        m_src_copy[j] += src_stride[j];
+      }
+    }
+  }
+
+  void destruct_children()
+  {
+    for (size_t i = 0; i < m_copy_offsets.size(); ++i) {
+      destroy_child_ckernel(m_copy_offsets[i]);
+    }
+  }
+};
+
+/** The element type of a one dimensional argument */
+ndt::type get_groupby_element_type(const ndt::type &tp)
+{
+  if (tp.get_ndim() != 1 || tp.get_kind() != dim_kind) {
+    stringstream ss;
+    ss << "dynd groupby_aggregate: the arguments must be one dimensional, "
+          "got " << tp;
+    throw type_error(ss.str());
+  }
+  return tp.extended<ndt::base_dim_type>()->get_element_type();
+}
+
+void check_groupby_nsrc(const nd::functional::groupby_aggregate_arrfunc_data *data,
+                        intptr_t nsrc)
+{
+  if (nsrc != data->nkeys + data->nvalues) {
+    stringstream ss;
+    ss << "dynd groupby_aggregate: expected " << data->nkeys
+       << " key arrays and " << data->nvalues << " value arrays, got " << nsrc
+       << " arguments";
+    throw invalid_argument(ss.str());
+  }
+}
+
+} // anonymous namespace
+
+intptr_t nd::functional::groupby_aggregate_ck::instantiate(
+    const arrfunc_type_data *af_self,
+    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const groupby_aggregate_arrfunc_data *data =
+      *af_self->get_data_as<groupby_aggregate_arrfunc_data *>();
+  check_groupby_nsrc(data, nsrc);
+  if (dst_tp.get_type_id() != struct_type_id) {
+    stringstream ss;
+    ss << "dynd groupby_aggregate: the destination must be a struct, got "
+       << dst_tp;
+    throw type_error(ss.str());
+  }
+  const ndt::base_struct_type *dst_struct_tp =
+      dst_tp.extended<ndt::base_struct_type>();
+  if (dst_struct_tp->get_field_count() !=
+      data->nkeys + static_cast<intptr_t>(data->aggs.size())) {
+    stringstream ss;
+    ss << "dynd groupby_aggregate: destination type " << dst_tp
+       << " has the wrong number of fields";
+    throw type_error(ss.str());
+  }
+
+  intptr_t root_ckb_offset = ckb_offset;
+  groupby_aggregate_kernel *self =
+      groupby_aggregate_kernel::make(ckb, kernreq, ckb_offset);
+  self->m_aggs = data->aggs;
+  self->m_src_copy.resize(nsrc);
+  self->m_nthreads =
+      (ectx != NULL && ectx->nthreads > 1) ? ectx->nthreads : 1;
+  self->m_grain_size = ectx != NULL ? ectx->parallel_grain_size : 1;
+
+  // The arguments, which all have one fixed dimension of the same size
+  std::vector<ndt::type> el_tp(nsrc);
+  std::vector<const char *> el_arrmeta(nsrc);
+  for (intptr_t i = 0; i < nsrc; ++i) {
+    intptr_t size, stride;
+    if (!src_tp[i].get_as_strided(src_arrmeta[i], &size, &stride, &el_tp[i],
+                                  &el_arrmeta[i]) ||
+        el_tp[i].get_ndim() != 0) {
+      stringstream ss;
+      ss << "dynd groupby_aggregate: the arguments must have one fixed "
+            "dimension, got " << src_tp[i];
+      throw type_error(ss.str());
+    }
+    if (i == 0) {
+      self->m_size = size;
+    } else if (size != self->m_size) {
+      throw broadcast_error(self->m_size, size, "groupby_aggregate key",
+                            "groupby_aggregate argument");
+    }
+    if (i < data->nkeys) {
+      if (!key_encoder::is_supported(el_tp[i])) {
+        stringstream ss;
+        ss << "dynd groupby_aggregate: key type " << el_tp[i]
+           << " is not supported";
+        throw type_error(ss.str());
+      }
+      groupby_key key;
+      key.data = NULL;
+      key.stride = stride;
+      key.encoder = key_encoder(el_tp[i], el_arrmeta[i]);
+      self->m_keys.push_back(key);
+    } else {
+      groupby_value value = {NULL, stride, el_tp[i].get_type_id()};
+      self->m_values.push_back(value);
+    }
+  }
+  for (size_t i = 0; i < data->aggs.size(); ++i) {
+    get_aggregate_type(data->aggs[i].op,
+                       el_tp[data->nkeys + data->aggs[i].value]);
+  }
+
+  const uintptr_t *data_offsets = dst_struct_tp->get_data_offsets(dst_arrmeta);
+  const uintptr_t *arrmeta_offsets = dst_struct_tp->get_arrmeta_offsets_raw();
+  for (intptr_t f = 0; f < dst_struct_tp->get_field_count(); ++f) {
+    const ndt::type &field_tp = dst_struct_tp->get_field_type(f);
+    if (field_tp.get_type_id() != var_dim_type_id) {
+      stringstream ss;
+      ss << "dynd groupby_aggregate: the destination fields must be var "
+            "dimensions, got " << field_tp;
+      throw type_error(ss.str());
+    }
+    self->m_field_tps.push_back(field_tp);
+    self->m_field_arrmeta.push_back(dst_arrmeta + arrmeta_offsets[f]);
+    self->m_field_offsets.push_back(data_offsets[f]);
+  }
+
+  self->m_copy_offsets.resize(data->nkeys);
+  for (intptr_t i = 0; i < data->nkeys; ++i) {
+    self = groupby_aggregate_kernel::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_copy_offsets[i] = ckb_offset - root_ckb_offset;
+    const ndt::type &field_tp = self->m_field_tps[i];
+    ckb_offset = make_assignment_kernel(
+        NULL, NULL, ckb, ckb_offset,
+        field_tp.extended<ndt::base_dim_type>()->get_element_type(),
+        self->m_field_arrmeta[i] + sizeof(var_dim_type_arrmeta), el_tp[i],
+        el_arrmeta[i], kernel_request_single, ectx, nd::array());
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  }
+  return ckb_offset;
+}
+
+void nd::functional::groupby_aggregate_ck::resolve_dst_type(
+    const arrfunc_type_data *af_self,
+    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data),
+    ndt::type &dst_tp, intptr_t nsrc, const ndt::type *src_tp,
+    const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const groupby_aggregate_arrfunc_data *data =
+      *af_self->get_data_as<groupby_aggregate_arrfunc_data *>();
+  check_groupby_nsrc(data, nsrc);
+
+  std::vector<std::string> field_names;
+  std::vector<ndt::type> field_tps;
+  for (intptr_t i = 0; i < data->nkeys; ++i) {
+    stringstream ss;
+    ss << "key" << i;
+    field_names.push_back(ss.str());
+    field_tps.push_back(ndt::make_var_dim(
+        get_groupby_element_type(src_tp[i]).get_canonical_type()));
+  }
+  for (size_t i = 0; i < data->aggs.size(); ++i) {
+    const groupby_aggregation &agg = data->aggs[i];
+    field_names.push_back(agg.name);
+    field_tps.push_back(ndt::make_var_dim(get_aggregate_type(
+        agg.op, get_groupby_element_type(src_tp[data->nkeys + agg.value]))));
+  }
+  dst_tp = ndt::make_struct(field_names, field_tps);
+}
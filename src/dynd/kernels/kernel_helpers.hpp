@@ -0,0 +1,158 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+// This file is an internal implementation detail of the kernels which walk
+// dimensions and read keyword arguments, like sort, scan and the reductions
+
+#pragma once
+
+#include <sstream>
+#include <string>
+
+#include <dynd/array.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+namespace dynd {
+namespace detail {
+
+  template <class T>
+  struct is_complex_value {
+    enum { value = false };
+  };
+
+  template <class T>
+  struct is_complex_value<dynd::complex<T>> {
+    enum { value = true };
+  };
+
+  template <class T>
+  inline bool is_nan_value(T DYND_UNUSED(v))
+  {
+    return false;
+  }
+
+  inline bool is_nan_value(float v) { return v != v; }
+
+  inline bool is_nan_value(double v) { return v != v; }
+
+  /**
+   * The keyword argument ``name``, or a NULL nd::array if it was not given.
+   * The kwds are absent altogether when an arrfunc is instantiated as a
+   * child of another one, like a lifted reduction or a rolling window.
+   */
+  inline nd::array get_kwd(const nd::array &kwds, const char *name)
+  {
+    if (!kwds.is_null() && kwds.get_type().get_kind() == struct_kind &&
+        kwds.get_type().extended<ndt::base_struct_type>()->get_field_index(
+            name) >= 0) {
+      nd::array value = kwds.p(name);
+      if (!value.is_missing()) {
+        return value;
+      }
+    }
+    return nd::array();
+  }
+
+  /**
+   * The ``axis`` keyword argument, or ``default_axis`` if it was not given,
+   * with a negative axis counted from the end of the ``ndim`` dimensions.
+   */
+  inline intptr_t get_axis_kwd(const nd::array &kwds, intptr_t ndim,
+                               intptr_t default_axis)
+  {
+    nd::array value = get_kwd(kwds, "axis");
+    intptr_t axis = value.is_null() ? default_axis : value.as<intptr_t>();
+    if (axis < -ndim || axis >= ndim) {
+      throw axis_out_of_bounds(axis, ndim);
+    }
+    return axis < 0 ? axis + ndim : axis;
+  }
+
+  /**
+   * One dimension a kernel goes through, either a fixed dimension whose
+   * size and stride are known when the ckernel is made, or a var dimension
+   * read from (or, for the destination, allocated in) each element.
+   */
+  struct fixed_or_var_dim {
+    // The size of a fixed dimension, or -1 for a var dimension
+    intptr_t size;
+    intptr_t stride;
+    // For a var dimension
+    ndt::type tp;
+    const char *arrmeta;
+    intptr_t offset;
+    // The name of the kernel, for errors
+    const char *name;
+
+    void init(const char *kernel_name, const ndt::type &dim_tp,
+              const char *dim_arrmeta, ndt::type &el_tp,
+              const char *&el_arrmeta)
+    {
+      name = kernel_name;
+      if (dim_tp.get_type_id() == var_dim_type_id) {
+        const var_dim_type_arrmeta *md =
+            reinterpret_cast<const var_dim_type_arrmeta *>(dim_arrmeta);
+        size = -1;
+        stride = md->stride;
+        tp = dim_tp;
+        arrmeta = dim_arrmeta;
+        offset = md->offset;
+        el_tp = dim_tp.extended<ndt::base_dim_type>()->get_element_type();
+        el_arrmeta = dim_arrmeta + sizeof(var_dim_type_arrmeta);
+      } else if (!dim_tp.get_as_strided(dim_arrmeta, &size, &stride, &el_tp,
+                                        &el_arrmeta)) {
+        std::stringstream ss;
+        ss << "dynd " << name << ": could not process type " << dim_tp
+           << " as a dimension";
+        throw type_error(ss.str());
+      }
+    }
+
+    /** The source data of the dimension, setting ``dim_size`` */
+    char *get_src(char *data, intptr_t &dim_size) const
+    {
+      if (size >= 0) {
+        dim_size = size;
+        return data;
+      }
+      const var_dim_type_data *d =
+          reinterpret_cast<const var_dim_type_data *>(data);
+      dim_size = d->size;
+      return d->begin + offset;
+    }
+
+    /**
+     * The destination data of the dimension, allocating a var dimension
+     * which hasn't been yet
+     */
+    char *get_dst(char *data, intptr_t dim_size) const
+    {
+      if (size >= 0) {
+        if (size != dim_size) {
+          throw_broadcast_error(size, dim_size);
+        }
+        return data;
+      }
+      var_dim_type_data *d = reinterpret_cast<var_dim_type_data *>(data);
+      if (d->begin == NULL) {
+        ndt::var_dim_element_initialize(tp, arrmeta, data, dim_size);
+      } else if (static_cast<intptr_t>(d->size) != dim_size) {
+        throw_broadcast_error(d->size, dim_size);
+      }
+      return d->begin + offset;
+    }
+
+  private:
+    void throw_broadcast_error(intptr_t dst_size, intptr_t src_size) const
+    {
+      throw broadcast_error(dst_size, src_size,
+                            (std::string(name) + " dst").c_str(),
+                            (std::string(name) + " src").c_str());
+    }
+  };
+
+} // namespace dynd::detail
+} // namespace dynd
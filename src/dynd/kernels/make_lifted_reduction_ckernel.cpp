@@ -10,6 +10,7 @@
 #include <dynd/kernels/expr_kernel_generator.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
 #include <dynd/kernels/base_kernel.hpp>
+#include <dynd/thread_pool.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -624,6 +625,65 @@ struct strided_inner_broadcast_kernel_extra
   }
 };
 
+/**
+ * PARALLEL OUTER REDUCTION DIMENSION
+ * This ckernel splits the outermost dimension, which is being reduced,
+ * into contiguous chunks executed on the thread pool, where:
+ *  - Each chunk has its own copy of the lifted reduction ckernel, which
+ *    reduces the chunk into a private partial result.
+ *  - The partial results are then combined in chunk order by another
+ *    lifted reduction, so only associativity is required of the operation.
+ *
+ * Requirements:
+ *  - The chunk ckernels must be *single*, taking the start of the chunk.
+ *  - The combining ckernel must be *single*, reducing the partials array.
+ *
+ */
+struct parallel_outer_reduction_kernel
+    : nd::base_kernel<parallel_outer_reduction_kernel, kernel_request_host,
+                      1> {
+  typedef parallel_outer_reduction_kernel self_type;
+
+  intptr_t nthreads;
+  intptr_t src_stride;
+  std::vector<intptr_t> chunk_begin;
+  std::vector<intptr_t> chunk_offsets;
+  intptr_t combine_offset;
+  // A "nchunks * <dst type>" array holding each chunk's partial result
+  nd::array partials;
+
+  parallel_outer_reduction_kernel(intptr_t nthreads, intptr_t src_stride)
+      : nthreads(nthreads), src_stride(src_stride)
+  {
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    char *partials_data = partials.get_readwrite_originptr();
+    intptr_t partials_stride =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(
+            partials.get_arrmeta())->stride;
+    thread_pool::get().run(nthreads, chunk_offsets.size(), [&](intptr_t i) {
+      ckernel_prefix *chunk = get_child_ckernel(chunk_offsets[i]);
+      expr_single_t chunk_fn = chunk->get_function<expr_single_t>();
+      char *chunk_src = src[0] + chunk_begin[i] * src_stride;
+      chunk_fn(partials_data + i * partials_stride, &chunk_src, chunk);
+    });
+
+    ckernel_prefix *combine = get_child_ckernel(combine_offset);
+    expr_single_t combine_fn = combine->get_function<expr_single_t>();
+    combine_fn(dst, &partials_data, combine);
+  }
+
+  void destruct_children()
+  {
+    for (size_t i = 0; i < chunk_offsets.size(); ++i) {
+      destroy_child_ckernel(chunk_offsets[i]);
+    }
+    destroy_child_ckernel(combine_offset);
+  }
+};
+
 } // anonymous namespace
 
 /**
@@ -1005,90 +1065,23 @@ static size_t make_strided_inner_broadcast_dimension_kernel(
   return ckb_offset;
 }
 
-size_t dynd::make_lifted_reduction_ckernel(
+/**
+ * Adds the ckernel layers for all the dimensions of the reduction, once
+ * the arguments have been validated. If ``outer_src_size`` is not negative,
+ * it replaces the size of the outermost source dimension, so the ckernel
+ * processes a leading chunk of it.
+ */
+static size_t make_lifted_reduction_dimension_kernels(
     const arrfunc_type_data *elwise_reduction,
     const ndt::arrfunc_type *elwise_reduction_tp,
     const arrfunc_type_data *dst_initialization,
-    const ndt::arrfunc_type *dst_initialization_tp, void *ckb, intptr_t ckb_offset,
-    const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src_tp,
-    const char *src_arrmeta, intptr_t reduction_ndim,
-    const bool *reduction_dimflags, bool associative, bool commutative,
-    bool right_associative, const nd::array &reduction_identity,
+    const ndt::arrfunc_type *dst_initialization_tp, void *ckb,
+    intptr_t ckb_offset, const ndt::type &dst_tp, const char *dst_arrmeta,
+    const ndt::type &src_tp, const char *src_arrmeta, intptr_t reduction_ndim,
+    const bool *reduction_dimflags, bool keep_dims, bool right_associative,
+    const nd::array &reduction_identity, intptr_t outer_src_size,
     dynd::kernel_request_t kernreq, const eval::eval_context *ectx)
 {
-  // Count the number of dimensions being reduced
-  intptr_t reducedim_count = 0;
-  for (intptr_t i = 0; i < reduction_ndim; ++i) {
-    reducedim_count += reduction_dimflags[i];
-  }
-  if (reducedim_count == 0) {
-    if (reduction_ndim == 0) {
-      // If there are no dimensions to reduce, it's
-      // just a dst_initialization operation, so create
-      // that ckernel directly
-      if (dst_initialization != NULL) {
-        return dst_initialization->instantiate(
-            dst_initialization, dst_initialization_tp, NULL, ckb, ckb_offset,
-            dst_tp, dst_arrmeta, elwise_reduction_tp->get_npos(), &src_tp,
-            &src_arrmeta, kernreq, ectx, nd::array(),
-            std::map<nd::string, ndt::type>());
-      } else if (reduction_identity.is_null()) {
-        return make_assignment_kernel(NULL, NULL, ckb, ckb_offset, dst_tp,
-                                      dst_arrmeta, src_tp, src_arrmeta, kernreq,
-                                      ectx, nd::array());
-      } else {
-        // Create the kernel which copies the identity and then
-        // does one reduction
-        return make_strided_inner_reduction_dimension_kernel(
-            elwise_reduction, elwise_reduction_tp, dst_initialization,
-            dst_initialization_tp, ckb, ckb_offset, 0, 1, dst_tp, dst_arrmeta,
-            src_tp, src_arrmeta, right_associative, reduction_identity, kernreq,
-            ectx);
-      }
-    }
-    throw runtime_error("make_lifted_reduction_ckernel: no dimensions were "
-                        "flagged for reduction");
-  }
-
-  if (!(reducedim_count == 1 || (associative && commutative))) {
-    throw runtime_error(
-        "make_lifted_reduction_ckernel: for reducing along multiple dimensions,"
-        " the reduction function must be both associative and commutative");
-  }
-  if (right_associative) {
-    throw runtime_error("make_lifted_reduction_ckernel: right_associative is "
-                        "not yet supported");
-  }
-
-  ndt::type dst_el_tp = elwise_reduction_tp->get_return_type();
-  ndt::type src_el_tp = elwise_reduction_tp->get_pos_type(0);
-
-  // This is the number of dimensions being processed by the reduction
-  if (reduction_ndim != src_tp.get_ndim() - src_el_tp.get_ndim()) {
-    stringstream ss;
-    ss << "make_lifted_reduction_ckernel: wrong number of reduction "
-          "dimensions, ";
-    ss << "requested " << reduction_ndim << ", but types have ";
-    ss << (src_tp.get_ndim() - src_el_tp.get_ndim());
-    ss << " lifting from " << src_el_tp << " to " << src_tp;
-    throw runtime_error(ss.str());
-  }
-  // Determine whether reduced dimensions are being kept or not
-  bool keep_dims;
-  if (reduction_ndim == dst_tp.get_ndim() - dst_el_tp.get_ndim()) {
-    keep_dims = true;
-  } else if (reduction_ndim - reducedim_count ==
-             dst_tp.get_ndim() - dst_el_tp.get_ndim()) {
-    keep_dims = false;
-  } else {
-    stringstream ss;
-    ss << "make_lifted_reduction_ckernel: The number of dimensions flagged for "
-          "reduction, ";
-    ss << reducedim_count << ", is not consistent with the destination type ";
-    ss << "reducing " << dst_tp << " with element " << dst_el_tp;
-    throw runtime_error(ss.str());
-  }
-
   ndt::type dst_i_tp = dst_tp, src_i_tp = src_tp;
 
   for (intptr_t i = 0; i < reduction_ndim; ++i) {
@@ -1101,6 +1094,9 @@ size_t dynd::make_lifted_reduction_ckernel(
          << " not supported as source";
       throw type_error(ss.str());
     }
+    if (i == 0 && outer_src_size >= 0) {
+      src_size = outer_src_size;
+    }
     if (reduction_dimflags[i]) {
       // This dimension is being reduced
       if (src_size == 0 && reduction_identity.is_null()) {
@@ -1186,3 +1182,202 @@ size_t dynd::make_lifted_reduction_ckernel(
   throw runtime_error("make_lifted_reduction_ckernel: internal error, "
                       "should have returned in the loop");
 }
+
+/**
+ * Returns true if the reduction should split its outermost dimension across
+ * the thread pool. That dimension must be reduced and large enough, and
+ * combining the partial results needs an associative operation and a
+ * combine arrfunc. The elementwise reduction can't stand in for the
+ * combine, even when its types match, because it may not merge two
+ * accumulators, like count_nonzero, or a reduction with a
+ * dst_initialization.
+ */
+static bool use_parallel_reduction(
+    const arrfunc_type_data *combine, const ndt::type &dst_tp,
+    const ndt::type &src_tp, const char *src_arrmeta,
+    const bool *reduction_dimflags, bool associative,
+    kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+  if (kernreq != kernel_request_single || ectx == NULL ||
+      ectx->nthreads <= 1 || !reduction_dimflags[0] || !associative ||
+      combine == NULL ||
+      (dst_tp.get_flags() & type_flag_blockref) ||
+      src_tp.get_type_id() != fixed_dim_type_id) {
+    return false;
+  }
+  intptr_t src_size =
+      reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta)->dim_size;
+  return src_size >= 2 * ectx->parallel_grain_size;
+}
+
+/**
+ * Adds a ckernel which reduces chunks of the outermost dimension in
+ * parallel, one copy of the lifted reduction per chunk, followed by a
+ * lifted reduction of ``combine`` merging the partial results in order.
+ */
+static size_t make_parallel_outer_reduction_kernel(
+    const arrfunc_type_data *elwise_reduction,
+    const ndt::arrfunc_type *elwise_reduction_tp,
+    const arrfunc_type_data *dst_initialization,
+    const ndt::arrfunc_type *dst_initialization_tp,
+    const arrfunc_type_data *combine, const ndt::arrfunc_type *combine_tp,
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
+    intptr_t reduction_ndim, const bool *reduction_dimflags, bool keep_dims,
+    const nd::array &reduction_identity, kernel_request_t kernreq,
+    const eval::eval_context *ectx)
+{
+  typedef parallel_outer_reduction_kernel self_type;
+  const fixed_dim_type_arrmeta *src_md =
+      reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta);
+
+  intptr_t root_ckb_offset = ckb_offset;
+  self_type *self = self_type::make(ckb, kernreq, ckb_offset, ectx->nthreads,
+                                    src_md->stride);
+  intptr_t nchunks =
+      partition_range(ectx->nthreads, src_md->dim_size,
+                      ectx->parallel_grain_size, self->chunk_begin);
+  self->chunk_offsets.resize(nchunks);
+  self->partials = nd::empty(ndt::make_fixed_dim(nchunks, dst_tp));
+  ndt::type partials_tp = self->partials.get_type();
+  const char *partials_arrmeta = self->partials.get_arrmeta();
+  const char *partial_arrmeta =
+      partials_arrmeta + sizeof(fixed_dim_type_arrmeta);
+
+  // The serial reduction of each chunk into its partial result
+  for (intptr_t i = 0; i < nchunks; ++i) {
+    self = self_type::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->chunk_offsets[i] = ckb_offset - root_ckb_offset;
+    ckb_offset = make_lifted_reduction_dimension_kernels(
+        elwise_reduction, elwise_reduction_tp, dst_initialization,
+        dst_initialization_tp, ckb, ckb_offset, dst_tp, partial_arrmeta,
+        src_tp, src_arrmeta, reduction_ndim, reduction_dimflags, keep_dims,
+        false, reduction_identity,
+        self->chunk_begin[i + 1] - self->chunk_begin[i], kernel_request_single,
+        ectx);
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  }
+
+  // Combining the partials reduces their first dimension, and broadcasts
+  // over the dimensions of the destination
+  ndt::type dst_el_tp = elwise_reduction_tp->get_return_type();
+  intptr_t combine_ndim = 1 + dst_tp.get_ndim() - dst_el_tp.get_ndim();
+  shortvector<bool> combine_dimflags(combine_ndim);
+  combine_dimflags[0] = true;
+  for (intptr_t i = 1; i < combine_ndim; ++i) {
+    combine_dimflags[i] = false;
+  }
+  self = self_type::get_self(
+      reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+      root_ckb_offset);
+  self->combine_offset = ckb_offset - root_ckb_offset;
+  return make_lifted_reduction_dimension_kernels(
+      combine, combine_tp, NULL, NULL, ckb, ckb_offset,
+      dst_tp, dst_arrmeta, partials_tp, partials_arrmeta, combine_ndim,
+      combine_dimflags.get(), false, false, nd::array(), -1,
+      kernel_request_single, ectx);
+}
+
+size_t dynd::make_lifted_reduction_ckernel(
+    const arrfunc_type_data *elwise_reduction,
+    const ndt::arrfunc_type *elwise_reduction_tp,
+    const arrfunc_type_data *dst_initialization,
+    const ndt::arrfunc_type *dst_initialization_tp, void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src_tp,
+    const char *src_arrmeta, intptr_t reduction_ndim,
+    const bool *reduction_dimflags, bool associative, bool commutative,
+    bool right_associative, const nd::array &reduction_identity,
+    dynd::kernel_request_t kernreq, const eval::eval_context *ectx,
+    const arrfunc_type_data *combine, const ndt::arrfunc_type *combine_tp)
+{
+  // Count the number of dimensions being reduced
+  intptr_t reducedim_count = 0;
+  for (intptr_t i = 0; i < reduction_ndim; ++i) {
+    reducedim_count += reduction_dimflags[i];
+  }
+  if (reducedim_count == 0) {
+    if (reduction_ndim == 0) {
+      // If there are no dimensions to reduce, it's
+      // just a dst_initialization operation, so create
+      // that ckernel directly
+      if (dst_initialization != NULL) {
+        return dst_initialization->instantiate(
+            dst_initialization, dst_initialization_tp, NULL, ckb, ckb_offset,
+            dst_tp, dst_arrmeta, elwise_reduction_tp->get_npos(), &src_tp,
+            &src_arrmeta, kernreq, ectx, nd::array(),
+            std::map<nd::string, ndt::type>());
+      } else if (reduction_identity.is_null()) {
+        return make_assignment_kernel(NULL, NULL, ckb, ckb_offset, dst_tp,
+                                      dst_arrmeta, src_tp, src_arrmeta, kernreq,
+                                      ectx, nd::array());
+      } else {
+        // Create the kernel which copies the identity and then
+        // does one reduction
+        return make_strided_inner_reduction_dimension_kernel(
+            elwise_reduction, elwise_reduction_tp, dst_initialization,
+            dst_initialization_tp, ckb, ckb_offset, 0, 1, dst_tp, dst_arrmeta,
+            src_tp, src_arrmeta, right_associative, reduction_identity, kernreq,
+            ectx);
+      }
+    }
+    throw runtime_error("make_lifted_reduction_ckernel: no dimensions were "
+                        "flagged for reduction");
+  }
+
+  if (!(reducedim_count == 1 || (associative && commutative))) {
+    throw runtime_error(
+        "make_lifted_reduction_ckernel: for reducing along multiple dimensions,"
+        " the reduction function must be both associative and commutative");
+  }
+  if (right_associative) {
+    throw runtime_error("make_lifted_reduction_ckernel: right_associative is "
+                        "not yet supported");
+  }
+
+  ndt::type dst_el_tp = elwise_reduction_tp->get_return_type();
+  ndt::type src_el_tp = elwise_reduction_tp->get_pos_type(0);
+
+  // This is the number of dimensions being processed by the reduction
+  if (reduction_ndim != src_tp.get_ndim() - src_el_tp.get_ndim()) {
+    stringstream ss;
+    ss << "make_lifted_reduction_ckernel: wrong number of reduction "
+          "dimensions, ";
+    ss << "requested " << reduction_ndim << ", but types have ";
+    ss << (src_tp.get_ndim() - src_el_tp.get_ndim());
+    ss << " lifting from " << src_el_tp << " to " << src_tp;
+    throw runtime_error(ss.str());
+  }
+  // Determine whether reduced dimensions are being kept or not
+  bool keep_dims;
+  if (reduction_ndim == dst_tp.get_ndim() - dst_el_tp.get_ndim()) {
+    keep_dims = true;
+  } else if (reduction_ndim - reducedim_count ==
+             dst_tp.get_ndim() - dst_el_tp.get_ndim()) {
+    keep_dims = false;
+  } else {
+    stringstream ss;
+    ss << "make_lifted_reduction_ckernel: The number of dimensions flagged for "
+          "reduction, ";
+    ss << reducedim_count << ", is not consistent with the destination type ";
+    ss << "reducing " << dst_tp << " with element " << dst_el_tp;
+    throw runtime_error(ss.str());
+  }
+
+  if (use_parallel_reduction(combine, dst_tp, src_tp, src_arrmeta,
+                             reduction_dimflags, associative, kernreq, ectx)) {
+    return make_parallel_outer_reduction_kernel(
+        elwise_reduction, elwise_reduction_tp, dst_initialization,
+        dst_initialization_tp, combine, combine_tp, ckb, ckb_offset, dst_tp,
+        dst_arrmeta, src_tp, src_arrmeta, reduction_ndim, reduction_dimflags,
+        keep_dims, reduction_identity, kernreq, ectx);
+  }
+
+  return make_lifted_reduction_dimension_kernels(
+      elwise_reduction, elwise_reduction_tp, dst_initialization,
+      dst_initialization_tp, ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp,
+      src_arrmeta, reduction_ndim, reduction_dimflags, keep_dims,
+      right_associative, reduction_identity, -1, kernreq, ectx);
+}
@@ -0,0 +1,358 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <cstddef>
+
+#include <dynd/kernels/moments_kernels.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/array.hpp>
+#include <dynd/func/chain.hpp>
+#include <dynd/func/lift_reduction_arrfunc.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/struct_type.hpp>
+
+#include "state_reduction.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+/**
+ * Adds one value to the moments, with the update of Welford extended to
+ * the third and fourth moments by Terriberry.
+ */
+inline void moments_add(kernels::moments_state &s, double x)
+{
+  double n1 = static_cast<double>(s.count);
+  double n = n1 + 1;
+  double delta = x - s.mean;
+  double delta_n = delta / n;
+  double delta_n2 = delta_n * delta_n;
+  double term1 = delta * delta_n * n1;
+  s.count += 1;
+  s.mean += delta_n;
+  s.m4 += term1 * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * s.m2 -
+          4 * delta_n * s.m3;
+  s.m3 += term1 * delta_n * (n - 2) - 3 * delta_n * s.m2;
+  s.m2 += term1;
+}
+
+/**
+ * Merges the moments of ``b`` into ``a``, with the pairwise update of
+ * Chan et al. extended to the higher moments by Pebay.
+ */
+inline void moments_merge(kernels::moments_state &a,
+                          const kernels::moments_state &b)
+{
+  if (b.count == 0) {
+    return;
+  } else if (a.count == 0) {
+    a = b;
+    return;
+  }
+  double na = static_cast<double>(a.count), nb = static_cast<double>(b.count);
+  double n = na + nb;
+  double delta = b.mean - a.mean;
+  double delta2 = delta * delta;
+  double m2 = a.m2 + b.m2 + delta2 * na * nb / n;
+  double m3 = a.m3 + b.m3 + delta2 * delta * na * nb * (na - nb) / (n * n) +
+              3 * delta * (na * b.m2 - nb * a.m2) / n;
+  double m4 = a.m4 + b.m4 +
+              delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) /
+                  (n * n * n) +
+              6 * delta2 * (na * na * b.m2 + nb * nb * a.m2) / (n * n) +
+              4 * delta * (na * b.m3 - nb * a.m3) / n;
+  a.count += b.count;
+  a.mean += delta * nb / n;
+  a.m2 = m2;
+  a.m3 = m3;
+  a.m4 = m4;
+}
+
+const uintptr_t moments_offsets[5] = {
+    offsetof(kernels::moments_state, count),
+    offsetof(kernels::moments_state, mean),
+    offsetof(kernels::moments_state, m2), offsetof(kernels::moments_state, m3),
+    offsetof(kernels::moments_state, m4)};
+
+void check_moments_arrmeta(const char *name, const ndt::type &tp,
+                           const char *arrmeta)
+{
+  detail::check_state_arrmeta(name, kernels::make_moments_type(),
+                              moments_offsets, tp, arrmeta);
+}
+
+template <class T>
+struct moments_reduction_kernel
+    : nd::base_kernel<moments_reduction_kernel<T>, kernel_request_host, 1> {
+  void single(char *dst, char *const *src)
+  {
+    moments_add(*reinterpret_cast<kernels::moments_state *>(dst),
+                static_cast<double>(**reinterpret_cast<T *const *>(src)));
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    const char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    if (dst_stride == 0) {
+      // Accumulate in a local copy, so the compiler keeps it in registers
+      kernels::moments_state s =
+          *reinterpret_cast<kernels::moments_state *>(dst);
+      for (size_t i = 0; i < count; ++i) {
+        moments_add(s, static_cast<double>(*reinterpret_cast<const T *>(src0)));
+        src0 += src0_stride;
+      }
+      *reinterpret_cast<kernels::moments_state *>(dst) = s;
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        moments_add(*reinterpret_cast<kernels::moments_state *>(dst),
+                    static_cast<double>(*reinterpret_cast<const T *>(src0)));
+        dst += dst_stride;
+        src0 += src0_stride;
+      }
+    }
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *DYND_UNUSED(self),
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *DYND_UNUSED(src_arrmeta),
+              kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_moments_arrmeta("dynd moments reduction", dst_tp, dst_arrmeta);
+    if (src_tp[0] != ndt::make_type<T>()) {
+      stringstream ss;
+      ss << "dynd moments reduction: expected source type "
+         << ndt::make_type<T>() << ", got " << src_tp[0];
+      throw type_error(ss.str());
+    }
+    moments_reduction_kernel::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  }
+};
+
+struct moments_combine_kernel
+    : nd::base_kernel<moments_combine_kernel, kernel_request_host, 1> {
+  void single(char *dst, char *const *src)
+  {
+    moments_merge(*reinterpret_cast<kernels::moments_state *>(dst),
+                  **reinterpret_cast<kernels::moments_state *const *>(src));
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *DYND_UNUSED(self),
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_moments_arrmeta("dynd moments combine", dst_tp, dst_arrmeta);
+    check_moments_arrmeta("dynd moments combine", src_tp[0], src_arrmeta[0]);
+    moments_combine_kernel::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  }
+};
+
+struct moment_statistic_data {
+  kernels::moment_statistic_t stat;
+  intptr_t ddof;
+};
+
+struct moment_statistic_kernel
+    : nd::base_kernel<moment_statistic_kernel, kernel_request_host, 1> {
+  kernels::moment_statistic_t m_stat;
+  intptr_t m_ddof;
+
+  moment_statistic_kernel(kernels::moment_statistic_t stat, intptr_t ddof)
+      : m_stat(stat), m_ddof(ddof)
+  {
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    const kernels::moments_state &s =
+        **reinterpret_cast<kernels::moments_state *const *>(src);
+    double n = static_cast<double>(s.count), res;
+    if (s.count <= m_ddof) {
+      res = numeric_limits<double>::quiet_NaN();
+    } else {
+      switch (m_stat) {
+      case kernels::moment_statistic_var:
+        res = s.m2 / (n - m_ddof);
+        break;
+      case kernels::moment_statistic_std:
+        res = sqrt(s.m2 / (n - m_ddof));
+        break;
+      case kernels::moment_statistic_skew:
+        res = s.m2 == 0 ? numeric_limits<double>::quiet_NaN()
+                        : sqrt(n) * s.m3 / pow(s.m2, 1.5);
+        break;
+      case kernels::moment_statistic_kurtosis:
+        res = s.m2 == 0 ? numeric_limits<double>::quiet_NaN()
+                        : n * s.m4 / (s.m2 * s.m2) - 3;
+        break;
+      default:
+        res = numeric_limits<double>::quiet_NaN();
+        break;
+      }
+    }
+    *reinterpret_cast<double *>(dst) = res;
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *self,
+              const ndt::arrfunc_type *DYND_UNUSED(self_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *DYND_UNUSED(dst_arrmeta),
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    check_moments_arrmeta("dynd moment statistic", src_tp[0], src_arrmeta[0]);
+    if (dst_tp.get_type_id() != float64_type_id) {
+      stringstream ss;
+      ss << "dynd moment statistic: expected destination type float64, got "
+         << dst_tp;
+      throw type_error(ss.str());
+    }
+    const moment_statistic_data *data =
+        self->get_data_as<moment_statistic_data>();
+    moment_statistic_kernel::make(ckb, kernreq, ckb_offset, data->stat,
+                                  data->ddof);
+    return ckb_offset;
+  }
+};
+
+} // anonymous namespace
+
+ndt::type kernels::make_moments_type()
+{
+  static ndt::type moments_tp = ndt::make_struct(
+      ndt::make_type<int64_t>(), "count", ndt::make_type<double>(), "mean",
+      ndt::make_type<double>(), "m2", ndt::make_type<double>(), "m3",
+      ndt::make_type<double>(), "m4");
+  return moments_tp;
+}
+
+nd::arrfunc kernels::make_builtin_moments_reduction_arrfunc(type_id_t tid)
+{
+  arrfunc_instantiate_t instantiate;
+  switch (tid) {
+  case int8_type_id:
+    instantiate = &moments_reduction_kernel<int8_t>::instantiate;
+    break;
+  case int16_type_id:
+    instantiate = &moments_reduction_kernel<int16_t>::instantiate;
+    break;
+  case int32_type_id:
+    instantiate = &moments_reduction_kernel<int32_t>::instantiate;
+    break;
+  case int64_type_id:
+    instantiate = &moments_reduction_kernel<int64_t>::instantiate;
+    break;
+  case uint8_type_id:
+    instantiate = &moments_reduction_kernel<uint8_t>::instantiate;
+    break;
+  case uint16_type_id:
+    instantiate = &moments_reduction_kernel<uint16_t>::instantiate;
+    break;
+  case uint32_type_id:
+    instantiate = &moments_reduction_kernel<uint32_t>::instantiate;
+    break;
+  case uint64_type_id:
+    instantiate = &moments_reduction_kernel<uint64_t>::instantiate;
+    break;
+  case float32_type_id:
+    instantiate = &moments_reduction_kernel<float>::instantiate;
+    break;
+  case float64_type_id:
+    instantiate = &moments_reduction_kernel<double>::instantiate;
+    break;
+  default: {
+    stringstream ss;
+    ss << "make_builtin_moments_reduction_arrfunc: data type ";
+    ss << ndt::type(tid) << " is not supported";
+    throw type_error(ss.str());
+  }
+  }
+  return detail::make_unary_arrfunc(ndt::type(tid), make_moments_type(),
+                                    instantiate);
+}
+
+nd::arrfunc kernels::make_moments_combine_arrfunc()
+{
+  return detail::make_unary_arrfunc(make_moments_type(), make_moments_type(),
+                                    &moments_combine_kernel::instantiate);
+}
+
+nd::arrfunc kernels::lift_builtin_moments_reduction_arrfunc(
+    type_id_t tid, const ndt::type &lifted_arr_type, bool keepdims,
+    intptr_t reduction_ndim, const bool *reduction_dimflags)
+{
+  nd::array identity = nd::empty(make_moments_type());
+  moments_state zero = {0, 0, 0, 0, 0};
+  *reinterpret_cast<moments_state *>(identity.get_readwrite_originptr()) =
+      zero;
+  identity.flag_as_immutable();
+  return lift_reduction_arrfunc(
+      make_builtin_moments_reduction_arrfunc(tid), lifted_arr_type,
+      nd::array(), keepdims, reduction_ndim, reduction_dimflags, true, true,
+      false, identity, make_moments_combine_arrfunc());
+}
+
+nd::arrfunc kernels::make_moment_statistic_arrfunc(moment_statistic_t stat,
+                                                   intptr_t ddof)
+{
+  if (ddof < 0) {
+    throw invalid_argument("make_moment_statistic_arrfunc: ddof must not be "
+                           "negative");
+  }
+  nd::array af = nd::empty(ndt::make_arrfunc(
+      ndt::make_tuple(make_moments_type()), ndt::make_type<double>()));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  moment_statistic_data *data = out_af->get_data_as<moment_statistic_data>();
+  data->stat = stat;
+  data->ddof = ddof;
+  out_af->instantiate = &moment_statistic_kernel::instantiate;
+  out_af->free = NULL;
+  af.flag_as_immutable();
+  return af;
+}
+
+nd::arrfunc kernels::make_builtin_moment1d_arrfunc(moment_statistic_t stat,
+                                                   type_id_t tid,
+                                                   intptr_t ddof)
+{
+  bool reduction_dimflags[1] = {true};
+  nd::arrfunc af = nd::functional::chain(
+      lift_builtin_moments_reduction_arrfunc(
+          tid, ndt::make_fixed_dim_kind(ndt::type(tid)), false, 1,
+          reduction_dimflags),
+      make_moment_statistic_arrfunc(stat, ddof), make_moments_type());
+  if (stat == moment_statistic_var || stat == moment_statistic_std) {
+    builtin1d_info info = {
+        stat == moment_statistic_var ? builtin1d_var : builtin1d_std, tid,
+        ddof};
+    return make_builtin1d_tagged_arrfunc(af, info);
+  }
+  return af;
+}
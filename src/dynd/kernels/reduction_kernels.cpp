@@ -5,16 +5,139 @@
 
 #include <dynd/kernels/reduction_kernels.hpp>
 #include <dynd/array.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
 #include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
 #include <dynd/func/lift_reduction_arrfunc.hpp>
 
+#include "kernel_helpers.hpp"
+
 using namespace std;
 using namespace dynd;
 
 namespace {
+// Blocks of at most this many elements are summed with independent
+// accumulators, larger ones are split in half, as numpy does. The error
+// then grows with the log of the count instead of linearly.
+const size_t pairwise_block_size = 128;
+
+template <class T, class Accum>
+Accum pairwise_sum(const char *src, intptr_t src_stride, size_t count)
+{
+  if (count < 8) {
+    Accum s = 0;
+    for (size_t i = 0; i < count; ++i) {
+      s = s + *reinterpret_cast<const T *>(src);
+      src += src_stride;
+    }
+    return s;
+  } else if (count <= pairwise_block_size) {
+    // Eight accumulators break the dependency between consecutive adds, so
+    // the loop is pipelined, and vectorized when the source is contiguous
+    Accum r[8];
+    size_t i, n8 = count - count % 8;
+    if (src_stride == sizeof(T)) {
+      const T *p = reinterpret_cast<const T *>(src);
+      for (int j = 0; j < 8; ++j) {
+        r[j] = p[j];
+      }
+      for (i = 8; i < n8; i += 8) {
+        for (int j = 0; j < 8; ++j) {
+          r[j] = r[j] + p[i + j];
+        }
+      }
+    } else {
+      for (int j = 0; j < 8; ++j) {
+        r[j] = *reinterpret_cast<const T *>(src + j * src_stride);
+      }
+      for (i = 8; i < n8; i += 8) {
+        const char *p = src + i * src_stride;
+        for (int j = 0; j < 8; ++j) {
+          r[j] = r[j] + *reinterpret_cast<const T *>(p + j * src_stride);
+        }
+      }
+    }
+    Accum s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));
+    for (; i < count; ++i) {
+      s = s + *reinterpret_cast<const T *>(src + i * src_stride);
+    }
+    return s;
+  } else {
+    size_t n2 = count / 2;
+    n2 -= n2 % 8;
+    return pairwise_sum<T, Accum>(src, src_stride, n2) +
+           pairwise_sum<T, Accum>(src + n2 * src_stride, src_stride,
+                                  count - n2);
+  }
+}
+
+/**
+ * Adds ``count`` values to ``s`` with Neumaier's variant of Kahan
+ * summation, which carries the rounding error of every add in a
+ * compensation term. The error doesn't grow with the count.
+ */
+template <class T, class Accum>
+Accum compensated_sum(Accum s, const char *src, intptr_t src_stride,
+                      size_t count)
+{
+  Accum c = 0;
+  for (size_t i = 0; i < count; ++i) {
+    Accum v = *reinterpret_cast<const T *>(src);
+    Accum t = s + v;
+    if ((s < 0 ? -s : s) >= (v < 0 ? -v : v)) {
+      c += (s - t) + v;
+    } else {
+      c += (v - t) + s;
+    }
+    s = t;
+    src += src_stride;
+  }
+  return s + c;
+}
+
+/**
+ * Adds ``count`` strided values into ``*dst``, accumulating with the
+ * requested accuracy.
+ */
+template <class T, class Accum, kernels::sum_accuracy_t Accuracy>
+struct sum_accumulate {
+  static void run(T *dst, const char *src, intptr_t src_stride, size_t count)
+  {
+    *dst = static_cast<T>(*dst +
+                          pairwise_sum<T, Accum>(src, src_stride, count));
+  }
+};
+
 template <class T, class Accum>
+struct sum_accumulate<T, Accum, kernels::sum_accuracy_kahan> {
+  static void run(T *dst, const char *src, intptr_t src_stride, size_t count)
+  {
+    *dst = static_cast<T>(
+        compensated_sum<T, Accum>(*dst, src, src_stride, count));
+  }
+};
+
+// Complex values are compensated one component at a time
+template <class T, class Accum>
+struct sum_accumulate<dynd::complex<T>, dynd::complex<Accum>,
+                      kernels::sum_accuracy_kahan> {
+  static void run(dynd::complex<T> *dst, const char *src, intptr_t src_stride,
+                  size_t count)
+  {
+    T *d = reinterpret_cast<T *>(dst);
+    d[0] = static_cast<T>(
+        compensated_sum<T, Accum>(d[0], src, src_stride, count));
+    d[1] = static_cast<T>(
+        compensated_sum<T, Accum>(d[1], src + sizeof(T), src_stride, count));
+  }
+};
+
+template <class T, class Accum, kernels::sum_accuracy_t Accuracy>
 struct sum_reduction
-    : nd::base_kernel<sum_reduction<T, Accum>, kernel_request_host, 1> {
+    : nd::base_kernel<sum_reduction<T, Accum, Accuracy>, kernel_request_host,
+                      1> {
   void single(char *dst, char *const *src)
   {
     *reinterpret_cast<T *>(dst) =
@@ -27,13 +150,8 @@ struct sum_reduction
     char *src0 = src[0];
     intptr_t src0_stride = src_stride[0];
     if (dst_stride == 0) {
-      Accum s = 0;
-      for (size_t i = 0; i < count; ++i) {
-        s = s + *reinterpret_cast<T *>(src0);
-        src0 += src0_stride;
-      }
-      *reinterpret_cast<T *>(dst) =
-          static_cast<T>(*reinterpret_cast<T *>(dst) + s);
+      sum_accumulate<T, Accum, Accuracy>::run(reinterpret_cast<T *>(dst), src0,
+                                              src0_stride, count);
     } else {
       for (size_t i = 0; i < count; ++i) {
         *reinterpret_cast<T *>(dst) =
@@ -44,33 +162,78 @@ struct sum_reduction
     }
   }
 };
+
+template <class T, class Accum>
+void make_sum_reduction(void *ckb, kernel_request_t kernreq,
+                        intptr_t &ckb_offset, kernels::sum_accuracy_t accuracy)
+{
+  if (accuracy == kernels::sum_accuracy_kahan) {
+    sum_reduction<T, Accum, kernels::sum_accuracy_kahan>::make(ckb, kernreq,
+                                                               ckb_offset);
+  } else {
+    sum_reduction<T, Accum, kernels::sum_accuracy_pairwise>::make(
+        ckb, kernreq, ckb_offset);
+  }
+}
+
+kernels::sum_accuracy_t get_sum_accuracy(const nd::array &kwds,
+                                         kernels::sum_accuracy_t accuracy)
+{
+  nd::array value = detail::get_kwd(kwds, "accuracy");
+  if (value.is_null()) {
+    return accuracy;
+  }
+  string name = value.as<string>();
+  if (name == "pairwise") {
+    return kernels::sum_accuracy_pairwise;
+  } else if (name == "kahan") {
+    return kernels::sum_accuracy_kahan;
+  }
+  stringstream ss;
+  ss << "dynd sum: unrecognized accuracy \"" << name
+     << "\", expected \"pairwise\" or \"kahan\"";
+  throw invalid_argument(ss.str());
+}
+
+ndt::type make_sum_arrfunc_type(const ndt::type &src_tp,
+                                const ndt::type &dst_tp)
+{
+  return ndt::make_arrfunc(
+      ndt::make_tuple(src_tp),
+      ndt::make_struct(ndt::make_option(ndt::make_string()), "accuracy"),
+      dst_tp);
+}
 } // anonymous namespace
 
 intptr_t kernels::make_builtin_sum_reduction_ckernel(void *ckb,
                                                      intptr_t ckb_offset,
                                                      type_id_t tid,
-                                                     kernel_request_t kernreq)
+                                                     kernel_request_t kernreq,
+                                                     sum_accuracy_t accuracy)
 {
   switch (tid) {
   case int32_type_id:
-    sum_reduction<int32_t, int32_t>::make(ckb, kernreq, ckb_offset);
+    // Integer sums are exact, so every accuracy uses the same kernel
+    make_sum_reduction<int32_t, int32_t>(ckb, kernreq, ckb_offset,
+                                         sum_accuracy_pairwise);
     break;
   case int64_type_id:
-    sum_reduction<int64_t, int64_t>::make(ckb, kernreq, ckb_offset);
+    make_sum_reduction<int64_t, int64_t>(ckb, kernreq, ckb_offset,
+                                         sum_accuracy_pairwise);
     break;
   case float32_type_id:
-    sum_reduction<float, double>::make(ckb, kernreq, ckb_offset);
+    make_sum_reduction<float, double>(ckb, kernreq, ckb_offset, accuracy);
     break;
   case float64_type_id:
-    sum_reduction<double, double>::make(ckb, kernreq, ckb_offset);
+    make_sum_reduction<double, double>(ckb, kernreq, ckb_offset, accuracy);
     break;
   case complex_float32_type_id:
-    sum_reduction<complex<float>, complex<float>>::make(ckb, kernreq,
-                                                        ckb_offset);
+    make_sum_reduction<complex<float>, complex<float>>(ckb, kernreq,
+                                                       ckb_offset, accuracy);
     break;
   case complex_float64_type_id:
-    sum_reduction<complex<double>, complex<double>>::make(ckb, kernreq,
-                                                          ckb_offset);
+    make_sum_reduction<complex<double>, complex<double>>(ckb, kernreq,
+                                                         ckb_offset, accuracy);
     break;
   default: {
     stringstream ss;
@@ -84,13 +247,12 @@ intptr_t kernels::make_builtin_sum_reduction_ckernel(void *ckb,
 }
 
 static intptr_t instantiate_builtin_sum_reduction_arrfunc(
-    const arrfunc_type_data *DYND_UNUSED(self_data_ptr),
-    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data), void *ckb,
-    intptr_t ckb_offset, const ndt::type &dst_tp,
-    const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc),
-    const ndt::type *src_tp, const char *const *DYND_UNUSED(src_arrmeta),
-    kernel_request_t kernreq, const eval::eval_context *DYND_UNUSED(ectx),
-    const nd::array &DYND_UNUSED(kwds),
+    const arrfunc_type_data *self, const ndt::arrfunc_type *DYND_UNUSED(af_tp),
+    char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *DYND_UNUSED(dst_arrmeta),
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx), const nd::array &kwds,
     const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
 {
   if (dst_tp != src_tp[0]) {
@@ -100,10 +262,12 @@ static intptr_t instantiate_builtin_sum_reduction_arrfunc(
     throw type_error(ss.str());
   }
   return kernels::make_builtin_sum_reduction_ckernel(
-      ckb, ckb_offset, dst_tp.get_type_id(), kernreq);
+      ckb, ckb_offset, dst_tp.get_type_id(), kernreq,
+      get_sum_accuracy(kwds, *self->get_data_as<kernels::sum_accuracy_t>()));
 }
 
-nd::arrfunc kernels::make_builtin_sum_reduction_arrfunc(type_id_t tid)
+nd::arrfunc kernels::make_builtin_sum_reduction_arrfunc(type_id_t tid,
+                                                        sum_accuracy_t accuracy)
 {
   if (tid < 0 || tid >= builtin_type_id_count) {
     stringstream ss;
@@ -111,24 +275,764 @@ nd::arrfunc kernels::make_builtin_sum_reduction_arrfunc(type_id_t tid)
     ss << ndt::type(tid) << " is not supported";
     throw type_error(ss.str());
   }
-  nd::array af = nd::empty(
-      ndt::make_arrfunc(ndt::make_tuple(ndt::type(tid)), ndt::type(tid)));
+  nd::array af =
+      nd::empty(make_sum_arrfunc_type(ndt::type(tid), ndt::type(tid)));
   arrfunc_type_data *out_af =
       reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
-  *out_af->get_data_as<type_id_t>() = tid;
+  *out_af->get_data_as<sum_accuracy_t>() = accuracy;
   out_af->instantiate = &instantiate_builtin_sum_reduction_arrfunc;
   out_af->free = NULL;
   af.flag_as_immutable();
   return af;
 }
 
+namespace {
+/**
+ * The lifted reduction doesn't pass kwds on to its child, so the 1D sum
+ * holds one lifted reduction per accuracy, and picks one from its kwds.
+ */
+struct sum1d_arrfunc_data {
+  nd::arrfunc lifted[2];
+
+  static void free(arrfunc_type_data *self_af)
+  {
+    delete *self_af->get_data_as<sum1d_arrfunc_data *>();
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *af_self,
+              const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *data,
+              void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+              const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &tp_vars)
+  {
+    const nd::arrfunc &child =
+        (*af_self->get_data_as<sum1d_arrfunc_data *>())
+            ->lifted[get_sum_accuracy(kwds, kernels::sum_accuracy_pairwise)];
+    return child.get()->instantiate(
+        child.get(), child.get_type(), data, ckb, ckb_offset, dst_tp,
+        dst_arrmeta, nsrc, src_tp, src_arrmeta, kernreq, ectx, nd::array(),
+        tp_vars);
+  }
+};
+} // anonymous namespace
+
 nd::arrfunc kernels::make_builtin_sum1d_arrfunc(type_id_t tid)
 {
-  nd::arrfunc sum_ew = kernels::make_builtin_sum_reduction_arrfunc(tid);
+  sum1d_arrfunc_data *data = new sum1d_arrfunc_data;
+  bool reduction_dimflags[1] = {true};
+  for (int i = 0; i < 2; ++i) {
+    // The partial sums of the threads are summed the same way
+    nd::arrfunc reduction = kernels::make_builtin_sum_reduction_arrfunc(
+        tid, static_cast<sum_accuracy_t>(i));
+    data->lifted[i] = lift_reduction_arrfunc(
+        reduction, ndt::make_fixed_dim_kind(ndt::type(tid)), nd::array(),
+        false, 1, reduction_dimflags, true, true, false, 0, reduction);
+  }
+  nd::array af = nd::empty(make_sum_arrfunc_type(
+      ndt::make_fixed_dim_kind(ndt::type(tid)), ndt::type(tid)));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  *out_af->get_data_as<sum1d_arrfunc_data *>() = data;
+  out_af->instantiate = &sum1d_arrfunc_data::instantiate;
+  out_af->free = &sum1d_arrfunc_data::free;
+  af.flag_as_immutable();
+  builtin1d_info info = {builtin1d_sum, tid, 0};
+  return make_builtin1d_tagged_arrfunc(af, info);
+}
+
+namespace {
+using detail::is_complex_value;
+using detail::is_nan_value;
+
+/**
+ * The reduction operations. ``init`` turns a source value into an
+ * accumulated value, ``merge`` combines two accumulated values, and
+ * ``decided`` is true once more values can't change the result.
+ */
+template <class T>
+struct min_op {
+  typedef T src_type;
+  typedef T dst_type;
+  enum { supported = !is_complex_value<T>::value };
+
+  static T init(T v) { return v; }
+  // A NaN on either side is propagated
+  static T merge(T a, T b) { return (b < a || is_nan_value(b)) ? b : a; }
+  static bool decided(T a) { return is_nan_value(a); }
+};
+
+template <class T>
+struct max_op {
+  typedef T src_type;
+  typedef T dst_type;
+  enum { supported = !is_complex_value<T>::value };
+
+  static T init(T v) { return v; }
+  static T merge(T a, T b) { return (b > a || is_nan_value(b)) ? b : a; }
+  static bool decided(T a) { return is_nan_value(a); }
+};
+
+template <class T>
+struct prod_op {
+  typedef T src_type;
+  typedef T dst_type;
+  enum { supported = !is_same<T, dynd_bool>::value };
+
+  static T init(T v) { return v; }
+  static T merge(T a, T b) { return a * b; }
+  static bool decided(T DYND_UNUSED(a)) { return false; }
+};
+
+// NaN is nonzero, so it counts as true
+template <class T>
+struct any_op {
+  typedef T src_type;
+  typedef dynd_bool dst_type;
+  enum { supported = true };
+
+  static dynd_bool init(T v) { return dynd_bool(v); }
+  static dynd_bool merge(dynd_bool a, dynd_bool b) { return a || b; }
+  static bool decided(dynd_bool a) { return a; }
+};
+
+template <class T>
+struct all_op {
+  typedef T src_type;
+  typedef dynd_bool dst_type;
+  enum { supported = true };
+
+  static dynd_bool init(T v) { return dynd_bool(v); }
+  static dynd_bool merge(dynd_bool a, dynd_bool b) { return a && b; }
+  static bool decided(dynd_bool a) { return !a; }
+};
+
+template <class T>
+struct count_nonzero_op {
+  typedef T src_type;
+  typedef int64_t dst_type;
+  enum { supported = true };
+
+  static int64_t init(T v) { return dynd_bool(v) ? 1 : 0; }
+  static int64_t merge(int64_t a, int64_t b) { return a + b; }
+  static bool decided(int64_t DYND_UNUSED(a)) { return false; }
+};
+
+/**
+ * Reduces ``count`` values, at least one, with eight independent
+ * accumulators, so the loop is pipelined, and vectorized when the source
+ * is contiguous.
+ */
+template <class Op>
+typename Op::dst_type reduce_block(const char *src, intptr_t src_stride,
+                                   size_t count)
+{
+  typedef typename Op::src_type T;
+  typedef typename Op::dst_type R;
+  if (count < 8) {
+    R s = Op::init(*reinterpret_cast<const T *>(src));
+    for (size_t i = 1; i < count; ++i) {
+      src += src_stride;
+      s = Op::merge(s, Op::init(*reinterpret_cast<const T *>(src)));
+    }
+    return s;
+  }
+  R r[8];
+  size_t i, n8 = count - count % 8;
+  if (src_stride == sizeof(T)) {
+    const T *p = reinterpret_cast<const T *>(src);
+    for (int j = 0; j < 8; ++j) {
+      r[j] = Op::init(p[j]);
+    }
+    for (i = 8; i < n8; i += 8) {
+      for (int j = 0; j < 8; ++j) {
+        r[j] = Op::merge(r[j], Op::init(p[i + j]));
+      }
+    }
+  } else {
+    for (int j = 0; j < 8; ++j) {
+      r[j] = Op::init(*reinterpret_cast<const T *>(src + j * src_stride));
+    }
+    for (i = 8; i < n8; i += 8) {
+      const char *p = src + i * src_stride;
+      for (int j = 0; j < 8; ++j) {
+        r[j] = Op::merge(
+            r[j], Op::init(*reinterpret_cast<const T *>(p + j * src_stride)));
+      }
+    }
+  }
+  R s = Op::merge(Op::merge(Op::merge(r[0], r[1]), Op::merge(r[2], r[3])),
+                  Op::merge(Op::merge(r[4], r[5]), Op::merge(r[6], r[7])));
+  for (; i < count; ++i) {
+    s = Op::merge(
+        s, Op::init(*reinterpret_cast<const T *>(src + i * src_stride)));
+  }
+  return s;
+}
+
+// The number of values reduced between checks for an early exit
+const size_t reduce_block_size = 1024;
+
+template <class Op>
+struct builtin_reduction
+    : nd::base_kernel<builtin_reduction<Op>, kernel_request_host, 1> {
+  typedef typename Op::src_type T;
+  typedef typename Op::dst_type R;
+
+  void single(char *dst, char *const *src)
+  {
+    *reinterpret_cast<R *>(dst) =
+        Op::merge(*reinterpret_cast<R *>(dst),
+                  Op::init(**reinterpret_cast<T *const *>(src)));
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    if (dst_stride == 0) {
+      R s = *reinterpret_cast<R *>(dst);
+      for (size_t i = 0; i < count && !Op::decided(s);
+           i += reduce_block_size) {
+        s = Op::merge(s, reduce_block<Op>(src0 + i * src0_stride, src0_stride,
+                                          min(count - i, reduce_block_size)));
+      }
+      *reinterpret_cast<R *>(dst) = s;
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<R *>(dst) =
+            Op::merge(*reinterpret_cast<R *>(dst),
+                      Op::init(*reinterpret_cast<T *>(src0)));
+        dst += dst_stride;
+        src0 += src0_stride;
+      }
+    }
+  }
+};
+
+template <class Op, bool Supported = Op::supported>
+struct builtin_reduction_for_type {
+  static void make(void *ckb, kernel_request_t kernreq, intptr_t &ckb_offset)
+  {
+    builtin_reduction<Op>::make(ckb, kernreq, ckb_offset);
+  }
+
+  static ndt::type dst_type()
+  {
+    return ndt::make_type<typename Op::dst_type>();
+  }
+};
+
+template <class Op>
+struct builtin_reduction_for_type<Op, false> {
+  static void make(void *DYND_UNUSED(ckb),
+                   kernel_request_t DYND_UNUSED(kernreq),
+                   intptr_t &DYND_UNUSED(ckb_offset))
+  {
+    throw type_error("builtin reduction: unsupported data type");
+  }
+
+  static ndt::type dst_type() { return ndt::type(); }
+};
+
+/**
+ * Calls ``f.template apply<Op<T>>()`` with the C++ type ``T`` of the
+ * type id, returning false if the type id isn't a numeric one.
+ */
+template <template <class> class Op, class F>
+bool visit_numeric_type(type_id_t tid, F &f)
+{
+  switch (tid) {
+  case bool_type_id:
+    f.template apply<Op<dynd_bool>>();
+    return true;
+  case int8_type_id:
+    f.template apply<Op<int8_t>>();
+    return true;
+  case int16_type_id:
+    f.template apply<Op<int16_t>>();
+    return true;
+  case int32_type_id:
+    f.template apply<Op<int32_t>>();
+    return true;
+  case int64_type_id:
+    f.template apply<Op<int64_t>>();
+    return true;
+  case uint8_type_id:
+    f.template apply<Op<uint8_t>>();
+    return true;
+  case uint16_type_id:
+    f.template apply<Op<uint16_t>>();
+    return true;
+  case uint32_type_id:
+    f.template apply<Op<uint32_t>>();
+    return true;
+  case uint64_type_id:
+    f.template apply<Op<uint64_t>>();
+    return true;
+  case float32_type_id:
+    f.template apply<Op<float>>();
+    return true;
+  case float64_type_id:
+    f.template apply<Op<double>>();
+    return true;
+  case complex_float32_type_id:
+    f.template apply<Op<dynd::complex<float>>>();
+    return true;
+  case complex_float64_type_id:
+    f.template apply<Op<dynd::complex<double>>>();
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <class F>
+bool visit_builtin_reduction(kernels::builtin_reduction_t op, type_id_t tid,
+                             F &f)
+{
+  switch (op) {
+  case kernels::builtin_reduction_min:
+    return visit_numeric_type<min_op>(tid, f);
+  case kernels::builtin_reduction_max:
+    return visit_numeric_type<max_op>(tid, f);
+  case kernels::builtin_reduction_prod:
+    return visit_numeric_type<prod_op>(tid, f);
+  case kernels::builtin_reduction_any:
+    return visit_numeric_type<any_op>(tid, f);
+  case kernels::builtin_reduction_all:
+    return visit_numeric_type<all_op>(tid, f);
+  case kernels::builtin_reduction_count_nonzero:
+    return visit_numeric_type<count_nonzero_op>(tid, f);
+  default:
+    return false;
+  }
+}
+
+struct make_builtin_reduction_visitor {
+  void *ckb;
+  kernel_request_t kernreq;
+  intptr_t ckb_offset;
+
+  template <class Op>
+  void apply()
+  {
+    builtin_reduction_for_type<Op>::make(ckb, kernreq, ckb_offset);
+  }
+};
+
+struct builtin_reduction_dst_type_visitor {
+  ndt::type dst_tp;
+
+  template <class Op>
+  void apply()
+  {
+    dst_tp = builtin_reduction_for_type<Op>::dst_type();
+  }
+};
+
+const char *builtin_reduction_name(kernels::builtin_reduction_t op)
+{
+  switch (op) {
+  case kernels::builtin_reduction_min:
+    return "min";
+  case kernels::builtin_reduction_max:
+    return "max";
+  case kernels::builtin_reduction_prod:
+    return "prod";
+  case kernels::builtin_reduction_any:
+    return "any";
+  case kernels::builtin_reduction_all:
+    return "all";
+  case kernels::builtin_reduction_count_nonzero:
+    return "count_nonzero";
+  default:
+    return "<unknown>";
+  }
+}
+
+/**
+ * The destination type of the builtin reduction on the type id, throwing
+ * if it isn't supported.
+ */
+ndt::type get_builtin_reduction_dst_type(kernels::builtin_reduction_t op,
+                                         type_id_t tid)
+{
+  builtin_reduction_dst_type_visitor f;
+  if (!visit_builtin_reduction(op, tid, f) || f.dst_tp.is_null()) {
+    stringstream ss;
+    ss << "dynd " << builtin_reduction_name(op) << " reduction: data type "
+       << ndt::type(tid) << " is not supported";
+    throw type_error(ss.str());
+  }
+  return f.dst_tp;
+}
+
+struct builtin_reduction_arrfunc_data {
+  kernels::builtin_reduction_t op;
+  type_id_t tid;
+};
+
+intptr_t instantiate_builtin_reduction_arrfunc(
+    const arrfunc_type_data *self, const ndt::arrfunc_type *af_tp,
+    char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *DYND_UNUSED(dst_arrmeta),
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const builtin_reduction_arrfunc_data *data =
+      self->get_data_as<builtin_reduction_arrfunc_data>();
+  if (src_tp[0] != af_tp->get_pos_type(0) ||
+      dst_tp != af_tp->get_return_type()) {
+    stringstream ss;
+    ss << "dynd " << builtin_reduction_name(data->op)
+       << " reduction: expected types " << af_tp << ", got " << src_tp[0]
+       << " and " << dst_tp;
+    throw type_error(ss.str());
+  }
+  return kernels::make_builtin_reduction_ckernel(ckb, ckb_offset, data->op,
+                                                 data->tid, kernreq);
+}
+} // anonymous namespace
+
+intptr_t kernels::make_builtin_reduction_ckernel(void *ckb,
+                                                 intptr_t ckb_offset,
+                                                 builtin_reduction_t op,
+                                                 type_id_t tid,
+                                                 kernel_request_t kernreq)
+{
+  // Validates the type, with a clearer message than the visitor's
+  get_builtin_reduction_dst_type(op, tid);
+  make_builtin_reduction_visitor f = {ckb, kernreq, ckb_offset};
+  visit_builtin_reduction(op, tid, f);
+  return f.ckb_offset;
+}
+
+nd::arrfunc kernels::make_builtin_reduction_arrfunc(builtin_reduction_t op,
+                                                    type_id_t tid)
+{
+  ndt::type dst_tp = get_builtin_reduction_dst_type(op, tid);
+  nd::array af = nd::empty(
+      ndt::make_arrfunc(ndt::make_tuple(ndt::type(tid)), dst_tp));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  builtin_reduction_arrfunc_data *data =
+      out_af->get_data_as<builtin_reduction_arrfunc_data>();
+  data->op = op;
+  data->tid = tid;
+  out_af->instantiate = &instantiate_builtin_reduction_arrfunc;
+  out_af->free = NULL;
+  af.flag_as_immutable();
+  return af;
+}
+
+nd::array kernels::make_builtin_reduction_identity(builtin_reduction_t op,
+                                                   type_id_t tid)
+{
+  ndt::type dst_tp = get_builtin_reduction_dst_type(op, tid);
+  nd::array identity;
+  switch (op) {
+  case builtin_reduction_prod:
+    identity = nd::empty(dst_tp);
+    identity.vals() = 1;
+    break;
+  case builtin_reduction_any:
+    identity = false;
+    break;
+  case builtin_reduction_all:
+    identity = true;
+    break;
+  case builtin_reduction_count_nonzero:
+    identity = static_cast<int64_t>(0);
+    break;
+  default:
+    return identity;
+  }
+  identity.flag_as_immutable();
+  return identity;
+}
+
+nd::array kernels::get_builtin_reduction_identity(const nd::arrfunc &af)
+{
+  if (af.is_null() ||
+      af.get()->instantiate != &instantiate_builtin_reduction_arrfunc) {
+    return nd::array();
+  }
+  const builtin_reduction_arrfunc_data *data =
+      af.get()->get_data_as<builtin_reduction_arrfunc_data>();
+  return make_builtin_reduction_identity(data->op, data->tid);
+}
+
+nd::arrfunc kernels::make_builtin_reduction_combine_arrfunc(
+    builtin_reduction_t op, type_id_t tid)
+{
+  type_id_t dst_tid = get_builtin_reduction_dst_type(op, tid).get_type_id();
+  if (op == builtin_reduction_count_nonzero) {
+    return make_builtin_sum_reduction_arrfunc(dst_tid);
+  }
+  return make_builtin_reduction_arrfunc(op, dst_tid);
+}
+
+namespace {
+struct builtin1d_tagged_data {
+  nd::arrfunc child;
+  kernels::builtin1d_info info;
+};
+
+/** Forwards everything to the child arrfunc */
+struct builtin1d_tagged_ck : nd::base_virtual_kernel<builtin1d_tagged_ck> {
+  static intptr_t
+  instantiate(const arrfunc_type_data *af_self,
+              const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *data,
+              void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+              const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &tp_vars)
+  {
+    const nd::arrfunc &child =
+        (*af_self->get_data_as<builtin1d_tagged_data *>())->child;
+    return child.get()->instantiate(child.get(), child.get_type(), data, ckb,
+                                    ckb_offset, dst_tp, dst_arrmeta, nsrc,
+                                    src_tp, src_arrmeta, kernreq, ectx, kwds,
+                                    tp_vars);
+  }
+
+  static void resolve_dst_type(const arrfunc_type_data *af_self,
+                               const ndt::arrfunc_type *af_tp, char *data,
+                               ndt::type &dst_tp, intptr_t nsrc,
+                               const ndt::type *src_tp, const nd::array &kwds,
+                               const std::map<nd::string, ndt::type> &tp_vars)
+  {
+    const nd::arrfunc &child =
+        (*af_self->get_data_as<builtin1d_tagged_data *>())->child;
+    if (child.get()->resolve_dst_type != NULL) {
+      child.get()->resolve_dst_type(child.get(), child.get_type(), data,
+                                    dst_tp, nsrc, src_tp, kwds, tp_vars);
+    } else {
+      nd::base_virtual_kernel<builtin1d_tagged_ck>::resolve_dst_type(
+          af_self, af_tp, data, dst_tp, nsrc, src_tp, kwds, tp_vars);
+    }
+  }
+};
+} // anonymous namespace
+
+nd::arrfunc kernels::make_builtin1d_tagged_arrfunc(const nd::arrfunc &child,
+                                                   const builtin1d_info &info)
+{
+  std::shared_ptr<builtin1d_tagged_data> data(new builtin1d_tagged_data);
+  data->child = child;
+  data->info = info;
+  return nd::arrfunc::make<builtin1d_tagged_ck>(child.get_array_type(), data,
+                                                0);
+}
+
+nd::arrfunc kernels::make_builtin_reduction1d_arrfunc(builtin_reduction_t op,
+                                                      type_id_t tid)
+{
+  nd::arrfunc reduction = kernels::make_builtin_reduction_arrfunc(op, tid);
   bool reduction_dimflags[1] = {true};
-  return lift_reduction_arrfunc(
-      sum_ew, ndt::make_fixed_dim_kind(ndt::type(tid)), nd::array(), false, 1,
-      reduction_dimflags, true, true, false, 0);
+  nd::arrfunc lifted = lift_reduction_arrfunc(
+      reduction, ndt::make_fixed_dim_kind(ndt::type(tid)), nd::array(), false,
+      1, reduction_dimflags, true, true, false,
+      make_builtin_reduction_identity(op, tid),
+      make_builtin_reduction_combine_arrfunc(op, tid));
+  if (op == builtin_reduction_min || op == builtin_reduction_max) {
+    builtin1d_info info = {
+        op == builtin_reduction_min ? builtin1d_min : builtin1d_max, tid, 0};
+    return make_builtin1d_tagged_arrfunc(lifted, info);
+  }
+  return lifted;
+}
+
+namespace {
+/**
+ * Finds the index of the first minimum or maximum value. Each block is
+ * reduced to its extreme value with the vectorized loop, and only
+ * searched for the index when that value beats the best so far, so the
+ * data is read from memory once. The first NaN wins, as in numpy.
+ */
+template <class T, bool Max>
+struct argminmax1d_ck
+    : nd::base_kernel<argminmax1d_ck<T, Max>, kernel_request_host, 1> {
+  typedef typename conditional<Max, max_op<T>, min_op<T>>::type op_type;
+
+  intptr_t m_src_dim_size, m_src_stride;
+  uintptr_t m_index_offset, m_value_offset;
+
+  static bool better(T a, T b) { return Max ? (a > b) : (a < b); }
+
+  void single(char *dst, char *const *src)
+  {
+    const char *src0 = src[0];
+    intptr_t src_dim_size = m_src_dim_size, src_stride = m_src_stride;
+    intptr_t best_index = 0;
+    T best = *reinterpret_cast<const T *>(src0);
+    for (intptr_t i = 0; i < src_dim_size && !is_nan_value(best);
+         i += reduce_block_size) {
+      const char *block = src0 + i * src_stride;
+      size_t count = min<size_t>(src_dim_size - i, reduce_block_size);
+      T m = reduce_block<op_type>(block, src_stride, count);
+      if (is_nan_value(m) || better(m, best)) {
+        for (size_t j = 0; j < count; ++j) {
+          T v = *reinterpret_cast<const T *>(block + j * src_stride);
+          if (v == m || (is_nan_value(m) && is_nan_value(v))) {
+            best = v;
+            best_index = i + j;
+            break;
+          }
+        }
+      }
+    }
+    *reinterpret_cast<intptr_t *>(dst + m_index_offset) = best_index;
+    *reinterpret_cast<T *>(dst + m_value_offset) = best;
+  }
+};
+
+template <bool Max>
+struct argminmax1d_arrfunc {
+  static ndt::type make_dst_type(type_id_t tid)
+  {
+    return ndt::make_struct(ndt::make_type<intptr_t>(), "index",
+                            ndt::type(tid), "value");
+  }
+
+  template <class T>
+  static void make(void *ckb, kernel_request_t kernreq, intptr_t &ckb_offset,
+                   intptr_t src_dim_size, intptr_t src_stride,
+                   const uintptr_t *dst_offsets)
+  {
+    typedef argminmax1d_ck<T, Max> self_type;
+    self_type *self = self_type::make(ckb, kernreq, ckb_offset);
+    self->m_src_dim_size = src_dim_size;
+    self->m_src_stride = src_stride;
+    self->m_index_offset = dst_offsets[0];
+    self->m_value_offset = dst_offsets[1];
+  }
+
+  static intptr_t
+  instantiate(const arrfunc_type_data *af_self,
+              const ndt::arrfunc_type *DYND_UNUSED(af_tp),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    const char *name = Max ? "argmax1d" : "argmin1d";
+    type_id_t tid = *af_self->get_data_as<type_id_t>();
+    intptr_t src_dim_size, src_stride;
+    ndt::type src_el_tp;
+    const char *src_el_arrmeta;
+    if (!src_tp[0].get_as_strided(src_arrmeta[0], &src_dim_size, &src_stride,
+                                  &src_el_tp, &src_el_arrmeta)) {
+      stringstream ss;
+      ss << name << ": could not process type " << src_tp[0];
+      ss << " as a strided dimension";
+      throw type_error(ss.str());
+    }
+    if (src_el_tp.get_type_id() != tid || dst_tp != make_dst_type(tid)) {
+      stringstream ss;
+      ss << name << ": expected element type " << ndt::type(tid)
+         << " and output type " << make_dst_type(tid) << ", got "
+         << src_el_tp << " and " << dst_tp;
+      throw type_error(ss.str());
+    }
+    if (src_dim_size == 0) {
+      stringstream ss;
+      ss << name << ": the input is empty";
+      throw invalid_argument(ss.str());
+    }
+    const uintptr_t *dst_offsets =
+        dst_tp.extended<ndt::base_struct_type>()->get_data_offsets(
+            dst_arrmeta);
+    switch (tid) {
+    case int8_type_id:
+      make<int8_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                   dst_offsets);
+      break;
+    case int16_type_id:
+      make<int16_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                    dst_offsets);
+      break;
+    case int32_type_id:
+      make<int32_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                    dst_offsets);
+      break;
+    case int64_type_id:
+      make<int64_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                    dst_offsets);
+      break;
+    case uint8_type_id:
+      make<uint8_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                    dst_offsets);
+      break;
+    case uint16_type_id:
+      make<uint16_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                     dst_offsets);
+      break;
+    case uint32_type_id:
+      make<uint32_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                     dst_offsets);
+      break;
+    case uint64_type_id:
+      make<uint64_t>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                     dst_offsets);
+      break;
+    case float32_type_id:
+      make<float>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                  dst_offsets);
+      break;
+    case float64_type_id:
+      make<double>(ckb, kernreq, ckb_offset, src_dim_size, src_stride,
+                   dst_offsets);
+      break;
+    default:
+      throw type_error("unsupported type");
+    }
+    return ckb_offset;
+  }
+
+  static nd::arrfunc make_arrfunc(type_id_t tid)
+  {
+    if (tid < int8_type_id || tid > float64_type_id ||
+        tid == int128_type_id || tid == uint128_type_id ||
+        tid == float16_type_id) {
+      stringstream ss;
+      ss << "make_builtin_" << (Max ? "argmax1d" : "argmin1d")
+         << "_arrfunc: data type " << ndt::type(tid) << " is not supported";
+      throw type_error(ss.str());
+    }
+    nd::array af = nd::empty(ndt::make_arrfunc(
+        ndt::make_tuple(ndt::make_fixed_dim_kind(ndt::type(tid))),
+        make_dst_type(tid)));
+    arrfunc_type_data *out_af =
+        reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+    *out_af->get_data_as<type_id_t>() = tid;
+    out_af->instantiate = &instantiate;
+    out_af->free = NULL;
+    af.flag_as_immutable();
+    return af;
+  }
+};
+} // anonymous namespace
+
+nd::arrfunc kernels::make_builtin_argmin1d_arrfunc(type_id_t tid)
+{
+  return argminmax1d_arrfunc<false>::make_arrfunc(tid);
+}
+
+nd::arrfunc kernels::make_builtin_argmax1d_arrfunc(type_id_t tid)
+{
+  return argminmax1d_arrfunc<true>::make_arrfunc(tid);
 }
 
 namespace {
@@ -232,5 +1136,20 @@ nd::arrfunc kernels::make_builtin_mean1d_arrfunc(type_id_t tid, intptr_t minp)
   out_af->instantiate = &mean1d_arrfunc_data::instantiate;
   out_af->free = &mean1d_arrfunc_data::free;
   mean1d.flag_as_immutable();
-  return mean1d;
+  builtin1d_info info = {builtin1d_mean, float64_type_id, minp};
+  return make_builtin1d_tagged_arrfunc(mean1d, info);
+}
+
+bool kernels::get_builtin1d_info(const nd::arrfunc &af,
+                                 builtin1d_info &out_info)
+{
+  if (af.is_null()) {
+    return false;
+  }
+  const arrfunc_type_data *self = af.get();
+  if (self->instantiate != &builtin1d_tagged_ck::instantiate) {
+    return false;
+  }
+  out_info = (*self->get_data_as<builtin1d_tagged_data *>())->info;
+  return true;
 }
@@ -3,23 +3,46 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include <dynd/kernels/ckernel_common_functions.hpp>
 #include <dynd/kernels/rolling.hpp>
 #include <dynd/types/var_dim_type.hpp>
 
+#include "kernel_helpers.hpp"
+
 using namespace std;
 using namespace dynd;
 
 void nd::functional::strided_rolling_ck::single(char *dst, char *const *src)
 {
-  ckernel_prefix *nachild = get_child_ckernel();
   ckernel_prefix *wopchild = get_child_ckernel(m_window_op_offset);
-  expr_strided_t nachild_fn = nachild->get_function<expr_strided_t>();
   expr_strided_t wopchild_fn = wopchild->get_function<expr_strided_t>();
   // Fill in NA/NaN at the beginning
-  if (m_dim_size > 0) {
-    nachild_fn(dst, m_dst_stride, NULL, NULL,
-               std::min(m_window_size - 1, m_dim_size), nachild);
+  intptr_t nfill = std::min(m_min_periods - 1, m_dim_size);
+  if (nfill > 0) {
+    ckernel_prefix *nachild = get_child_ckernel();
+    nachild->get_function<expr_strided_t>()(dst, m_dst_stride, NULL, NULL,
+                                            nfill, nachild);
+  }
+  // The windows at the beginning which are shorter than the window size.
+  // The values are copied after the identity padding in the head buffer, so
+  // a full size window ending at each of them covers only the values so far.
+  intptr_t nhead = std::min(m_window_size - 1, m_dim_size);
+  if (nfill < nhead) {
+    intptr_t el_size = m_head_el_size;
+    char *head_values = &m_head_buffer[0] + (m_window_size - 1) * el_size;
+    for (intptr_t i = 0; i < nhead; ++i) {
+      memcpy(head_values + i * el_size, src[0] + i * m_src_stride, el_size);
+    }
+    ckernel_prefix *headchild = get_child_ckernel(m_head_op_offset);
+    char *head_src = &m_head_buffer[0] + nfill * el_size;
+    headchild->get_function<expr_strided_t>()(dst + m_dst_stride * nfill,
+                                              m_dst_stride, &head_src,
+                                              &el_size, nhead - nfill,
+                                              headchild);
   }
   // Use stride trickery to do this as one strided call
   if (m_dim_size >= m_window_size) {
@@ -31,9 +54,15 @@ void nd::functional::strided_rolling_ck::single(char *dst, char *const *src)
 void nd::functional::strided_rolling_ck::destruct_children()
 {
   // The NA filler
-  get_child_ckernel()->destroy();
+  if (m_min_periods > 1) {
+    get_child_ckernel()->destroy();
+  }
   // The window op
   destroy_child_ckernel(m_window_op_offset);
+  // The window op for the windows at the start
+  if (m_min_periods < m_window_size) {
+    destroy_child_ckernel(m_head_op_offset);
+  }
 }
 
 void nd::functional::var_rolling_ck::single(char *dst, char *const *src)
@@ -75,6 +104,541 @@ void nd::functional::var_rolling_ck::destruct_children()
   destroy_child_ckernel(sizeof(self_type));
 }
 
+namespace {
+
+/**
+ * The window states for rolling a builtin aggregate incrementally. Each
+ * one has values added on the right and removed on the left as the
+ * window moves, and produces the aggregate of the window in O(1). Removing
+ * a value returns true if the state should be rebuilt from the window.
+ */
+
+/**
+ * Integer sums wrap around like the sum reduction does, so the running
+ * sum is kept modulo 2^64, where adding and removing values is exact.
+ */
+template <class T>
+struct rolling_int_sum {
+  typedef T src_type;
+  typedef T dst_type;
+  static const bool periodic_rebuild = false;
+
+  uint64_t m_sum;
+
+  void init(const kernels::builtin1d_info &DYND_UNUSED(info),
+            intptr_t DYND_UNUSED(window_size))
+  {
+  }
+
+  void reset() { m_sum = 0; }
+
+  void add(T v, intptr_t DYND_UNUSED(i)) { m_sum += static_cast<uint64_t>(v); }
+
+  bool remove(T v, intptr_t DYND_UNUSED(i))
+  {
+    m_sum -= static_cast<uint64_t>(v);
+    return false;
+  }
+
+  T result(intptr_t DYND_UNUSED(count)) const
+  {
+    return static_cast<T>(m_sum);
+  }
+};
+
+/**
+ * The finite values of a window, added and removed with Neumaier
+ * compensation, and counts of the other values. A running sum which
+ * included a NaN or an infinity would stay NaN after it left the window.
+ */
+struct compensated_window_sum {
+  double m_sum, m_comp;
+  intptr_t m_finite_count, m_nan_count, m_posinf_count, m_neginf_count;
+
+  void reset()
+  {
+    m_sum = m_comp = 0;
+    m_finite_count = m_nan_count = m_posinf_count = m_neginf_count = 0;
+  }
+
+  void update(double v, intptr_t delta)
+  {
+    if (detail::is_nan_value(v)) {
+      m_nan_count += delta;
+    } else if (v == numeric_limits<double>::infinity()) {
+      m_posinf_count += delta;
+    } else if (v == -numeric_limits<double>::infinity()) {
+      m_neginf_count += delta;
+    } else if ((m_finite_count += delta) == 0) {
+      // Drop the rounding error whenever the window has no finite values
+      m_sum = m_comp = 0;
+    } else {
+      double x = delta > 0 ? v : -v;
+      double t = m_sum + x;
+      if (fabs(m_sum) >= fabs(x)) {
+        m_comp += (m_sum - t) + x;
+      } else {
+        m_comp += (x - t) + m_sum;
+      }
+      m_sum = t;
+    }
+  }
+
+  /** The sum of the values which aren't NaN */
+  double nan_skipping_sum() const
+  {
+    if (m_posinf_count > 0) {
+      return m_neginf_count > 0 ? numeric_limits<double>::quiet_NaN()
+                                : numeric_limits<double>::infinity();
+    } else if (m_neginf_count > 0) {
+      return -numeric_limits<double>::infinity();
+    }
+    return m_sum + m_comp;
+  }
+
+  double sum() const
+  {
+    return m_nan_count > 0 ? numeric_limits<double>::quiet_NaN()
+                           : nan_skipping_sum();
+  }
+};
+
+template <class T>
+struct rolling_real_sum {
+  typedef T src_type;
+  typedef T dst_type;
+  static const bool periodic_rebuild = false;
+
+  compensated_window_sum m_sum;
+
+  void init(const kernels::builtin1d_info &DYND_UNUSED(info),
+            intptr_t DYND_UNUSED(window_size))
+  {
+  }
+
+  void reset() { m_sum.reset(); }
+
+  void add(T v, intptr_t DYND_UNUSED(i)) { m_sum.update(v, 1); }
+
+  bool remove(T v, intptr_t DYND_UNUSED(i))
+  {
+    m_sum.update(v, -1);
+    return false;
+  }
+
+  T result(intptr_t DYND_UNUSED(count)) const
+  {
+    return static_cast<T>(m_sum.sum());
+  }
+};
+
+/** The mean of the values which aren't NaN, like mean1d */
+struct rolling_mean {
+  typedef double src_type;
+  typedef double dst_type;
+  static const bool periodic_rebuild = false;
+
+  intptr_t m_minp;
+  compensated_window_sum m_sum;
+
+  void init(const kernels::builtin1d_info &info,
+            intptr_t DYND_UNUSED(window_size))
+  {
+    m_minp = info.param;
+  }
+
+  void reset() { m_sum.reset(); }
+
+  void add(double v, intptr_t DYND_UNUSED(i)) { m_sum.update(v, 1); }
+
+  bool remove(double v, intptr_t DYND_UNUSED(i))
+  {
+    m_sum.update(v, -1);
+    return false;
+  }
+
+  double result(intptr_t count) const
+  {
+    // As in mean1d, a minp which isn't positive counts back from the
+    // number of values in the window
+    intptr_t minp = m_minp > 0 ? m_minp : m_minp + count;
+    intptr_t n = m_sum.m_finite_count + m_sum.m_posinf_count +
+                 m_sum.m_neginf_count;
+    if (n >= minp) {
+      return m_sum.nan_skipping_sum() / n;
+    } else {
+      return numeric_limits<double>::quiet_NaN();
+    }
+  }
+};
+
+/**
+ * The count, mean and sum of squared deviations of the finite values,
+ * updated by Welford's method, which also runs backwards to remove a
+ * value. Removing values accumulates rounding error, so the state is
+ * rebuilt from the window every window_size removals, amortizing to O(1).
+ */
+template <class T, bool Std>
+struct rolling_moments {
+  typedef T src_type;
+  typedef double dst_type;
+  static const bool periodic_rebuild = true;
+
+  intptr_t m_ddof;
+  intptr_t m_count, m_nonfinite_count;
+  double m_mean, m_m2;
+
+  void init(const kernels::builtin1d_info &info,
+            intptr_t DYND_UNUSED(window_size))
+  {
+    m_ddof = info.param;
+  }
+
+  void reset()
+  {
+    m_count = m_nonfinite_count = 0;
+    m_mean = m_m2 = 0;
+  }
+
+  void add(T v, intptr_t DYND_UNUSED(i))
+  {
+    double x = static_cast<double>(v);
+    if (!(x - x == 0)) {
+      ++m_nonfinite_count;
+    } else {
+      ++m_count;
+      double delta = x - m_mean;
+      m_mean += delta / static_cast<double>(m_count);
+      m_m2 += delta * (x - m_mean);
+    }
+  }
+
+  bool remove(T v, intptr_t DYND_UNUSED(i))
+  {
+    double x = static_cast<double>(v);
+    if (!(x - x == 0)) {
+      --m_nonfinite_count;
+    } else if (--m_count == 0) {
+      m_mean = m_m2 = 0;
+    } else {
+      double delta = x - m_mean;
+      m_mean -= delta / static_cast<double>(m_count);
+      double m2 = m_m2 - delta * (x - m_mean);
+      // When an outlier leaves, most of the digits of m2 cancel, so ask
+      // for the state to be rebuilt from the window
+      bool rebuild = m_m2 > 0 && !(m2 * 1e4 > m_m2);
+      m_m2 = std::max(m2, 0.0);
+      return rebuild && m_count > 1;
+    }
+    return false;
+  }
+
+  double result(intptr_t DYND_UNUSED(count)) const
+  {
+    // The moments reduction gives NaN for a NaN or an infinity
+    if (m_nonfinite_count > 0 || m_count <= m_ddof) {
+      return numeric_limits<double>::quiet_NaN();
+    }
+    double var = m_m2 / static_cast<double>(m_count - m_ddof);
+    return Std ? sqrt(var) : var;
+  }
+};
+
+/**
+ * The minimum or maximum of a window from a monotonic deque of the values
+ * which may still become the result, each with its index. A value removes
+ * the ones it beats from the back, so the front is the result, and a
+ * value leaves from the front once its index leaves the window. A NaN in
+ * the window makes the result NaN, as in the min and max reductions.
+ */
+template <class T, bool Max>
+struct rolling_minmax {
+  typedef T src_type;
+  typedef T dst_type;
+  static const bool periodic_rebuild = false;
+
+  // A ring buffer holding the deque
+  std::vector<std::pair<T, intptr_t>> m_deque;
+  intptr_t m_front, m_size, m_nan_count;
+
+  void init(const kernels::builtin1d_info &DYND_UNUSED(info),
+            intptr_t window_size)
+  {
+    m_deque.resize(window_size);
+  }
+
+  void reset() { m_front = m_size = m_nan_count = 0; }
+
+  void add(T v, intptr_t i)
+  {
+    if (detail::is_nan_value(v)) {
+      ++m_nan_count;
+      return;
+    }
+    intptr_t capacity = static_cast<intptr_t>(m_deque.size());
+    while (m_size > 0) {
+      intptr_t back = m_front + m_size - 1;
+      const T &back_value =
+          m_deque[back >= capacity ? back - capacity : back].first;
+      if (Max ? (back_value > v) : (back_value < v)) {
+        break;
+      }
+      --m_size;
+    }
+    intptr_t pos = m_front + m_size;
+    m_deque[pos >= capacity ? pos - capacity : pos] = std::make_pair(v, i);
+    ++m_size;
+  }
+
+  bool remove(T v, intptr_t i)
+  {
+    if (detail::is_nan_value(v)) {
+      --m_nan_count;
+    } else if (m_size > 0 && m_deque[m_front].second == i) {
+      if (++m_front == static_cast<intptr_t>(m_deque.size())) {
+        m_front = 0;
+      }
+      --m_size;
+    }
+    return false;
+  }
+
+  T result(intptr_t DYND_UNUSED(count)) const
+  {
+    return m_nan_count > 0 ? numeric_limits<T>::quiet_NaN()
+                           : m_deque[m_front].first;
+  }
+};
+
+/**
+ * Rolls a window state along a strided dimension, in one pass over it.
+ * The first ``min_periods - 1`` outputs are filled by the NA-filling
+ * child ckernel, like in strided_rolling_ck.
+ */
+template <class State>
+struct incremental_rolling_ck
+    : nd::base_kernel<incremental_rolling_ck<State>, kernel_request_host, 1> {
+  typedef typename State::src_type src_type;
+  typedef typename State::dst_type dst_type;
+
+  intptr_t m_window_size, m_min_periods;
+  intptr_t m_dim_size, m_dst_stride, m_src_stride;
+  State m_state;
+
+  void single(char *dst, char *const *src)
+  {
+    intptr_t window_size = m_window_size, dim_size = m_dim_size;
+    intptr_t dst_stride = m_dst_stride, src_stride = m_src_stride;
+    const char *src0 = src[0];
+    intptr_t nfill = std::min(m_min_periods - 1, dim_size);
+    if (nfill > 0) {
+      ckernel_prefix *nachild = this->get_child_ckernel();
+      nachild->get_function<expr_strided_t>()(dst, dst_stride, NULL, NULL,
+                                              nfill, nachild);
+    }
+    State &state = m_state;
+    state.reset();
+    intptr_t nremoved = 0;
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      if (i >= window_size) {
+        intptr_t j = i - window_size;
+        bool rebuild = state.remove(
+            *reinterpret_cast<const src_type *>(src0 + j * src_stride), j);
+        if (rebuild ||
+            (State::periodic_rebuild && ++nremoved == window_size)) {
+          nremoved = 0;
+          state.reset();
+          for (++j; j < i; ++j) {
+            state.add(
+                *reinterpret_cast<const src_type *>(src0 + j * src_stride), j);
+          }
+        }
+      }
+      state.add(*reinterpret_cast<const src_type *>(src0 + i * src_stride), i);
+      if (i >= nfill) {
+        *reinterpret_cast<dst_type *>(dst + i * dst_stride) =
+            state.result(std::min(i + 1, window_size));
+      }
+    }
+  }
+
+  void destruct_children()
+  {
+    if (m_min_periods > 1) {
+      this->get_child_ckernel()->destroy();
+    }
+  }
+};
+
+struct rolling_dims {
+  intptr_t dim_size, dst_stride, src_stride;
+  ndt::type dst_el_tp;
+  const char *dst_el_arrmeta;
+};
+
+template <class State>
+intptr_t make_incremental_rolling_ck(
+    const nd::functional::rolling_arrfunc_data *data, void *ckb,
+    intptr_t ckb_offset, const rolling_dims &dims, kernel_request_t kernreq,
+    const eval::eval_context *ectx)
+{
+  typedef incremental_rolling_ck<State> self_type;
+  self_type *self = self_type::make(ckb, kernreq, ckb_offset);
+  self->m_window_size = data->window_size;
+  self->m_min_periods = data->min_periods;
+  self->m_dim_size = dims.dim_size;
+  self->m_dst_stride = dims.dst_stride;
+  self->m_src_stride = dims.src_stride;
+  self->m_state.init(data->builtin, data->window_size);
+  if (data->min_periods > 1) {
+    ckb_offset = kernels::make_constant_value_assignment_ckernel(
+        ckb, ckb_offset, dims.dst_el_tp, dims.dst_el_arrmeta,
+        numeric_limits<double>::quiet_NaN(), kernel_request_strided, ectx);
+  }
+  return ckb_offset;
+}
+
+template <template <class, bool> class State, bool Flag>
+bool make_numeric_rolling_ck(const nd::functional::rolling_arrfunc_data *data,
+                             void *ckb, intptr_t &ckb_offset,
+                             const rolling_dims &dims, kernel_request_t kernreq,
+                             const eval::eval_context *ectx)
+{
+  switch (data->builtin.tid) {
+  case int8_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<int8_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case int16_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<int16_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case int32_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<int32_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case int64_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<int64_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case uint8_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<uint8_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case uint16_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<uint16_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case uint32_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<uint32_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case uint64_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<uint64_t, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case float32_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<float, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case float64_type_id:
+    ckb_offset = make_incremental_rolling_ck<State<double, Flag>>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Makes the incremental ckernel for a builtin window op, returning false
+ * if there isn't one for its types.
+ */
+bool make_builtin_rolling_ck(const nd::functional::rolling_arrfunc_data *data,
+                             void *ckb, intptr_t &ckb_offset,
+                             const rolling_dims &dims,
+                             const ndt::type &src_el_tp,
+                             kernel_request_t kernreq,
+                             const eval::eval_context *ectx)
+{
+  const kernels::builtin1d_info &info = data->builtin;
+  type_id_t dst_tid = info.tid;
+  if (info.op == kernels::builtin1d_mean || info.op == kernels::builtin1d_var ||
+      info.op == kernels::builtin1d_std) {
+    dst_tid = float64_type_id;
+  }
+  if (src_el_tp.get_type_id() != info.tid ||
+      dims.dst_el_tp.get_type_id() != dst_tid) {
+    return false;
+  }
+
+  switch (info.op) {
+  case kernels::builtin1d_sum:
+    switch (info.tid) {
+    case int32_type_id:
+      ckb_offset = make_incremental_rolling_ck<rolling_int_sum<int32_t>>(
+          data, ckb, ckb_offset, dims, kernreq, ectx);
+      return true;
+    case int64_type_id:
+      ckb_offset = make_incremental_rolling_ck<rolling_int_sum<int64_t>>(
+          data, ckb, ckb_offset, dims, kernreq, ectx);
+      return true;
+    case float32_type_id:
+      ckb_offset = make_incremental_rolling_ck<rolling_real_sum<float>>(
+          data, ckb, ckb_offset, dims, kernreq, ectx);
+      return true;
+    case float64_type_id:
+      ckb_offset = make_incremental_rolling_ck<rolling_real_sum<double>>(
+          data, ckb, ckb_offset, dims, kernreq, ectx);
+      return true;
+    default:
+      return false;
+    }
+  case kernels::builtin1d_mean:
+    if (info.param <= 0 && info.param <= -data->min_periods) {
+      throw invalid_argument(
+          "minp parameter is too large of a negative number");
+    }
+    ckb_offset = make_incremental_rolling_ck<rolling_mean>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+    return true;
+  case kernels::builtin1d_min:
+    return make_numeric_rolling_ck<rolling_minmax, false>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+  case kernels::builtin1d_max:
+    return make_numeric_rolling_ck<rolling_minmax, true>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+  case kernels::builtin1d_var:
+    return make_numeric_rolling_ck<rolling_moments, false>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+  case kernels::builtin1d_std:
+    return make_numeric_rolling_ck<rolling_moments, true>(
+        data, ckb, ckb_offset, dims, kernreq, ectx);
+  default:
+    return false;
+  }
+}
+
+/**
+ * Sets up arrmeta for the window op to view ``size`` values of the
+ * source dimension as a fixed dimension.
+ */
+void make_window_arrmeta(arrmeta_holder &out_meta, intptr_t size,
+                         intptr_t src_stride, const ndt::type &src_el_tp,
+                         const char *src_el_arrmeta)
+{
+  arrmeta_holder(ndt::make_fixed_dim(size, src_el_tp)).swap(out_meta);
+  out_meta.get_at<fixed_dim_type_arrmeta>(0)->dim_size = size;
+  out_meta.get_at<fixed_dim_type_arrmeta>(0)->stride = src_stride;
+  if (src_el_tp.get_arrmeta_size() > 0) {
+    src_el_tp.extended()->arrmeta_copy_construct(
+        out_meta.get() + sizeof(fixed_dim_type_arrmeta), src_el_arrmeta,
+        NULL);
+  }
+}
+
+} // anonymous namespace
+
 // TODO This should handle both strided and var cases
 intptr_t nd::functional::rolling_ck::instantiate(
     const arrfunc_type_data *af_self, const ndt::arrfunc_type *DYND_UNUSED(af_tp),
@@ -87,15 +651,11 @@ intptr_t nd::functional::rolling_ck::instantiate(
   typedef dynd::nd::functional::strided_rolling_ck self_type;
   rolling_arrfunc_data *data = *af_self->get_data_as<rolling_arrfunc_data *>();
 
-  intptr_t root_ckb_offset = ckb_offset;
-  self_type *self = self_type::make(ckb, kernreq, ckb_offset);
-  const arrfunc_type_data *window_af = data->window_op.get();
-  const ndt::arrfunc_type *window_af_tp = data->window_op.get_type();
-  ndt::type dst_el_tp, src_el_tp;
-  const char *dst_el_arrmeta, *src_el_arrmeta;
-  if (!dst_tp.get_as_strided(dst_arrmeta, &self->m_dim_size,
-                             &self->m_dst_stride, &dst_el_tp,
-                             &dst_el_arrmeta)) {
+  rolling_dims dims;
+  ndt::type src_el_tp;
+  const char *src_el_arrmeta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, &dims.dim_size, &dims.dst_stride,
+                             &dims.dst_el_tp, &dims.dst_el_arrmeta)) {
     stringstream ss;
     ss << "rolling window ckernel: could not process type " << dst_tp;
     ss << " as a strided dimension";
@@ -103,50 +663,93 @@ intptr_t nd::functional::rolling_ck::instantiate(
   }
   intptr_t src_dim_size;
   if (!src_tp[0].get_as_strided(src_arrmeta[0], &src_dim_size,
-                                &self->m_src_stride, &src_el_tp,
+                                &dims.src_stride, &src_el_tp,
                                 &src_el_arrmeta)) {
     stringstream ss;
     ss << "rolling window ckernel: could not process type " << src_tp[0];
     ss << " as a strided dimension";
     throw type_error(ss.str());
   }
-  if (src_dim_size != self->m_dim_size) {
+  if (src_dim_size != dims.dim_size) {
     stringstream ss;
     ss << "rolling window ckernel: source dimension size " << src_dim_size
        << " for type " << src_tp[0] << " does not match dest dimension size "
-       << self->m_dim_size << " for type " << dst_tp;
+       << dims.dim_size << " for type " << dst_tp;
     throw type_error(ss.str());
   }
+
+  // A builtin aggregate is updated as the window moves, rather than
+  // computed over every window
+  if (data->is_builtin && make_builtin_rolling_ck(data, ckb, ckb_offset, dims,
+                                                  src_el_tp, kernreq, ectx)) {
+    return ckb_offset;
+  }
+
+  intptr_t root_ckb_offset = ckb_offset;
+  self_type *self = self_type::make(ckb, kernreq, ckb_offset);
   self->m_window_size = data->window_size;
+  self->m_min_periods = data->min_periods;
+  self->m_dim_size = dims.dim_size;
+  self->m_dst_stride = dims.dst_stride;
+  self->m_src_stride = dims.src_stride;
   // Create the NA-filling child ckernel
-  ckb_offset = kernels::make_constant_value_assignment_ckernel(
-      ckb, ckb_offset, dst_el_tp, dst_el_arrmeta,
-      numeric_limits<double>::quiet_NaN(), kernel_request_strided, ectx);
-  // Re-retrieve the self pointer, because it may be at a new memory location
-  // now
-  self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
-             ->get_at<self_type>(root_ckb_offset);
+  if (data->min_periods > 1) {
+    ckb_offset = kernels::make_constant_value_assignment_ckernel(
+        ckb, ckb_offset, dims.dst_el_tp, dims.dst_el_arrmeta,
+        numeric_limits<double>::quiet_NaN(), kernel_request_strided, ectx);
+    // Re-retrieve the self pointer, because it may be at a new memory
+    // location now
+    self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+               ->get_at<self_type>(root_ckb_offset);
+  }
   // Create the window op child ckernel
+  const arrfunc_type_data *window_af = data->window_op.get();
+  const ndt::arrfunc_type *window_af_tp = data->window_op.get_type();
   self->m_window_op_offset = ckb_offset - root_ckb_offset;
   // We construct array arrmeta for the window op ckernel to use,
   // without actually creating an nd::array to hold it.
-  arrmeta_holder(ndt::make_fixed_dim(data->window_size, src_el_tp))
-      .swap(self->m_src_winop_meta);
-  self->m_src_winop_meta.get_at<fixed_dim_type_arrmeta>(0)->dim_size =
-      self->m_window_size;
-  self->m_src_winop_meta.get_at<fixed_dim_type_arrmeta>(0)->stride =
-      self->m_src_stride;
-  if (src_el_tp.get_arrmeta_size() > 0) {
-    src_el_tp.extended()->arrmeta_copy_construct(
-        self->m_src_winop_meta.get() + sizeof(fixed_dim_type_arrmeta),
-        src_el_arrmeta, NULL);
-  }
-
+  make_window_arrmeta(self->m_src_winop_meta, data->window_size,
+                      dims.src_stride, src_el_tp, src_el_arrmeta);
+  const ndt::type *src_winop_tp = &self->m_src_winop_meta.get_type();
   const char *src_winop_meta = self->m_src_winop_meta.get();
-  return window_af->instantiate(
-      window_af, window_af_tp, NULL, ckb, ckb_offset, dst_el_tp, dst_el_arrmeta,
-      nsrc, &self->m_src_winop_meta.get_type(), &src_winop_meta,
+  ckb_offset = window_af->instantiate(
+      window_af, window_af_tp, NULL, ckb, ckb_offset, dims.dst_el_tp,
+      dims.dst_el_arrmeta, nsrc, src_winop_tp, &src_winop_meta,
       kernel_request_strided, ectx, kwds, tp_vars);
+  // The windows at the beginning shorter than the window size share one
+  // more instance of the window op, over the padded head buffer
+  if (data->min_periods < data->window_size) {
+    const nd::array &ident = data->head_identity;
+    if (ident.is_null() || !src_el_tp.is_builtin() ||
+        ident.get_type() != src_el_tp) {
+      stringstream ss;
+      ss << "rolling window ckernel: a min_periods less than the window size "
+            "requires a builtin reduction of " << src_el_tp
+         << " as the window op";
+      throw type_error(ss.str());
+    }
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+    self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+               ->get_at<self_type>(root_ckb_offset);
+    intptr_t el_size = src_el_tp.get_data_size();
+    self->m_head_op_offset = ckb_offset - root_ckb_offset;
+    self->m_head_el_size = el_size;
+    self->m_head_buffer.resize(2 * (data->window_size - 1) * el_size);
+    for (intptr_t i = 0; i < data->window_size - 1; ++i) {
+      memcpy(&self->m_head_buffer[i * el_size], ident.get_readonly_originptr(),
+             el_size);
+    }
+    make_window_arrmeta(self->m_head_winop_meta, data->window_size, el_size,
+                        src_el_tp, src_el_arrmeta);
+    src_winop_tp = &self->m_head_winop_meta.get_type();
+    src_winop_meta = self->m_head_winop_meta.get();
+    ckb_offset = window_af->instantiate(
+        window_af, window_af_tp, NULL, ckb, ckb_offset, dims.dst_el_tp,
+        dims.dst_el_arrmeta, nsrc, src_winop_tp, &src_winop_meta,
+        kernel_request_strided, ectx, kwds, tp_vars);
+  }
+  return ckb_offset;
 }
 
 void nd::functional::rolling_ck::resolve_dst_type(
@@ -170,8 +773,8 @@ void nd::functional::rolling_ck::resolve_dst_type(
   if (child_af->resolve_dst_type) {
     ndt::type child_src_tp = ndt::make_fixed_dim(
         data->window_size, src_tp[0].get_type_at_dimension(NULL, 1));
-    child_af->resolve_dst_type(child_af, af_tp, NULL, child_dst_tp, 1,
-                               &child_src_tp, kwds, tp_vars);
+    child_af->resolve_dst_type(child_af, data->window_op.get_type(), NULL,
+                               child_dst_tp, 1, &child_src_tp, kwds, tp_vars);
   } else {
     child_dst_tp = data->window_op.get_type()->get_return_type();
   }
@@ -0,0 +1,608 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/scan.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "kernel_helpers.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+using detail::fixed_or_var_dim;
+using detail::is_complex_value;
+using detail::is_nan_value;
+
+/**
+ * The builtin scan operations. ``combine(a, b)`` is the scan value after
+ * ``b``, given the scan value ``a`` before it.
+ */
+template <class T>
+struct sum_scan_op {
+  enum { supported = true };
+  static T combine(T a, T b) { return static_cast<T>(a + b); }
+};
+
+template <class T>
+struct prod_scan_op {
+  enum { supported = true };
+  static T combine(T a, T b) { return static_cast<T>(a * b); }
+};
+
+template <class T>
+struct min_scan_op {
+  enum { supported = !is_complex_value<T>::value };
+  // A NaN on either side is propagated
+  static T combine(T a, T b) { return (b < a || is_nan_value(b)) ? b : a; }
+};
+
+template <class T>
+struct max_scan_op {
+  enum { supported = !is_complex_value<T>::value };
+  static T combine(T a, T b) { return (b > a || is_nan_value(b)) ? b : a; }
+};
+
+/**
+ * Calls ``f.apply<Op<T>>()`` for the C++ type T of the type id, returning
+ * false if the type id isn't one the scans handle.
+ */
+template <template <class> class Op, class F>
+bool visit_scan_type(type_id_t tid, F &f)
+{
+  switch (tid) {
+  case int8_type_id:
+    return f.template apply<Op<int8_t>>();
+  case int16_type_id:
+    return f.template apply<Op<int16_t>>();
+  case int32_type_id:
+    return f.template apply<Op<int32_t>>();
+  case int64_type_id:
+    return f.template apply<Op<int64_t>>();
+  case uint8_type_id:
+    return f.template apply<Op<uint8_t>>();
+  case uint16_type_id:
+    return f.template apply<Op<uint16_t>>();
+  case uint32_type_id:
+    return f.template apply<Op<uint32_t>>();
+  case uint64_type_id:
+    return f.template apply<Op<uint64_t>>();
+  case float32_type_id:
+    return f.template apply<Op<float>>();
+  case float64_type_id:
+    return f.template apply<Op<double>>();
+  case complex_float32_type_id:
+    return f.template apply<Op<dynd::complex<float>>>();
+  case complex_float64_type_id:
+    return f.template apply<Op<dynd::complex<double>>>();
+  default:
+    return false;
+  }
+}
+
+template <class F>
+bool visit_builtin_scan(nd::functional::builtin_scan_t op, type_id_t tid,
+                        F &f)
+{
+  switch (op) {
+  case nd::functional::builtin_scan_sum:
+    return visit_scan_type<sum_scan_op>(tid, f);
+  case nd::functional::builtin_scan_prod:
+    return visit_scan_type<prod_scan_op>(tid, f);
+  case nd::functional::builtin_scan_min:
+    return visit_scan_type<min_scan_op>(tid, f);
+  case nd::functional::builtin_scan_max:
+    return visit_scan_type<max_scan_op>(tid, f);
+  default:
+    return false;
+  }
+}
+
+template <class T>
+struct scan_value_type;
+
+template <template <class> class Op, class T>
+struct scan_value_type<Op<T>> {
+  typedef T type;
+};
+
+/**
+ * A dimension before the scanned one, whose elements are scanned
+ * independently by the child ckernel.
+ */
+struct scan_outer_ck
+    : nd::base_kernel<scan_outer_ck, kernel_request_host, 1> {
+  fixed_or_var_dim m_dst_dim, m_src_dim;
+
+  void single(char *dst, char *const *src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_single_t child_fn = child->get_function<expr_single_t>();
+    intptr_t dim_size;
+    char *src_data = m_src_dim.get_src(src[0], dim_size);
+    char *dst_data = m_dst_dim.get_dst(dst, dim_size);
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      child_fn(dst_data, &src_data, child);
+      dst_data += m_dst_dim.stride;
+      src_data += m_src_dim.stride;
+    }
+  }
+
+  void destruct_children() { get_child_ckernel()->destroy(); }
+};
+
+/**
+ * The scanned dimension. A var dimension, or a fixed one too small to be
+ * worth splitting, is scanned serially. Otherwise the dimension is split
+ * into chunks, and
+ *  - every chunk but the last is reduced on the thread pool,
+ *  - the chunk totals are combined in order into the scan value before
+ *    each chunk,
+ *  - every chunk is scanned on the thread pool, starting from the scan
+ *    value before it.
+ *
+ * Self provides, where ``chunk`` identifies the calling thread's chunk,
+ *  - ``scan_line(chunk, dst, src, n, carry)``, scanning n elements starting
+ *    from the value ``carry``, or from the first element if it's NULL,
+ *  - ``reduce_line(chunk, dst, src, n)``, reducing n > 0 elements,
+ *  - ``combine(chunk, dst, a, b)``, setting ``dst`` to ``op(a, b)``.
+ */
+template <class Self>
+struct scan_dim_ck : nd::base_kernel<Self, kernel_request_host, 1> {
+  fixed_or_var_dim m_dst_dim, m_src_dim;
+  intptr_t m_nthreads;
+  // The chunk boundaries if the dimension is split, otherwise empty
+  std::vector<intptr_t> m_chunk_begin;
+  // The value of each chunk's reduction, then of the scan up to its end
+  std::vector<char> m_partials;
+  size_t m_partial_size;
+
+  scan_dim_ck() : m_nthreads(1), m_partial_size(0) {}
+
+  /**
+   * Splits the dimension into chunks if it's fixed on both sides and the
+   * eval_context asks for threads, returning the number of chunks.
+   */
+  intptr_t partition(bool parallel, size_t partial_size,
+                     const eval::eval_context *ectx)
+  {
+    if (!parallel || ectx == NULL || ectx->nthreads <= 1 ||
+        m_src_dim.size < 0 || m_dst_dim.size < 0 ||
+        m_src_dim.size < 2 * ectx->parallel_grain_size) {
+      return 1;
+    }
+    intptr_t nchunks = partition_range(ectx->nthreads, m_src_dim.size,
+                                       ectx->parallel_grain_size,
+                                       m_chunk_begin);
+    if (nchunks <= 1) {
+      m_chunk_begin.clear();
+      return 1;
+    }
+    m_nthreads = ectx->nthreads;
+    m_partial_size = partial_size;
+    m_partials.resize(nchunks * partial_size);
+    return nchunks;
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    Self *self = static_cast<Self *>(this);
+    intptr_t dim_size;
+    const char *src_data = m_src_dim.get_src(src[0], dim_size);
+    char *dst_data = m_dst_dim.get_dst(dst, dim_size);
+    if (m_chunk_begin.empty()) {
+      self->scan_line(0, dst_data, src_data, dim_size, NULL);
+      return;
+    }
+
+    const std::vector<intptr_t> &chunk_begin = m_chunk_begin;
+    intptr_t nchunks = chunk_begin.size() - 1;
+    intptr_t dst_stride = m_dst_dim.stride, src_stride = m_src_dim.stride;
+    char *partials = &m_partials[0];
+    size_t partial_size = m_partial_size;
+    thread_pool::get().run(m_nthreads, nchunks - 1, [&](intptr_t i) {
+      self->reduce_line(i, partials + i * partial_size,
+                        src_data + chunk_begin[i] * src_stride,
+                        chunk_begin[i + 1] - chunk_begin[i]);
+    });
+    for (intptr_t i = 1; i < nchunks - 1; ++i) {
+      self->combine(0, partials + i * partial_size,
+                    partials + (i - 1) * partial_size,
+                    partials + i * partial_size);
+    }
+    thread_pool::get().run(m_nthreads, nchunks, [&](intptr_t i) {
+      self->scan_line(i, dst_data + chunk_begin[i] * dst_stride,
+                      src_data + chunk_begin[i] * src_stride,
+                      chunk_begin[i + 1] - chunk_begin[i],
+                      i == 0 ? NULL : partials + (i - 1) * partial_size);
+    });
+  }
+};
+
+/** The scanned dimension of a builtin scan with scalar elements */
+template <class Op>
+struct builtin_scan_ck : scan_dim_ck<builtin_scan_ck<Op>> {
+  typedef typename scan_value_type<Op>::type T;
+
+  void scan_line(intptr_t DYND_UNUSED(chunk), char *dst, const char *src,
+                 intptr_t n, const char *carry)
+  {
+    if (n <= 0) {
+      return;
+    }
+    intptr_t dst_stride = this->m_dst_dim.stride;
+    intptr_t src_stride = this->m_src_dim.stride;
+    T acc = *reinterpret_cast<const T *>(src);
+    if (carry != NULL) {
+      acc = Op::combine(*reinterpret_cast<const T *>(carry), acc);
+    }
+    *reinterpret_cast<T *>(dst) = acc;
+    if (dst_stride == sizeof(T) && src_stride == sizeof(T)) {
+      T *dst_ptr = reinterpret_cast<T *>(dst);
+      const T *src_ptr = reinterpret_cast<const T *>(src);
+      for (intptr_t i = 1; i < n; ++i) {
+        acc = Op::combine(acc, src_ptr[i]);
+        dst_ptr[i] = acc;
+      }
+    } else {
+      for (intptr_t i = 1; i < n; ++i) {
+        src += src_stride;
+        dst += dst_stride;
+        acc = Op::combine(acc, *reinterpret_cast<const T *>(src));
+        *reinterpret_cast<T *>(dst) = acc;
+      }
+    }
+  }
+
+  void reduce_line(intptr_t DYND_UNUSED(chunk), char *dst, const char *src,
+                   intptr_t n)
+  {
+    intptr_t src_stride = this->m_src_dim.stride;
+    T acc = *reinterpret_cast<const T *>(src);
+    for (intptr_t i = 1; i < n; ++i) {
+      src += src_stride;
+      acc = Op::combine(acc, *reinterpret_cast<const T *>(src));
+    }
+    *reinterpret_cast<T *>(dst) = acc;
+  }
+
+  void combine(intptr_t DYND_UNUSED(chunk), char *dst, const char *a,
+               const char *b)
+  {
+    *reinterpret_cast<T *>(dst) = Op::combine(
+        *reinterpret_cast<const T *>(a), *reinterpret_cast<const T *>(b));
+  }
+};
+
+/**
+ * The scanned dimension of any other scan, with a pair of child ckernels
+ * per chunk, one copying an element and one applying the operation.
+ */
+struct generic_scan_ck : scan_dim_ck<generic_scan_ck> {
+  // The offsets of the copy and operation ckernels of each chunk
+  std::vector<intptr_t> m_child_offsets;
+
+  void copy(intptr_t chunk, char *dst, const char *src)
+  {
+    ckernel_prefix *child = get_child_ckernel(m_child_offsets[2 * chunk]);
+    char *child_src = const_cast<char *>(src);
+    child->get_function<expr_single_t>()(dst, &child_src, child);
+  }
+
+  void combine(intptr_t chunk, char *dst, const char *a, const char *b)
+  {
+    ckernel_prefix *child = get_child_ckernel(m_child_offsets[2 * chunk + 1]);
+    char *child_src[2] = {const_cast<char *>(a), const_cast<char *>(b)};
+    child->get_function<expr_single_t>()(dst, child_src, child);
+  }
+
+  void scan_line(intptr_t chunk, char *dst, const char *src, intptr_t n,
+                 const char *carry)
+  {
+    if (n <= 0) {
+      return;
+    }
+    if (carry == NULL) {
+      copy(chunk, dst, src);
+    } else {
+      combine(chunk, dst, carry, src);
+    }
+    for (intptr_t i = 1; i < n; ++i) {
+      src += m_src_dim.stride;
+      combine(chunk, dst + m_dst_dim.stride, dst, src);
+      dst += m_dst_dim.stride;
+    }
+  }
+
+  void reduce_line(intptr_t chunk, char *dst, const char *src, intptr_t n)
+  {
+    copy(chunk, dst, src);
+    for (intptr_t i = 1; i < n; ++i) {
+      src += m_src_dim.stride;
+      combine(chunk, dst, dst, src);
+    }
+  }
+
+  void destruct_children()
+  {
+    for (size_t i = 0; i < m_child_offsets.size(); ++i) {
+      destroy_child_ckernel(m_child_offsets[i]);
+    }
+  }
+};
+
+struct make_builtin_scan_ck {
+  void *ckb;
+  intptr_t &ckb_offset;
+  kernel_request_t kernreq;
+  const eval::eval_context *ectx;
+  const fixed_or_var_dim &dst_dim, &src_dim;
+  bool associative;
+
+  template <class Op>
+  typename std::enable_if<Op::supported, bool>::type apply()
+  {
+    typedef builtin_scan_ck<Op> ck_type;
+    ck_type *self = ck_type::make(ckb, kernreq, ckb_offset);
+    self->m_dst_dim = dst_dim;
+    self->m_src_dim = src_dim;
+    self->partition(associative, sizeof(typename ck_type::T), ectx);
+    return true;
+  }
+
+  template <class Op>
+  typename std::enable_if<!Op::supported, bool>::type apply()
+  {
+    return false;
+  }
+};
+
+intptr_t make_generic_scan_ck(const nd::arrfunc &op, bool associative,
+                              void *ckb, intptr_t ckb_offset,
+                              const fixed_or_var_dim &dst_dim,
+                              const ndt::type &dst_tp, const char *dst_arrmeta,
+                              const fixed_or_var_dim &src_dim,
+                              const ndt::type &src_tp, const char *src_arrmeta,
+                              kernel_request_t kernreq,
+                              const eval::eval_context *ectx)
+{
+  intptr_t root_ckb_offset = ckb_offset;
+  generic_scan_ck *self = generic_scan_ck::make(ckb, kernreq, ckb_offset);
+  self->m_dst_dim = dst_dim;
+  self->m_src_dim = src_dim;
+  // The partial results are kept in plain memory, so splitting the
+  // dimension is only done for elements which don't need arrmeta
+  bool pod = dst_tp == src_tp && dst_tp.get_arrmeta_size() == 0 &&
+             (dst_tp.get_flags() & (type_flag_blockref | type_flag_zeroinit |
+                                    type_flag_destructor)) == 0;
+  intptr_t nchunks =
+      self->partition(associative && pod, dst_tp.get_data_size(), ectx);
+  self->m_child_offsets.resize(2 * nchunks);
+
+  ndt::type op_src_tp[2] = {dst_tp, src_tp};
+  const char *op_src_arrmeta[2] = {dst_arrmeta, src_arrmeta};
+  for (intptr_t i = 0; i < nchunks; ++i) {
+    self = generic_scan_ck::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_child_offsets[2 * i] = ckb_offset - root_ckb_offset;
+    ckb_offset = make_assignment_kernel(
+        NULL, NULL, ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp, src_arrmeta,
+        kernel_request_single, ectx, nd::array());
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+    self = generic_scan_ck::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_child_offsets[2 * i + 1] = ckb_offset - root_ckb_offset;
+    ckb_offset = op.get()->instantiate(
+        op.get(), op.get_type(), NULL, ckb, ckb_offset, dst_tp, dst_arrmeta,
+        2, op_src_tp, op_src_arrmeta, kernel_request_single, ectx,
+        nd::array(), std::map<nd::string, ndt::type>());
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  }
+  return ckb_offset;
+}
+
+intptr_t make_scan_kernels(const nd::functional::scan_arrfunc_data *data,
+                           intptr_t axis, void *ckb, intptr_t ckb_offset,
+                           const ndt::type &dst_tp, const char *dst_arrmeta,
+                           const ndt::type &src_tp, const char *src_arrmeta,
+                           kernel_request_t kernreq,
+                           const eval::eval_context *ectx)
+{
+  fixed_or_var_dim dst_dim, src_dim;
+  ndt::type dst_el_tp, src_el_tp;
+  const char *dst_el_arrmeta, *src_el_arrmeta;
+  dst_dim.init("scan", dst_tp, dst_arrmeta, dst_el_tp, dst_el_arrmeta);
+  src_dim.init("scan", src_tp, src_arrmeta, src_el_tp, src_el_arrmeta);
+  if (dst_dim.size >= 0 && src_dim.size >= 0 &&
+      dst_dim.size != src_dim.size) {
+    throw broadcast_error(dst_dim.size, src_dim.size, "scan dst",
+                          "scan src");
+  }
+
+  if (axis > 0) {
+    scan_outer_ck *self = scan_outer_ck::make(ckb, kernreq, ckb_offset);
+    self->m_dst_dim = dst_dim;
+    self->m_src_dim = src_dim;
+    return make_scan_kernels(data, axis - 1, ckb, ckb_offset, dst_el_tp,
+                             dst_el_arrmeta, src_el_tp, src_el_arrmeta,
+                             kernel_request_single, ectx);
+  }
+
+  nd::arrfunc op;
+  if (data->builtin != nd::functional::builtin_scan_none) {
+    if (dst_el_tp.is_builtin() && dst_el_tp == src_el_tp) {
+      make_builtin_scan_ck f = {ckb,     ckb_offset, kernreq,          ectx,
+                                dst_dim, src_dim,    data->associative};
+      if (!visit_builtin_scan(data->builtin, dst_el_tp.get_type_id(), f)) {
+        stringstream ss;
+        ss << "dynd scan: data type " << dst_el_tp << " is not supported";
+        throw type_error(ss.str());
+      }
+      return ckb_offset;
+    }
+    op = nd::functional::elwise(nd::functional::make_builtin_scan_op_arrfunc(
+        data->builtin, dst_el_tp.get_dtype().get_type_id()));
+  } else if (src_el_tp.get_ndim() >
+             data->op.get_type()->get_pos_type(0).get_ndim()) {
+    op = data->elwise_op;
+  } else {
+    op = data->op;
+  }
+  return make_generic_scan_ck(op, data->associative, ckb, ckb_offset, dst_dim,
+                              dst_el_tp, dst_el_arrmeta, src_dim, src_el_tp,
+                              src_el_arrmeta, kernreq, ectx);
+}
+
+/** The number of dimensions the scan can go along */
+intptr_t get_scan_ndim(const nd::functional::scan_arrfunc_data *data,
+                       const ndt::type &src_tp)
+{
+  intptr_t ndim = src_tp.get_ndim();
+  if (!data->op.is_null()) {
+    ndim -= data->op.get_type()->get_pos_type(0).get_ndim();
+  }
+  if (ndim < 1) {
+    stringstream ss;
+    ss << "dynd scan: the argument must have a dimension to scan, got "
+       << src_tp;
+    throw invalid_argument(ss.str());
+  }
+  return ndim;
+}
+
+struct builtin_scan_op_ck {
+  template <class Op>
+  struct type : nd::base_kernel<type<Op>, kernel_request_host, 2> {
+    typedef typename scan_value_type<Op>::type T;
+
+    void single(char *dst, char *const *src)
+    {
+      *reinterpret_cast<T *>(dst) =
+          Op::combine(*reinterpret_cast<const T *>(src[0]),
+                      *reinterpret_cast<const T *>(src[1]));
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src,
+                 const intptr_t *src_stride, size_t count)
+    {
+      const char *src0 = src[0], *src1 = src[1];
+      intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+      for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<T *>(dst) =
+            Op::combine(*reinterpret_cast<const T *>(src0),
+                        *reinterpret_cast<const T *>(src1));
+        dst += dst_stride;
+        src0 += src0_stride;
+        src1 += src1_stride;
+      }
+    }
+  };
+};
+
+template <class Op>
+struct builtin_scan_op_virtual_ck
+    : nd::base_virtual_kernel<builtin_scan_op_virtual_ck<Op>> {
+  static intptr_t
+  instantiate(const arrfunc_type_data *DYND_UNUSED(self),
+              const ndt::arrfunc_type *self_tp, char *DYND_UNUSED(data),
+              void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+              const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc),
+              const ndt::type *src_tp,
+              const char *const *DYND_UNUSED(src_arrmeta),
+              kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &DYND_UNUSED(kwds),
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    const ndt::type &tp = self_tp->get_return_type();
+    if (dst_tp != tp || src_tp[0] != tp || src_tp[1] != tp) {
+      stringstream ss;
+      ss << "dynd scan: expected (" << tp << ", " << tp << ") -> " << tp
+         << ", got (" << src_tp[0] << ", " << src_tp[1] << ") -> " << dst_tp;
+      throw type_error(ss.str());
+    }
+    builtin_scan_op_ck::type<Op>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  }
+};
+
+struct make_builtin_scan_op {
+  nd::arrfunc &af;
+
+  template <class Op>
+  typename std::enable_if<Op::supported, bool>::type apply()
+  {
+    ndt::type tp = ndt::make_type<typename scan_value_type<Op>::type>();
+    af = nd::arrfunc::make<builtin_scan_op_virtual_ck<Op>>(
+        ndt::make_arrfunc(ndt::make_tuple(tp, tp), tp), 0);
+    return true;
+  }
+
+  template <class Op>
+  typename std::enable_if<!Op::supported, bool>::type apply()
+  {
+    return false;
+  }
+};
+
+} // anonymous namespace
+
+nd::arrfunc nd::functional::make_builtin_scan_op_arrfunc(builtin_scan_t op,
+                                                         type_id_t tid)
+{
+  nd::arrfunc af;
+  make_builtin_scan_op f = {af};
+  if (!visit_builtin_scan(op, tid, f)) {
+    stringstream ss;
+    ss << "dynd scan: data type " << ndt::type(tid) << " is not supported";
+    throw type_error(ss.str());
+  }
+  return af;
+}
+
+intptr_t nd::functional::scan_ck::instantiate(
+    const arrfunc_type_data *af_self,
+    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t DYND_UNUSED(nsrc),
+    const ndt::type *src_tp, const char *const *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx,
+    const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const scan_arrfunc_data *data = *af_self->get_data_as<scan_arrfunc_data *>();
+  intptr_t axis =
+      dynd::detail::get_axis_kwd(kwds, get_scan_ndim(data, src_tp[0]), 0);
+  return make_scan_kernels(data, axis, ckb, ckb_offset, dst_tp, dst_arrmeta,
+                           src_tp[0], src_arrmeta[0], kernreq, ectx);
+}
+
+void nd::functional::scan_ck::resolve_dst_type(
+    const arrfunc_type_data *af_self, const ndt::arrfunc_type *af_tp,
+    char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t nsrc,
+    const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  if (nsrc != 1) {
+    stringstream ss;
+    ss << "Wrong number of arguments to scan arrfunc with prototype ";
+    ss << af_tp << ", got " << nsrc << " arguments";
+    throw invalid_argument(ss.str());
+  }
+  const scan_arrfunc_data *data = *af_self->get_data_as<scan_arrfunc_data *>();
+  get_scan_ndim(data, src_tp[0]);
+  // The scan keeps the dimensions and the element type, fixed dimensions
+  // staying fixed and var ones var
+  dst_tp = src_tp[0].get_canonical_type();
+}
@@ -0,0 +1,250 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+
+#include <dynd/kernels/simd_arithmetic.hpp>
+
+using namespace std;
+using namespace dynd;
+
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define DYND_SIMD_X86
+#endif
+
+namespace {
+
+template <kernels::arithmetic_op_t Op>
+struct arithmetic_op;
+
+template <>
+struct arithmetic_op<kernels::arithmetic_op_add> {
+  template <typename T>
+  static inline T apply(T a, T b)
+  {
+    return a + b;
+  }
+};
+
+template <>
+struct arithmetic_op<kernels::arithmetic_op_subtract> {
+  template <typename T>
+  static inline T apply(T a, T b)
+  {
+    return a - b;
+  }
+};
+
+template <>
+struct arithmetic_op<kernels::arithmetic_op_multiply> {
+  template <typename T>
+  static inline T apply(T a, T b)
+  {
+    return a * b;
+  }
+};
+
+template <>
+struct arithmetic_op<kernels::arithmetic_op_divide> {
+  template <typename T>
+  static inline T apply(T a, T b)
+  {
+    return a / b;
+  }
+};
+
+// The loops are written so the compiler vectorizes them, and are compiled
+// once per instruction set level by giving each copy a target attribute.
+// Every copy has the same results, only the instructions differ.
+#define DYND_SIMD_BINARY_LOOPS(NAME, ATTR)                                     \
+  template <kernels::arithmetic_op_t Op, typename T>                           \
+  struct NAME {                                                                \
+    ATTR static void vv(char *dst, const char *src0, const char *src1,         \
+                        size_t count)                                          \
+    {                                                                          \
+      T *d = reinterpret_cast<T *>(dst);                                       \
+      const T *a = reinterpret_cast<const T *>(src0);                          \
+      const T *b = reinterpret_cast<const T *>(src1);                          \
+      for (size_t i = 0; i < count; ++i) {                                     \
+        d[i] = arithmetic_op<Op>::apply(a[i], b[i]);                           \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    ATTR static void vs(char *dst, const char *src0, const char *src1,         \
+                        size_t count)                                          \
+    {                                                                          \
+      T *d = reinterpret_cast<T *>(dst);                                       \
+      const T *a = reinterpret_cast<const T *>(src0);                          \
+      const T b = *reinterpret_cast<const T *>(src1);                          \
+      for (size_t i = 0; i < count; ++i) {                                     \
+        d[i] = arithmetic_op<Op>::apply(a[i], b);                              \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    ATTR static void sv(char *dst, const char *src0, const char *src1,         \
+                        size_t count)                                          \
+    {                                                                          \
+      T *d = reinterpret_cast<T *>(dst);                                       \
+      const T a = *reinterpret_cast<const T *>(src0);                          \
+      const T *b = reinterpret_cast<const T *>(src1);                          \
+      for (size_t i = 0; i < count; ++i) {                                     \
+        d[i] = arithmetic_op<Op>::apply(a, b[i]);                              \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    ATTR static void ss(char *dst, const char *src0, const char *src1,         \
+                        size_t count)                                          \
+    {                                                                          \
+      T *d = reinterpret_cast<T *>(dst);                                       \
+      const T a = *reinterpret_cast<const T *>(src0);                          \
+      const T b = *reinterpret_cast<const T *>(src1);                          \
+      const T v = arithmetic_op<Op>::apply(a, b);                              \
+      for (size_t i = 0; i < count; ++i) {                                     \
+        d[i] = v;                                                              \
+      }                                                                        \
+    }                                                                          \
+  }
+
+DYND_SIMD_BINARY_LOOPS(generic_loops, );
+#ifdef DYND_SIMD_X86
+DYND_SIMD_BINARY_LOOPS(sse2_loops, __attribute__((target("sse2"))));
+DYND_SIMD_BINARY_LOOPS(avx2_loops, __attribute__((target("avx2"))));
+DYND_SIMD_BINARY_LOOPS(avx512_loops, __attribute__((target("avx512f"))));
+#endif
+
+#undef DYND_SIMD_BINARY_LOOPS
+
+enum { simd_type_count = 4 };
+
+int simd_type_index(type_id_t tid)
+{
+  switch (tid) {
+  case float32_type_id:
+    return 0;
+  case float64_type_id:
+    return 1;
+  case int32_type_id:
+    return 2;
+  case int64_type_id:
+    return 3;
+  default:
+    return -1;
+  }
+}
+
+/**
+ * The loops for every level, operation, type, and contiguity of the two
+ * sources (index src0_contiguous * 2 + src1_contiguous).
+ */
+struct simd_loop_table {
+  kernels::simd_binary_loop_t loops[kernels::simd_level_count]
+                                   [kernels::arithmetic_op_count]
+                                   [simd_type_count][4];
+  kernels::simd_level_t supported_level, level;
+
+  template <template <kernels::arithmetic_op_t, typename> class L,
+            kernels::arithmetic_op_t Op, typename T>
+  void set_loops(kernels::simd_level_t lvl, int type_index)
+  {
+    kernels::simd_binary_loop_t *l = loops[lvl][Op][type_index];
+    l[0] = &L<Op, T>::ss;
+    l[1] = &L<Op, T>::sv;
+    l[2] = &L<Op, T>::vs;
+    l[3] = &L<Op, T>::vv;
+  }
+
+  template <template <kernels::arithmetic_op_t, typename> class L,
+            kernels::arithmetic_op_t Op>
+  void set_op_loops(kernels::simd_level_t lvl)
+  {
+    set_loops<L, Op, float>(lvl, 0);
+    set_loops<L, Op, double>(lvl, 1);
+    // There are no vector instructions for integer division
+    if (Op != kernels::arithmetic_op_divide) {
+      set_loops<L, Op, int32_t>(lvl, 2);
+      set_loops<L, Op, int64_t>(lvl, 3);
+    }
+  }
+
+  template <template <kernels::arithmetic_op_t, typename> class L>
+  void set_level_loops(kernels::simd_level_t lvl)
+  {
+    set_op_loops<L, kernels::arithmetic_op_add>(lvl);
+    set_op_loops<L, kernels::arithmetic_op_subtract>(lvl);
+    set_op_loops<L, kernels::arithmetic_op_multiply>(lvl);
+    set_op_loops<L, kernels::arithmetic_op_divide>(lvl);
+  }
+
+  simd_loop_table() : supported_level(kernels::simd_level_none)
+  {
+    memset(loops, 0, sizeof(loops));
+    set_level_loops<generic_loops>(kernels::simd_level_none);
+#ifdef DYND_SIMD_X86
+    set_level_loops<sse2_loops>(kernels::simd_level_sse2);
+    set_level_loops<avx2_loops>(kernels::simd_level_avx2);
+    set_level_loops<avx512_loops>(kernels::simd_level_avx512);
+
+    // These checks include whether the OS saves the wider registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+      supported_level = kernels::simd_level_sse2;
+      if (__builtin_cpu_supports("avx2")) {
+        supported_level = kernels::simd_level_avx2;
+        if (__builtin_cpu_supports("avx512f")) {
+          supported_level = kernels::simd_level_avx512;
+        }
+      }
+    }
+#endif
+    level = supported_level;
+  }
+
+  static simd_loop_table &get()
+  {
+    static simd_loop_table table;
+    return table;
+  }
+};
+
+// Pick the level when the library is loaded, rather than on first use
+const simd_loop_table &init_simd_loop_table = simd_loop_table::get();
+
+} // anonymous namespace
+
+kernels::simd_level_t kernels::get_supported_simd_level()
+{
+  return simd_loop_table::get().supported_level;
+}
+
+kernels::simd_level_t kernels::get_simd_level()
+{
+  return simd_loop_table::get().level;
+}
+
+kernels::simd_level_t kernels::set_simd_level(simd_level_t level)
+{
+  simd_loop_table &table = simd_loop_table::get();
+  if (level < simd_level_none) {
+    level = simd_level_none;
+  } else if (level > table.supported_level) {
+    level = table.supported_level;
+  }
+  table.level = level;
+  return level;
+}
+
+kernels::simd_binary_loop_t
+kernels::get_simd_binary_loop(arithmetic_op_t op, type_id_t tid,
+                              bool src0_contiguous, bool src1_contiguous)
+{
+  int type_index = simd_type_index(tid);
+  if (type_index < 0 || op < 0 || op >= arithmetic_op_count) {
+    return NULL;
+  }
+  const simd_loop_table &table = simd_loop_table::get();
+  return table.loops[table.level][op][type_index]
+                    [(src0_contiguous ? 2 : 0) + (src1_contiguous ? 1 : 0)];
+}
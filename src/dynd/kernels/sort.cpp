@@ -0,0 +1,654 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/kernels/sort.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "kernel_helpers.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+using detail::fixed_or_var_dim;
+
+// Lines shorter than this are insertion sorted instead of radix sorted
+const intptr_t radix_sort_min_size = 64;
+
+/**
+ * The radix keys, unsigned integers ordered like the values they are made
+ * from. ``Key::to_key`` and ``Key::from_key`` convert between the two.
+ */
+template <class T, class U>
+struct unsigned_radix_key {
+  typedef T value_type;
+  typedef U key_type;
+  static U to_key(T v) { return static_cast<U>(v); }
+  static T from_key(U k) { return static_cast<T>(k); }
+};
+
+template <class T, class U>
+struct signed_radix_key {
+  typedef T value_type;
+  typedef U key_type;
+  static const U sign_bit = static_cast<U>(1) << (8 * sizeof(U) - 1);
+  static U to_key(T v) { return static_cast<U>(v) ^ sign_bit; }
+  static T from_key(U k) { return static_cast<T>(k ^ sign_bit); }
+};
+
+/**
+ * A signed integer whose minimum value is the NA of a date, time or
+ * datetime. The keys are shifted down by one, so the NA gets the largest
+ * key and is sorted last.
+ */
+template <class T, class U>
+struct na_last_radix_key {
+  typedef T value_type;
+  typedef U key_type;
+  static const U sign_bit = static_cast<U>(1) << (8 * sizeof(U) - 1);
+  static U to_key(T v)
+  {
+    return static_cast<U>((static_cast<U>(v) ^ sign_bit) - 1);
+  }
+  static T from_key(U k)
+  {
+    return static_cast<T>(static_cast<U>(k + 1) ^ sign_bit);
+  }
+};
+
+/**
+ * A float or a double, the bits of a positive value getting the sign bit
+ * set and those of a negative one flipped. Every NaN is made the quiet NaN
+ * first, whose key is larger than the one of infinity, so NaNs are sorted
+ * last.
+ */
+template <class T, class U>
+struct real_radix_key {
+  typedef T value_type;
+  typedef U key_type;
+  static const U sign_bit = static_cast<U>(1) << (8 * sizeof(U) - 1);
+
+  static U to_key(T v)
+  {
+    if (v != v) {
+      v = numeric_limits<T>::quiet_NaN();
+    }
+    U u;
+    memcpy(&u, &v, sizeof(U));
+    return (u & sign_bit) ? ~u : (u | sign_bit);
+  }
+
+  static T from_key(U k)
+  {
+    U u = (k & sign_bit) ? (k & ~sign_bit) : ~k;
+    T v;
+    memcpy(&v, &u, sizeof(T));
+    return v;
+  }
+};
+
+/**
+ * Sorts the n keys, and the indices along with them unless they are NULL,
+ * with an LSD radix sort on the bytes of the keys. The passes swap the
+ * arrays with the temporary ones, so on return ``keys`` and ``indices``
+ * point at whichever arrays hold the result.
+ */
+template <class U>
+void radix_sort(U *&keys, U *&keys_tmp, int64_t *&indices,
+                int64_t *&indices_tmp, intptr_t n)
+{
+  if (n < radix_sort_min_size) {
+    for (intptr_t i = 1; i < n; ++i) {
+      U k = keys[i];
+      int64_t index = indices != NULL ? indices[i] : 0;
+      intptr_t j = i;
+      for (; j > 0 && k < keys[j - 1]; --j) {
+        keys[j] = keys[j - 1];
+        if (indices != NULL) {
+          indices[j] = indices[j - 1];
+        }
+      }
+      keys[j] = k;
+      if (indices != NULL) {
+        indices[j] = index;
+      }
+    }
+    return;
+  }
+
+  // The histograms of all the bytes, counted in a single pass
+  intptr_t counts[sizeof(U)][256];
+  memset(counts, 0, sizeof(counts));
+  for (intptr_t i = 0; i < n; ++i) {
+    U k = keys[i];
+    for (size_t b = 0; b < sizeof(U); ++b) {
+      ++counts[b][(k >> (8 * b)) & 0xff];
+    }
+  }
+
+  for (size_t b = 0; b < sizeof(U); ++b) {
+    intptr_t *offsets = counts[b];
+    // A byte which is the same in every key leaves the order as it is
+    if (offsets[(keys[0] >> (8 * b)) & 0xff] == n) {
+      continue;
+    }
+    intptr_t total = 0;
+    for (int d = 0; d < 256; ++d) {
+      intptr_t count = offsets[d];
+      offsets[d] = total;
+      total += count;
+    }
+    if (indices != NULL) {
+      for (intptr_t i = 0; i < n; ++i) {
+        intptr_t pos = offsets[(keys[i] >> (8 * b)) & 0xff]++;
+        keys_tmp[pos] = keys[i];
+        indices_tmp[pos] = indices[i];
+      }
+      swap(indices, indices_tmp);
+    } else {
+      for (intptr_t i = 0; i < n; ++i) {
+        keys_tmp[offsets[(keys[i] >> (8 * b)) & 0xff]++] = keys[i];
+      }
+    }
+    swap(keys, keys_tmp);
+  }
+}
+
+/**
+ * The sorted dimension and the fixed dimensions after it, each line along
+ * the sorted dimension being sorted separately.
+ */
+struct sort_layout {
+  fixed_or_var_dim dst_dim, src_dim;
+  std::vector<intptr_t> inner_shape, dst_inner_strides, src_inner_strides;
+};
+
+/** A dimension before the sorted one */
+struct sort_outer_ck
+    : nd::base_kernel<sort_outer_ck, kernel_request_host, 1> {
+  fixed_or_var_dim m_dst_dim, m_src_dim;
+
+  void single(char *dst, char *const *src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_single_t child_fn = child->get_function<expr_single_t>();
+    intptr_t dim_size;
+    char *src_data = m_src_dim.get_src(src[0], dim_size);
+    char *dst_data = m_dst_dim.get_dst(dst, dim_size);
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      child_fn(dst_data, &src_data, child);
+      dst_data += m_dst_dim.stride;
+      src_data += m_src_dim.stride;
+    }
+  }
+
+  void destruct_children() { get_child_ckernel()->destroy(); }
+};
+
+/**
+ * The sorted dimension. Self provides ``sort_line(dst, dst_stride, src,
+ * src_stride, n)``, sorting one line of n elements.
+ */
+template <class Self>
+struct sort_dim_ck : nd::base_kernel<Self, kernel_request_host, 1> {
+  sort_layout m_layout;
+  // The index in the inner dimensions of the line being sorted
+  std::vector<intptr_t> m_index;
+
+  void single(char *dst, char *const *src)
+  {
+    Self *self = static_cast<Self *>(this);
+    const sort_layout &l = m_layout;
+    intptr_t dim_size;
+    const char *src_data = l.src_dim.get_src(src[0], dim_size);
+    char *dst_data = l.dst_dim.get_dst(dst, dim_size);
+    intptr_t ninner = l.inner_shape.size();
+    for (intptr_t j = 0; j < ninner; ++j) {
+      if (l.inner_shape[j] == 0) {
+        return;
+      }
+      m_index[j] = 0;
+    }
+
+    for (;;) {
+      self->sort_line(dst_data, l.dst_dim.stride, src_data, l.src_dim.stride,
+                      dim_size);
+      intptr_t j = ninner - 1;
+      for (; j >= 0; --j) {
+        if (++m_index[j] < l.inner_shape[j]) {
+          dst_data += l.dst_inner_strides[j];
+          src_data += l.src_inner_strides[j];
+          break;
+        }
+        dst_data -= (l.inner_shape[j] - 1) * l.dst_inner_strides[j];
+        src_data -= (l.inner_shape[j] - 1) * l.src_inner_strides[j];
+        m_index[j] = 0;
+      }
+      if (j < 0) {
+        return;
+      }
+    }
+  }
+
+  void set_layout(const sort_layout &layout)
+  {
+    m_layout = layout;
+    m_index.resize(layout.inner_shape.size());
+  }
+};
+
+/** The sorted dimension of a type with radix keys */
+template <class Key>
+struct radix_sort_ck : sort_dim_ck<radix_sort_ck<Key>> {
+  typedef typename Key::value_type T;
+  typedef typename Key::key_type U;
+
+  bool m_argsort;
+  // The keys and indices of the line being sorted, with their temporaries
+  std::vector<U> m_keys;
+  std::vector<int64_t> m_indices;
+
+  void sort_line(char *dst, intptr_t dst_stride, const char *src,
+                 intptr_t src_stride, intptr_t n)
+  {
+    if (n == 0) {
+      return;
+    }
+    if (static_cast<intptr_t>(m_keys.size()) < 2 * n) {
+      m_keys.resize(2 * n);
+    }
+    U *keys = &m_keys[0], *keys_tmp = keys + n;
+    for (intptr_t i = 0; i < n; ++i, src += src_stride) {
+      keys[i] = Key::to_key(*reinterpret_cast<const T *>(src));
+    }
+    int64_t *indices = NULL, *indices_tmp = NULL;
+    if (m_argsort) {
+      if (static_cast<intptr_t>(m_indices.size()) < 2 * n) {
+        m_indices.resize(2 * n);
+      }
+      indices = &m_indices[0];
+      indices_tmp = indices + n;
+      for (intptr_t i = 0; i < n; ++i) {
+        indices[i] = i;
+      }
+    }
+
+    radix_sort(keys, keys_tmp, indices, indices_tmp, n);
+
+    if (m_argsort) {
+      for (intptr_t i = 0; i < n; ++i, dst += dst_stride) {
+        *reinterpret_cast<int64_t *>(dst) = indices[i];
+      }
+    } else {
+      for (intptr_t i = 0; i < n; ++i, dst += dst_stride) {
+        *reinterpret_cast<T *>(dst) = Key::from_key(keys[i]);
+      }
+    }
+  }
+};
+
+/** Orders the indices of elements with a sorting less ckernel */
+struct sort_index_less {
+  const char *src;
+  intptr_t src_stride;
+  ckernel_prefix *less;
+
+  bool operator()(int64_t i, int64_t j) const
+  {
+    const char *s[2] = {src + i * src_stride, src + j * src_stride};
+    return less->get_function<expr_predicate_t>()(s, less) != 0;
+  }
+};
+
+/**
+ * The sorted dimension of any other type, sorting the indices of the
+ * elements with comparison ckernels, then copying the elements in that
+ * order for sort. A line long enough is split into one chunk per thread,
+ * the chunks are sorted on the thread pool, then merged pairwise, each
+ * thread comparing elements with its own ckernel.
+ */
+struct comparison_sort_ck : sort_dim_ck<comparison_sort_ck> {
+  bool m_argsort, m_stable;
+  intptr_t m_nthreads, m_grain_size;
+  // The offset of the ckernel copying an element, for sort
+  intptr_t m_copy_offset;
+  // The offsets of the comparison ckernels, one per thread
+  std::vector<intptr_t> m_less_offsets;
+  std::vector<int64_t> m_indices, m_merged;
+  std::vector<intptr_t> m_chunk_begin;
+
+  sort_index_less get_less(intptr_t thread, const char *src,
+                           intptr_t src_stride)
+  {
+    sort_index_less less = {src, src_stride,
+                            get_child_ckernel(m_less_offsets[thread])};
+    return less;
+  }
+
+  void sort_range(intptr_t thread, int64_t *begin, int64_t *end,
+                  const char *src, intptr_t src_stride)
+  {
+    if (m_stable) {
+      std::stable_sort(begin, end, get_less(thread, src, src_stride));
+    } else {
+      std::sort(begin, end, get_less(thread, src, src_stride));
+    }
+  }
+
+  void sort_line(char *dst, intptr_t dst_stride, const char *src,
+                 intptr_t src_stride, intptr_t n)
+  {
+    m_indices.resize(n);
+    for (intptr_t i = 0; i < n; ++i) {
+      m_indices[i] = i;
+    }
+    int64_t *indices = n > 0 ? &m_indices[0] : NULL;
+
+    intptr_t nchunks = 1;
+    if (m_nthreads > 1 && n >= 2 * m_grain_size) {
+      nchunks = partition_range(m_nthreads, n, m_grain_size, m_chunk_begin);
+    }
+    if (nchunks <= 1) {
+      sort_range(0, indices, indices + n, src, src_stride);
+    } else {
+      std::vector<intptr_t> &bounds = m_chunk_begin;
+      thread_pool::get().run(m_nthreads, nchunks, [&](intptr_t i) {
+        sort_range(i, indices + bounds[i], indices + bounds[i + 1], src,
+                   src_stride);
+      });
+      // Merges pairs of sorted runs until one is left. std::merge takes
+      // equal elements from the first run first, keeping a stable sort
+      // stable.
+      m_merged.resize(n);
+      int64_t *from = indices, *to = &m_merged[0];
+      while (bounds.size() > 2) {
+        intptr_t nruns = bounds.size() - 1;
+        thread_pool::get().run(m_nthreads, (nruns + 1) / 2, [&](intptr_t i) {
+          intptr_t begin = bounds[2 * i];
+          intptr_t mid = bounds[std::min(2 * i + 1, nruns)];
+          intptr_t end = bounds[std::min(2 * i + 2, nruns)];
+          std::merge(from + begin, from + mid, from + mid, from + end,
+                     to + begin, get_less(i, src, src_stride));
+        });
+        intptr_t j = 0;
+        for (intptr_t i = 0; i < nruns; i += 2) {
+          bounds[j++] = bounds[i];
+        }
+        bounds[j++] = bounds[nruns];
+        bounds.resize(j);
+        std::swap(from, to);
+      }
+      indices = from;
+    }
+
+    if (m_argsort) {
+      for (intptr_t i = 0; i < n; ++i, dst += dst_stride) {
+        *reinterpret_cast<int64_t *>(dst) = indices[i];
+      }
+    } else {
+      ckernel_prefix *copy = get_child_ckernel(m_copy_offset);
+      expr_single_t copy_fn = copy->get_function<expr_single_t>();
+      for (intptr_t i = 0; i < n; ++i, dst += dst_stride) {
+        char *child_src = const_cast<char *>(src) + indices[i] * src_stride;
+        copy_fn(dst, &child_src, copy);
+      }
+    }
+  }
+
+  void destruct_children()
+  {
+    if (!m_argsort) {
+      destroy_child_ckernel(m_copy_offset);
+    }
+    for (size_t i = 0; i < m_less_offsets.size(); ++i) {
+      destroy_child_ckernel(m_less_offsets[i]);
+    }
+  }
+};
+
+template <class Key>
+intptr_t make_radix_sort_ck(bool argsort, void *ckb, intptr_t ckb_offset,
+                            const sort_layout &layout, kernel_request_t kernreq)
+{
+  radix_sort_ck<Key> *self =
+      radix_sort_ck<Key>::make(ckb, kernreq, ckb_offset);
+  self->set_layout(layout);
+  self->m_argsort = argsort;
+  return ckb_offset;
+}
+
+/**
+ * Makes the radix sort ckernel for the type id, or returns -1 if the type
+ * isn't radix sorted
+ */
+intptr_t make_builtin_sort_ck(type_id_t tid, bool argsort, void *ckb,
+                              intptr_t ckb_offset, const sort_layout &layout,
+                              kernel_request_t kernreq)
+{
+  switch (tid) {
+  case bool_type_id:
+  case uint8_type_id:
+    return make_radix_sort_ck<unsigned_radix_key<uint8_t, uint8_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case uint16_type_id:
+    return make_radix_sort_ck<unsigned_radix_key<uint16_t, uint16_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case uint32_type_id:
+    return make_radix_sort_ck<unsigned_radix_key<uint32_t, uint32_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case uint64_type_id:
+    return make_radix_sort_ck<unsigned_radix_key<uint64_t, uint64_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case int8_type_id:
+    return make_radix_sort_ck<signed_radix_key<int8_t, uint8_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case int16_type_id:
+    return make_radix_sort_ck<signed_radix_key<int16_t, uint16_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case int32_type_id:
+    return make_radix_sort_ck<signed_radix_key<int32_t, uint32_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case int64_type_id:
+    return make_radix_sort_ck<signed_radix_key<int64_t, uint64_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case float32_type_id:
+    return make_radix_sort_ck<real_radix_key<float, uint32_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case float64_type_id:
+    return make_radix_sort_ck<real_radix_key<double, uint64_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case date_type_id:
+    return make_radix_sort_ck<na_last_radix_key<int32_t, uint32_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  case time_type_id:
+  case datetime_type_id:
+    return make_radix_sort_ck<na_last_radix_key<int64_t, uint64_t>>(
+        argsort, ckb, ckb_offset, layout, kernreq);
+  default:
+    return -1;
+  }
+}
+
+intptr_t make_comparison_sort_ck(bool argsort, bool stable, void *ckb,
+                                 intptr_t ckb_offset, const sort_layout &layout,
+                                 const ndt::type &dst_el_tp,
+                                 const char *dst_el_arrmeta,
+                                 const ndt::type &src_el_tp,
+                                 const char *src_el_arrmeta,
+                                 kernel_request_t kernreq,
+                                 const eval::eval_context *ectx)
+{
+  intptr_t root_ckb_offset = ckb_offset;
+  comparison_sort_ck *self =
+      comparison_sort_ck::make(ckb, kernreq, ckb_offset);
+  self->set_layout(layout);
+  self->m_argsort = argsort;
+  self->m_stable = stable;
+  self->m_nthreads = (ectx != NULL && ectx->nthreads > 1) ? ectx->nthreads : 1;
+  self->m_grain_size = ectx != NULL ? ectx->parallel_grain_size : 1;
+  self->m_less_offsets.resize(self->m_nthreads);
+  intptr_t nthreads = self->m_nthreads;
+
+  if (!argsort) {
+    self->m_copy_offset = ckb_offset - root_ckb_offset;
+    ckb_offset = make_assignment_kernel(
+        NULL, NULL, ckb, ckb_offset, dst_el_tp, dst_el_arrmeta, src_el_tp,
+        src_el_arrmeta, kernel_request_single, ectx, nd::array());
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  }
+  for (intptr_t i = 0; i < nthreads; ++i) {
+    self = comparison_sort_ck::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_less_offsets[i] = ckb_offset - root_ckb_offset;
+    ckb_offset = make_comparison_kernel(
+        ckb, ckb_offset, src_el_tp, src_el_arrmeta, src_el_tp, src_el_arrmeta,
+        comparison_type_sorting_less, ectx);
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  }
+  return ckb_offset;
+}
+
+intptr_t make_sort_kernels(bool argsort, bool stable, intptr_t axis,
+                           void *ckb, intptr_t ckb_offset,
+                           const ndt::type &dst_tp, const char *dst_arrmeta,
+                           const ndt::type &src_tp, const char *src_arrmeta,
+                           kernel_request_t kernreq,
+                           const eval::eval_context *ectx)
+{
+  sort_layout layout;
+  ndt::type dst_el_tp, src_el_tp;
+  const char *dst_el_arrmeta, *src_el_arrmeta;
+  layout.dst_dim.init("sort", dst_tp, dst_arrmeta, dst_el_tp, dst_el_arrmeta);
+  layout.src_dim.init("sort", src_tp, src_arrmeta, src_el_tp, src_el_arrmeta);
+  if (layout.dst_dim.size >= 0 && layout.src_dim.size >= 0 &&
+      layout.dst_dim.size != layout.src_dim.size) {
+    throw broadcast_error(layout.dst_dim.size, layout.src_dim.size,
+                          "sort dst", "sort src");
+  }
+
+  if (axis > 0) {
+    sort_outer_ck *self = sort_outer_ck::make(ckb, kernreq, ckb_offset);
+    self->m_dst_dim = layout.dst_dim;
+    self->m_src_dim = layout.src_dim;
+    return make_sort_kernels(argsort, stable, axis - 1, ckb, ckb_offset,
+                             dst_el_tp, dst_el_arrmeta, src_el_tp,
+                             src_el_arrmeta, kernel_request_single, ectx);
+  }
+
+  // The dimensions after the sorted one are walked by the sorting ckernel
+  while (src_el_tp.get_ndim() > 0) {
+    intptr_t dst_size, src_size, dst_stride, src_stride;
+    ndt::type dst_inner_tp, src_inner_tp;
+    const char *dst_inner_arrmeta, *src_inner_arrmeta;
+    if (!dst_el_tp.get_as_strided(dst_el_arrmeta, &dst_size, &dst_stride,
+                                  &dst_inner_tp, &dst_inner_arrmeta) ||
+        !src_el_tp.get_as_strided(src_el_arrmeta, &src_size, &src_stride,
+                                  &src_inner_tp, &src_inner_arrmeta)) {
+      stringstream ss;
+      ss << "dynd sort: the dimensions after the sorted one must be fixed, "
+            "got " << src_el_tp;
+      throw type_error(ss.str());
+    }
+    if (dst_size != src_size) {
+      throw broadcast_error(dst_size, src_size, "sort dst", "sort src");
+    }
+    layout.inner_shape.push_back(src_size);
+    layout.dst_inner_strides.push_back(dst_stride);
+    layout.src_inner_strides.push_back(src_stride);
+    dst_el_tp = dst_inner_tp;
+    dst_el_arrmeta = dst_inner_arrmeta;
+    src_el_tp = src_inner_tp;
+    src_el_arrmeta = src_inner_arrmeta;
+  }
+
+  if (argsort ? dst_el_tp.get_type_id() != int64_type_id
+              : dst_el_tp != src_el_tp) {
+    stringstream ss;
+    ss << "dynd sort: cannot sort " << src_el_tp << " into " << dst_el_tp;
+    throw type_error(ss.str());
+  }
+  intptr_t radix_ckb_offset = make_builtin_sort_ck(
+      src_el_tp.get_type_id(), argsort, ckb, ckb_offset, layout, kernreq);
+  if (radix_ckb_offset >= 0) {
+    return radix_ckb_offset;
+  }
+  return make_comparison_sort_ck(argsort, stable, ckb, ckb_offset, layout,
+                                 dst_el_tp, dst_el_arrmeta, src_el_tp,
+                                 src_el_arrmeta, kernreq, ectx);
+}
+
+void check_sort_src(const ndt::type &src_tp)
+{
+  if (src_tp.get_ndim() < 1) {
+    stringstream ss;
+    ss << "dynd sort: the argument must have a dimension to sort, got "
+       << src_tp;
+    throw invalid_argument(ss.str());
+  }
+}
+
+/** Reads the ``axis`` and ``stable`` keywords */
+void get_sort_kwds(const nd::array &kwds, intptr_t ndim, intptr_t &axis,
+                   bool &stable)
+{
+  axis = detail::get_axis_kwd(kwds, ndim, -1);
+  nd::array value = detail::get_kwd(kwds, "stable");
+  stable = !value.is_null() && value.as<bool>();
+}
+
+} // anonymous namespace
+
+intptr_t nd::sort_ck::instantiate(
+    const arrfunc_type_data *af_self,
+    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t DYND_UNUSED(nsrc),
+    const ndt::type *src_tp, const char *const *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx,
+    const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  bool argsort = *af_self->get_data_as<bool>();
+  check_sort_src(src_tp[0]);
+  intptr_t axis;
+  bool stable;
+  get_sort_kwds(kwds, src_tp[0].get_ndim(), axis, stable);
+  return make_sort_kernels(argsort, stable, axis, ckb, ckb_offset, dst_tp,
+                           dst_arrmeta, src_tp[0], src_arrmeta[0], kernreq,
+                           ectx);
+}
+
+void nd::sort_ck::resolve_dst_type(
+    const arrfunc_type_data *af_self, const ndt::arrfunc_type *af_tp,
+    char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t nsrc,
+    const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  if (nsrc != 1) {
+    stringstream ss;
+    ss << "Wrong number of arguments to sort arrfunc with prototype ";
+    ss << af_tp << ", got " << nsrc << " arguments";
+    throw invalid_argument(ss.str());
+  }
+  check_sort_src(src_tp[0]);
+  // The sort keeps the dimensions, fixed dimensions staying fixed and var
+  // ones var, and argsort replaces the element type with the indices
+  dst_tp = src_tp[0].get_canonical_type();
+  if (*af_self->get_data_as<bool>()) {
+    dst_tp = dst_tp.with_replaced_dtype(ndt::make_type<int64_t>());
+  }
+}
@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+// This file is an internal implementation detail of the reductions which
+// accumulate into a struct of state, like the moments and describe ones
+
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/types/base_struct_type.hpp>
+
+namespace dynd {
+namespace detail {
+
+  /**
+   * Checks that ``tp`` is the state type ``state_tp``, and that its arrmeta
+   * lays the fields out at ``offsets``, the offsets of the members of the C
+   * struct the kernels use. This is always the case for arrays made with
+   * nd::empty.
+   */
+  inline void check_state_arrmeta(const char *name, const ndt::type &state_tp,
+                                  const uintptr_t *offsets,
+                                  const ndt::type &tp, const char *arrmeta)
+  {
+    if (tp != state_tp) {
+      std::stringstream ss;
+      ss << name << ": expected the state type " << state_tp << ", got "
+         << tp;
+      throw type_error(ss.str());
+    }
+    const ndt::base_struct_type *struct_tp =
+        tp.extended<ndt::base_struct_type>();
+    if (!std::equal(offsets, offsets + struct_tp->get_field_count(),
+                    struct_tp->get_data_offsets(arrmeta))) {
+      std::stringstream ss;
+      ss << name << ": the state struct must have the default field layout";
+      throw type_error(ss.str());
+    }
+  }
+
+  /**
+   * Makes an arrfunc without static data.
+   * (<src_tp>) -> <dst_tp>
+   */
+  inline nd::arrfunc make_unary_arrfunc(const ndt::type &src_tp,
+                                        const ndt::type &dst_tp,
+                                        arrfunc_instantiate_t instantiate)
+  {
+    nd::array af =
+        nd::empty(ndt::make_arrfunc(ndt::make_tuple(src_tp), dst_tp));
+    arrfunc_type_data *out_af =
+        reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+    out_af->instantiate = instantiate;
+    out_af->free = NULL;
+    af.flag_as_immutable();
+    return af;
+  }
+
+} // namespace dynd::detail
+} // namespace dynd
@@ -0,0 +1,188 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <dynd/kernels/tiled_assignment_kernels.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/shortvector.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// The tiles are sized to fill a 32KB L1 data cache
+const intptr_t tile_max_byte_count = 0x8000;
+// Tiling only pays off when both tiled dimensions have this many elements
+const intptr_t tile_min_dim_size = 8;
+
+struct tiled_assign_ck
+    : nd::base_kernel<tiled_assign_ck, kernel_request_host, 1> {
+  // The dimensions outside the tile, outermost first
+  std::vector<intptr_t> m_outer_shape, m_outer_dst_stride, m_outer_src_stride;
+  // The dimension with the smallest dst stride, which the child ckernel
+  // runs along
+  intptr_t m_inner_size, m_inner_dst_stride, m_inner_src_stride;
+  // The dimension with the smallest src stride
+  intptr_t m_tile_size, m_tile_dst_stride, m_tile_src_stride;
+  intptr_t m_block_size;
+
+  void tile(char *dst, char *src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_strided_t child_fn = child->get_function<expr_strided_t>();
+    for (intptr_t i = 0; i < m_inner_size; i += m_block_size) {
+      size_t count = min(m_block_size, m_inner_size - i);
+      for (intptr_t j = 0; j < m_tile_size; j += m_block_size) {
+        intptr_t j_end = min(j + m_block_size, m_tile_size);
+        // Each call writes a contiguous run of the dst, and the src
+        // cache lines it touches are reused by the following calls
+        for (intptr_t k = j; k < j_end; ++k) {
+          char *child_src = src + k * m_tile_src_stride + i * m_inner_src_stride;
+          child_fn(dst + k * m_tile_dst_stride + i * m_inner_dst_stride,
+                   m_inner_dst_stride, &child_src, &m_inner_src_stride, count,
+                   child);
+        }
+      }
+    }
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    intptr_t nouter = m_outer_shape.size();
+    shortvector<intptr_t> index(nouter);
+    for (intptr_t j = 0; j < nouter; ++j) {
+      index[j] = 0;
+    }
+    for (;;) {
+      char *outer_dst = dst, *outer_src = src[0];
+      for (intptr_t j = 0; j < nouter; ++j) {
+        outer_dst += index[j] * m_outer_dst_stride[j];
+        outer_src += index[j] * m_outer_src_stride[j];
+      }
+      tile(outer_dst, outer_src);
+
+      // Advance to the next tile
+      intptr_t j = nouter - 1;
+      for (; j >= 0; --j) {
+        if (++index[j] < m_outer_shape[j]) {
+          break;
+        }
+        index[j] = 0;
+      }
+      if (j < 0) {
+        break;
+      }
+    }
+  }
+
+  void destruct_children() { get_child_ckernel()->destroy(); }
+};
+
+struct tiled_dim {
+  intptr_t size, dst_stride, src_stride;
+};
+
+bool greater_dst_stride(const tiled_dim &a, const tiled_dim &b)
+{
+  return abs(a.dst_stride) > abs(b.dst_stride);
+}
+
+} // anonymous namespace
+
+intptr_t dynd::make_tiled_assignment_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+  if (dst_tp.get_ndim() != src_tp.get_ndim()) {
+    return -1;
+  }
+
+  // Gather the leading fixed dimensions of both, dropping size one ones. An
+  // empty dimension leaves nothing to tile, so the generic kernel handles it
+  std::vector<tiled_dim> dims;
+  ndt::type dst_el_tp = dst_tp, src_el_tp = src_tp;
+  const char *dst_el_arrmeta = dst_arrmeta, *src_el_arrmeta = src_arrmeta;
+  while (dst_el_tp.get_type_id() == fixed_dim_type_id &&
+         src_el_tp.get_type_id() == fixed_dim_type_id) {
+    const fixed_dim_type_arrmeta *dst_md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_el_arrmeta);
+    const fixed_dim_type_arrmeta *src_md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(src_el_arrmeta);
+    if (src_md->dim_size != 1 && src_md->dim_size != dst_md->dim_size) {
+      throw broadcast_error(dst_tp, dst_arrmeta, src_tp, src_arrmeta);
+    }
+    if (dst_md->dim_size == 0) {
+      return -1;
+    }
+    if (dst_md->dim_size != 1) {
+      tiled_dim d = {dst_md->dim_size, dst_md->stride,
+                     src_md->dim_size == 1 ? 0 : src_md->stride};
+      dims.push_back(d);
+    }
+    dst_el_tp = dst_el_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    src_el_tp = src_el_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    dst_el_arrmeta += sizeof(fixed_dim_type_arrmeta);
+    src_el_arrmeta += sizeof(fixed_dim_type_arrmeta);
+  }
+  if (dims.size() < 2) {
+    return -1;
+  }
+
+  // Find the innermost dimension of each side, ignoring broadcast ones
+  intptr_t ndim = dims.size(), dst_inner = 0, src_inner = -1;
+  for (intptr_t i = 0; i < ndim; ++i) {
+    if (abs(dims[i].dst_stride) < abs(dims[dst_inner].dst_stride)) {
+      dst_inner = i;
+    }
+    if (dims[i].src_stride != 0 &&
+        (src_inner < 0 ||
+         abs(dims[i].src_stride) < abs(dims[src_inner].src_stride))) {
+      src_inner = i;
+    }
+  }
+  if (src_inner < 0 || src_inner == dst_inner ||
+      dims[dst_inner].size < tile_min_dim_size ||
+      dims[src_inner].size < tile_min_dim_size) {
+    return -1;
+  }
+
+  // The largest power of two block size whose square tile fits
+  intptr_t element_size =
+      max<intptr_t>(max<intptr_t>(dst_el_tp.get_data_size(),
+                                  src_el_tp.get_data_size()), 1);
+  intptr_t block_size = 8;
+  while (block_size < 256 &&
+         4 * block_size * block_size * element_size <= tile_max_byte_count) {
+    block_size *= 2;
+  }
+
+  tiled_dim inner = dims[dst_inner], tile = dims[src_inner];
+  dims.erase(dims.begin() + max(dst_inner, src_inner));
+  dims.erase(dims.begin() + min(dst_inner, src_inner));
+  stable_sort(dims.begin(), dims.end(), &greater_dst_stride);
+
+  tiled_assign_ck *self = tiled_assign_ck::make(ckb, kernreq, ckb_offset);
+  for (size_t i = 0; i < dims.size(); ++i) {
+    self->m_outer_shape.push_back(dims[i].size);
+    self->m_outer_dst_stride.push_back(dims[i].dst_stride);
+    self->m_outer_src_stride.push_back(dims[i].src_stride);
+  }
+  self->m_inner_size = inner.size;
+  self->m_inner_dst_stride = inner.dst_stride;
+  self->m_inner_src_stride = inner.src_stride;
+  self->m_tile_size = tile.size;
+  self->m_tile_dst_stride = tile.dst_stride;
+  self->m_tile_src_stride = tile.src_stride;
+  self->m_block_size = block_size;
+  return ::make_assignment_kernel(NULL, NULL, ckb, ckb_offset, dst_el_tp,
+                                  dst_el_arrmeta, src_el_tp, src_el_arrmeta,
+                                  kernel_request_strided, ectx, nd::array());
+}
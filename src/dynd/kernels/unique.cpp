@@ -0,0 +1,296 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+
+#include <dynd/hash_index.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/kernels/unique.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "kernel_helpers.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/** A var dimension output of the unique ckernel */
+struct unique_output {
+  ndt::type tp;
+  const char *arrmeta;
+  uintptr_t offset;
+
+  /** Allocates ``size`` elements, returning the first and their stride */
+  char *initialize(char *dst, intptr_t size, intptr_t &stride) const
+  {
+    char *data = dst + offset;
+    ndt::var_dim_element_initialize(tp, arrmeta, data, size);
+    const var_dim_type_arrmeta *md =
+        reinterpret_cast<const var_dim_type_arrmeta *>(arrmeta);
+    stride = md->stride;
+    return reinterpret_cast<var_dim_type_data *>(data)->begin + md->offset;
+  }
+};
+
+/** Compares two elements by the index of their first occurrence */
+struct unique_less {
+  const std::vector<const char *> &m_firsts;
+  expr_predicate_t m_less;
+  ckernel_prefix *m_less_self;
+
+  unique_less(const std::vector<const char *> &firsts, ckernel_prefix *less)
+      : m_firsts(firsts), m_less(less->get_function<expr_predicate_t>()),
+        m_less_self(less)
+  {
+  }
+
+  bool operator()(intptr_t i, intptr_t j) const
+  {
+    char *const src[2] = {const_cast<char *>(m_firsts[i]),
+                          const_cast<char *>(m_firsts[j])};
+    return m_less(src, m_less_self) != 0;
+  }
+};
+
+struct unique_kernel
+    : nd::base_kernel<unique_kernel, kernel_request_host, 1> {
+  intptr_t m_size, m_src_stride;
+  key_encoder m_encoder;
+  bool m_sorted;
+  unique_output m_values, m_counts;
+  bool m_has_counts, m_has_inverse;
+  uintptr_t m_inverse_offset;
+  intptr_t m_inverse_stride;
+  // The child ckernels copying the values and comparing them if sorted
+  intptr_t m_copy_offset, m_less_offset;
+
+  void single(char *dst, char *const *src)
+  {
+    // Gives each distinct value an id, in the order they first appear
+    hash_index index;
+    std::vector<const char *> firsts;
+    std::vector<int64_t> counts;
+    std::vector<intptr_t> ids(m_has_inverse ? m_size : 0);
+    std::vector<char> buf;
+    bool word_keys = m_encoder.is_word();
+    size_t word_size = word_keys ? m_encoder.get_word_size() : 0;
+    const char *el = src[0];
+    for (intptr_t i = 0; i < m_size; ++i, el += m_src_stride) {
+      bool inserted;
+      intptr_t id;
+      if (word_keys) {
+        // A scalar is hashed as it is, without encoding it into the buffer
+        uint64_t w = m_encoder.encode_word(el);
+        id = index.insert(reinterpret_cast<const char *>(&w), word_size,
+                          hash_mix(w), inserted);
+      } else {
+        buf.clear();
+        m_encoder.encode(el, buf);
+        id = index.insert(buf, inserted);
+      }
+      if (inserted) {
+        firsts.push_back(el);
+        counts.push_back(0);
+      }
+      ++counts[id];
+      if (m_has_inverse) {
+        ids[i] = id;
+      }
+    }
+
+    // Only the distinct values get sorted
+    intptr_t nunique = firsts.size();
+    std::vector<intptr_t> order(nunique);
+    for (intptr_t i = 0; i < nunique; ++i) {
+      order[i] = i;
+    }
+    if (m_sorted) {
+      std::sort(order.begin(), order.end(),
+                unique_less(firsts, get_child_ckernel(m_less_offset)));
+    }
+
+    intptr_t stride;
+    char *values = m_values.initialize(dst, nunique, stride);
+    ckernel_prefix *copy = get_child_ckernel(m_copy_offset);
+    expr_single_t copy_fn = copy->get_function<expr_single_t>();
+    for (intptr_t i = 0; i < nunique; ++i, values += stride) {
+      char *child_src = const_cast<char *>(firsts[order[i]]);
+      copy_fn(values, &child_src, copy);
+    }
+
+    if (m_has_counts) {
+      char *counts_el = m_counts.initialize(dst, nunique, stride);
+      for (intptr_t i = 0; i < nunique; ++i, counts_el += stride) {
+        *reinterpret_cast<int64_t *>(counts_el) = counts[order[i]];
+      }
+    }
+
+    if (m_has_inverse) {
+      // The position of each id in the output
+      std::vector<intptr_t> rank(nunique);
+      for (intptr_t i = 0; i < nunique; ++i) {
+        rank[order[i]] = i;
+      }
+      char *inverse = dst + m_inverse_offset;
+      for (intptr_t i = 0; i < m_size; ++i, inverse += m_inverse_stride) {
+        *reinterpret_cast<int64_t *>(inverse) = rank[ids[i]];
+      }
+    }
+  }
+
+  void destruct_children()
+  {
+    destroy_child_ckernel(m_copy_offset);
+    if (m_sorted) {
+      destroy_child_ckernel(m_less_offset);
+    }
+  }
+};
+
+/** The element type of the argument, which has one dimension */
+ndt::type get_unique_element_type(const ndt::type &tp)
+{
+  if (tp.get_ndim() != 1 || tp.get_kind() != dim_kind) {
+    stringstream ss;
+    ss << "dynd unique: the argument must be one dimensional, got " << tp;
+    throw invalid_argument(ss.str());
+  }
+  const ndt::type &el_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+  if (!key_encoder::is_supported(el_tp)) {
+    stringstream ss;
+    ss << "dynd unique: element type " << el_tp << " is not supported";
+    throw type_error(ss.str());
+  }
+  return el_tp;
+}
+
+/** Reads the ``sorted`` keyword */
+bool get_unique_sorted(const nd::array &kwds)
+{
+  nd::array value = detail::get_kwd(kwds, "sorted");
+  return !value.is_null() && value.as<bool>();
+}
+
+} // anonymous namespace
+
+intptr_t nd::unique_ck::instantiate(
+    const arrfunc_type_data *af_self,
+    const ndt::arrfunc_type *DYND_UNUSED(af_tp), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t DYND_UNUSED(nsrc),
+    const ndt::type *src_tp, const char *const *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx,
+    const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const unique_arrfunc_data &data =
+      *af_self->get_data_as<unique_arrfunc_data>();
+  get_unique_element_type(src_tp[0]);
+  intptr_t size, src_stride;
+  ndt::type src_el_tp;
+  const char *src_el_arrmeta;
+  if (!src_tp[0].get_as_strided(src_arrmeta[0], &size, &src_stride,
+                                &src_el_tp, &src_el_arrmeta)) {
+    stringstream ss;
+    ss << "dynd unique: the argument must have a fixed dimension, got "
+       << src_tp[0];
+    throw type_error(ss.str());
+  }
+
+  intptr_t root_ckb_offset = ckb_offset;
+  unique_kernel *self = unique_kernel::make(ckb, kernreq, ckb_offset);
+  self->m_size = size;
+  self->m_src_stride = src_stride;
+  self->m_encoder = key_encoder(src_el_tp, src_el_arrmeta);
+  self->m_sorted = get_unique_sorted(kwds);
+  self->m_has_inverse = data.inverse;
+  self->m_has_counts = data.counts;
+
+  if (data.struct_output) {
+    const ndt::base_struct_type *dst_struct_tp =
+        dst_tp.extended<ndt::base_struct_type>();
+    const uintptr_t *data_offsets = dst_struct_tp->get_data_offsets(dst_arrmeta);
+    const uintptr_t *arrmeta_offsets = dst_struct_tp->get_arrmeta_offsets_raw();
+    intptr_t f = 0;
+    unique_output values = {dst_struct_tp->get_field_type(f),
+                            dst_arrmeta + arrmeta_offsets[f], data_offsets[f]};
+    self->m_values = values;
+    if (data.inverse) {
+      ++f;
+      self->m_inverse_offset = data_offsets[f];
+      self->m_inverse_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                                   dst_arrmeta + arrmeta_offsets[f])->stride;
+    }
+    if (data.counts) {
+      ++f;
+      unique_output counts = {dst_struct_tp->get_field_type(f),
+                              dst_arrmeta + arrmeta_offsets[f],
+                              data_offsets[f]};
+      self->m_counts = counts;
+    }
+  } else {
+    unique_output values = {dst_tp, dst_arrmeta, 0};
+    self->m_values = values;
+  }
+
+  const ndt::type &values_tp = self->m_values.tp;
+  const char *values_arrmeta = self->m_values.arrmeta;
+  bool sorted = self->m_sorted;
+  self->m_copy_offset = ckb_offset - root_ckb_offset;
+  ckb_offset = make_assignment_kernel(
+      NULL, NULL, ckb, ckb_offset,
+      values_tp.extended<ndt::base_dim_type>()->get_element_type(),
+      values_arrmeta + sizeof(var_dim_type_arrmeta), src_el_tp, src_el_arrmeta,
+      kernel_request_single, ectx, nd::array());
+  reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+      ->reserve(ckb_offset + sizeof(ckernel_prefix));
+  if (sorted) {
+    self = unique_kernel::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->m_less_offset = ckb_offset - root_ckb_offset;
+    ckb_offset = make_comparison_kernel(
+        ckb, ckb_offset, src_el_tp, src_el_arrmeta, src_el_tp, src_el_arrmeta,
+        comparison_type_sorting_less, ectx);
+  }
+  return ckb_offset;
+}
+
+void nd::unique_ck::resolve_dst_type(
+    const arrfunc_type_data *af_self, const ndt::arrfunc_type *af_tp,
+    char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t nsrc,
+    const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  if (nsrc != 1) {
+    stringstream ss;
+    ss << "Wrong number of arguments to unique arrfunc with prototype ";
+    ss << af_tp << ", got " << nsrc << " arguments";
+    throw invalid_argument(ss.str());
+  }
+  const unique_arrfunc_data &data =
+      *af_self->get_data_as<unique_arrfunc_data>();
+  dst_tp = ndt::make_var_dim(
+      get_unique_element_type(src_tp[0]).get_canonical_type());
+  if (data.struct_output) {
+    vector<std::string> field_names(1, "values");
+    vector<ndt::type> field_tps(1, dst_tp);
+    if (data.inverse) {
+      field_names.push_back("inverse");
+      field_tps.push_back(ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                                              ndt::make_type<int64_t>()));
+    }
+    if (data.counts) {
+      field_names.push_back("counts");
+      field_tps.push_back(ndt::make_var_dim(ndt::make_type<int64_t>()));
+    }
+    dst_tp = ndt::make_struct(field_names, field_tps);
+  }
+}
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/thread_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+thread_pool::thread_pool()
+    : m_task(NULL), m_ntasks(0), m_next_task(0), m_pending_tasks(0),
+      m_nactive(0), m_max_active(0), m_running(false), m_stopping(false)
+{
+}
+
+thread_pool::~thread_pool()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_work_cv.notify_all();
+  for (size_t i = 0; i < m_workers.size(); ++i) {
+    if (m_workers[i].joinable()) {
+      m_workers[i].join();
+    }
+  }
+}
+
+void thread_pool::grow(intptr_t nworkers)
+{
+  while (static_cast<intptr_t>(m_workers.size()) < nworkers) {
+    m_workers.push_back(thread(&thread_pool::worker_main, this));
+  }
+}
+
+void thread_pool::worker_main()
+{
+  unique_lock<mutex> lock(m_mutex);
+  for (;;) {
+    m_work_cv.wait(lock, [this] {
+      return m_stopping || (m_task != NULL && m_next_task < m_ntasks &&
+                            m_nactive < m_max_active);
+    });
+    if (m_stopping) {
+      return;
+    }
+    run_tasks(lock);
+  }
+}
+
+void thread_pool::run_tasks(unique_lock<mutex> &lock)
+{
+  ++m_nactive;
+  while (m_task != NULL && m_next_task < m_ntasks) {
+    intptr_t i = m_next_task++;
+    const function<void(intptr_t)> *task = m_task;
+    lock.unlock();
+    exception_ptr e;
+    try {
+      (*task)(i);
+    }
+    catch (...) {
+      e = current_exception();
+    }
+    lock.lock();
+    if (e && !m_exception) {
+      m_exception = e;
+    }
+    if (--m_pending_tasks == 0) {
+      m_done_cv.notify_all();
+    }
+  }
+  --m_nactive;
+}
+
+void thread_pool::run(intptr_t nthreads, intptr_t ntasks,
+                      const function<void(intptr_t)> &task)
+{
+  if (ntasks <= 0) {
+    return;
+  }
+
+  unique_lock<mutex> lock(m_mutex);
+  if (nthreads <= 1 || ntasks == 1 || m_running) {
+    // Nested or concurrent parallel executions run serially
+    lock.unlock();
+    for (intptr_t i = 0; i < ntasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  nthreads = min(nthreads, ntasks);
+  grow(nthreads - 1);
+  m_task = &task;
+  m_ntasks = ntasks;
+  m_next_task = 0;
+  m_pending_tasks = ntasks;
+  m_max_active = nthreads;
+  m_exception = exception_ptr();
+  m_running = true;
+  m_work_cv.notify_all();
+
+  // The calling thread participates in the execution
+  run_tasks(lock);
+  m_done_cv.wait(lock, [this] { return m_pending_tasks == 0; });
+
+  m_task = NULL;
+  m_running = false;
+  exception_ptr e = m_exception;
+  m_exception = exception_ptr();
+  lock.unlock();
+
+  if (e) {
+    rethrow_exception(e);
+  }
+}
+
+thread_pool &thread_pool::get()
+{
+  static thread_pool pool;
+  return pool;
+}
+
+intptr_t dynd::partition_range(intptr_t nthreads, intptr_t size,
+                               intptr_t grain_size,
+                               vector<intptr_t> &chunk_begin)
+{
+  intptr_t nchunks = 1;
+  if (nthreads > 1 && size > 0) {
+    nchunks = size / max(grain_size, intptr_t(1));
+    nchunks = max(intptr_t(1), min(nchunks, nthreads));
+  }
+
+  chunk_begin.resize(nchunks + 1);
+  for (intptr_t i = 0; i <= nchunks; ++i) {
+    chunk_begin[i] = (size / nchunks) * i + min(i, size % nchunks);
+  }
+
+  return nchunks;
+}
+
+void dynd::parallel_for(
+    intptr_t nthreads, intptr_t size, intptr_t grain_size,
+    const function<void(intptr_t, intptr_t, intptr_t)> &func)
+{
+  vector<intptr_t> chunk_begin;
+  intptr_t nchunks = partition_range(nthreads, size, grain_size, chunk_begin);
+  thread_pool::get().run(nthreads, nchunks, [&](intptr_t i) {
+    func(i, chunk_begin[i], chunk_begin[i + 1]);
+  });
+}
@@ -8,6 +8,7 @@
 #include <set>
 
 #include <dynd/auxiliary_data.hpp>
+#include <dynd/hash_index.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
@@ -15,6 +16,7 @@
 #include <dynd/types/convert_type.hpp>
 #include <dynd/func/make_callable.hpp>
 #include <dynd/array_range.hpp>
+#include <dynd/thread_pool.hpp>
 
 using namespace dynd;
 using namespace std;
@@ -96,19 +98,53 @@ struct category_to_categorical_kernel_extra
 
   const ndt::categorical_type *dst_cat_tp;
   const char *src_arrmeta;
+  // Encodes the input to probe the hash index of the categories
+  key_encoder encoder;
+  std::vector<char> buf;
+
+  category_to_categorical_kernel_extra(const ndt::categorical_type *dst_cat_tp,
+                                       const char *src_arrmeta)
+      : dst_cat_tp(dst_cat_tp), src_arrmeta(src_arrmeta)
+  {
+    if (dst_cat_tp->get_category_index() != NULL) {
+      encoder = key_encoder(dst_cat_tp->get_category_type(), src_arrmeta);
+    }
+  }
+
+  ~category_to_categorical_kernel_extra() { base_type_decref(dst_cat_tp); }
+
+  uint32_t get_value(const hash_index *index, const char *src)
+  {
+    if (index != NULL) {
+      buf.clear();
+      encoder.encode(src, buf);
+      intptr_t value = index->find(buf);
+      if (value >= 0) {
+        return (uint32_t)value;
+      }
+    }
+    // Raises the error for an unrecognized category, or does the binary
+    // search if the categories aren't indexed
+    return dst_cat_tp->get_value_from_category(src_arrmeta, src);
+  }
 
   // Assign from an input matching the category type to a categorical type
   void single(char *dst, char *const *src)
   {
-    uint32_t src_val = dst_cat_tp->get_value_from_category(src_arrmeta, src[0]);
-    *reinterpret_cast<UIntType *>(dst) = src_val;
+    *reinterpret_cast<UIntType *>(dst) =
+        get_value(dst_cat_tp->get_category_index(), src[0]);
   }
 
-  static void destruct(ckernel_prefix *self)
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
   {
-    self_type *e = reinterpret_cast<self_type *>(self);
-    if (e->dst_cat_tp != NULL) {
-      base_type_decref(e->dst_cat_tp);
+    const hash_index *index = dst_cat_tp->get_category_index();
+    const char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    for (size_t i = 0; i != count; ++i) {
+      *reinterpret_cast<UIntType *>(dst) = get_value(index, src0);
+      dst += dst_stride;
+      src0 += src0_stride;
     }
   }
 };
@@ -163,11 +199,98 @@ struct category_to_categorical_kernel_extra
 
 } // anoymous namespace
 
-/** This function converts the set of char* pointers into a strided immutable
+/**
+ * Returns the index of the first value of the strided array equal to an
+ * earlier one, or -1 if the values are unique. The values are hashed if the
+ * type can be encoded as a key, otherwise put in a set ordered by ``less``.
+ */
+static intptr_t find_duplicate(const char *data, intptr_t stride,
+                               intptr_t size, const ndt::type &el_tp,
+                               const char *el_arrmeta, const cmp &less)
+{
+  if (key_encoder::is_supported(el_tp)) {
+    key_encoder encoder(el_tp, el_arrmeta);
+    hash_index index;
+    index.reserve(size);
+    std::vector<char> buf;
+    for (intptr_t i = 0; i < size; ++i) {
+      buf.clear();
+      encoder.encode(data + i * stride, buf);
+      bool inserted;
+      index.insert(buf, inserted);
+      if (!inserted) {
+        return i;
+      }
+    }
+  } else {
+    set<const char *, cmp> uniques(less);
+    for (intptr_t i = 0; i < size; ++i) {
+      if (!uniques.insert(data + i * stride).second) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * Appends the first occurrence of each distinct value of the strided array
+ * to ``uniques``, in the order the values first appear. Large arrays are
+ * split into chunks which are deduplicated in parallel, each with its own
+ * hash index, the chunks' uniques then being merged in order.
+ */
+static void hash_uniques(const char *data, intptr_t stride, intptr_t size,
+                         const ndt::type &el_tp, const char *el_arrmeta,
+                         const eval::eval_context *ectx,
+                         std::vector<const char *> &uniques)
+{
+  key_encoder encoder(el_tp, el_arrmeta);
+  intptr_t nthreads = ectx->nthreads > 1 ? ectx->nthreads : 1;
+  std::vector<intptr_t> chunk_begin;
+  intptr_t nchunks =
+      partition_range(nthreads, size, ectx->parallel_grain_size, chunk_begin);
+
+  std::vector<hash_index> indices(nchunks);
+  std::vector<std::vector<const char *>> chunk_uniques(nchunks);
+  thread_pool::get().run(nthreads, nchunks, [&](intptr_t c) {
+    std::vector<char> buf;
+    for (intptr_t i = chunk_begin[c]; i < chunk_begin[c + 1]; ++i) {
+      const char *value = data + i * stride;
+      buf.clear();
+      encoder.encode(value, buf);
+      bool inserted;
+      indices[c].insert(buf, inserted);
+      if (inserted) {
+        chunk_uniques[c].push_back(value);
+      }
+    }
+  });
+  if (nchunks == 1) {
+    uniques.swap(chunk_uniques[0]);
+    return;
+  }
+
+  // The keys of the chunks already have their hashes, so the merge
+  // doesn't encode or hash anything again
+  hash_index merged;
+  for (intptr_t c = 0; c < nchunks; ++c) {
+    const hash_index &index = indices[c];
+    for (intptr_t id = 0; id < index.size(); ++id) {
+      bool inserted;
+      merged.insert(index.get_key(id), index.get_key_size(id),
+                    index.get_hash(id), inserted);
+      if (inserted) {
+        uniques.push_back(chunk_uniques[c][id]);
+      }
+    }
+  }
+}
+
+/** This function converts the sorted char* pointers into a strided immutable
  * nd::array of the categories */
-static nd::array make_sorted_categories(const set<const char *, cmp> &uniques,
-                                        const ndt::type &element_tp,
-                                        const char *arrmeta)
+static nd::array
+make_sorted_categories(const std::vector<const char *> &uniques,
+                       const ndt::type &element_tp, const char *arrmeta)
 {
   nd::array categories = nd::empty(uniques.size(), element_tp);
   ckernel_builder<kernel_request_host> k;
@@ -180,9 +303,8 @@ static nd::array make_sorted_categories(const set<const char *, cmp> &uniques,
   intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
                         categories.get_arrmeta())->stride;
   char *dst_ptr = categories.get_readwrite_originptr();
-  for (set<const char *, cmp>::const_iterator it = uniques.begin();
-       it != uniques.end(); ++it) {
-    char *src = const_cast<char *>(*it);
+  for (size_t i = 0; i < uniques.size(); ++i) {
+    char *src = const_cast<char *>(uniques[i]);
     fn(dst_ptr, &src, k.get());
     dst_ptr += stride;
   }
@@ -238,7 +360,18 @@ ndt::categorical_type::categorical_type(const nd::array &categories, bool presor
     expr_predicate_t fn = k.get()->get_function<expr_predicate_t>();
 
     cmp less(fn, k.get());
-    set<const char *, cmp> uniques(less);
+    const char *categories_data = categories.get_readonly_originptr();
+    intptr_t duplicate =
+        find_duplicate(categories_data, categories_stride, category_count,
+                       m_category_tp, categories_element_arrmeta, less);
+    if (duplicate >= 0) {
+      stringstream ss;
+      ss << "categories must be unique: category value ";
+      m_category_tp.print_data(ss, categories_element_arrmeta,
+                               categories_data + duplicate * categories_stride);
+      ss << " appears more than once";
+      throw std::runtime_error(ss.str());
+    }
 
     m_value_to_category_index =
         nd::empty(category_count, make_type<intptr_t>());
@@ -249,38 +382,24 @@ ndt::categorical_type::categorical_type(const nd::array &categories, bool presor
     // categories to values
     for (size_t i = 0; i != (size_t)category_count; ++i) {
       unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, i) = i;
-      const char *category_value =
-          categories.get_readonly_originptr() + i * categories_stride;
-
-      if (uniques.find(category_value) == uniques.end()) {
-        uniques.insert(category_value);
-      } else {
-        stringstream ss;
-        ss << "categories must be unique: category value ";
-        m_category_tp.print_data(ss, categories_element_arrmeta,
-                                 category_value);
-        ss << " appears more than once";
-        throw std::runtime_error(ss.str());
-      }
     }
-    // TODO: Putting everything in a set already caused a sort operation to
-    // occur,
-    //       there's no reason we should need a second sort.
     std::sort(
         &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, 0),
         &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value,
                                               category_count),
-        sorter(categories.get_readonly_originptr(), categories_stride,
-               fn, k.get()));
+        sorter(categories_data, categories_stride, fn, k.get()));
 
     // invert the m_category_index_to_value permutation
+    std::vector<const char *> sorted_categories(category_count);
     for (intptr_t i = 0; i < category_count; ++i) {
-      unchecked_fixed_dim_get_rw<intptr_t>(
-          m_value_to_category_index,
-          unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i)) = i;
+      intptr_t value =
+          unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
+      unchecked_fixed_dim_get_rw<intptr_t>(m_value_to_category_index, value) =
+          i;
+      sorted_categories[i] = categories_data + value * categories_stride;
     }
 
-    m_categories = make_sorted_categories(uniques, m_category_tp,
+    m_categories = make_sorted_categories(sorted_categories, m_category_tp,
                                           categories_element_arrmeta);
   }
 
@@ -294,6 +413,37 @@ ndt::categorical_type::categorical_type(const nd::array &categories, bool presor
   }
   m_members.data_size = m_storage_type.get_data_size();
   m_members.data_alignment = (uint8_t)m_storage_type.get_data_alignment();
+
+  make_category_index();
+}
+
+ndt::categorical_type::~categorical_type() {}
+
+void ndt::categorical_type::make_category_index()
+{
+  if (!key_encoder::is_supported(m_category_tp)) {
+    return;
+  }
+
+  // Inserts the categories in the order of their values, so their ids are
+  // their values
+  key_encoder encoder(m_category_tp, get_category_arrmeta());
+  uint32_t category_count = (uint32_t)get_category_count();
+  std::unique_ptr<hash_index> index(new hash_index);
+  index->reserve(category_count);
+  std::vector<char> buf;
+  for (uint32_t value = 0; value < category_count; ++value) {
+    buf.clear();
+    encoder.encode(get_category_data_from_value(value), buf);
+    bool inserted;
+    index->insert(buf, inserted);
+    if (!inserted) {
+      // Categories which compare unequal but encode the same, which the
+      // binary search can still tell apart
+      return;
+    }
+  }
+  m_category_index = std::move(index);
 }
 
 void ndt::categorical_type::print_data(std::ostream &o,
@@ -359,17 +509,25 @@ uint32_t
 ndt::categorical_type::get_value_from_category(const char *category_arrmeta,
                                           const char *category_data) const
 {
-  intptr_t i = nd::binary_search(m_categories, category_arrmeta, category_data);
-  if (i < 0) {
+  intptr_t value;
+  if (m_category_index) {
+    std::vector<char> buf;
+    key_encoder(m_category_tp, category_arrmeta).encode(category_data, buf);
+    value = m_category_index->find(buf);
+  } else {
+    intptr_t i =
+        nd::binary_search(m_categories, category_arrmeta, category_data);
+    value = i < 0 ? -1 : unchecked_fixed_dim_get<intptr_t>(
+                             m_category_index_to_value, i);
+  }
+  if (value < 0) {
     stringstream ss;
     ss << "Unrecognized category value ";
     m_category_tp.print_data(ss, category_arrmeta, category_data);
     ss << " assigning to dynd type " << type(this, true);
     throw std::runtime_error(ss.str());
-  } else {
-    return (uint32_t)unchecked_fixed_dim_get<intptr_t>(
-        m_category_index_to_value, i);
   }
+  return (uint32_t)value;
 }
 
 uint32_t
@@ -456,28 +614,22 @@ intptr_t ndt::categorical_type::make_assignment_kernel(
     else if (src_tp == m_category_tp) {
       switch (m_storage_type.get_type_id()) {
       case uint8_type_id: {
-        category_to_categorical_kernel_extra<uint8_t> *e =
-            category_to_categorical_kernel_extra<uint8_t>::make(ckb, kernreq,
-                                                                ckb_offset);
-        e->dst_cat_tp =
-            static_cast<const categorical_type *>(type(dst_tp).release());
-        e->src_arrmeta = src_arrmeta;
+        category_to_categorical_kernel_extra<uint8_t>::make(
+            ckb, kernreq, ckb_offset,
+            static_cast<const categorical_type *>(type(dst_tp).release()),
+            src_arrmeta);
       } break;
       case uint16_type_id: {
-        category_to_categorical_kernel_extra<uint16_t> *e =
-            category_to_categorical_kernel_extra<uint16_t>::make(ckb, kernreq,
-                                                                 ckb_offset);
-        e->dst_cat_tp =
-            static_cast<const categorical_type *>(type(dst_tp).release());
-        e->src_arrmeta = src_arrmeta;
+        category_to_categorical_kernel_extra<uint16_t>::make(
+            ckb, kernreq, ckb_offset,
+            static_cast<const categorical_type *>(type(dst_tp).release()),
+            src_arrmeta);
       } break;
       case uint32_type_id: {
-        category_to_categorical_kernel_extra<uint32_t> *e =
-            category_to_categorical_kernel_extra<uint32_t>::make(ckb, kernreq,
-                                                                 ckb_offset);
-        e->dst_cat_tp =
-            static_cast<const categorical_type *>(type(dst_tp).release());
-        e->src_arrmeta = src_arrmeta;
+        category_to_categorical_kernel_extra<uint32_t>::make(
+            ckb, kernreq, ckb_offset,
+            static_cast<const categorical_type *>(type(dst_tp).release()),
+            src_arrmeta);
       } break;
       default:
         throw runtime_error(
@@ -606,13 +758,19 @@ ndt::type ndt::factor_categorical(const nd::array &values)
   expr_predicate_t fn = k.get()->get_function<expr_predicate_t>();
 
   cmp less(fn, k.get());
-  set<const char *, cmp> uniques(less);
-
-  for (intptr_t i = 0; i < dim_size; ++i) {
-    const char *data = values_eval.get_readonly_originptr() + i * stride;
-    if (uniques.find(data) == uniques.end()) {
-      uniques.insert(data);
+  const char *data = values_eval.get_readonly_originptr();
+  std::vector<const char *> uniques;
+  if (key_encoder::is_supported(el_tp)) {
+    // Only the distinct values get sorted
+    hash_uniques(data, stride, dim_size, el_tp, el_arrmeta,
+                 &eval::default_eval_context, uniques);
+    std::sort(uniques.begin(), uniques.end(), less);
+  } else {
+    set<const char *, cmp> unique_set(less);
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      unique_set.insert(data + i * stride);
     }
+    uniques.assign(unique_set.begin(), unique_set.end());
   }
 
   // Copy the values (now sorted and unique) into a new nd::array
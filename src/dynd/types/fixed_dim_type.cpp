@@ -15,6 +15,7 @@
 #include <dynd/kernels/elwise.hpp>
 #include <dynd/kernels/option_kernels.hpp>
 #include <dynd/kernels/string_assignment_kernels.hpp>
+#include <dynd/kernels/tiled_assignment_kernels.hpp>
 #include <dynd/func/callable.hpp>
 #include <dynd/func/make_callable.hpp>
 #include <dynd/types/typevar_type.hpp>
@@ -532,6 +533,15 @@ intptr_t ndt::fixed_dim_type::make_assignment_kernel(
     type src_el_tp;
     const char *src_el_arrmeta;
 
+    // Dimensions in a different memory order are traversed in tiles, so
+    // neither side is walked with a large stride in the inner loop
+    intptr_t tiled_ckb_offset = make_tiled_assignment_kernel(
+        ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp, src_arrmeta, kernreq,
+        ectx);
+    if (tiled_ckb_offset >= 0) {
+      return tiled_ckb_offset;
+    }
+
     if (src_tp.get_ndim() < dst_tp.get_ndim()) {
       src_stride = 0;
       nd::functional::elwise_ck<fixed_dim_type_id, fixed_dim_type_id, 1>::make(
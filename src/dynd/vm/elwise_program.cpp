@@ -16,7 +16,28 @@ const dynd::vm::opcode_info_t dynd::vm::opcode_info[opcode_count] = {
     {"add", 2},
     {"subtract", 2},
     {"multiply", 2},
-    {"divide", 2}
+    {"divide", 2},
+    {"negate", 1},
+    {"minimum", 2},
+    {"maximum", 2},
+    {"less", 2},
+    {"less_equal", 2},
+    {"equal", 2},
+    {"not_equal", 2},
+    {"greater_equal", 2},
+    {"greater", 2},
+    {"select", 3},
+    {"cast", 1},
+    {"abs", 1},
+    {"sqrt", 1},
+    {"exp", 1},
+    {"log", 1},
+    {"sin", 1},
+    {"cos", 1},
+    {"tan", 1},
+    {"floor", 1},
+    {"ceil", 1},
+    {"power", 2}
 };
 
 int dynd::vm::validate_elwise_program(int input_count, int reg_count, size_t program_size, const int *program)
@@ -117,7 +138,7 @@ void dynd::vm::elwise_program::debug_print(std::ostream& o, const std::string& i
         int arity = vm::opcode_info[opcode].arity;
         // operation
         o << indent << "  " << vm::opcode_info[opcode].name << " ";
-        for (size_t i = 0, i_end = 12 - strlen(vm::opcode_info[opcode].name); i != i_end; ++i) {
+        for (size_t i = strlen(vm::opcode_info[opcode].name); i < 12; ++i) {
             o << " ";
         }
         // output
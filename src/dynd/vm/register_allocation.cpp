@@ -10,7 +10,8 @@ using namespace dynd;
 
 dynd::vm::register_allocation::register_allocation(const std::vector<ndt::type>& regtypes,
                         intptr_t max_element_count, intptr_t max_byte_count)
-    : m_regtypes(regtypes), m_registers(m_regtypes.size()), m_blockrefs(m_regtypes.size()), m_allocated_memory(NULL)
+    : m_regtypes(regtypes), m_registers(m_regtypes.size()), m_blockrefs(m_regtypes.size()),
+      m_element_count(0), m_allocated_memory(NULL)
 {
     if (regtypes.empty()) {
         throw runtime_error("Cannot do a register allocation with no registers");
@@ -21,7 +22,7 @@ dynd::vm::register_allocation::register_allocation(const std::vector<ndt::type>&
     for (size_t i = 1; i < regtypes.size(); ++i) {
         bytes_per_element += regtypes[i].get_data_size();
     }
-    // Turn it into an element count, clamped to [1, max_element_count
+    // Turn it into an element count, clamped to [1, max_element_count]
     intptr_t element_count = max_byte_count / bytes_per_element;
     if (element_count == 0) {
         element_count = 1;
@@ -43,7 +44,9 @@ dynd::vm::register_allocation::register_allocation(const std::vector<ndt::type>&
         // Align the pointer
         offset = inc_to_alignment(offset, d.get_data_alignment());
         m_registers[i] = m_allocated_memory + offset;
+        offset += d.get_data_size() * element_count;
     }
+    m_element_count = element_count;
 }
 
 dynd::vm::register_allocation::~register_allocation()
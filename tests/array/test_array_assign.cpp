@@ -241,6 +241,79 @@ TYPED_TEST_P(ArrayAssign, ScalarAssignment_Uint64)
   EXPECT_EQ(20000000000ULL, TestFixture::First::Dereference(ptr_u64));
 }
 
+TEST(ArrayAssign, TiledTranspose)
+{
+  // Sizes which aren't multiples of the tile size
+  nd::array a = nd::empty(37, 301, "int32");
+  int32_t *a_data = reinterpret_cast<int32_t *>(a.get_readwrite_originptr());
+  for (int i = 0; i < 37 * 301; ++i) {
+    a_data[i] = i;
+  }
+
+  // A transpose into C order, converting the type
+  nd::array b = nd::empty(301, 37, "float64");
+  b.vals() = a.transpose();
+  const double *b_data =
+      reinterpret_cast<const double *>(b.get_readonly_originptr());
+  for (int i = 0; i < 301; ++i) {
+    for (int j = 0; j < 37; ++j) {
+      EXPECT_EQ(j * 301 + i, b_data[i * 37 + j]);
+    }
+  }
+
+  // Three dimensions, with the inner dimensions of the src and the dst
+  // separated by another one
+  nd::array c = nd::empty(9, 10, 11, "int32");
+  int32_t *c_data = reinterpret_cast<int32_t *>(c.get_readwrite_originptr());
+  for (int i = 0; i < 9 * 10 * 11; ++i) {
+    c_data[i] = i;
+  }
+  intptr_t axes[3] = {2, 0, 1};
+  nd::array d = nd::empty(11, 9, 10, "int32");
+  d.vals() = c.permute(3, axes);
+  const int32_t *d_data =
+      reinterpret_cast<const int32_t *>(d.get_readonly_originptr());
+  for (int i = 0; i < 11; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      for (int k = 0; k < 10; ++k) {
+        EXPECT_EQ((j * 10 + k) * 11 + i, d_data[(i * 9 + j) * 10 + k]);
+      }
+    }
+  }
+
+  // A broadcast dimension in the src
+  nd::array f = nd::empty(20, 1, 16, "int32");
+  int32_t *f_data = reinterpret_cast<int32_t *>(f.get_readwrite_originptr());
+  for (int i = 0; i < 20 * 16; ++i) {
+    f_data[i] = i;
+  }
+  intptr_t reverse_axes[3] = {2, 1, 0};
+  nd::array g = nd::empty(16, 3, 20, "int32");
+  g.vals() = f.permute(3, reverse_axes);
+  const int32_t *g_data =
+      reinterpret_cast<const int32_t *>(g.get_readonly_originptr());
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 20; ++k) {
+        EXPECT_EQ(k * 16 + i, g_data[(i * 3 + j) * 20 + k]);
+      }
+    }
+  }
+
+  // An empty outer dimension, which must not touch the memory behind the views
+  nd::array h = nd::empty(2, 64, 64, "float64");
+  h.vals() = 1.0;
+  nd::array k = nd::empty(2, 64, 64, "float64");
+  k.vals() = 0.0;
+  intptr_t inner_axes[3] = {0, 2, 1};
+  k(irange() < 0).vals() = h.permute(3, inner_axes)(irange() < 0);
+  const double *k_data =
+      reinterpret_cast<const double *>(k.get_readonly_originptr());
+  for (int i = 0; i < 2 * 64 * 64; ++i) {
+    EXPECT_EQ(0.0, k_data[i]);
+  }
+}
+
 #if !(                                                                         \
     defined(_WIN32) &&                                                         \
     !defined(_M_X64)) // TODO: How to mark as expected failures in googletest?
@@ -60,3 +60,99 @@ TEST(CodeGenCache, UnaryCaching) {
 }
 #endif // TODO reenable
 
+
+#include <dynd/codegen/codegen_cache.hpp>
+#include <dynd/platform_definitions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(CodeGenCache, ElwiseProgram) {
+    // r0 = max(r1 * r2 - r3, sqrt(r1)) / r2, with registers aliased
+    vector<ndt::type> regtypes(6, ndt::make_type<double>());
+    int program_data[] = {vm::opcode_multiply, 4, 1, 2,
+                          vm::opcode_subtract, 4, 4, 3,
+                          vm::opcode_sqrt, 5, 1,
+                          vm::opcode_maximum, 5, 4, 5,
+                          vm::opcode_divide, 0, 5, 2};
+    vector<int> program(program_data, program_data + 19);
+    vm::elwise_program ep(3, regtypes, program);
+
+    codegen_cache cgcache;
+    expr_strided_t fn = cgcache.codegen_elwise_program(ep);
+#if defined(DYND_CALL_SYSV_X64)
+    ASSERT_TRUE(fn != NULL);
+#else
+    if (fn == NULL) {
+        return;
+    }
+#endif
+    // The generated loop is reused
+    EXPECT_EQ(fn, cgcache.codegen_elwise_program(ep));
+
+    const int n = 37;
+    double dst[n], a[n], b = 2.5, c[2 * n];
+    for (int i = 0; i < n; ++i) {
+        a[i] = i;
+        c[2 * i] = (i % 3) * 20.0;
+        c[2 * i + 1] = -1;
+    }
+    char *src[3] = {reinterpret_cast<char *>(a), reinterpret_cast<char *>(&b),
+                    reinterpret_cast<char *>(c)};
+    intptr_t src_stride[3] = {sizeof(double), 0, 2 * sizeof(double)};
+    fn(reinterpret_cast<char *>(dst), sizeof(double), src, src_stride, n, NULL);
+    for (int i = 0; i < n; ++i) {
+        double x = a[i] * b - c[2 * i], y = sqrt(a[i]);
+        EXPECT_EQ((x < y ? y : x) / b, dst[i]);
+    }
+
+    // A zero count doesn't touch anything
+    dst[0] = -7;
+    fn(reinterpret_cast<char *>(dst), sizeof(double), src, src_stride, 0, NULL);
+    EXPECT_EQ(-7, dst[0]);
+}
+
+TEST(CodeGenCache, ElwiseProgramFloat32) {
+    // r0 = min(r1, r2) + r1
+    vector<ndt::type> regtypes(4, ndt::make_type<float>());
+    int program_data[] = {vm::opcode_minimum, 3, 1, 2,
+                          vm::opcode_add, 0, 3, 1};
+    vector<int> program(program_data, program_data + 8);
+    vm::elwise_program ep(2, regtypes, program);
+
+    codegen_cache cgcache;
+    expr_strided_t fn = cgcache.codegen_elwise_program(ep);
+    if (fn == NULL) {
+        return;
+    }
+    const int n = 9;
+    float dst[n], a[n], b[n];
+    for (int i = 0; i < n; ++i) {
+        a[i] = i * 0.5f;
+        b[i] = 4.0f - i;
+    }
+    char *src[2] = {reinterpret_cast<char *>(a), reinterpret_cast<char *>(b)};
+    intptr_t src_stride[2] = {sizeof(float), sizeof(float)};
+    fn(reinterpret_cast<char *>(dst), sizeof(float), src, src_stride, n, NULL);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ((b[i] < a[i] ? b[i] : a[i]) + a[i], dst[i]);
+    }
+}
+
+TEST(CodeGenCache, ElwiseProgramUnsupported) {
+    // Integer registers and comparisons fall back to the interpreter
+    vector<ndt::type> regtypes(3, ndt::make_type<int32_t>());
+    int program_data[] = {vm::opcode_add, 0, 1, 2};
+    vector<int> program(program_data, program_data + 4);
+    vm::elwise_program ep(2, regtypes, program);
+    codegen_cache cgcache;
+    EXPECT_TRUE(cgcache.codegen_elwise_program(ep) == NULL);
+
+    vector<ndt::type> regtypes2(4, ndt::make_type<double>());
+    regtypes2[3] = ndt::make_type<dynd_bool>();
+    int program_data2[] = {vm::opcode_less, 3, 1, 2,
+                           vm::opcode_select, 0, 3, 1, 2};
+    vector<int> program2(program_data2, program_data2 + 9);
+    vm::elwise_program ep2(2, regtypes2, program2);
+    EXPECT_TRUE(cgcache.codegen_elwise_program(ep2) == NULL);
+}
@@ -9,6 +9,7 @@
 
 #include <memory>
 
+#include <dynd/eval/eval_context.hpp>
 #include <dynd/json_parser.hpp>
 #include <dynd/types/base_struct_type.hpp>
 #include <dynd/type_promotion.hpp>
@@ -375,3 +376,36 @@ AssertArrayNear(const char *expected_expr, const char *actual_expr,
 
 #define EXPECT_ARRAY_NEAR(EXPECTED, ACTUAL, REL_ERROR_MAX)                     \
   ASSERT_PRED_FORMAT3(AssertArrayNear, EXPECTED, ACTUAL, REL_ERROR_MAX)
+
+/**
+ * Saves eval::default_eval_context, and restores it when it goes out of
+ * scope, so a test which changes it doesn't leak the change into the tests
+ * after it, even when an assertion fails or an exception is thrown.
+ */
+class default_eval_context_guard {
+  dynd::eval::eval_context m_saved;
+
+public:
+  default_eval_context_guard() : m_saved(dynd::eval::default_eval_context) {}
+
+  /**
+   * Also runs the parallel code paths on ``nthreads`` threads, splitting
+   * the work into pieces of at least ``parallel_grain_size`` elements.
+   */
+  default_eval_context_guard(intptr_t nthreads, intptr_t parallel_grain_size)
+      : m_saved(dynd::eval::default_eval_context)
+  {
+    dynd::eval::default_eval_context.nthreads = nthreads;
+    dynd::eval::default_eval_context.parallel_grain_size = parallel_grain_size;
+  }
+
+  default_eval_context_guard(const default_eval_context_guard &) = delete;
+
+  ~default_eval_context_guard()
+  {
+    dynd::eval::default_eval_context = m_saved;
+  }
+
+  default_eval_context_guard &
+  operator=(const default_eval_context_guard &) = delete;
+};
@@ -9,9 +9,12 @@
 #include <inc_gtest.hpp>
 
 #include "../test_memory_new.hpp"
+#include "../dynd_assertions.hpp"
 
 #include <dynd/func/arithmetic.hpp>
 #include <dynd/func/elwise.hpp>
+#include <dynd/kernels/simd_arithmetic.hpp>
+#include <dynd/eval/deferred_elwise_eval.hpp>
 #include <dynd/array.hpp>
 #include <dynd/json_parser.hpp>
 
@@ -257,6 +260,148 @@ TYPED_TEST_P(Arithmetic, ComplexScalar)
   EXPECT_EQ(dynd::complex<double>(0, -3), c(2).as<dynd::complex<double>>());
 }
 
+template <typename T>
+static void check_strided_arithmetic()
+{
+  // An odd size, so the vectorized loops also have a remainder
+  const int n = 37;
+  nd::array a = nd::empty(n, ndt::make_type<T>());
+  nd::array b = nd::empty(n, ndt::make_type<T>());
+  for (int i = 0; i < n; ++i) {
+    a(i).vals() = static_cast<T>(3 * i + 1);
+    b(i).vals() = static_cast<T>(i % 5 + 1);
+  }
+  nd::array s = static_cast<T>(2);
+
+  nd::array c = a + b, d = a - b, e = a * b, f = a / b;
+  for (int i = 0; i < n; ++i) {
+    T x = static_cast<T>(3 * i + 1), y = static_cast<T>(i % 5 + 1);
+    EXPECT_EQ(static_cast<T>(x + y), c(i).as<T>());
+    EXPECT_EQ(static_cast<T>(x - y), d(i).as<T>());
+    EXPECT_EQ(static_cast<T>(x * y), e(i).as<T>());
+    EXPECT_EQ(static_cast<T>(x / y), f(i).as<T>());
+  }
+
+  // Broadcasting a scalar on either side
+  c = a + s;
+  d = s - b;
+  e = s * s + a;
+  for (int i = 0; i < n; ++i) {
+    T x = static_cast<T>(3 * i + 1), y = static_cast<T>(i % 5 + 1);
+    EXPECT_EQ(static_cast<T>(x + 2), c(i).as<T>());
+    EXPECT_EQ(static_cast<T>(2 - y), d(i).as<T>());
+    EXPECT_EQ(static_cast<T>(4 + x), e(i).as<T>());
+  }
+
+  // Non-contiguous operands take the generic strided loop
+  nd::array a2 = a(irange().by(2)), b2 = b(irange().by(2));
+  c = a2 * b2;
+  for (int i = 0; i < (n + 1) / 2; ++i) {
+    T x = static_cast<T>(6 * i + 1), y = static_cast<T>((2 * i) % 5 + 1);
+    EXPECT_EQ(static_cast<T>(x * y), c(i).as<T>());
+  }
+}
+
+TEST(ArithmeticOp, SIMDLevels)
+{
+  kernels::simd_level_t saved_level = kernels::get_simd_level();
+  for (int level = kernels::simd_level_none;
+       level <= kernels::get_supported_simd_level(); ++level) {
+    EXPECT_EQ(level, kernels::set_simd_level(
+                         static_cast<kernels::simd_level_t>(level)));
+    check_strided_arithmetic<float>();
+    check_strided_arithmetic<double>();
+    check_strided_arithmetic<int32_t>();
+    check_strided_arithmetic<int64_t>();
+  }
+  kernels::set_simd_level(saved_level);
+
+  // Levels above the supported one are clamped
+  EXPECT_EQ(kernels::get_supported_simd_level(),
+            kernels::set_simd_level(kernels::simd_level_avx512));
+  kernels::set_simd_level(saved_level);
+
+  EXPECT_TRUE(kernels::get_simd_binary_loop(kernels::arithmetic_op_add,
+                                            float64_type_id, true, true) !=
+              NULL);
+  EXPECT_TRUE(kernels::get_simd_binary_loop(kernels::arithmetic_op_divide,
+                                            int32_type_id, true, true) ==
+              NULL);
+  EXPECT_TRUE(kernels::get_simd_binary_loop(kernels::arithmetic_op_add,
+                                            int8_type_id, true, true) == NULL);
+}
+
+TEST(ArithmeticOp, Deferred)
+{
+  nd::array a = parse_json("2 * 5 * float64",
+                           "[[1, 2, 3, 4, 5], [6, 7, 8, 9, 10]]");
+  nd::array b = parse_json("5 * float64", "[0.5, 1.5, 2.5, 3.5, 4.5]");
+  nd::array c = parse_json("2 * 5 * int32",
+                           "[[3, 1, 4, 1, 5], [9, 2, 6, 5, 3]]");
+  nd::array d = parse_json("2 * 5 * float64",
+                           "[[2, 7, 1, 8, 2], [8, 1, 8, 2, 8]]");
+  nd::array expected = (a + b) * c - d;
+  EXPECT_FALSE(eval::is_deferred_elwise(expected));
+
+  nd::array e, f, g;
+  {
+    default_eval_context_guard ectx_guard;
+    eval::default_eval_context.deferred_elwise = true;
+    e = (a + b) * c - d;
+    f = -(a * 2.0) / d;
+    g = c + c / 2;
+  }
+
+  EXPECT_TRUE(eval::is_deferred_elwise(e));
+  EXPECT_TRUE(e.get_type().is_expression());
+  EXPECT_EQ(ndt::type("2 * 5 * float64"), e.get_type().value_type());
+  EXPECT_TRUE(eval::is_deferred_elwise(f));
+  EXPECT_EQ(ndt::type("2 * 5 * int32"), g.get_type().value_type());
+
+  // Operators on a deferred expression stay deferred
+  nd::array e2 = e * a;
+  EXPECT_TRUE(eval::is_deferred_elwise(e2));
+
+  nd::array e_eval = e.eval(), e2_eval = e2.eval(), f_eval = f.eval(),
+            g_eval = g.eval();
+  EXPECT_FALSE(e_eval.get_type().is_expression());
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      double av = a(i, j).as<double>(), dv = d(i, j).as<double>();
+      int cv = c(i, j).as<int>();
+      EXPECT_EQ(expected(i, j).as<double>(), e_eval(i, j).as<double>());
+      EXPECT_EQ(expected(i, j).as<double>() * av, e2_eval(i, j).as<double>());
+      EXPECT_EQ(-(av * 2.0) / dv, f_eval(i, j).as<double>());
+      EXPECT_EQ(cv + cv / 2, g_eval(i, j).as<int>());
+    }
+  }
+
+  // Assignment evaluates into strided memory without a temporary
+  nd::array out = nd::empty(2, 10, ndt::make_type<int32_t>());
+  nd::array out_view = out(irange(), irange().by(2));
+  out_view.val_assign(g);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      EXPECT_EQ(g_eval(i, j).as<int>(), out(i, 2 * j).as<int>());
+    }
+  }
+
+  // Indexing a deferred expression indexes its operands
+  nd::array e_row = e(1);
+  EXPECT_EQ(ndt::type("5 * float64"), e_row.get_type().value_type());
+  nd::array e_row_eval = e_row.eval();
+  for (int j = 0; j < 5; ++j) {
+    EXPECT_EQ(expected(1, j).as<double>(), e_row_eval(j).as<double>());
+  }
+
+  // Types the VM doesn't support are evaluated eagerly
+  nd::array ez = e(0) + nd::array(dynd::complex<double>(0, 1));
+  EXPECT_FALSE(eval::is_deferred_elwise(ez));
+  EXPECT_EQ(ndt::type("5 * complex[float64]"), ez.get_type());
+  EXPECT_EQ(dynd::complex<double>(expected(0, 2).as<double>(), 1),
+            ez(2).as<dynd::complex<double>>());
+}
+
 /*
 TEST(Arithmetic, Plus)
 {
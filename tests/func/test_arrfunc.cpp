@@ -15,11 +15,15 @@
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/func/apply.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_profile.hpp>
 #include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
 #include <dynd/func/elwise.hpp>
 #include <dynd/func/take.hpp>
 #include <dynd/func/call_callable.hpp>
 #include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include "../dynd_assertions.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -175,6 +179,133 @@ TEST(Arrfunc, DecomposedDynamicCall)
   EXPECT_EQ(26.5, af(kwds(3, names, values)).as<double>());
 }
 
+TEST(ArrFunc, KernelCache)
+{
+  nd::arrfunc af = nd::functional::apply(
+      [](int x, double y) { return 2 * x - y; }, "y");
+
+  // Repeated calls with the same layout reuse the instantiated ckernel,
+  // but must still see the new argument and keyword values
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(2 * i - 0.5, af(i, kwds("y", 0.5)).as<double>());
+    EXPECT_EQ(2 * i - 1.5, af(i, kwds("y", 1.5)).as<double>());
+  }
+
+  af = nd::functional::elwise(
+      nd::functional::apply([](int x, int y) { return x * y; }));
+  nd::array a = parse_json("3 * int32", "[1, 2, 3]");
+  nd::array b = parse_json("3 * int32", "[4, 5, 6]");
+  nd::array c = parse_json("2 * int32", "[7, 8]");
+  EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+  EXPECT_JSON_EQ_ARR("[16, 25, 36]", af(b, b));
+  EXPECT_JSON_EQ_ARR("[49, 64]", af(c, c));
+  // A strided view differs only in arrmeta from a contiguous array
+  nd::array d = parse_json("6 * int32", "[1, 2, 3, 4, 5, 6]");
+  EXPECT_JSON_EQ_ARR("[4, 15, 30]", af(d(irange().by(2)), b));
+
+  // With the cache disabled the results are the same
+  {
+    default_eval_context_guard ectx_guard;
+    eval::default_eval_context.kernel_cache_size = 0;
+    EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+  }
+
+  nd::clear_kernel_cache();
+  EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+}
+
+TEST(ArrFunc, KernelCacheHits)
+{
+  nd::arrfunc af = nd::functional::elwise(
+      nd::functional::apply([](int x, int y) { return x * y; }));
+  nd::array a = parse_json("3 * int32", "[1, 2, 3]");
+  nd::array b = parse_json("3 * int32", "[4, 5, 6]");
+
+  // The first call instantiates and caches a ckernel, a second one with
+  // the same types and arrmeta reuses it
+  nd::clear_kernel_cache();
+  EXPECT_EQ(0, nd::get_kernel_cache_size());
+  EXPECT_EQ(0, nd::get_kernel_cache_hits());
+  EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+  EXPECT_EQ(1, nd::get_kernel_cache_size());
+  EXPECT_EQ(0, nd::get_kernel_cache_hits());
+  EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+  EXPECT_EQ(1, nd::get_kernel_cache_size());
+  EXPECT_EQ(1, nd::get_kernel_cache_hits());
+
+  // Different types instantiate another one
+  nd::array c = parse_json("2 * int32", "[7, 8]");
+  EXPECT_JSON_EQ_ARR("[49, 64]", af(c, c));
+  EXPECT_EQ(2, nd::get_kernel_cache_size());
+  EXPECT_EQ(1, nd::get_kernel_cache_hits());
+
+  // Calls with a blockref kwd, like a string, bypass the cache
+  nd::arrfunc sum = kernels::make_builtin_sum1d_arrfunc(float64_type_id);
+  nd::array d = parse_json("4 * float64", "[1, 1e100, 1, -1e100]");
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(2.0, sum(d, kwds("accuracy", nd::array("kahan"))).as<double>());
+    EXPECT_EQ(2, nd::get_kernel_cache_size());
+    EXPECT_EQ(1, nd::get_kernel_cache_hits());
+  }
+
+  // So do calls with the cache disabled
+  {
+    default_eval_context_guard ectx_guard;
+    eval::default_eval_context.kernel_cache_size = 0;
+    EXPECT_JSON_EQ_ARR("[4, 10, 18]", af(a, b));
+    EXPECT_EQ(2, nd::get_kernel_cache_size());
+    EXPECT_EQ(1, nd::get_kernel_cache_hits());
+  }
+
+  nd::clear_kernel_cache();
+  EXPECT_EQ(0, nd::get_kernel_cache_size());
+  EXPECT_EQ(0, nd::get_kernel_cache_hits());
+}
+
+TEST(ArrFunc, Bind)
+{
+  nd::arrfunc af = nd::functional::elwise(
+      nd::functional::apply([](int x, int y) { return x + y; }));
+
+  nd::array a = parse_json("3 * int32", "[1, 2, 3]");
+  nd::array b = parse_json("3 * int32", "[4, 5, 6]");
+  nd::bound_arrfunc bf = af.bind(a, b);
+  EXPECT_FALSE(bf.is_null());
+  EXPECT_EQ(2, bf.get_narg());
+  EXPECT_EQ(ndt::type("3 * int32"), bf.get_dst_type());
+  EXPECT_EQ(ndt::type("3 * int32"), bf.get_arg_type(0));
+  EXPECT_JSON_EQ_ARR("[5, 7, 9]", bf(a, b));
+  EXPECT_JSON_EQ_ARR("[8, 10, 12]", bf(b, b));
+
+  // Calling on raw data pointers
+  nd::array dst = nd::empty(bf.get_dst_type());
+  char *const src[2] = {b.get_ndo()->m_data_pointer,
+                        a.get_ndo()->m_data_pointer};
+  bf.call(dst.get_readwrite_originptr(), src);
+  EXPECT_JSON_EQ_ARR("[5, 7, 9]", dst);
+
+  // Arguments with a different layout are rejected
+  nd::array c = parse_json("4 * int32", "[1, 2, 3, 4]");
+  EXPECT_FALSE(bf.matches(0, c));
+  EXPECT_THROW(bf(c, c), invalid_argument);
+  nd::array d = parse_json("6 * int32", "[1, 2, 3, 4, 5, 6]");
+  EXPECT_FALSE(bf.matches(0, d(irange().by(2))));
+  EXPECT_THROW(bf(d(irange().by(2)), b), invalid_argument);
+  EXPECT_THROW(bf(a), invalid_argument);
+
+  // Binding with keyword arguments
+  af = nd::functional::apply([](int x, double y) { return 2 * x - y; }, "y");
+  bf = af.bind(1, kwds("y", 2.5));
+  EXPECT_EQ(-0.5, bf(1).as<double>());
+  EXPECT_EQ(11.5, bf(7).as<double>());
+
+  // Types which refer to other memory can't be bound
+  af = nd::functional::elwise(
+      nd::functional::apply([](int x, int y) { return x + y; }));
+  nd::array e = parse_json("var * int32", "[1, 2, 3]");
+  EXPECT_THROW(af.bind(e, e), type_error);
+}
+
 TEST(ArrFunc, KeywordParsing)
 {
   nd::arrfunc af0 =
@@ -313,6 +444,69 @@ TEST(ArrFunc, AssignmentAsExpr)
   EXPECT_EQ(891029, ints_out[2]);
 }
 
+TEST(ArrFunc, PooledCKernelBuilder)
+{
+  nd::array a = nd::empty("3 * 4 * 5 * {x: int32, y: float64, z: int16}");
+  nd::array b = nd::empty("3 * 4 * 5 * {x: float64, y: int32, z: int64}");
+  a.val_assign(0);
+
+  // This assignment ckernel doesn't fit in the builder's inline storage
+  {
+    ckernel_builder<kernel_request_host> ckb;
+    make_assignment_kernel(NULL, NULL, &ckb, 0, b.get_type(), b.get_arrmeta(),
+                           a.get_type(), a.get_arrmeta(),
+                           kernel_request_single, &eval::default_eval_context,
+                           nd::array());
+    EXPECT_LT(128, ckb.get_capacity());
+  }
+
+#ifndef DYND_THREAD_LOCAL_POD_ONLY
+  // Once the pool has buffers, instantiating again doesn't touch the heap
+  intptr_t count = 0;
+  for (int i = 0; i < 10; ++i) {
+    if (i == 1) {
+      count = get_ckernel_builder_heap_allocation_count();
+    }
+    ckernel_builder<kernel_request_host> ckb;
+    make_assignment_kernel(NULL, NULL, &ckb, 0, b.get_type(), b.get_arrmeta(),
+                           a.get_type(), a.get_arrmeta(),
+                           kernel_request_single, &eval::default_eval_context,
+                           nd::array());
+    b.val_assign(a);
+  }
+  EXPECT_EQ(count, get_ckernel_builder_heap_allocation_count());
+  EXPECT_EQ(0, b(2, 3, 4, 0).as<double>());
+#endif
+}
+
+TEST(ArrFunc, ProfileKernels)
+{
+  nd::array a = parse_json("3 * 4 * int32",
+                           "[[1, 2, 3, 4], [5, 6, 7, 8], [9, 10, 11, 12]]");
+  nd::array b = parse_json("4 * float64", "[0.5, 1.5, 2.5, 3.5]");
+
+  clear_ckernel_profiles();
+  eval::default_eval_context.profile_kernels = true;
+  nd::array c = a + b;
+  eval::default_eval_context.profile_kernels = false;
+  EXPECT_EQ(15.5, c(2, 3).as<double>());
+
+  std::stringstream ss;
+  print_ckernel_profiles(ss);
+  std::string report = ss.str();
+  // The label is the call's signature, followed by the kernel tree
+  EXPECT_EQ(
+      0u, report.find("(3 * 4 * int32, 4 * float64) -> 3 * 4 * float64\n"));
+  EXPECT_NE(std::string::npos, report.find("\n  -> elwise_ck<"));
+  EXPECT_NE(std::string::npos, report.find("(calls=1 elements=3)"));
+  EXPECT_NE(std::string::npos, report.find("(calls=3 elements=12)"));
+
+  clear_ckernel_profiles();
+  ss.str("");
+  print_ckernel_profiles(ss);
+  EXPECT_EQ("", ss.str());
+}
+
 /*
 // TODO Reenable once there's a convenient way to make the binary arrfunc
 TEST(ArrFunc, Expr) {
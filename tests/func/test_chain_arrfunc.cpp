@@ -39,3 +39,30 @@ TEST(ChainArrFunc, Simple)
   chained(3.1, kwds("dst", a));
   EXPECT_DOUBLE_EQ(sin(3.1), a.as<double>());
 }
+
+TEST(ChainArrFunc, StringBufferManyChunks)
+{
+  // Format to a string and parse it back, with enough elements that the
+  // string buffer is reused for several chunks
+  nd::arrfunc chained = nd::functional::elwise(nd::functional::chain(
+      make_arrfunc_from_assignment(ndt::make_string(), ndt::make_type<int>(),
+                                   assign_error_default),
+      make_arrfunc_from_assignment(ndt::make_type<double>(),
+                                   ndt::make_string(), assign_error_default),
+      ndt::make_string()));
+  nd::array a = nd::empty(1000, ndt::make_type<int>());
+  for (int i = 0; i < 1000; ++i) {
+    a(i).vals() = i * 7 - 3000;
+  }
+  nd::array b = nd::empty(1000, ndt::make_type<double>());
+  chained(a, kwds("dst", b));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i * 7 - 3000, b(i).as<double>());
+  }
+  // Strided source and destination
+  nd::array c = nd::empty(250, ndt::make_type<double>());
+  chained(a(irange().by(4)), kwds("dst", c));
+  for (int i = 0; i < 250; ++i) {
+    EXPECT_EQ(i * 28 - 3000, c(i).as<double>());
+  }
+}
@@ -19,6 +19,7 @@
 #include <dynd/func/take.hpp>
 #include <dynd/func/call_callable.hpp>
 #include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
 #include <dynd/json_parser.hpp>
 #include "../dynd_assertions.hpp"
 
@@ -257,4 +258,97 @@ TEST(Elwise, Simple)
 //  baf = nd::functional::elwise(af);
 //  EXPECT_ARR_EQ(nd::array({3, 5, 7}).to_cuda_device(), baf(a, b));
 #endif
-}
\ No newline at end of file
+}
+TEST(Elwise, Parallel)
+{
+  default_eval_context_guard parallel_ectx(4, 16);
+
+  nd::arrfunc af = nd::functional::elwise(nd::functional::apply<callable0>());
+
+  // One dimension, split into chunks along the only dimension
+  nd::array a = nd::range(1000);
+  nd::array b = nd::range(1000, 2000);
+  nd::array c = af(a, b);
+  EXPECT_EQ(ndt::type("1000 * int32"), c.get_type());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(1000 + 2 * i, c(i).as<int>());
+  }
+
+  // Two dimensions, with a broadcast operand
+  a = nd::empty(100, 7, ndt::make_type<int>());
+  for (int i = 0; i < 100; ++i) {
+    a(i).vals() = i;
+  }
+  b = parse_json("7 * int", "[0, 1, 2, 3, 4, 5, 6]");
+  c = af(a, b);
+  EXPECT_EQ(ndt::type("100 * 7 * int32"), c.get_type());
+  for (int i = 0; i < 100; ++i) {
+    for (int j = 0; j < 7; ++j) {
+      EXPECT_EQ(i + j, c(i, j).as<int>());
+    }
+  }
+
+  // Below the grain size, the serial kernel is used
+  a = parse_json("3 * int", "[0, 1, 2]");
+  b = parse_json("3 * int", "[3, 4, 5]");
+  EXPECT_ARR_EQ(nd::array({3, 5, 7}), af(a, b));
+}
+
+TEST(Elwise, Coalesce)
+{
+  nd::arrfunc af = nd::functional::elwise(nd::functional::apply<callable0>());
+
+  // Contiguous dimensions become a single strided loop
+  nd::array a = nd::empty(5, 3, 2, ndt::make_type<int>());
+  nd::array b = nd::empty(5, 3, 2, ndt::make_type<int>());
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 2; ++k) {
+        a(i, j, k).vals() = 100 * i + 10 * j + k;
+        b(i, j, k).vals() = 1000;
+      }
+    }
+  }
+  nd::array c = af(a, b);
+  EXPECT_EQ(ndt::type("5 * 3 * 2 * int32"), c.get_type());
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 2; ++k) {
+        EXPECT_EQ(1000 + 100 * i + 10 * j + k, c(i, j, k).as<int>());
+      }
+    }
+  }
+
+  // Broadcasting over the outer dimensions, and within the inner ones
+  b = parse_json("2 * int", "[1000, 2000]");
+  c = af(a, b);
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 2; ++k) {
+        EXPECT_EQ(1000 * (k + 1) + 100 * i + 10 * j + k, c(i, j, k).as<int>());
+      }
+    }
+  }
+  b = parse_json("3 * 2 * int", "[[1000, 2000], [3000, 4000], [5000, 6000]]");
+  c = af(a, b);
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 2; ++k) {
+        EXPECT_EQ(1000 * (2 * j + k + 1) + 100 * i + 10 * j + k,
+                  c(i, j, k).as<int>());
+      }
+    }
+  }
+
+  // Strided views which can only be partially coalesced
+  nd::array d = a(irange(), irange().by(2));
+  c = af(d, d);
+  EXPECT_EQ(ndt::type("5 * 2 * 2 * int32"), c.get_type());
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      for (int k = 0; k < 2; ++k) {
+        EXPECT_EQ(2 * (100 * i + 20 * j + k), c(i, j, k).as<int>());
+      }
+    }
+  }
+}
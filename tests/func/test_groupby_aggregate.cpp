@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/func/groupby_aggregate.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::nd::functional;
+
+static vector<groupby_aggregation> all_aggregations(intptr_t value)
+{
+  groupby_aggregation aggs[] = {{"count", groupby_count, value},
+                                {"sum", groupby_sum, value},
+                                {"mean", groupby_mean, value},
+                                {"min", groupby_min, value},
+                                {"max", groupby_max, value}};
+  return vector<groupby_aggregation>(aggs, aggs + 5);
+}
+
+TEST(GroupbyAggregate, Int)
+{
+  nd::arrfunc af = groupby_aggregate(1, 1, all_aggregations(0));
+  nd::array keys = parse_json("7 * int32", "[3, 1, 3, 2, 1, 3, 7]");
+  nd::array values = parse_json("7 * int32", "[1, 2, 3, 4, 5, 8, -7]");
+  nd::array b = af(keys, values);
+  EXPECT_EQ(ndt::type("{key0: var * int32, count: var * int64, sum: var * "
+                      "int64, mean: var * float64, min: var * int32, max: "
+                      "var * int32}"),
+            b.get_type());
+  // The groups are in the order of their first row, compared as JSON
+  // because comparing var dimensions isn't implemented
+  EXPECT_EQ("{\"key0\":[3,1,2,7],\"count\":[3,2,1,1],\"sum\":[12,7,4,-7],"
+            "\"mean\":[4,3.5,4,-7],\"min\":[1,2,4,-7],\"max\":[8,5,4,-7]}",
+            format_json(b).as<string>());
+
+  // No rows
+  b = af(parse_json("0 * int32", "[]"), parse_json("0 * int32", "[]"));
+  EXPECT_EQ("{\"key0\":[],\"count\":[],\"sum\":[],\"mean\":[],\"min\":[],"
+            "\"max\":[]}",
+            format_json(b).as<string>());
+
+  EXPECT_THROW(af(keys), invalid_argument);
+  EXPECT_THROW(af(keys, values(irange() < 3)), broadcast_error);
+  EXPECT_THROW(groupby_aggregate(1, 1, all_aggregations(1)), invalid_argument);
+  EXPECT_THROW(groupby_aggregate(0, 1, all_aggregations(0)), invalid_argument);
+}
+
+TEST(GroupbyAggregate, Real)
+{
+  // NaN values are skipped, and negative zero and all NaNs are one key
+  nd::arrfunc af = groupby_aggregate(1, 1, all_aggregations(0));
+  nd::array keys = nd::empty(5, ndt::make_type<double>());
+  keys(0).vals() = 0.0;
+  keys(1).vals() = numeric_limits<double>::quiet_NaN();
+  keys(2).vals() = -0.0;
+  keys(3).vals() = -numeric_limits<double>::quiet_NaN();
+  keys(4).vals() = 0.0;
+  nd::array values = nd::empty(5, ndt::make_type<double>());
+  values(0).vals() = 1.5;
+  values(1).vals() = numeric_limits<double>::quiet_NaN();
+  values(2).vals() = numeric_limits<double>::quiet_NaN();
+  values(3).vals() = numeric_limits<double>::quiet_NaN();
+  values(4).vals() = 2.5;
+  nd::array b = af(keys, values);
+  EXPECT_EQ(2, b.p("count").get_dim_size());
+  EXPECT_EQ(2, b.p("count")(0).as<int64_t>());
+  EXPECT_EQ(0, b.p("count")(1).as<int64_t>());
+  EXPECT_EQ(4.0, b.p("sum")(0).as<double>());
+  EXPECT_EQ(0.0, b.p("sum")(1).as<double>());
+  EXPECT_EQ(2.0, b.p("mean")(0).as<double>());
+  EXPECT_TRUE(dynd::isnan(b.p("mean")(1).as<double>()));
+  EXPECT_EQ(1.5, b.p("min")(0).as<double>());
+  EXPECT_TRUE(dynd::isnan(b.p("max")(1).as<double>()));
+}
+
+TEST(GroupbyAggregate, MultipleKeys)
+{
+  groupby_aggregation aggs[] = {{"total", groupby_sum, 1},
+                                {"n", groupby_count, 0}};
+  nd::arrfunc af =
+      groupby_aggregate(2, 2, vector<groupby_aggregation>(aggs, aggs + 2));
+  nd::array a = parse_json("5 * string", "[\"x\", \"y\", \"x\", \"x\", \"y\"]");
+  nd::array b = parse_json("5 * date", "[\"2015-01-01\", \"2015-01-01\", "
+                                       "\"2015-01-02\", \"2015-01-01\", "
+                                       "\"2015-01-01\"]");
+  nd::array v0 = parse_json("5 * float32", "[1, 2, 3, 4, 5]");
+  nd::array v1 = parse_json("5 * uint8", "[10, 20, 30, 40, 250]");
+  nd::array args[4] = {a, b, v0, v1};
+  nd::array c = af(4, args);
+  EXPECT_EQ(ndt::type("{key0: var * string, key1: var * date, total: var * "
+                      "uint64, n: var * int64}"),
+            c.get_type());
+  EXPECT_EQ("{\"key0\":[\"x\",\"y\",\"x\"],\"key1\":[\"2015-01-01\","
+            "\"2015-01-01\",\"2015-01-02\"],\"total\":[50,270,30],"
+            "\"n\":[2,2,1]}",
+            format_json(c).as<string>());
+
+  // A struct key
+  af = groupby_aggregate(1, 1, all_aggregations(0));
+  nd::array keys = parse_json("4 * {a: int16, b: string}",
+                              "[[1, \"p\"], [1, \"q\"], [1, \"p\"], [2, \"p\"]]");
+  c = af(keys, parse_json("4 * int64", "[1, 2, 3, 4]"));
+  EXPECT_EQ("[{\"a\":1,\"b\":\"p\"},{\"a\":1,\"b\":\"q\"},{\"a\":2,\"b\":\"p\"}]",
+            format_json(c.p("key0")).as<string>());
+  EXPECT_EQ("[4,2,4]", format_json(c.p("sum")).as<string>());
+
+  EXPECT_THROW(af(parse_json("2 * 2 * int32", "[[1, 2], [3, 4]]"),
+                  parse_json("2 * int32", "[1, 2]")),
+               invalid_argument);
+  EXPECT_THROW(af(parse_json("2 * int32", "[1, 2]"),
+                  parse_json("2 * string", "[\"a\", \"b\"]")),
+               type_error);
+}
+
+TEST(GroupbyAggregate, Parallel)
+{
+  nd::arrfunc af = groupby_aggregate(1, 1, all_aggregations(0));
+  nd::array keys = nd::empty(5000, ndt::make_type<int64_t>());
+  nd::array values = nd::empty(5000, ndt::make_type<double>());
+  for (int i = 0; i < 5000; ++i) {
+    keys(i).vals() = (i * 7919) % 101;
+    values(i).vals() = i * 0.25;
+  }
+  nd::array expected = af(keys, values);
+
+  nd::array b;
+  {
+    default_eval_context_guard parallel_ectx(4, 16);
+    b = af(keys, values);
+  }
+
+  EXPECT_EQ(101, b.p("key0").get_dim_size());
+  EXPECT_EQ(format_json(expected).as<string>(), format_json(b).as<string>());
+}
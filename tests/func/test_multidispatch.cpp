@@ -123,6 +123,39 @@ TEST(MultiDispatchArrfunc, Values)
   EXPECT_JSON_EQ_ARR("[-1, -2, 4]", c);
 }
 
+TEST(MultiDispatchArrfunc, PromoteManyChunks)
+{
+  vector<nd::arrfunc> funcs;
+  funcs.push_back(nd::functional::apply(&manip0));
+  funcs.push_back(nd::functional::apply(&manip1));
+  nd::arrfunc af = nd::functional::elwise(
+      nd::functional::multidispatch(funcs.size(), &funcs[0]));
+
+  // Enough elements that the buffered operands are converted in several
+  // chunks, with one of them strided
+  nd::array a = nd::empty(1000, ndt::make_type<int16_t>());
+  nd::array b = nd::empty(2000, ndt::make_type<int8_t>());
+  for (int i = 0; i < 1000; ++i) {
+    a(i).vals() = i;
+  }
+  for (int i = 0; i < 2000; ++i) {
+    b(i).vals() = (i / 2) % 100;
+  }
+  nd::array c = af(a, b(irange().by(2)));
+  EXPECT_EQ(ndt::type("1000 * float64"), c.get_type());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i + i % 100, c(i).as<double>());
+  }
+
+  // Buffered and unbuffered operands together
+  a = nd::empty(1000, ndt::make_type<int>());
+  a.vals() = 1;
+  c = af(a, b(irange() < 1000));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(1 + (i / 2) % 100, c(i).as<double>());
+  }
+}
+
 /**
 TODO: This test broken when the order of resolve_option_values and
       resolve_dst_type changed. It should be fixed when we sort out
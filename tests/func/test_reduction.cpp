@@ -11,7 +11,11 @@
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+#include <dynd/func/apply.hpp>
 #include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/kernels/moments_kernels.hpp>
+#include <dynd/kernels/describe_kernels.hpp>
 #include <dynd/func/lift_reduction_arrfunc.hpp>
 #include <dynd/json_parser.hpp>
 
@@ -128,6 +132,45 @@ TEST(Reduction, BuiltinSum_Kernel)
   EXPECT_EQ(dynd::complex<double>(10.875, 12343.875), scf64);
 }
 
+TEST(Reduction, BuiltinSum_Accuracy)
+{
+  nd::arrfunc sum = kernels::make_builtin_sum1d_arrfunc(float64_type_id);
+
+  // Integers are summed exactly, contiguous or strided, in blocks and not
+  nd::arrfunc isum = kernels::make_builtin_sum1d_arrfunc(int64_type_id);
+  nd::array a = nd::range(100001).ucast(ndt::make_type<int64_t>()).eval();
+  EXPECT_EQ(5000050000LL, isum(a).as<int64_t>());
+  EXPECT_EQ(1666683333LL, isum(a(irange().by(3))).as<int64_t>());
+  EXPECT_EQ(15LL, isum(a(irange() < 6)).as<int64_t>());
+
+  // The compensation keeps the small terms that cancel out of a naive sum
+  a = parse_json("4 * float64", "[1, 1e100, 1, -1e100]");
+  EXPECT_EQ(2.0, sum(a, kwds("accuracy", nd::array("kahan"))).as<double>());
+  a = nd::empty(4, ndt::make_type<dynd::complex<double>>());
+  a(0).vals() = dynd::complex<double>(1, 1);
+  a(1).vals() = dynd::complex<double>(1e100, 1);
+  a(2).vals() = dynd::complex<double>(1, 1e100);
+  a(3).vals() = dynd::complex<double>(-1e100, -1e100);
+  nd::arrfunc csum =
+      kernels::make_builtin_sum1d_arrfunc(complex_float64_type_id);
+  EXPECT_EQ(dynd::complex<double>(2.0, 2.0),
+            csum(a, kwds("accuracy", nd::array("kahan")))
+                .as<dynd::complex<double>>());
+
+  // A long sum of a value which isn't exact in binary
+  a = nd::empty(1000000, ndt::make_type<double>());
+  a.vals() = 0.1;
+  double pairwise = sum(a).as<double>();
+  double kahan = sum(a, kwds("accuracy", nd::array("kahan"))).as<double>();
+  EXPECT_EQ(100000.0, kahan);
+  EXPECT_NEAR(100000.0, pairwise, 1e-9);
+  EXPECT_EQ(pairwise,
+            sum(a, kwds("accuracy", nd::array("pairwise"))).as<double>());
+  EXPECT_NEAR(50000.0, sum(a(irange().by(2))).as<double>(), 1e-9);
+
+  EXPECT_THROW(sum(a, kwds("accuracy", nd::array("naive"))), invalid_argument);
+}
+
 TEST(Reduction, BuiltinSum_Lift0D_NoIdentity)
 {
   // Start with a float32 reduction arrfunc
@@ -678,3 +721,472 @@ TEST(Reduction, BuiltinSum_Lift3D_StridedStridedStrided_ReduceBroadcastReduce)
   EXPECT_EQ(2.f + 1.25f + 7.f, b(1).as<float>());
   EXPECT_EQ(7.f - 0.5f + 2.125f + 0.25f, b(2).as<float>());
 }
+
+TEST(Reduction, BuiltinMinMaxProd)
+{
+  nd::arrfunc min1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_min, float64_type_id);
+  nd::arrfunc max1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_max, float64_type_id);
+
+  // Long enough for several blocks, contiguous and strided
+  nd::array a = nd::empty(3000, ndt::make_type<double>());
+  for (int i = 0; i < 3000; ++i) {
+    a(i).vals() = (i * 7919) % 3001 - 1500.5;
+  }
+  double lo = 1e300, hi = -1e300, slo = 1e300;
+  for (int i = 0; i < 3000; ++i) {
+    double v = a(i).as<double>();
+    lo = std::min(lo, v);
+    hi = std::max(hi, v);
+    if (i % 3 == 0) {
+      slo = std::min(slo, v);
+    }
+  }
+  EXPECT_EQ(lo, min1d(a).as<double>());
+  EXPECT_EQ(hi, max1d(a).as<double>());
+  EXPECT_EQ(slo, min1d(a(irange().by(3))).as<double>());
+
+  // NaN is propagated
+  a(2500).vals() = numeric_limits<double>::quiet_NaN();
+  EXPECT_TRUE(dynd::isnan(min1d(a).as<double>()));
+  EXPECT_TRUE(dynd::isnan(max1d(a).as<double>()));
+  a = parse_json("3 * float64", "[0, 1, 2]");
+  a(0).vals() = numeric_limits<double>::quiet_NaN();
+  EXPECT_TRUE(dynd::isnan(min1d(a).as<double>()));
+
+  a = parse_json("5 * uint8", "[7, 200, 3, 9, 3]");
+  EXPECT_EQ(3, kernels::make_builtin_reduction1d_arrfunc(
+                   kernels::builtin_reduction_min, uint8_type_id)(a)
+                   .as<int>());
+  EXPECT_EQ(200, kernels::make_builtin_reduction1d_arrfunc(
+                     kernels::builtin_reduction_max, uint8_type_id)(a)
+                     .as<int>());
+
+  a = parse_json("20 * int64", "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 1, 1, 1, "
+                               "1, 1, 1, 1, 1, -2]");
+  nd::arrfunc prod1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_prod, int64_type_id);
+  EXPECT_EQ(-7257600, prod1d(a).as<int64_t>());
+  EXPECT_EQ(1, prod1d(a(irange() < 0)).as<int64_t>());
+
+  EXPECT_THROW(kernels::make_builtin_reduction_arrfunc(
+                   kernels::builtin_reduction_min, complex_float64_type_id),
+               type_error);
+
+  EXPECT_TRUE(kernels::make_builtin_reduction_identity(
+                  kernels::builtin_reduction_max, int32_type_id).is_null());
+  nd::array identity = kernels::make_builtin_reduction_identity(
+      kernels::builtin_reduction_prod, complex_float32_type_id);
+  EXPECT_EQ(ndt::type("complex[float32]"), identity.get_type());
+  EXPECT_EQ(1.f, identity.as<dynd::complex<float>>());
+}
+
+TEST(Reduction, BuiltinAnyAllCountNonzero)
+{
+  nd::arrfunc any1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_any, float32_type_id);
+  nd::arrfunc all1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_all, float32_type_id);
+  nd::arrfunc count1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_count_nonzero, float32_type_id);
+  EXPECT_EQ(ndt::type("bool"), any1d.get_type()->get_return_type());
+  EXPECT_EQ(ndt::type("int64"), count1d.get_type()->get_return_type());
+
+  nd::array a = nd::empty(2000, ndt::make_type<float>());
+  a.vals() = 0;
+  EXPECT_FALSE(any1d(a).as<bool>());
+  EXPECT_FALSE(all1d(a).as<bool>());
+  EXPECT_EQ(0, count1d(a).as<int64_t>());
+  a(1999).vals() = 1.5f;
+  a(10).vals() = numeric_limits<float>::quiet_NaN();
+  EXPECT_TRUE(any1d(a).as<bool>());
+  EXPECT_EQ(2, count1d(a).as<int64_t>());
+  EXPECT_EQ(1, count1d(a(irange().by(2))).as<int64_t>());
+
+  a.vals() = -2;
+  EXPECT_TRUE(all1d(a).as<bool>());
+  a(1234).vals() = 0;
+  EXPECT_FALSE(all1d(a).as<bool>());
+  EXPECT_TRUE(all1d(a(irange() < 1234)).as<bool>());
+  EXPECT_TRUE(all1d(a(irange() < 0)).as<bool>());
+  EXPECT_FALSE(any1d(a(irange() < 0)).as<bool>());
+
+  // Reducing the inner dimension of a matrix, which gets the identity of
+  // count_nonzero without passing it
+  a = parse_json("3 * 4 * int32",
+                 "[[0, 0, 0, 0], [0, 3, 0, 1], [2, 2, 2, 2]]");
+  bool reduction_dimflags[2] = {false, true};
+  nd::arrfunc count = kernels::make_builtin_reduction_arrfunc(
+      kernels::builtin_reduction_count_nonzero, int32_type_id);
+  EXPECT_EQ(0, kernels::get_builtin_reduction_identity(count).as<int64_t>());
+  EXPECT_TRUE(kernels::get_builtin_reduction_identity(
+                  kernels::make_builtin_sum_reduction_arrfunc(int32_type_id))
+                  .is_null());
+  nd::arrfunc count2d = lift_reduction_arrfunc(
+      count, ndt::type("Fixed * Fixed * int32"), nd::array(), false, 2,
+      reduction_dimflags, true, true, false, nd::array());
+  nd::array b = nd::empty(3, ndt::make_type<int64_t>());
+  count2d(a, kwds("dst", b));
+  EXPECT_JSON_EQ_ARR("[0, 2, 4]", b);
+
+  // The partial counts of the threads are summed
+  a = nd::empty(4000, ndt::make_type<int64_t>());
+  a.vals() = 5;
+  count = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_count_nonzero, int64_type_id);
+  nd::arrfunc all = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_all, int64_type_id);
+  default_eval_context_guard parallel_ectx(4, 16);
+  EXPECT_EQ(4000, count(a).as<int64_t>());
+  EXPECT_TRUE(all(a).as<bool>());
+  a(3999).vals() = 0;
+  EXPECT_EQ(3999, count(a).as<int64_t>());
+  EXPECT_FALSE(all(a).as<bool>());
+}
+
+TEST(Reduction, BuiltinArgMinMax)
+{
+  nd::arrfunc argmin = kernels::make_builtin_argmin1d_arrfunc(float64_type_id);
+  nd::arrfunc argmax = kernels::make_builtin_argmax1d_arrfunc(float64_type_id);
+  EXPECT_EQ(ndt::type("{index: intptr, value: float64}"),
+            argmin.get_type()->get_return_type());
+
+  // The first of equal values, across block boundaries
+  nd::array a = nd::empty(5000, ndt::make_type<double>());
+  for (int i = 0; i < 5000; ++i) {
+    a(i).vals() = (i * 37) % 1000;
+  }
+  a(3100).vals() = -5;
+  a(4100).vals() = -5;
+  a(1500).vals() = 2000;
+  nd::array b = argmin(a);
+  EXPECT_EQ(3100, b.p("index").as<intptr_t>());
+  EXPECT_EQ(-5, b.p("value").as<double>());
+  b = argmax(a);
+  EXPECT_EQ(1500, b.p("index").as<intptr_t>());
+  EXPECT_EQ(2000, b.p("value").as<double>());
+  b = argmax(a(irange().by(2)));
+  EXPECT_EQ(750, b.p("index").as<intptr_t>());
+  b = argmin(a(irange() < 3));
+  EXPECT_EQ(0, b.p("index").as<intptr_t>());
+  EXPECT_EQ(0, b.p("value").as<double>());
+
+  // The first NaN wins
+  a(4500).vals() = numeric_limits<double>::quiet_NaN();
+  a(2).vals() = numeric_limits<double>::quiet_NaN();
+  b = argmin(a);
+  EXPECT_EQ(2, b.p("index").as<intptr_t>());
+  EXPECT_TRUE(dynd::isnan(b.p("value").as<double>()));
+
+  a = parse_json("6 * int16", "[3, -7, 12, -7, 12, 0]");
+  b = kernels::make_builtin_argmin1d_arrfunc(int16_type_id)(a);
+  EXPECT_EQ(1, b.p("index").as<intptr_t>());
+  EXPECT_EQ(-7, b.p("value").as<int>());
+  b = kernels::make_builtin_argmax1d_arrfunc(int16_type_id)(a);
+  EXPECT_EQ(2, b.p("index").as<intptr_t>());
+
+  EXPECT_THROW(argmin(nd::empty(0, ndt::make_type<double>())),
+               invalid_argument);
+}
+
+static int keep_left(int x, int DYND_UNUSED(y)) { return x; }
+static int keep_right(int DYND_UNUSED(x), int y) { return y; }
+
+TEST(Reduction, Parallel)
+{
+  default_eval_context_guard parallel_ectx(4, 16);
+
+  nd::arrfunc reduction_kernel =
+      kernels::make_builtin_sum_reduction_arrfunc(int32_type_id);
+
+  // One dimension, with and without an identity
+  bool reduction_dimflags[2] = {true, false};
+  nd::arrfunc af = lift_reduction_arrfunc(
+      reduction_kernel, ndt::type("Fixed * int32"), nd::array(), false, 1,
+      reduction_dimflags, true, true, false, nd::array(), reduction_kernel);
+  nd::array a = nd::range(1000);
+  nd::array b = nd::empty(ndt::make_type<int>());
+  af(a, kwds("dst", b));
+  EXPECT_EQ(499500, b.as<int>());
+  af = lift_reduction_arrfunc(reduction_kernel, ndt::type("Fixed * int32"),
+                              nd::array(), false, 1, reduction_dimflags, true,
+                              true, false, 0, reduction_kernel);
+  af(a(irange().by(3)), kwds("dst", b));
+  EXPECT_EQ(166833, b.as<int>());
+
+  // Reducing the outer dimension of two, keeping it as size one
+  af = lift_reduction_arrfunc(
+      reduction_kernel, ndt::type("Fixed * Fixed * int32"), nd::array(), true,
+      2, reduction_dimflags, true, true, false, nd::array(), reduction_kernel);
+  a = nd::empty(200, 3, ndt::make_type<int>());
+  for (int i = 0; i < 200; ++i) {
+    a(i).vals() = i;
+    a(i, 2).vals() = 1;
+  }
+  b = nd::empty(1, 3, ndt::make_type<int>());
+  af(a, kwds("dst", b));
+  EXPECT_EQ(19900, b(0, 0).as<int>());
+  EXPECT_EQ(19900, b(0, 1).as<int>());
+  EXPECT_EQ(200, b(0, 2).as<int>());
+
+  // Associative but not commutative operations, for which the partial
+  // results have to be combined in order to match the serial reduction
+  a = nd::range(5, 1005);
+  b = nd::empty(ndt::make_type<int>());
+  for (int (*func)(int, int) : {&keep_left, &keep_right}) {
+    nd::arrfunc child = nd::functional::apply(func);
+    af = lift_reduction_arrfunc(child, ndt::type("Fixed * int32"), nd::array(),
+                                false, 1, reduction_dimflags, true, false,
+                                false, nd::array(), child);
+    af(a, kwds("dst", b));
+    int parallel_result = b.as<int>();
+    eval::default_eval_context.nthreads = 1;
+    af(a, kwds("dst", b));
+    EXPECT_EQ(b.as<int>(), parallel_result);
+    eval::default_eval_context.nthreads = 4;
+  }
+
+  // Without a combine the reduction stays serial, because the elementwise
+  // reduction counting the values can't merge the partial counts
+  af = lift_reduction_arrfunc(
+      kernels::make_builtin_reduction_arrfunc(
+          kernels::builtin_reduction_count_nonzero, int64_type_id),
+      ndt::type("Fixed * int64"), nd::array(), false, 1, reduction_dimflags,
+      true, true, false, static_cast<int64_t>(0));
+  a = nd::empty(4000, ndt::make_type<int64_t>());
+  a.vals() = 5;
+  b = nd::empty(ndt::make_type<int64_t>());
+  af(a, kwds("dst", b));
+  EXPECT_EQ(4000, b.as<int64_t>());
+}
+
+TEST(Reduction, BuiltinMoments)
+{
+  // A large offset relative to the spread, which loses all the precision
+  // of the naive sum of squares
+  double vals[8] = {4, 7, 13, 16, 1, 9, 2, 20};
+  nd::array a = nd::empty(8, ndt::make_type<double>());
+  double mean = 0, m2 = 0, m3 = 0, m4 = 0;
+  for (int i = 0; i < 8; ++i) {
+    a(i).vals() = 1e9 + vals[i];
+    mean += vals[i] / 8;
+  }
+  for (int i = 0; i < 8; ++i) {
+    double d = vals[i] - mean;
+    m2 += d * d;
+    m3 += d * d * d;
+    m4 += d * d * d * d;
+  }
+
+  nd::arrfunc af = kernels::make_builtin_moment1d_arrfunc(
+      kernels::moment_statistic_var, float64_type_id);
+  EXPECT_NEAR(m2 / 8, af(a).as<double>(), 1e-6);
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                              float64_type_id, 1);
+  EXPECT_NEAR(m2 / 7, af(a).as<double>(), 1e-6);
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_std,
+                                              float64_type_id, 1);
+  EXPECT_NEAR(sqrt(m2 / 7), af(a).as<double>(), 1e-7);
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_skew,
+                                              float64_type_id);
+  EXPECT_NEAR(sqrt(8.0) * m3 / pow(m2, 1.5), af(a).as<double>(), 1e-6);
+  af = kernels::make_builtin_moment1d_arrfunc(
+      kernels::moment_statistic_kurtosis, float64_type_id);
+  EXPECT_NEAR(8 * m4 / (m2 * m2) - 3, af(a).as<double>(), 1e-6);
+
+  // Integer input
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                              int32_type_id);
+  EXPECT_EQ(8.25, af(parse_json("10 * int32", "[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]"))
+                      .as<double>());
+
+  // Too few values for the degrees of freedom, and all values equal
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                              int32_type_id, 1);
+  EXPECT_TRUE(dynd::isnan(af(parse_json("1 * int32", "[3]")).as<double>()));
+  af = kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_skew,
+                                              int32_type_id);
+  EXPECT_TRUE(dynd::isnan(af(parse_json("3 * int32", "[3, 3, 3]")).as<double>()));
+
+  EXPECT_THROW(kernels::make_builtin_moment1d_arrfunc(
+                   kernels::moment_statistic_var, complex_float64_type_id),
+               type_error);
+  EXPECT_THROW(kernels::make_moment_statistic_arrfunc(
+                   kernels::moment_statistic_var, -1),
+               invalid_argument);
+}
+
+TEST(Reduction, BuiltinMoments_Lift2D)
+{
+  // Reduce the inner dimension, then the outer one
+  nd::arrfunc stat = kernels::make_moment_statistic_arrfunc(
+      kernels::moment_statistic_var);
+  nd::array a = parse_json("3 * 4 * float64",
+                           "[[1, 2, 3, 4], [2, 2, 2, 2], [0, 10, 0, 10]]");
+  for (int axis = 0; axis < 2; ++axis) {
+    bool reduction_dimflags[2] = {axis == 0, axis == 1};
+    nd::arrfunc af = kernels::lift_builtin_moments_reduction_arrfunc(
+        float64_type_id, ndt::type("Fixed * Fixed * float64"), false, 2,
+        reduction_dimflags);
+    nd::array b = nd::empty(axis == 0 ? 4 : 3, kernels::make_moments_type());
+    af(a, kwds("dst", b));
+    const kernels::moments_state *s =
+        reinterpret_cast<const kernels::moments_state *>(
+            b.get_readonly_originptr());
+    if (axis == 0) {
+      EXPECT_EQ(3, s[0].count);
+      EXPECT_EQ(1, s[0].mean);
+      EXPECT_NEAR(2.0 / 3, stat(b(0)).as<double>(), 1e-12);
+      EXPECT_NEAR(128.0 / 9, stat(b(1)).as<double>(), 1e-12);
+    } else {
+      EXPECT_EQ(4, s[1].count);
+      EXPECT_EQ(2, s[1].mean);
+      EXPECT_NEAR(1.25, stat(b(0)).as<double>(), 1e-12);
+      EXPECT_EQ(0, stat(b(1)).as<double>());
+      EXPECT_NEAR(25, stat(b(2)).as<double>(), 1e-12);
+    }
+  }
+}
+
+TEST(Reduction, BuiltinMoments_Parallel)
+{
+  nd::arrfunc af = kernels::make_builtin_moment1d_arrfunc(
+      kernels::moment_statistic_kurtosis, int32_type_id);
+  nd::array a = nd::empty(1001, ndt::make_type<int>());
+  for (int i = 0; i < 1001; ++i) {
+    a(i).vals() = (i * 37) % 101 + i / 10;
+  }
+  double serial_result = af(a).as<double>();
+
+  {
+    default_eval_context_guard parallel_ectx(4, 16);
+    EXPECT_NEAR(serial_result, af(a).as<double>(), 1e-12);
+  }
+
+  // The combine arrfunc has to merge accumulators of the reduction's type
+  bool reduction_dimflags[1] = {true};
+  EXPECT_THROW(lift_reduction_arrfunc(
+                   kernels::make_builtin_moments_reduction_arrfunc(
+                       int32_type_id),
+                   ndt::type("Fixed * int32"), nd::array(), false, 1,
+                   reduction_dimflags, true, true, false, nd::array(),
+                   kernels::make_builtin_sum_reduction_arrfunc(int32_type_id)),
+               invalid_argument);
+}
+
+TEST(Reduction, BuiltinDescribe)
+{
+  nd::arrfunc af =
+      kernels::make_builtin_describe1d_arrfunc(kernels::describe_all,
+                                               ndt::make_type<double>());
+  nd::array a = nd::empty(6, ndt::make_type<double>());
+  a.vals() = nd::array{2.0, -1.0, numeric_limits<double>::quiet_NaN(), 7.5,
+                       4.0, numeric_limits<double>::quiet_NaN()};
+  nd::array b = af(a);
+  EXPECT_EQ(ndt::type("{count: int64, na_count: int64, sum: float64, "
+                      "mean: float64, min: float64, max: float64}"),
+            b.get_type());
+  EXPECT_EQ(4, b.p("count").as<int64_t>());
+  EXPECT_EQ(2, b.p("na_count").as<int64_t>());
+  EXPECT_EQ(12.5, b.p("sum").as<double>());
+  EXPECT_EQ(3.125, b.p("mean").as<double>());
+  EXPECT_EQ(-1, b.p("min").as<double>());
+  EXPECT_EQ(7.5, b.p("max").as<double>());
+
+  // A subset of the statistics, of an empty array
+  af = kernels::make_builtin_describe1d_arrfunc(
+      kernels::describe_count | kernels::describe_mean |
+          kernels::describe_max,
+      ndt::make_type<int32_t>());
+  b = af(nd::empty(0, ndt::make_type<int32_t>()));
+  EXPECT_EQ(ndt::type("{count: int64, mean: float64, max: float64}"),
+            b.get_type());
+  EXPECT_EQ(0, b.p("count").as<int64_t>());
+  EXPECT_TRUE(dynd::isnan(b.p("mean").as<double>()));
+  EXPECT_TRUE(dynd::isnan(b.p("max").as<double>()));
+
+  EXPECT_THROW(kernels::make_builtin_describe1d_arrfunc(
+                   0, ndt::make_type<int32_t>()),
+               invalid_argument);
+  EXPECT_THROW(kernels::make_builtin_describe1d_arrfunc(
+                   kernels::describe_all, ndt::make_string()),
+               type_error);
+}
+
+TEST(Reduction, BuiltinDescribe_Option)
+{
+  nd::arrfunc af = kernels::make_builtin_describe1d_arrfunc(
+      kernels::describe_count | kernels::describe_na_count |
+          kernels::describe_sum | kernels::describe_min,
+      ndt::type("?int32"));
+  nd::array a = parse_json("5 * ?int32", "[3, null, -4, 10, null]");
+  nd::array b = af(a);
+  EXPECT_EQ(3, b.p("count").as<int64_t>());
+  EXPECT_EQ(2, b.p("na_count").as<int64_t>());
+  EXPECT_EQ(9, b.p("sum").as<double>());
+  EXPECT_EQ(-4, b.p("min").as<double>());
+}
+
+TEST(Reduction, BuiltinDescribe_Axis)
+{
+  int adata[2][3] = {{1, 5, -2}, {4, 0, 9}};
+  nd::array a = adata;
+  int stats = kernels::describe_sum | kernels::describe_min |
+              kernels::describe_max;
+  for (int axis = 0; axis < 2; ++axis) {
+    SCOPED_TRACE(axis);
+    bool reduction_dimflags[2] = {axis == 0, axis == 1};
+    nd::arrfunc af = kernels::make_builtin_describe_arrfunc(
+        stats, ndt::make_type<int>(), ndt::type("Fixed * Fixed * int32"),
+        false, 2, reduction_dimflags);
+    nd::array b = af(a);
+    if (axis == 0) {
+      EXPECT_EQ(ndt::type("3 * {sum: float64, min: float64, max: float64}"),
+                b.get_type());
+      EXPECT_EQ(5, b(0).p("sum").as<double>());
+      EXPECT_EQ(0, b(1).p("min").as<double>());
+      EXPECT_EQ(9, b(2).p("max").as<double>());
+    } else {
+      EXPECT_EQ(ndt::type("2 * {sum: float64, min: float64, max: float64}"),
+                b.get_type());
+      EXPECT_EQ(4, b(0).p("sum").as<double>());
+      EXPECT_EQ(-2, b(0).p("min").as<double>());
+      EXPECT_EQ(9, b(1).p("max").as<double>());
+    }
+  }
+
+  // Keeping the reduced dimension
+  bool reduction_dimflags[2] = {false, true};
+  nd::arrfunc af = kernels::make_builtin_describe_arrfunc(
+      kernels::describe_count, ndt::make_type<int>(),
+      ndt::type("Fixed * Fixed * int32"), true, 2, reduction_dimflags);
+  nd::array b = af(a);
+  EXPECT_EQ(ndt::type("2 * 1 * {count: int64}"), b.get_type());
+  EXPECT_EQ(3, b(1, 0).p("count").as<int64_t>());
+}
+
+TEST(Reduction, BuiltinDescribe_Parallel)
+{
+  nd::arrfunc af = kernels::make_builtin_describe1d_arrfunc(
+      kernels::describe_all, ndt::make_type<int>());
+  nd::array a = nd::empty(1001, ndt::make_type<int>());
+  for (int i = 0; i < 1001; ++i) {
+    a(i).vals() = (i * 37) % 101 - i / 10;
+  }
+  nd::array serial_result = af(a);
+
+  nd::array parallel_result;
+  {
+    default_eval_context_guard parallel_ectx(4, 16);
+    parallel_result = af(a);
+  }
+  EXPECT_EQ(serial_result.p("count").as<int64_t>(),
+            parallel_result.p("count").as<int64_t>());
+  EXPECT_EQ(serial_result.p("sum").as<double>(),
+            parallel_result.p("sum").as<double>());
+  EXPECT_EQ(serial_result.p("min").as<double>(),
+            parallel_result.p("min").as<double>());
+  EXPECT_EQ(serial_result.p("max").as<double>(),
+            parallel_result.p("max").as<double>());
+}
@@ -9,10 +9,12 @@
 #include <cmath>
 
 #include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/func/rolling.hpp>
 #include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/kernels/moments_kernels.hpp>
 #include <dynd/func/lift_reduction_arrfunc.hpp>
 #include <dynd/func/call_callable.hpp>
 
@@ -60,3 +62,208 @@ TEST(Rolling, BuiltinMean_Kernel) {
         EXPECT_EQ(s / 4, b(i).as<double>());
     }
 }
+
+namespace {
+// The window op applied to every window the naive way, as a reference
+double naive_window(const string &op, const double *data, int begin, int end)
+{
+  int n = end - begin;
+  double s = 0, best = data[begin];
+  for (int j = begin; j < end; ++j) {
+    s += data[j];
+    if (dynd::isnan(data[j]) || dynd::isnan(best)) {
+      best = numeric_limits<double>::quiet_NaN();
+    } else if (op == "min" ? data[j] < best : data[j] > best) {
+      best = data[j];
+    }
+  }
+  if (op == "sum") {
+    return s;
+  } else if (op == "mean") {
+    return s / n;
+  } else if (op == "min" || op == "max") {
+    return best;
+  }
+  double mean = s / n, m2 = 0;
+  for (int j = begin; j < end; ++j) {
+    m2 += (data[j] - mean) * (data[j] - mean);
+  }
+  return op == "var" ? m2 / (n - 1) : sqrt(m2 / (n - 1));
+}
+} // anonymous namespace
+
+TEST(Rolling, BuiltinIncremental)
+{
+  const char *ops[] = {"sum", "mean", "var", "std", "min", "max"};
+  nd::arrfunc window_ops[] = {
+      kernels::make_builtin_sum1d_arrfunc(float64_type_id),
+      kernels::make_builtin_mean1d_arrfunc(float64_type_id, 0),
+      kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                             float64_type_id, 1),
+      kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_std,
+                                             float64_type_id, 1),
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_min,
+                                                float64_type_id),
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_max,
+                                                float64_type_id)};
+
+  // Large values entering and leaving the window check that no error is
+  // left behind by removing them
+  double adata[40];
+  for (int i = 0; i < 40; ++i) {
+    adata[i] = (i * 37) % 11 - 4.5 + ((i % 13 == 5) ? 1e12 : 0);
+  }
+  nd::array a = adata;
+
+  for (int k = 0; k < 6; ++k) {
+    SCOPED_TRACE(ops[k]);
+    kernels::builtin1d_info info;
+    EXPECT_TRUE(kernels::get_builtin1d_info(window_ops[k], info));
+    for (int w = 1; w <= 9; w += 4) {
+      nd::array b = nd::functional::rolling(window_ops[k], w)(a);
+      ASSERT_EQ(ndt::type("40 * float64"), b.get_type());
+      for (int i = 0; i < 40; ++i) {
+        double expected = i + 1 < w || (w == 1 && k >= 2 && k < 4)
+                              ? numeric_limits<double>::quiet_NaN()
+                              : naive_window(ops[k], adata, i + 1 - w, i + 1);
+        double actual = b(i).as<double>();
+        if (dynd::isnan(expected)) {
+          EXPECT_TRUE(dynd::isnan(actual)) << i;
+        } else {
+          EXPECT_NEAR(expected, actual, 1e-9 * (1 + fabs(expected))) << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(Rolling, BuiltinIncremental_NonFinite)
+{
+  double nan = numeric_limits<double>::quiet_NaN();
+  double inf = numeric_limits<double>::infinity();
+  nd::array a = nd::empty(8, ndt::make_type<double>());
+  a.vals() = nd::array{1.0, nan, 2.0, 3.0, inf, 4.0, 5.0, 6.0};
+
+  nd::array s = nd::functional::rolling(
+      kernels::make_builtin_sum1d_arrfunc(float64_type_id), 2)(a);
+  double sum_expected[] = {nan, nan, nan, 5, inf, inf, 9, 11};
+  // The mean skips NaN, needing one value with minp 1
+  nd::array b = nd::functional::rolling(
+      kernels::make_builtin_mean1d_arrfunc(float64_type_id, 1), 2)(a);
+  double mean_expected[] = {nan, 1, 2, 2.5, inf, inf, 4.5, 5.5};
+  nd::array c = nd::functional::rolling(
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_max,
+                                                float64_type_id),
+      2)(a);
+  double max_expected[] = {nan, nan, nan, 3, inf, inf, 5, 6};
+  nd::array d = nd::functional::rolling(
+      kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                             float64_type_id, 0),
+      2)(a);
+  double var_expected[] = {nan, nan, nan, 0.25, nan, nan, 0.25, 0.25};
+  for (int i = 0; i < 8; ++i) {
+    SCOPED_TRACE(i);
+    double results[] = {s(i).as<double>(), b(i).as<double>(),
+                        c(i).as<double>(), d(i).as<double>()};
+    double expected[] = {sum_expected[i], mean_expected[i], max_expected[i],
+                         var_expected[i]};
+    for (int k = 0; k < 4; ++k) {
+      if (dynd::isnan(expected[k])) {
+        EXPECT_TRUE(dynd::isnan(results[k])) << k;
+      } else {
+        EXPECT_EQ(expected[k], results[k]) << k;
+      }
+    }
+  }
+}
+
+TEST(Rolling, BuiltinIncremental_Int)
+{
+  int32_t adata[] = {5, -3, 7, 7, 1, 10, -8, 2, 2, 6};
+  nd::array a = adata;
+  nd::array s = nd::functional::rolling(
+      kernels::make_builtin_sum1d_arrfunc(int32_type_id), 3, 1)(a);
+  EXPECT_EQ(ndt::type("10 * int32"), s.get_type());
+  int32_t sum_expected[] = {5, 2, 9, 11, 15, 18, 3, 4, -4, 10};
+  nd::array b = nd::functional::rolling(
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_min,
+                                                int32_type_id),
+      3, 1)(a);
+  nd::array c = nd::functional::rolling(
+      kernels::make_builtin_reduction1d_arrfunc(kernels::builtin_reduction_max,
+                                                int32_type_id),
+      3, 1)(a);
+  int32_t min_expected[] = {5, -3, -3, -3, 1, 1, -8, -8, -8, 2};
+  int32_t max_expected[] = {5, 5, 7, 7, 7, 10, 10, 10, 2, 6};
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(sum_expected[i], s(i).as<int32_t>());
+    EXPECT_EQ(min_expected[i], b(i).as<int32_t>());
+    EXPECT_EQ(max_expected[i], c(i).as<int32_t>());
+  }
+
+  nd::array d = nd::functional::rolling(
+      kernels::make_builtin_moment1d_arrfunc(kernels::moment_statistic_var,
+                                             int32_type_id, 0),
+      2)(a);
+  EXPECT_EQ(ndt::type("10 * float64"), d.get_type());
+  EXPECT_TRUE(dynd::isnan(d(0).as<double>()));
+  EXPECT_EQ(16, d(1).as<double>());
+  EXPECT_EQ(0, d(3).as<double>());
+}
+
+TEST(Rolling, MinPeriods)
+{
+  double adata[] = {1, 3, 7, 2, 9, 4, -5};
+  nd::array a = adata;
+  // The builtin mean, and a product, which is called on every window
+  nd::arrfunc mean_1d = kernels::make_builtin_mean1d_arrfunc(float64_type_id, 0);
+  nd::arrfunc prod_1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_prod, float64_type_id);
+  kernels::builtin1d_info info;
+  EXPECT_FALSE(kernels::get_builtin1d_info(prod_1d, info));
+
+  nd::array b = nd::functional::rolling(mean_1d, 4, 2)(a);
+  nd::array c = nd::functional::rolling(prod_1d, 4, 2)(a);
+  EXPECT_TRUE(dynd::isnan(b(0).as<double>()));
+  EXPECT_TRUE(dynd::isnan(c(0).as<double>()));
+  for (int i = 1; i < 7; ++i) {
+    double s = 0, p = 1;
+    for (int j = max(i - 3, 0); j <= i; ++j) {
+      s += adata[j];
+      p *= adata[j];
+    }
+    EXPECT_EQ(s / (min(i, 3) + 1), b(i).as<double>());
+    EXPECT_EQ(p, c(i).as<double>());
+  }
+
+  // Shorter than the partial windows
+  b = nd::functional::rolling(prod_1d, 4, 1)(a(irange() < 2));
+  EXPECT_EQ(1, b(0).as<double>());
+  EXPECT_EQ(3, b(1).as<double>());
+
+  // Windows at the start, and only those, with an integer product
+  int64_t idata[] = {2, -3, 5, 7, 11};
+  nd::array ia = idata;
+  nd::arrfunc iprod_1d = kernels::make_builtin_reduction1d_arrfunc(
+      kernels::builtin_reduction_prod, int64_type_id);
+  EXPECT_JSON_EQ_ARR("[2, -6, -30, -210, -2310]",
+                     nd::functional::rolling(iprod_1d, 6, 1)(ia));
+  EXPECT_JSON_EQ_ARR("[2, -6, -30, -210, -1155]",
+                     nd::functional::rolling(iprod_1d, 4, 1)(ia));
+
+  // Only a builtin reduction has an identity to pad the windows at the start
+  EXPECT_EQ(1, get_lifted_builtin_reduction_identity(prod_1d).as<double>());
+  EXPECT_TRUE(get_lifted_builtin_reduction_identity(mean_1d).is_null());
+  bool broadcast = false;
+  nd::arrfunc broadcast_1d = lift_reduction_arrfunc(
+      kernels::make_builtin_reduction_arrfunc(kernels::builtin_reduction_prod,
+                                              float64_type_id),
+      ndt::type("Fixed * float64"), nd::arrfunc(), false, 1, &broadcast, true,
+      true, false, nd::array());
+  EXPECT_TRUE(get_lifted_builtin_reduction_identity(broadcast_1d).is_null());
+  EXPECT_THROW(nd::functional::rolling(broadcast_1d, 4, 2), invalid_argument);
+
+  EXPECT_THROW(nd::functional::rolling(mean_1d, 4, 0), invalid_argument);
+  EXPECT_THROW(nd::functional::rolling(mean_1d, 4, 5), invalid_argument);
+  EXPECT_THROW(nd::functional::rolling(mean_1d, 0), invalid_argument);
+}
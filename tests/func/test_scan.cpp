@@ -0,0 +1,131 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+#include <dynd/func/apply.hpp>
+#include <dynd/func/scan.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Scan, Builtin)
+{
+  nd::array a = parse_json("6 * int32", "[3, 1, 4, 1, 5, 9]");
+  nd::array b = nd::cumsum(a);
+  EXPECT_EQ(ndt::type("6 * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[3, 4, 8, 9, 14, 23]", b);
+  EXPECT_JSON_EQ_ARR("[3, 3, 12, 12, 60, 540]", nd::cumprod(a));
+  EXPECT_JSON_EQ_ARR("[3, 1, 1, 1, 1, 1]", nd::cummin(a));
+  EXPECT_JSON_EQ_ARR("[3, 3, 4, 4, 5, 9]", nd::cummax(a));
+
+  // A strided view
+  EXPECT_JSON_EQ_ARR("[3, 7, 12]", nd::cumsum(a(irange().by(2))));
+  EXPECT_JSON_EQ_ARR("[]", nd::cumsum(a(irange() < 0)));
+
+  // A NaN propagates through the min and max
+  a = nd::empty(4, ndt::make_type<double>());
+  a.vals() = 1.0;
+  a(1).vals() = numeric_limits<double>::quiet_NaN();
+  b = nd::cummax(a);
+  EXPECT_EQ(1.0, b(0).as<double>());
+  EXPECT_TRUE(dynd::isnan(b(1).as<double>()));
+  EXPECT_TRUE(dynd::isnan(b(3).as<double>()));
+
+  a = nd::empty(3, ndt::make_type<dynd::complex<double>>());
+  a(0).vals() = dynd::complex<double>(1, 2);
+  a(1).vals() = dynd::complex<double>(0, 1);
+  a(2).vals() = dynd::complex<double>(2, 0);
+  b = nd::cumprod(a);
+  EXPECT_EQ(dynd::complex<double>(-4, 2), b(2).as<dynd::complex<double>>());
+  EXPECT_THROW(nd::cummin(a), type_error);
+  EXPECT_THROW(nd::cumsum(nd::array(1)), invalid_argument);
+}
+
+TEST(Scan, Axis)
+{
+  nd::array a = parse_json("2 * 3 * int64", "[[1, 5, 3], [4, 2, 6]]");
+  EXPECT_JSON_EQ_ARR("[[1, 5, 3], [5, 7, 9]]", nd::cumsum(a));
+  EXPECT_JSON_EQ_ARR("[[1, 6, 9], [4, 6, 12]]",
+                     nd::cumsum(a, kwds("axis", 1)));
+  EXPECT_JSON_EQ_ARR("[[1, 5, 5], [4, 4, 6]]",
+                     nd::cummax(a, kwds("axis", -1)));
+  EXPECT_THROW(nd::cumsum(a, kwds("axis", 2)), axis_out_of_bounds);
+  EXPECT_THROW(nd::cumsum(a, kwds("axis", -3)), axis_out_of_bounds);
+}
+
+TEST(Scan, VarDim)
+{
+  // Each row of the var dimension is scanned on its own, compared as JSON
+  // because comparing var dimensions isn't implemented
+  nd::array a = parse_json("3 * var * int32", "[[1, 2, 3], [], [4, 5]]");
+  nd::array b = nd::cumsum(a, kwds("axis", 1));
+  EXPECT_EQ(ndt::type("3 * var * int32"), b.get_type());
+  EXPECT_EQ("[[1,3,6],[],[4,9]]", format_json(b).as<string>());
+
+  a = parse_json("var * 2 * float64", "[[1, 5], [4, 2], [1, 1]]");
+  b = nd::cumsum(a);
+  EXPECT_EQ(ndt::type("var * 2 * float64"), b.get_type());
+  EXPECT_EQ("[[1,5],[5,7],[6,8]]", format_json(b).as<string>());
+}
+
+static int affine(int x, int y) { return 2 * x + y; }
+
+static double mixed(int x, double y) { return x + y; }
+
+TEST(Scan, Generic)
+{
+  nd::arrfunc af = nd::functional::scan(nd::functional::apply(&affine));
+  EXPECT_EQ(ndt::type("(Dims... * int32, axis: ?int32) -> Dims... * int32"),
+            af.get_array_type());
+  EXPECT_JSON_EQ_ARR("[1, 4, 11, 26]",
+                     af(parse_json("4 * int32", "[1, 2, 3, 4]")));
+  // Along the outer dimension, the operation is applied to whole rows
+  EXPECT_JSON_EQ_ARR("[[1, 2], [5, 8]]",
+                     af(parse_json("2 * 2 * int32", "[[1, 2], [3, 4]]")));
+  EXPECT_JSON_EQ_ARR("[[1, 4], [3, 10]]",
+                     af(parse_json("2 * 2 * int32", "[[1, 2], [3, 4]]"),
+                        kwds("axis", 1)));
+
+  EXPECT_THROW(nd::functional::scan(nd::arrfunc()), invalid_argument);
+  EXPECT_THROW(nd::functional::scan(nd::functional::apply(&mixed)),
+               invalid_argument);
+}
+
+static int keep_left(int x, int DYND_UNUSED(y)) { return x; }
+
+TEST(Scan, Parallel)
+{
+  default_eval_context_guard parallel_ectx(4, 16);
+
+  nd::array a = nd::range(1000);
+  nd::array b = nd::cumsum(a);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i * (i + 1) / 2, b(i).as<int>());
+  }
+  b = nd::cummax(a(irange().by(-1)));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(999, b(i).as<int>());
+  }
+
+  // An associative but not commutative operation, whose chunks have to be
+  // combined in order
+  nd::arrfunc af =
+      nd::functional::scan(nd::functional::apply(&keep_left), true);
+  b = af(nd::range(5, 1005));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(5, b(i).as<int>());
+  }
+}
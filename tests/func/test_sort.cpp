@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+#include <dynd/func/random.hpp>
+#include <dynd/func/sort.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Sort, Builtin)
+{
+  nd::array a = parse_json("6 * int32", "[3, -1, 4, -1, 5, -9]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("6 * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[-9, -1, -1, 3, 4, 5]", b);
+  b = nd::argsort(a);
+  EXPECT_EQ(ndt::type("6 * int64"), b.get_type());
+  // The radix sort is stable
+  EXPECT_JSON_EQ_ARR("[5, 1, 3, 0, 2, 4]", b);
+
+  EXPECT_JSON_EQ_ARR("[-9, -1, -1]", nd::sort(a(irange().by(-2))));
+  EXPECT_JSON_EQ_ARR("[]", nd::sort(a(irange() < 0)));
+  EXPECT_JSON_EQ_ARR("[200, 7, 1]",
+                     nd::sort(parse_json("3 * uint8", "[7, 200, 1]"))(
+                         irange().by(-1)));
+  EXPECT_JSON_EQ_ARR("[false, false, true]",
+                     nd::sort(parse_json("3 * bool", "[true, false, false]")));
+  EXPECT_THROW(nd::sort(nd::array(1)), invalid_argument);
+}
+
+TEST(Sort, Real)
+{
+  // NaNs go last, and negative zero before zero
+  nd::array a = nd::empty(7, ndt::make_type<double>());
+  a(0).vals() = 2.5;
+  a(1).vals() = numeric_limits<double>::quiet_NaN();
+  a(2).vals() = -numeric_limits<double>::infinity();
+  a(3).vals() = 0.0;
+  a(4).vals() = -0.0;
+  a(5).vals() = -numeric_limits<double>::quiet_NaN();
+  a(6).vals() = -3.0;
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(-numeric_limits<double>::infinity(), b(0).as<double>());
+  EXPECT_EQ(-3.0, b(1).as<double>());
+  EXPECT_TRUE(signbit(b(2).as<double>()));
+  EXPECT_EQ(0.0, b(3).as<double>());
+  EXPECT_FALSE(signbit(b(3).as<double>()));
+  EXPECT_EQ(2.5, b(4).as<double>());
+  EXPECT_TRUE(dynd::isnan(b(5).as<double>()));
+  EXPECT_TRUE(dynd::isnan(b(6).as<double>()));
+  EXPECT_JSON_EQ_ARR("[2, 6, 4, 3, 0, 1, 5]", nd::argsort(a));
+
+  // Long enough lines to be radix sorted
+  a = nd::random::uniform(kwds("dst_tp", ndt::type("1000 * float64")));
+  a = (a - 0.5).eval();
+  b = nd::sort(a);
+  nd::array i = nd::argsort(a);
+  for (int j = 0; j < 1000; ++j) {
+    if (j > 0) {
+      EXPECT_LE(b(j - 1).as<double>(), b(j).as<double>());
+    }
+    EXPECT_EQ(b(j).as<double>(), a(i(j).as<intptr_t>()).as<double>());
+  }
+}
+
+TEST(Sort, Datetime)
+{
+  nd::array a = parse_json("4 * ?date",
+                           "[\"2015-03-01\", null, \"1999-12-31\", "
+                           "\"2001-01-01\"]").ucast(ndt::type("date")).eval();
+  EXPECT_JSON_EQ_ARR("[2, 3, 0, 1]", nd::argsort(a));
+}
+
+TEST(Sort, Axis)
+{
+  nd::array a = parse_json("2 * 3 * int64", "[[1, 5, 3], [4, 2, 6]]");
+  EXPECT_JSON_EQ_ARR("[[1, 3, 5], [2, 4, 6]]", nd::sort(a));
+  EXPECT_JSON_EQ_ARR("[[1, 2, 3], [4, 5, 6]]", nd::sort(a, kwds("axis", 0)));
+  EXPECT_JSON_EQ_ARR("[[0, 1, 0], [1, 0, 1]]",
+                     nd::argsort(a, kwds("axis", -2)));
+  EXPECT_THROW(nd::sort(a, kwds("axis", 2)), axis_out_of_bounds);
+
+  // Compared as JSON because comparing var dimensions isn't implemented
+  a = parse_json("2 * var * int32", "[[3, 1, 2], [5, 4]]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("2 * var * int32"), b.get_type());
+  EXPECT_EQ("[[1,2,3],[4,5]]", format_json(b).as<string>());
+  EXPECT_EQ("[[1,2,0],[1,0]]", format_json(nd::argsort(a)).as<string>());
+  EXPECT_THROW(nd::sort(a, kwds("axis", 0)), type_error);
+}
+
+TEST(Sort, String)
+{
+  nd::array a = parse_json("5 * string",
+                           "[\"pear\", \"apple\", \"fig\", \"apple\", \"b\"]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("5 * string"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[\"apple\", \"apple\", \"b\", \"fig\", \"pear\"]", b);
+  EXPECT_JSON_EQ_ARR("[1, 3, 4, 2, 0]",
+                     nd::argsort(a, kwds("stable", true)));
+
+  a = parse_json("4 * {x: int32, y: string}",
+                 "[[2, \"a\"], [1, \"z\"], [2, \"\"], [1, \"y\"]]");
+  EXPECT_JSON_EQ_ARR("[3, 1, 2, 0]", nd::argsort(a));
+  EXPECT_JSON_EQ_ARR("[{\"x\": 1, \"y\": \"y\"}, {\"x\": 1, \"y\": \"z\"}, "
+                     "{\"x\": 2, \"y\": \"\"}, {\"x\": 2, \"y\": \"a\"}]",
+                     nd::sort(a));
+}
+
+TEST(Sort, Parallel)
+{
+  default_eval_context_guard parallel_ectx(4, 16);
+
+  // Many equal keys, whose order only a stable sort keeps
+  nd::array a = nd::empty(1000, ndt::type("{key: string, i: int32}"));
+  for (int i = 0; i < 1000; ++i) {
+    a(i, 0).vals() = string(1, static_cast<char>('a' + (i * 7) % 13));
+    a(i, 1).vals() = i;
+  }
+  nd::array b = nd::sort(a, kwds("stable", true));
+  for (int i = 1; i < 1000; ++i) {
+    string prev = b(i - 1, 0).as<string>(), cur = b(i, 0).as<string>();
+    EXPECT_LE(prev, cur);
+    if (prev == cur) {
+      EXPECT_LT(b(i - 1, 1).as<int>(), b(i, 1).as<int>());
+    }
+  }
+  nd::array i = nd::argsort(a);
+  for (int j = 1; j < 1000; ++j) {
+    EXPECT_LE(a(i(j - 1).as<intptr_t>(), 0).as<string>(),
+              a(i(j).as<intptr_t>(), 0).as<string>());
+  }
+}
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+#include <dynd/func/unique.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Unique, Builtin)
+{
+  nd::array a = parse_json("8 * int32", "[3, -1, 4, -1, 5, 3, 3, -9]");
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * int32"), b.get_type());
+  EXPECT_EQ("[3,-1,4,5,-9]", format_json(b).as<string>());
+  b = nd::unique(a, kwds("sorted", true));
+  EXPECT_EQ("[-9,-1,3,4,5]", format_json(b).as<string>());
+
+  EXPECT_EQ("[-9,3,-1]",
+            format_json(nd::unique(a(irange().by(-2)))).as<string>());
+  EXPECT_EQ("[]", format_json(nd::unique(a(irange() < 0))).as<string>());
+
+  // All NaNs are one value, as are zero and negative zero
+  double c_vals[] = {1.5, numeric_limits<double>::quiet_NaN(), -0.0, 0.0,
+                     numeric_limits<double>::quiet_NaN(), 1.5};
+  b = nd::unique(nd::array(c_vals), kwds("sorted", true));
+  EXPECT_EQ(3, b.get_dim_size());
+  EXPECT_EQ(0.0, b(0).as<double>());
+  EXPECT_EQ(1.5, b(1).as<double>());
+  EXPECT_TRUE(std::isnan(b(2).as<double>()));
+}
+
+TEST(Unique, String)
+{
+  nd::array a = parse_json(
+      "6 * string", "[\"foo\", \"bar\", \"foo\", \"\", \"foot\", \"bar\"]");
+  EXPECT_EQ("[\"foo\",\"bar\",\"\",\"foot\"]",
+            format_json(nd::unique(a)).as<string>());
+  EXPECT_EQ("[\"\",\"bar\",\"foo\",\"foot\"]",
+            format_json(nd::unique(a, kwds("sorted", true))).as<string>());
+
+  a = parse_json("4 * fixed_string[3]", "[\"b\", \"a\", \"b\", \"ab\"]");
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * fixed_string[3]"), b.get_type());
+  EXPECT_EQ("[\"b\",\"a\",\"ab\"]", format_json(b).as<string>());
+}
+
+TEST(Unique, InverseAndCounts)
+{
+  nd::array a = parse_json("7 * int64", "[5, 2, 5, 7, 2, 5, 1]");
+  nd::arrfunc af = nd::functional::unique(true, true);
+  nd::array b = af(a);
+  EXPECT_EQ(ndt::type("{values: var * int64, inverse: 7 * int64, "
+                      "counts: var * int64}"),
+            b.get_type());
+  EXPECT_EQ("[5,2,7,1]", format_json(b.p("values")).as<string>());
+  EXPECT_JSON_EQ_ARR("[0, 1, 0, 2, 1, 0, 3]", b.p("inverse"));
+  EXPECT_EQ("[3,2,1,1]", format_json(b.p("counts")).as<string>());
+
+  b = af(a, kwds("sorted", true));
+  EXPECT_EQ("[1,2,5,7]", format_json(b.p("values")).as<string>());
+  EXPECT_JSON_EQ_ARR("[2, 1, 2, 3, 1, 2, 0]", b.p("inverse"));
+  EXPECT_EQ("[1,2,3,1]", format_json(b.p("counts")).as<string>());
+
+  b = nd::functional::unique(true, false)(a);
+  EXPECT_EQ(ndt::type("{values: var * int64, inverse: 7 * int64}"),
+            b.get_type());
+}
+
+TEST(Unique, ManyValues)
+{
+  // Enough distinct values to grow the hash table, both for scalars, which
+  // are hashed directly, and for structs, which are encoded first
+  nd::array a = nd::empty(5000, ndt::make_type<int16_t>());
+  nd::array s = nd::empty(5000, ndt::type("{x: int16, y: float32}"));
+  vector<int64_t> counts(1001, 0);
+  for (int i = 0; i < 5000; ++i) {
+    ++counts[(i * 37) % 1001];
+    a(i).vals() = (i * 37) % 1001 - 500;
+    s(i, 0).vals() = (i * 37) % 1001 - 500;
+    s(i, 1).vals() = i % 2 == 0 ? 0.0f : -0.0f;
+  }
+  nd::arrfunc af = nd::functional::unique(false, true);
+  nd::array b = af(a, kwds("sorted", true));
+  nd::array c = af(s, kwds("sorted", true));
+  ASSERT_EQ(1001, b.p("values").get_dim_size());
+  ASSERT_EQ(1001, c.p("values").get_dim_size());
+  for (int i = 0; i < 1001; ++i) {
+    EXPECT_EQ(i - 500, b.p("values")(i).as<int>());
+    EXPECT_EQ(i - 500, c.p("values")(i, 0).as<int>());
+    EXPECT_EQ(counts[i], b.p("counts")(i).as<int64_t>());
+    EXPECT_EQ(counts[i], c.p("counts")(i).as<int64_t>());
+  }
+}
+
+TEST(ValueCounts, String)
+{
+  nd::array a = parse_json(
+      "6 * string", "[\"foo\", \"bar\", \"foo\", \"baz\", \"foo\", \"bar\"]");
+  nd::array b = nd::value_counts(a);
+  EXPECT_EQ(ndt::type("{values: var * string, counts: var * int64}"),
+            b.get_type());
+  EXPECT_EQ("[\"foo\",\"bar\",\"baz\"]",
+            format_json(b.p("values")).as<string>());
+  EXPECT_EQ("[3,2,1]", format_json(b.p("counts")).as<string>());
+
+  b = nd::value_counts(a, kwds("sorted", true));
+  EXPECT_EQ("[\"bar\",\"baz\",\"foo\"]",
+            format_json(b.p("values")).as<string>());
+  EXPECT_EQ("[2,1,3]", format_json(b.p("counts")).as<string>());
+}
+
+TEST(Unique, Errors)
+{
+  EXPECT_THROW(nd::unique(parse_json("2 * 2 * int32", "[[1, 2], [3, 4]]")),
+               invalid_argument);
+  EXPECT_THROW(nd::unique(parse_json("2 * var * int32", "[[1], [2]]")),
+               invalid_argument);
+}
+
+TEST(Unique, OptionReal)
+{
+  // Zero and negative zero are one value under an option type too, and
+  // every NaN is the NA
+  nd::array a = parse_json("6 * ?float64",
+                           "[-0.0, 0.0, null, 1.5, null, 0.0]");
+  // Assigning a NaN to an option stores the NA, so other NaNs are written
+  // directly
+  uint64_t nan_bits[2] = {0x7ff8000000000123ULL, 0x7ff8000000000000ULL};
+  memcpy(a(3).get_readwrite_originptr(), &nan_bits[0], sizeof(double));
+  memcpy(a(5).get_readwrite_originptr(), &nan_bits[1], sizeof(double));
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * ?float64"), b.get_type());
+  ASSERT_EQ(2, b.get_dim_size());
+  EXPECT_EQ(0.0, b(0).as<double>());
+  EXPECT_TRUE(b(1).is_missing());
+
+  b = nd::unique(parse_json("5 * ?float32", "[0.0, -0.0, null, null, 2.5]"));
+  EXPECT_EQ(3, b.get_dim_size());
+}
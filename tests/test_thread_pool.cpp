@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/thread_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ThreadPool, PartitionRange)
+{
+  vector<intptr_t> chunk_begin;
+
+  EXPECT_EQ(1, partition_range(1, 100, 10, chunk_begin));
+  EXPECT_EQ(0, chunk_begin[0]);
+  EXPECT_EQ(100, chunk_begin[1]);
+
+  EXPECT_EQ(4, partition_range(4, 10, 2, chunk_begin));
+  EXPECT_EQ(0, chunk_begin[0]);
+  EXPECT_EQ(3, chunk_begin[1]);
+  EXPECT_EQ(6, chunk_begin[2]);
+  EXPECT_EQ(8, chunk_begin[3]);
+  EXPECT_EQ(10, chunk_begin[4]);
+
+  // The grain size limits the number of chunks
+  EXPECT_EQ(2, partition_range(8, 10, 5, chunk_begin));
+  EXPECT_EQ(5, chunk_begin[1]);
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+  vector<int> values(10000, 0);
+  parallel_for(4, values.size(), 100,
+               [&](intptr_t DYND_UNUSED(i), intptr_t begin, intptr_t end) {
+    for (intptr_t j = begin; j < end; ++j) {
+      values[j] += static_cast<int>(j);
+    }
+  });
+  for (size_t j = 0; j < values.size(); ++j) {
+    EXPECT_EQ(static_cast<int>(j), values[j]);
+  }
+}
+
+TEST(ThreadPool, Nested)
+{
+  // A parallel execution started from inside a task runs serially
+  vector<int> values(16, 0);
+  thread_pool::get().run(4, 4, [&](intptr_t i) {
+    thread_pool::get().run(4, 4, [&](intptr_t j) { values[4 * i + j] = 1; });
+  });
+  for (size_t j = 0; j < values.size(); ++j) {
+    EXPECT_EQ(1, values[j]);
+  }
+}
+
+TEST(ThreadPool, Exception)
+{
+  // Two tasks throw, one exception reaches the caller, and it is only
+  // rethrown once all the other tasks have finished
+  vector<int> finished(8, 0);
+  int caught = 0;
+  try {
+    thread_pool::get().run(4, 8, [&](intptr_t i) {
+      if (i == 2 || i == 5) {
+        throw runtime_error("task failed");
+      }
+      finished[i] = 1;
+    });
+  }
+  catch (const runtime_error &) {
+    ++caught;
+  }
+  EXPECT_EQ(1, caught);
+  for (intptr_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(i == 2 || i == 5 ? 0 : 1, finished[i]) << i;
+  }
+
+  // The pool is still usable afterwards, without the old exception
+  int count[3] = {0, 0, 0};
+  EXPECT_NO_THROW(
+      thread_pool::get().run(3, 3, [&](intptr_t i) { count[i] = 1; }));
+  EXPECT_EQ(1, count[0]);
+  EXPECT_EQ(1, count[1]);
+  EXPECT_EQ(1, count[2]);
+}
@@ -6,9 +6,12 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <limits>
 #include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/hash_index.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 #include <dynd/types/string_type.hpp>
@@ -163,6 +166,32 @@ TEST(CategoricalType, FactorInt) {
     EXPECT_EQ(ndt::make_categorical(int_cats), di);
 }
 
+TEST(CategoricalType, FactorReal) {
+    // NaNs factor into one category, as do zero and negative zero
+    double a_vals[] = {1.5, numeric_limits<double>::quiet_NaN(), -0.0, 0.0,
+                       -2.0, numeric_limits<double>::quiet_NaN(), 1.5};
+    ndt::type da = ndt::factor_categorical(a_vals);
+    EXPECT_EQ(4u, da.extended<ndt::categorical_type>()->get_category_count());
+}
+
+TEST(CategoricalType, FactorStringParallel) {
+    nd::array a = nd::empty(1000, ndt::make_string());
+    for (int i = 0; i < 1000; ++i) {
+        stringstream ss;
+        ss << "value" << (i * 37) % 101;
+        a(i).vals() = ss.str();
+    }
+    ndt::type serial = ndt::factor_categorical(a);
+    EXPECT_EQ(101u, serial.extended<ndt::categorical_type>()->get_category_count());
+
+    ndt::type parallel;
+    {
+        default_eval_context_guard parallel_ectx(4, 16);
+        parallel = ndt::factor_categorical(a);
+    }
+    EXPECT_EQ(serial, parallel);
+}
+
 TEST(CategoricalType, Values) {
     const char *a_vals[] = {"foo", "bar", "baz"};
     nd::array a = nd::empty(3, ndt::make_fixed_string(3, string_encoding_ascii));
@@ -322,3 +351,32 @@ TEST(CategoricalType, AssignFromOther) {
     EXPECT_EQ(3, a(5).as<int>());
 }
 
+
+TEST(CategoricalType, AssignStridedString) {
+    // More than 256 categories, so the storage is uint16
+    nd::array cats = nd::empty(300, ndt::make_string());
+    for (int i = 0; i < 300; ++i) {
+        stringstream ss;
+        ss << "cat" << (i * 7919) % 300;
+        cats(i).vals() = ss.str();
+    }
+    ndt::type cd = ndt::make_categorical(cats);
+    const ndt::categorical_type *cat_tp = cd.extended<ndt::categorical_type>();
+    ASSERT_TRUE(cat_tp->get_category_index() != NULL);
+    EXPECT_EQ(300, cat_tp->get_category_index()->size());
+
+    // Every other category, backwards
+    nd::array src = cats(irange().by(-2));
+    nd::array a = nd::empty(150, cd);
+    a.val_assign(src);
+    for (int i = 0; i < 150; ++i) {
+        EXPECT_EQ(src(i).as<string>(), a(i).as<string>());
+        EXPECT_EQ(src(i).as<string>(),
+                  cats(cat_tp->get_value_from_category(src(i))).as<string>());
+    }
+
+    nd::array bad = nd::empty(2, ndt::make_string());
+    bad(0).vals() = "cat1";
+    bad(1).vals() = "unknown";
+    EXPECT_THROW(a(irange() < 2).val_assign(bad), std::runtime_error);
+}
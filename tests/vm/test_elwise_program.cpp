@@ -11,6 +11,9 @@
 #include "inc_gtest.hpp"
 
 #include "dynd/vm/elwise_program.hpp"
+#include "dynd/eval/eval_elwise_vm.hpp"
+#include "dynd/json_parser.hpp"
+#include "../dynd_assertions.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -47,3 +50,98 @@ TEST(VMElwiseProgram, Validation) {
     program4[1] = 1;
     EXPECT_THROW(vm::validate_elwise_program(1, 3, 8, program4), runtime_error);
 }
+
+TEST(VMElwiseProgram, EvaluateFused) {
+    // a*b + c*d, with broadcasting and enough elements for several chunks
+    vector<ndt::type> regtypes(7, ndt::make_type<double>());
+    int program_data[] = {vm::opcode_multiply, 5, 1, 2,
+                          vm::opcode_multiply, 6, 3, 4,
+                          vm::opcode_add, 0, 5, 6};
+    vector<int> program(program_data, program_data + 12);
+    vm::elwise_program ep(4, regtypes, program);
+
+    const int n = 1000;
+    nd::array a = nd::empty(3, n, ndt::make_type<double>());
+    nd::array b = nd::empty(n, ndt::make_type<double>());
+    nd::array d = nd::empty(3, 2 * n, ndt::make_type<double>());
+    double *a_data = reinterpret_cast<double *>(a.get_readwrite_originptr());
+    double *b_data = reinterpret_cast<double *>(b.get_readwrite_originptr());
+    double *d_data = reinterpret_cast<double *>(d.get_readwrite_originptr());
+    for (int i = 0; i < 3 * n; ++i) {
+        a_data[i] = i;
+        d_data[2 * i] = 3 * i;
+        d_data[2 * i + 1] = -1;
+    }
+    for (int i = 0; i < n; ++i) {
+        b_data[i] = i % 7;
+    }
+    vector<nd::array> inputs;
+    inputs.push_back(a);
+    inputs.push_back(b);
+    inputs.push_back(0.5);
+    inputs.push_back(d(irange(), irange().by(2)));
+
+    nd::array c = eval::evaluate_elwise_vm(ep, inputs);
+    EXPECT_EQ(ndt::type("3 * 1000 * float64"), c.get_type());
+    const double *c_data = reinterpret_cast<const double *>(c.get_readonly_originptr());
+    for (int i = 0; i < 3 * n; ++i) {
+        EXPECT_EQ(i * ((i % n) % 7) + 0.5 * (3 * i), c_data[i]);
+    }
+}
+
+TEST(VMElwiseProgram, EvaluateSelect) {
+    // select(less(a, b), a, b), with the int32 input converted to float64
+    vector<ndt::type> regtypes;
+    regtypes.push_back(ndt::make_type<double>());
+    regtypes.push_back(ndt::make_type<double>());
+    regtypes.push_back(ndt::make_type<double>());
+    regtypes.push_back(ndt::make_type<dynd_bool>());
+    int program_data[] = {vm::opcode_less, 3, 1, 2,
+                          vm::opcode_select, 0, 3, 1, 2};
+    vector<int> program(program_data, program_data + 9);
+    vm::elwise_program ep(2, regtypes, program);
+
+    vector<nd::array> inputs;
+    inputs.push_back(parse_json("5 * int32", "[3, -1, 7, 0, 10]"));
+    inputs.push_back(parse_json("5 * float64", "[2.5, 0.5, 7.5, -0.5, 10]"));
+    nd::array c = eval::evaluate_elwise_vm(ep, inputs);
+    EXPECT_JSON_EQ_ARR("[2.5, -1, 7, -0.5, 10]", c);
+}
+
+TEST(VMElwiseProgram, EvaluateMathAndCast) {
+    // cast(floor(sqrt(a) * a)) to int64
+    vector<ndt::type> regtypes;
+    regtypes.push_back(ndt::make_type<int64_t>());
+    regtypes.push_back(ndt::make_type<double>());
+    regtypes.push_back(ndt::make_type<double>());
+    int program_data[] = {vm::opcode_sqrt, 2, 1,
+                          vm::opcode_multiply, 2, 2, 1,
+                          vm::opcode_floor, 2, 2,
+                          vm::opcode_cast, 0, 2};
+    vector<int> program(program_data, program_data + 13);
+    vm::elwise_program ep(1, regtypes, program);
+
+    vector<nd::array> inputs;
+    inputs.push_back(parse_json("2 * 2 * float64", "[[0, 1], [2, 4]]"));
+    nd::array c = eval::evaluate_elwise_vm(ep, inputs);
+    EXPECT_EQ(ndt::type("2 * 2 * int64"), c.get_type());
+    EXPECT_JSON_EQ_ARR("[[0, 1], [2, 8]]", c);
+}
+
+TEST(VMElwiseProgram, EvaluateErrors) {
+    vector<ndt::type> regtypes;
+    regtypes.push_back(ndt::make_type<double>());
+    regtypes.push_back(ndt::make_type<int32_t>());
+    regtypes.push_back(ndt::make_type<double>());
+    int program_data[] = {vm::opcode_add, 0, 1, 2};
+    vector<int> program(program_data, program_data + 4);
+    vm::elwise_program ep(2, regtypes, program);
+
+    vector<nd::array> inputs;
+    inputs.push_back(1);
+    // The wrong number of inputs
+    EXPECT_THROW(eval::evaluate_elwise_vm(ep, inputs), runtime_error);
+    // Arguments with mismatched register types
+    inputs.push_back(1.0);
+    EXPECT_THROW(eval::evaluate_elwise_vm(ep, inputs), type_error);
+}
@@ -20,7 +20,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/resource.h>
+#if defined OS_FREEBSD || defined OS_MACOSX
 #include <sys/sysctl.h>
+#endif
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>